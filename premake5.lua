@@ -6,6 +6,32 @@ workspace "IWindow"
 
     vulkanSdk = os.getenv("VULKAN_SDK");
 
+    newoption {
+        trigger = "wayland",
+        description = "Build the Linux test programs with the Wayland backend instead of X11"
+    }
+
+    newoption {
+        trigger = "null",
+        description = "Build TestWindow with the headless null backend"
+    }
+
+    -- Generates the xdg-shell client code the Wayland backend uses into src/generated.
+    function waylandProtocols()
+        local protocolDir = os.outputof("pkg-config --variable=pkgdatadir wayland-protocols")
+        if not protocolDir or protocolDir == "" then protocolDir = "/usr/share/wayland-protocols" end
+        local xdgShell = protocolDir .. "/stable/xdg-shell/xdg-shell.xml"
+
+        prebuildcommands {
+            "{MKDIR} %{wks.location}/src/generated",
+            "wayland-scanner client-header " .. xdgShell .. " %{wks.location}/src/generated/xdg-shell-client-protocol.h",
+            "wayland-scanner private-code " .. xdgShell .. " %{wks.location}/src/generated/xdg-shell-protocol.c",
+        }
+
+        files { "src/generated/xdg-shell-protocol.c" }
+        includedirs { "src/generated" }
+    end
+
     function defaultBuildCfg()
         filter "configurations:Debug"
             defines { "DEBUG" }
@@ -33,11 +59,22 @@ workspace "IWindow"
         language "C++"
         cppdialect "C++17"
 
-        files {"%{prj.location}/Window.cpp", "%{prj.location}/stb.cpp", "src/IWindowWin32.cpp", "src/IWindowWin32Gamepad.cpp", "src/IWindow.cpp", "src/IWindowUtilsWin32.cpp"}
+        files {"%{prj.location}/Window.cpp", "%{prj.location}/stb.cpp"}
 
         includedirs { "src" }
 
-        links { "User32", "XInput" } 
+        if _OPTIONS["null"] then
+            defines { "IWINDOW_NULL" }
+            links { "IWindowNull" }
+            -- Window::SetInputThread uses std::thread.
+            if package.config:sub(1,1) == "/" then links { "pthread" } end
+        elseif package.config:sub(1,1) == "/" then
+            defines { "IWINDOW_XCB" }
+            links { "IWindowXcb", "xcb", "xcb-xinput", "xcb-randr", "pthread" }
+        else
+            files {"src/IWindowWin32.cpp", "src/IWindowWin32Gamepad.cpp", "src/IWindowGamepad.cpp", "src/IWindowGamepadManager.cpp", "src/IWindowGamepadAxes.cpp", "src/IWindow.cpp", "src/IWindowWindow.cpp", "src/IWindowMonitor.cpp", "src/IWindowFramePacer.cpp", "src/IWindowUtilsWin32.cpp"}
+            links { "User32", "XInput" } 
+        end
 
         defaultBuildLocation()
 
@@ -76,7 +113,13 @@ workspace "IWindow"
         
         
         if package.config:sub(1,1) == "/" then -- Linux
-            platformLinks = { "IWindowXlibVk", "X11", "Xcursor", "vulkan", "GLX" }
+            if _OPTIONS["wayland"] then
+                platformLinks = { "IWindowWaylandVk", "wayland-client", "wayland-cursor", "xkbcommon", "vulkan", "pthread" }
+                defines { "IWINDOW_WAYLAND" }
+            else
+                platformLinks = { "IWindowXlibVk", "X11", "Xcursor", "Xi", "Xrandr", "vulkan", "GLX", "pthread" }
+                defines { "IWINDOW_XLIB" }
+            end
             includedirs { "src" }
         else
             libdirs { vulkanSdk .. "/Lib" }
@@ -90,6 +133,362 @@ workspace "IWindow"
 
         defaultBuildCfg()
 
+    -- Cost of setting, copying and calling a callback. Run the Release build.
+    project "BenchmarkDelegate"
+        location "test/BenchmarkDelegate"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/BenchmarkDelegate.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Cost of reading every key each frame with the Is* queries and ForEachChangedKey. Run the Release build.
+    project "BenchmarkInput"
+        location "test/BenchmarkInput"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/BenchmarkInput.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Checks that Window::CaptureInputSnapshot holds the input of one update and can be read on another thread.
+    project "TestInputSnapshot"
+        location "test/TestInputSnapshot"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/InputSnapshot.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Checks that events carry the time they happened, in the event queue and inside callbacks.
+    project "TestInputTimestamps"
+        location "test/TestInputTimestamps"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/InputTimestamps.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Checks the input-to-present latency histogram, presenting with IWindow::Null::PresentFramebuffer.
+    project "TestLatencyStats"
+        location "test/TestLatencyStats"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/LatencyStats.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Replays a recorded window drag with and without event coalescing. Run the Release build.
+    project "BenchmarkCoalescing"
+        location "test/BenchmarkCoalescing"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/BenchmarkCoalescing.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Cost of reading the time with IWindow::GetTimeNs, with and without the time stamp counter, and with std::chrono. Run the Release build.
+    project "BenchmarkTimer"
+        location "test/BenchmarkTimer"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/BenchmarkTimer.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Pacing error of FramePacer and of a sleep_for limiter at 60, 144 and 240 frames per second. Run the Release build on an idle machine.
+    project "BenchmarkFramePacer"
+        location "test/BenchmarkFramePacer"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/BenchmarkFramePacer.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Driver calls per frame of GamepadManager against polling every slot in every Gamepad::Update, with a mock backend. Also checks the probe schedule.
+    project "BenchmarkGamepadManager"
+        location "test/BenchmarkGamepadManager"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/BenchmarkGamepadManager.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Input handling time of scanning every gamepad button and axis each frame against the GamepadManager button and axis callbacks.
+    project "BenchmarkGamepadEvents"
+        location "test/BenchmarkGamepadEvents"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/BenchmarkGamepadEvents.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Axis conversion and deadzones of four gamepads once per update against converting in every getter call. Also checks the SIMD path against scalar formulas.
+    project "BenchmarkGamepadAxes"
+        location "test/BenchmarkGamepadAxes"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        files {"%{prj.location}/BenchmarkGamepadAxes.cpp"}
+
+        includedirs { "src" }
+
+        defines { "IWINDOW_NULL" }
+        links { "IWindowNull" }
+        if package.config:sub(1,1) == "/" then links { "pthread" } end
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    -- Reads gamepads with the evdev backend: a uinput virtual pad when run as root, otherwise a replayed capture. Linux only.
+    if package.config:sub(1,1) == "/" then
+        project "TestEvdevGamepad"
+            location "test/TestEvdevGamepad"
+            kind "ConsoleApp"
+            language "C++"
+            cppdialect "C++17"
+
+            files {"%{prj.location}/EvdevGamepad.cpp"}
+
+            includedirs { "src" }
+
+            defines { "IWINDOW_NULL" }
+            links { "IWindowNull", "pthread" }
+
+            defaultBuildLocation()
+
+            defaultBuildCfg()
+    end
+
+    -- Taps a replayed evdev pad faster than the frames and compares reading it per frame with the gamepad polling thread. Linux only.
+    if package.config:sub(1,1) == "/" then
+        project "BenchmarkGamepadPolling"
+            location "test/BenchmarkGamepadPolling"
+            kind "ConsoleApp"
+            language "C++"
+            cppdialect "C++17"
+
+            files {"%{prj.location}/BenchmarkGamepadPolling.cpp"}
+
+            includedirs { "src" }
+
+            defines { "IWINDOW_NULL" }
+            links { "IWindowNull", "pthread" }
+
+            defaultBuildLocation()
+
+            defaultBuildCfg()
+    end
+
+    -- Connects and disconnects monitors and checks the monitor callback. Linux only.
+    -- With --null it runs anywhere. Otherwise it adds RandR 1.5 monitors to the X server, so run it with xvfb-run.
+    if package.config:sub(1,1) == "/" then
+        project "TestMonitors"
+            location "test/TestMonitors"
+            kind "ConsoleApp"
+            language "C++"
+            cppdialect "C++17"
+
+            files {"%{prj.location}/Monitors.cpp"}
+
+            includedirs { "src" }
+
+            if _OPTIONS["null"] then
+                defines { "IWINDOW_NULL" }
+                links { "IWindowNull", "pthread" }
+            else
+                defines { "IWINDOW_XCB" }
+                links { "IWindowXcb", "xcb", "xcb-xinput", "xcb-randr", "pthread" }
+            end
+
+            defaultBuildLocation()
+
+            defaultBuildCfg()
+    end
+
+    -- Switches the primary monitor to another video mode with exclusive fullscreen and back. Linux only.
+    -- With --null it runs anywhere. Otherwise it adds RandR modes to the X server, so run it with xvfb-run.
+    if package.config:sub(1,1) == "/" then
+        project "TestVideoModes"
+            location "test/TestVideoModes"
+            kind "ConsoleApp"
+            language "C++"
+            cppdialect "C++17"
+
+            files {"%{prj.location}/VideoModes.cpp"}
+
+            includedirs { "src" }
+
+            if _OPTIONS["null"] then
+                defines { "IWINDOW_NULL" }
+                links { "IWindowNull", "pthread" }
+            else
+                defines { "IWINDOW_XCB" }
+                links { "IWindowXcb", "xcb", "xcb-xinput", "xcb-randr", "pthread" }
+            end
+
+            defaultBuildLocation()
+
+            defaultBuildCfg()
+    end
+
+    -- Replays recorded mouse motion through raw mouse motion. Linux only.
+    -- With --null it runs anywhere. Otherwise it injects XTest motion, so run it with xvfb-run.
+    if package.config:sub(1,1) == "/" then
+        project "TestRawMouse"
+            location "test/TestRawMouse"
+            kind "ConsoleApp"
+            language "C++"
+            cppdialect "C++17"
+
+            files {"%{prj.location}/RawMouse.cpp"}
+
+            includedirs { "src" }
+
+            if _OPTIONS["null"] then
+                defines { "IWINDOW_NULL" }
+                links { "IWindowNull", "pthread" }
+            else
+                defines { "IWINDOW_XCB" }
+                links { "IWindowXcb", "xcb", "xcb-xinput", "xcb-randr", "xcb-xtest", "pthread" }
+            end
+
+            defaultBuildLocation()
+
+            defaultBuildCfg()
+    end
+
+    -- Embeds IWindow in an epoll loop through IWindow::GetEventFd. Linux only.
+    if package.config:sub(1,1) == "/" then
+        project "TestWindowEpoll"
+            location "test/TestWindowEpoll"
+            kind "ConsoleApp"
+            language "C++"
+            cppdialect "C++17"
+
+            files {"%{prj.location}/WindowEpoll.cpp"}
+
+            includedirs { "src" }
+
+            -- With the null backend the example presses a key and closes the window by itself and fails if the events never arrived.
+            if _OPTIONS["null"] then
+                defines { "IWINDOW_NULL" }
+                links { "IWindowNull", "pthread" }
+            elseif _OPTIONS["wayland"] then
+                defines { "IWINDOW_WAYLAND" }
+                links { "IWindowWayland", "wayland-client", "wayland-cursor", "xkbcommon", "pthread" }
+            else
+                defines { "IWINDOW_XCB" }
+                links { "IWindowXcb", "xcb", "xcb-xinput", "xcb-randr", "pthread" }
+            end
+
+            defaultBuildLocation()
+
+            defaultBuildCfg()
+    end
+
     project "IWindowWin32GL"
         location "src"
         kind "StaticLib"
@@ -98,7 +497,7 @@ workspace "IWindow"
 
         includedirs { "src" }
 
-        files {"%{prj.location}/IWindowWin32.cpp", "%{prj.location}/IWindowWin32GL.cpp", "src/IWindowWin32Gamepad.cpp", "src/IWindow.cpp", "src/IWindowUtilsWin32.cpp"}
+        files {"%{prj.location}/IWindowWin32.cpp", "%{prj.location}/IWindowWin32GL.cpp", "src/IWindowWin32Gamepad.cpp", "src/IWindowGamepad.cpp", "src/IWindowGamepadManager.cpp", "src/IWindowGamepadAxes.cpp", "src/IWindow.cpp", "src/IWindowWindow.cpp", "src/IWindowMonitor.cpp", "src/IWindowFramePacer.cpp", "src/IWindowUtilsWin32.cpp"}
 
         links {"User32", "OpenGL32", "XInput"}
 
@@ -106,6 +505,25 @@ workspace "IWindow"
 
         defaultBuildCfg()
 
+    project "IWindowXcb"
+        location "src"
+        kind "StaticLib"
+        language "C++"
+        cppdialect "C++17"
+
+        includedirs { "src" }
+
+        -- Client applications have to define IWINDOW_XCB too.
+        defines { "IWINDOW_XCB" }
+
+        files {"%{prj.location}/IWindowXcb.cpp", "src/IWindowUtilsXcb.cpp", "src/IWindowEvdevGamepad.cpp", "src/IWindowGamepad.cpp", "src/IWindowGamepadManager.cpp", "src/IWindowGamepadAxes.cpp", "src/IWindow.cpp", "src/IWindowWindow.cpp", "src/IWindowMonitor.cpp", "src/IWindowFramePacer.cpp"}
+
+        links {"xcb", "xcb-xinput", "xcb-randr", "pthread"}
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
 
     project "IWindowWin32Vk"
         location "src"
@@ -113,7 +531,7 @@ workspace "IWindow"
         language "C++"
         cppdialect "C++17"
 
-        files {"%{prj.location}/IWindowWin32.cpp", "%{prj.location}/IWindowWin32Vk.cpp", "src/IWindowWin32Gamepad.cpp", "src/IWindow.cpp", "src/IWindowUtilsWin32.cpp"}
+        files {"%{prj.location}/IWindowWin32.cpp", "%{prj.location}/IWindowWin32Vk.cpp", "src/IWindowWin32Gamepad.cpp", "src/IWindowGamepad.cpp", "src/IWindowGamepadManager.cpp", "src/IWindowGamepadAxes.cpp", "src/IWindow.cpp", "src/IWindowWindow.cpp", "src/IWindowMonitor.cpp", "src/IWindowFramePacer.cpp", "src/IWindowUtilsWin32.cpp"}
 
         includedirs { vulkanSdk .. "/Include", "src" }
 
@@ -124,6 +542,84 @@ workspace "IWindow"
 
         defaultBuildCfg()
 
+    project "IWindowXlibVk"
+        location "src"
+        kind "StaticLib"
+        language "C++"
+        cppdialect "C++17"
+
+        -- Client applications have to define IWINDOW_XLIB too.
+        defines { "IWINDOW_XLIB" }
+
+        files {"%{prj.location}/IWindowXlib.cpp", "%{prj.location}/IWindowXlibVk.cpp", "src/IWindowUtilsXlib.cpp", "src/IWindowEvdevGamepad.cpp", "src/IWindowGamepad.cpp", "src/IWindowGamepadManager.cpp", "src/IWindowGamepadAxes.cpp", "src/IWindow.cpp", "src/IWindowWindow.cpp", "src/IWindowMonitor.cpp", "src/IWindowFramePacer.cpp"}
+
+        includedirs { "src" }
+
+        links {"X11", "Xcursor", "Xi", "Xrandr", "vulkan", "pthread"}
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    project "IWindowWayland"
+        location "src"
+        kind "StaticLib"
+        language "C++"
+        cppdialect "C++17"
+
+        -- Client applications have to define IWINDOW_WAYLAND too.
+        defines { "IWINDOW_WAYLAND" }
+
+        files {"%{prj.location}/IWindowWayland.cpp", "src/IWindowUtilsWayland.cpp", "src/IWindowEvdevGamepad.cpp", "src/IWindowGamepad.cpp", "src/IWindowGamepadManager.cpp", "src/IWindowGamepadAxes.cpp", "src/IWindow.cpp", "src/IWindowWindow.cpp", "src/IWindowMonitor.cpp", "src/IWindowFramePacer.cpp"}
+
+        includedirs { "src" }
+
+        waylandProtocols()
+
+        links {"wayland-client", "wayland-cursor", "xkbcommon", "pthread"}
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    project "IWindowWaylandVk"
+        location "src"
+        kind "StaticLib"
+        language "C++"
+        cppdialect "C++17"
+
+        -- Client applications have to define IWINDOW_WAYLAND too.
+        defines { "IWINDOW_WAYLAND" }
+
+        files {"%{prj.location}/IWindowWayland.cpp", "%{prj.location}/IWindowWaylandVk.cpp", "src/IWindowUtilsWayland.cpp", "src/IWindowEvdevGamepad.cpp", "src/IWindowGamepad.cpp", "src/IWindowGamepadManager.cpp", "src/IWindowGamepadAxes.cpp", "src/IWindow.cpp", "src/IWindowWindow.cpp", "src/IWindowMonitor.cpp", "src/IWindowFramePacer.cpp"}
+
+        includedirs { "src" }
+
+        waylandProtocols()
+
+        links {"wayland-client", "wayland-cursor", "xkbcommon", "vulkan", "pthread"}
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
+    project "IWindowNull"
+        location "src"
+        kind "StaticLib"
+        language "C++"
+        cppdialect "C++17"
+
+        -- Client applications have to define IWINDOW_NULL too.
+        defines { "IWINDOW_NULL" }
+
+        files {"%{prj.location}/IWindowNull.cpp", "src/IWindowNullGamepad.cpp", "src/IWindowEvdevGamepad.cpp", "src/IWindowGamepad.cpp", "src/IWindowGamepadManager.cpp", "src/IWindowGamepadAxes.cpp", "src/IWindowUtilsNull.cpp", "src/IWindow.cpp", "src/IWindowWindow.cpp", "src/IWindowMonitor.cpp", "src/IWindowFramePacer.cpp"}
+
+        includedirs { "src" }
+
+        defaultBuildLocation()
+
+        defaultBuildCfg()
+
     project "IWindowWin32All"
         location "src"
         kind "StaticLib"
@@ -1,5 +1,24 @@
 #include "IWindow.h"
 
+#include <atomic>
+#include <mutex>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <intrin.h>
+#else
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define IWINDOW_HAS_TSC
+#endif
+
 namespace IWindow {
 	static Version ver = "";
 
@@ -23,4 +42,130 @@ namespace IWindow {
 
 	// Shutdown does not do anything currently
 	void Shutdown() { }
-}
+
+	static uint64_t OsTimerValue() {
+#if defined(_WIN32)
+		LARGE_INTEGER counter{};
+		::QueryPerformanceCounter(&counter);
+		return (uint64_t)counter.QuadPart;
+#else
+		timespec now{};
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (uint64_t)now.tv_sec * 1'000'000'000 + (uint64_t)now.tv_nsec;
+#endif
+	}
+
+	static uint64_t OsTimerFrequency() {
+#if defined(_WIN32)
+		// Fixed at boot.
+		static const uint64_t frequency = [] {
+			LARGE_INTEGER frequency{};
+			::QueryPerformanceFrequency(&frequency);
+			return (uint64_t)frequency.QuadPart;
+		}();
+		return frequency;
+#else
+		return 1'000'000'000;
+#endif
+	}
+
+	static uint64_t OsTimeNs() {
+#if defined(_WIN32)
+		// Split so the multiplication doesn't overflow after a few days of uptime.
+		const uint64_t counter = OsTimerValue();
+		const uint64_t frequency = OsTimerFrequency();
+		return counter / frequency * 1'000'000'000 + counter % frequency * 1'000'000'000 / frequency;
+#else
+		return OsTimerValue();
+#endif
+	}
+
+	// Written once by the first UseTscTimer(true) before s_useTsc is set, and never again, so a reader that saw s_useTsc sees all of it.
+	struct TscTimer {
+		uint64_t frequency;
+		// A time stamp counter and OS clock pair read together. Later times are counted from it.
+		uint64_t baseTicks, baseNs;
+		double nsPerTick;
+	};
+
+	static TscTimer s_tsc{};
+	static std::atomic<bool> s_useTsc{ false };
+	static std::mutex s_tscMutex;
+
+	static bool HasInvariantTsc() {
+#if defined(_WIN32) && defined(IWINDOW_HAS_TSC)
+		int info[4]{};
+		__cpuid(info, (int)0x80000000);
+		if ((uint32_t)info[0] < 0x80000007) return false;
+
+		__cpuid(info, (int)0x80000007);
+		return info[3] & (1 << 8);
+#elif defined(IWINDOW_HAS_TSC)
+		uint32_t eax, ebx, ecx, edx;
+		if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+
+		return edx & (1 << 8);
+#else
+		return false;
+#endif
+	}
+
+	bool UseTscTimer(bool use) {
+		std::lock_guard<std::mutex> lock(s_tscMutex);
+
+		// Going back to the OS clock or calibrating again would let the clock jump backwards by the drift, so the switch only goes one way.
+		if (s_useTsc.load(std::memory_order_relaxed)) {
+			IWINDOW_CHECK_ERROR(!use, ErrorType::WindowApi, ErrorSeverity::Warning, "IWindow::UseTscTimer can't turn the time stamp counter off again. The clock keeps reading it.", false, true);
+			return true;
+		}
+
+		if (!use || !HasInvariantTsc()) return false;
+
+#if defined(IWINDOW_HAS_TSC)
+		// A read of the OS clock takes tens of nanoseconds, so 10 milliseconds measure the rate to a few parts per million.
+		const uint64_t startNs = OsTimeNs();
+		const uint64_t startTicks = __rdtsc();
+
+		uint64_t endNs, endTicks;
+		do {
+			endNs = OsTimeNs();
+			endTicks = __rdtsc();
+		} while (endNs - startNs < 10'000'000);
+
+		TscTimer tsc{};
+		tsc.nsPerTick = (double)(endNs - startNs) / (double)(endTicks - startTicks);
+		tsc.frequency = (uint64_t)(1'000'000'000.0 / tsc.nsPerTick + 0.5);
+		tsc.baseTicks = endTicks;
+		tsc.baseNs = endNs;
+
+		s_tsc = tsc;
+		s_useTsc.store(true, std::memory_order_release);
+#endif
+		return true;
+	}
+
+	uint64_t GetTimeNs() {
+#if defined(IWINDOW_HAS_TSC)
+		if (s_useTsc.load(std::memory_order_acquire)) {
+			// rdtsc isn't ordered with the loads around it, which is fine for a clock. A double keeps the nanoseconds exact for a month of ticks.
+			const uint64_t ticks = __rdtsc();
+			return ticks > s_tsc.baseTicks ? s_tsc.baseNs + (uint64_t)((double)(ticks - s_tsc.baseTicks) * s_tsc.nsPerTick) : s_tsc.baseNs;
+		}
+#endif
+		return OsTimeNs();
+	}
+
+	uint64_t GetTimerValue() {
+#if defined(IWINDOW_HAS_TSC)
+		if (s_useTsc.load(std::memory_order_acquire)) return __rdtsc();
+#endif
+		return OsTimerValue();
+	}
+
+	uint64_t GetTimerFrequency() {
+#if defined(IWINDOW_HAS_TSC)
+		if (s_useTsc.load(std::memory_order_acquire)) return s_tsc.frequency;
+#endif
+		return OsTimerFrequency();
+	}
+}
\ No newline at end of file
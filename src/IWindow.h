@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <functional>
 #include "IWindowCore.h"
@@ -20,6 +21,63 @@ namespace IWindow {
 	const ErrorCallback& IWINDOW_API GetErrorCallback();
 	const Version& IWINDOW_API GetVersion();
 	void IWINDOW_API Shutdown();
+
+	/// <summary>
+	/// Handles the pending events of every window in one pass. Cheaper than calling Window::Update on each window.
+	/// </summary>
+	void IWINDOW_API PollEvents();
+	/// <summary>
+	/// The current thread will be paused until any window gets an event. Then the events of every window are handled.
+	/// </summary>
+	void IWINDOW_API WaitEvents();
+	/// <summary>
+	/// Same as IWindow::WaitEvents but returns after timeoutSeconds at the latest. A negative timeout waits forever.
+	/// </summary>
+	void IWINDOW_API WaitEvents(double timeoutSeconds);
+	/// <summary>
+	/// Makes IWindow::WaitEvents and Window::WaitForEvent return on the threads waiting in them, e.g. when a background job finished. 
+	/// Safe to call from any thread.
+	/// </summary>
+	void IWINDOW_API PostEmptyEvent();
+
+	/// <summary>
+	/// Nanoseconds on the process-wide monotonic clock: QueryPerformanceCounter on Win32 and clock_gettime(CLOCK_MONOTONIC) elsewhere, which Linux answers from the vDSO without a system call.
+	/// Unlike Window::GetTime it never goes backwards, doesn't depend on a window and keeps full precision however long the machine runs. Safe to call from any thread.
+	/// On Linux it is the clock of clock_nanosleep, timerfd and evdev timestamps.
+	/// </summary>
+	uint64_t IWINDOW_API GetTimeNs();
+	/// <summary>
+	/// The raw count IWindow::GetTimeNs is made from, for profilers that take many timestamps and convert them later with IWindow::GetTimerFrequency.
+	/// </summary>
+	uint64_t IWINDOW_API GetTimerValue();
+	/// <returns>How many times per second IWindow::GetTimerValue counts.</returns>
+	uint64_t IWINDOW_API GetTimerFrequency();
+	/// <summary>
+	/// Reads the clock from the time stamp counter of the CPU (rdtsc) instead of asking the OS. Only for x86 CPUs whose counter runs at a constant rate on every core (invariant TSC).
+	/// Turning it on measures the counter against the OS clock for about 10 milliseconds. IWindow::GetTimeNs carries on from the OS clock and drifts from it by a few microseconds per second at most.
+	/// It is a one-way switch: once the counter is used, later calls neither calibrate again nor go back to the OS clock, since either would make the clock jump. 
+	/// Safe to call from any thread, but call it at startup so timestamps taken before it don't come from the other clock.
+	/// </summary>
+	/// <returns>
+	/// true if the clock reads the time stamp counter, also when it already did and use is false.
+	/// false if it reads the OS clock, because use was false or the CPU has no invariant TSC.
+	/// </returns>
+	bool IWINDOW_API UseTscTimer(bool use);
+
+#if defined(__linux__)
+	/// <summary>
+	/// A file descriptor that becomes readable when a window has events to handle. Add it to an epoll, poll or io_uring loop and call IWindow::DispatchPending when it is readable.
+	/// The X11 backends return the connection to the X server, which changes when every window was destroyed. The Wayland backend returns an epoll fd over the connection of every window.
+	/// Windows with an input thread are not covered, the same as IWindow::PollEvents. -1 if there is nothing to wait on yet.
+	/// </summary>
+	int IWINDOW_API GetEventFd();
+	/// <summary>
+	/// Handles the pending events of every window without blocking. Afterwards no event is left in a client side queue and every request was sent, 
+	/// so the loop can go back to waiting on IWindow::GetEventFd.
+	/// </summary>
+	void IWINDOW_API DispatchPending();
+#endif
 }
 
-#include "IWindowWindow.h"
\ No newline at end of file
+#include "IWindowWindow.h"
+#include "IWindowFramePacer.h"
\ No newline at end of file
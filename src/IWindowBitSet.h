@@ -0,0 +1,99 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace IWindow {
+    // Index of the lowest set bit. value must not be 0.
+    inline uint32_t CountTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return (uint32_t)index;
+#else
+        return (uint32_t)__builtin_ctzll(value);
+#endif
+    }
+
+    /// <summary>
+    /// Fixed-size set of bits in 64 bit words. Used for the keys and mouse buttons that are down.
+    /// </summary>
+    template<size_t BIT_COUNT>
+    class BitSet {
+    public:
+        static constexpr size_t WORD_COUNT = (BIT_COUNT + 63) / 64;
+
+        bool Test(size_t bit) const { return (m_words[bit / 64] >> (bit % 64)) & 1; }
+
+        void Set(size_t bit, bool value) {
+            const uint64_t mask = 1ull << (bit % 64);
+            if (value) m_words[bit / 64] |= mask;
+            else m_words[bit / 64] &= ~mask;
+        }
+
+        void Clear() { m_words.fill(0); }
+
+        bool Any() const {
+            uint64_t any = 0;
+            for (uint64_t word : m_words) any |= word;
+            return any != 0;
+        }
+
+        /// <summary>
+        /// Calls function(bit, set) for every bit that is different in previous. Words without a change cost one XOR.
+        /// </summary>
+        template<typename F>
+        void ForEachChanged(const BitSet& previous, F&& function) const {
+            for (size_t word = 0; word < WORD_COUNT; word++) {
+                uint64_t changed = m_words[word] ^ previous.m_words[word];
+
+                while (changed) {
+                    const size_t bit = word * 64 + CountTrailingZeros(changed);
+                    function(bit, Test(bit));
+                    // Clears the lowest set bit.
+                    changed &= changed - 1;
+                }
+            }
+        }
+
+        // Bit (n % 64) of word (n / 64) is bit n.
+        const std::array<uint64_t, WORD_COUNT>& GetWords() const { return m_words; }
+
+        bool operator==(const BitSet& other) const { return m_words == other.m_words; }
+        bool operator!=(const BitSet& other) const { return m_words != other.m_words; }
+    private:
+        std::array<uint64_t, WORD_COUNT> m_words{};
+    };
+}
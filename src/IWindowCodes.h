@@ -33,7 +33,9 @@
 #if defined (_WIN32)
     #define WIN32_LEAN_AND_MEAN
     #include <windows.h> // For virtual key codes 
-    #include <Xinput.h> // xinput codes
+#else
+    #include <linux/input-event-codes.h> // For evdev key codes
+#endif
 
 namespace IWindow {
     /// <summary>
@@ -154,6 +156,97 @@ namespace IWindow {
         Max
     };
 
+    /// <summary>
+    /// Represents keyboard modifiers. This is bitmask type.
+    /// </summary>
+    enum struct KeyModifier {
+        None = 0x0,
+        Shift = 0x1,
+        Control = 0x2,
+        Alt = 0x4,
+        Super = 0x8,
+        CapsLock = 0x10,
+        NumLock = 0x20,
+        Max
+    };
+    IWINDOW_CREATE_FLAGS_FROM_ENUM_STRUCT(KeyModifier)
+
+    /// <summary>
+    /// Represents mouse buttons.
+    /// </summary>
+    enum struct MouseButton {
+        Left,
+        Right,
+        Middle, // Scroll Wheel
+        Side1,  // Browser back button
+        Side2,  // Browser forward button
+        Max
+    };
+
+    /// <summary>
+    /// Represents what state the key/button/modifier was in when it was pressed.
+    /// </summary>
+    enum struct InputState {
+        Down,
+        Up,
+        Max
+    };
+
+    /// <summary>
+    /// Represents buttons on a gamepad.
+    /// The values are the same bits XInput uses for wButtons on every platform.
+    /// </summary>
+    enum struct GamepadButton {
+        A = 0x1000,
+        B = 0x2000,
+        X = 0x4000,
+        Y = 0x8000,
+
+        DpadUp = 0x0001,
+        DpadDown = 0x0002,
+        DpadRight = 0x0008,
+        DpadLeft = 0x0004,
+
+        LeftShoulder = 0x0100,
+        RightShoulder = 0x0200,
+        
+        LeftStick = 0x0040,
+        RightStick = 0x0080,
+
+        Start = 0x0010,
+        Back = 0x0020,
+
+        Max,
+    };
+
+
+    /// <summary>
+    /// ID of gamepads.
+    /// </summary>
+    enum struct GamepadID {
+        GP0,
+        GP1,
+        GP2,
+        GP3,
+        
+        Max,
+    };
+
+    /// <summary>
+    /// Analog inputs of a gamepad.
+    /// </summary>
+    enum struct GamepadAxis {
+        LeftStickX,
+        LeftStickY,
+        RightStickX,
+        RightStickY,
+        LeftTrigger,
+        RightTrigger,
+
+        Max,
+    };
+
+#if defined(_WIN32)
     /// <summary>
     /// Convert Virtual Key codes to IWindow::Key.
     /// </summary>
@@ -463,238 +556,121 @@ namespace IWindow {
         }
     }
 
+#else
     /// <summary>
-    /// Represents keyboard modifiers. This is bitmask type.
-    /// </summary>
-    enum struct KeyModifier {
-        None = 0x0,
-        Shift = 0x1,
-        Control = 0x2,
-        Alt = 0x4,
-        Super = 0x8,
-        CapsLock = 0x10,
-        NumLock = 0x20,
-        Max
-    };
-    IWINDOW_CREATE_FLAGS_FROM_ENUM_STRUCT(KeyModifier)
-
-    /// <summary>
-    /// Represents mouse buttons.
-    /// </summary>
-    enum struct MouseButton {
-        Left,
-        Right,
-        Middle, // Scroll Wheel
-        Side1,  // Browser back button
-        Side2,  // Browser forward button
-        Max
-    };
-
-    /// <summary>
-    /// Represents what state the key/button/modifier was in when it was pressed.
-    /// </summary>
-    enum struct InputState {
-        Down,
-        Up,
-        Max
-    };
-
-    /// <summary>
-    /// Represents buttons on a gamepad.
-    /// </summary>
-    enum struct GamepadButton {
-        A = XINPUT_GAMEPAD_A,
-        B = XINPUT_GAMEPAD_B,
-        X = XINPUT_GAMEPAD_X,
-        Y = XINPUT_GAMEPAD_Y,
-
-        DpadUp = XINPUT_GAMEPAD_DPAD_UP,
-        DpadDown = XINPUT_GAMEPAD_DPAD_DOWN,
-        DpadRight = XINPUT_GAMEPAD_DPAD_RIGHT,
-        DpadLeft = XINPUT_GAMEPAD_DPAD_LEFT,
-
-        LeftShoulder = XINPUT_GAMEPAD_LEFT_SHOULDER,
-        RightShoulder = XINPUT_GAMEPAD_RIGHT_SHOULDER,
-        
-        LeftStick = XINPUT_GAMEPAD_LEFT_THUMB,
-        RightStick = XINPUT_GAMEPAD_RIGHT_THUMB,
-
-        Start = XINPUT_GAMEPAD_START,
-        Back = XINPUT_GAMEPAD_BACK,
-
-        Max,
-    };
-
-
-    /// <summary>
-    /// ID of gamepads.
+    /// Convert evdev key codes (KEY_*) to IWindow::Key.
+    /// X11 key codes are evdev key codes offset by 8.
     /// </summary>
-    enum struct GamepadID {
-        GP0,
-        GP1,
-        GP2,
-        GP3,
-        
-        Max,
-    };
-}
-
-#else
-
-namespace IWindow {
-
-    enum struct Key {
-        N0 = 19,
-        N1 = 10,
-        N2 = 11,
-        N3 = 12,
-        N4 = 13,
-        N5 = 14,
-        N6 = 15,
-        N7 = 16,
-        N8 = 17,
-        N9 = 18,
-
-        A = 38,
-        B = 56,
-        C = 54,
-        D = 40,
-        E = 26,
-        F = 41,
-        G = 42,
-        H = 43,
-        I = 31,
-        J = 44,
-        K = 45,
-        L = 46,
-        M = 58,
-        N = 57,
-        O = 32,
-        P = 33,
-        Q = 24,
-        R = 27,
-        S = 39,
-        T = 28,
-        U = 30,
-        V = 55,
-        W = 25,
-        X = 53,
-        Y = 29,
-        Z = 52,
-
-        Np0 = 90,
-        Np1 = 87,
-        Np2 = 88,
-        Np3 = 89,
-        Np4 = 83,
-        Np5 = 84,
-        Np6 = 85,
-        Np7 = 79,
-        Np8 = 80,
-        Np9 = 81,
-
-
-        F1 = 67,
-        F2 = 68,
-        F3 = 69,
-        F4 = 70,
-        F5 = 71,
-        F6 = 72,
-        F7 = 73,
-        F8 = 74,
-        F9 = 75,
-        F10 = 76,
-        F11 = 95,
-        F12 = 96,
-
-        Back = 22,
-        Tab = 23,
-        Enter = 108, 
-        Shift = 56,
-        Control = 37,
-        Alt = 64,
-        Pause = 110,
-        CapsLock = 66,
-        Escape = 9,
-        Space = 65,
-        PageUp = 99,
-        PageDown = 105,
-        End = 103,
-        Home = 97,
-        ArrowLeft = 113,
-        ArrowUp = 111,
-        ArrowRight = 114,
-        ArrowDown = 116,
-        PrintScreen = 111,
-        Insert = 106,
-        Delete = 107,
-        LeftSuper = 133,
-        RightSuper = 0, // Get this
-        Subtract = 20,
-        Decimal = 60,
-        Add = 86,
-        Divide = 61,
-        Multiply = 63,
-        ScrollLock = 78,
-        NumLock = 77,
-        LShift = Shift,
-        RShift = 62,
-        LControl = Control,
-        RControl = 109,
-        LMenu = 117,
-        RMenu = 117,
-
-        Max = 200,
-    };
-
-
-    enum struct MouseButton {
-        Left = 1,
-        Right = 3,  
-        Middle = 2, // Scroll Wheel
-        Side1 = 8,  // Browser back button
-        Side2 = 9,  // Browser forward button
-        Max
-    };
-
-    enum struct InputState {
-        Down,
-        Up,
-        Max
-    };
-
-    enum struct GamepadButton {
-        A,
-        B,
-        X,
-        Y,
-
-        LeftShoulder,
-        RightShoulder,
-
-        Back,
-        Start,
-
-        //Super,
-
-        LeftStick = 9,
-        RightStick = 10,
-
-        DpadUp = 11,
-        DpadDown = 12,
-        DpadRight = 13,
-        DpadLeft = 14,
-
-        Max,
-    };
-
-    enum struct GamepadID {
-        GP1,
-        GP2,
-        GP3,
-        GP4,
-        
-        Max,
-    };
-};
+    inline Key EvdevKeyCodeToIWindowKey(uint32_t key) {
+        switch (key)
+        {
+        case KEY_0: return Key::N0;
+        case KEY_1: return Key::N1;
+        case KEY_2: return Key::N2;
+        case KEY_3: return Key::N3;
+        case KEY_4: return Key::N4;
+        case KEY_5: return Key::N5;
+        case KEY_6: return Key::N6;
+        case KEY_7: return Key::N7;
+        case KEY_8: return Key::N8;
+        case KEY_9: return Key::N9;
+        case KEY_A: return Key::A;
+        case KEY_B: return Key::B;
+        case KEY_C: return Key::C;
+        case KEY_D: return Key::D;
+        case KEY_E: return Key::E;
+        case KEY_F: return Key::F;
+        case KEY_G: return Key::G;
+        case KEY_H: return Key::H;
+        case KEY_I: return Key::I;
+        case KEY_J: return Key::J;
+        case KEY_K: return Key::K;
+        case KEY_L: return Key::L;
+        case KEY_M: return Key::M;
+        case KEY_N: return Key::N;
+        case KEY_O: return Key::O;
+        case KEY_P: return Key::P;
+        case KEY_Q: return Key::Q;
+        case KEY_R: return Key::R;
+        case KEY_S: return Key::S;
+        case KEY_T: return Key::T;
+        case KEY_U: return Key::U;
+        case KEY_V: return Key::V;
+        case KEY_W: return Key::W;
+        case KEY_X: return Key::X;
+        case KEY_Y: return Key::Y;
+        case KEY_Z: return Key::Z;
+        case KEY_BACKSPACE: return Key::Back;
+        case KEY_TAB: return Key::Tab;
+        case KEY_ENTER: return Key::Enter;
+        case KEY_KPENTER: return Key::Enter;
+        case KEY_PAUSE: return Key::Pause;
+        case KEY_ESC: return Key::Escape;
+        case KEY_SPACE: return Key::Space;
+        case KEY_PAGEUP: return Key::PageUp;
+        case KEY_PAGEDOWN: return Key::PageDown;
+        case KEY_END: return Key::End;
+        case KEY_HOME: return Key::Home;
+        case KEY_LEFT: return Key::ArrowLeft;
+        case KEY_UP: return Key::ArrowUp;
+        case KEY_RIGHT: return Key::ArrowRight;
+        case KEY_DOWN: return Key::ArrowDown;
+        case KEY_SYSRQ: return Key::PrintScreen;
+        case KEY_INSERT: return Key::Insert;
+        case KEY_DELETE: return Key::Delete;
+        case KEY_KPPLUS: return Key::Add;
+        case KEY_KPASTERISK: return Key::Multiply;
+        case KEY_KPMINUS: return Key::Subtract;
+        case KEY_KPDOT: return Key::Decimal;
+        case KEY_KPSLASH: return Key::Divide;
+        case KEY_SCROLLLOCK: return Key::ScrollLock;
+        case KEY_SEMICOLON: return Key::SemiColen;
+        case KEY_EQUAL: return Key::Plus;
+        case KEY_COMMA: return Key::Comma;
+        case KEY_MINUS: return Key::Minus;
+        case KEY_DOT: return Key::Period;
+        case KEY_SLASH: return Key::ForwardSlash;
+        case KEY_GRAVE: return Key::Tilde;
+        case KEY_LEFTBRACE: return Key::LeftBoxBraces;
+        case KEY_BACKSLASH: return Key::BackSlash;
+        case KEY_RIGHTBRACE: return Key::RightBoxBraces;
+        case KEY_APOSTROPHE: return Key::SingleQuotes;
+        case KEY_LEFTCTRL: return Key::LControl;
+        case KEY_RIGHTCTRL: return Key::RControl;
+        case KEY_LEFTSHIFT: return Key::LShift;
+        case KEY_RIGHTSHIFT: return Key::RShift;
+        case KEY_LEFTALT: return Key::LAlt;
+        case KEY_RIGHTALT: return Key::RAlt;
+        case KEY_LEFTMETA: return Key::LSuper;
+        case KEY_RIGHTMETA: return Key::RSuper;
+        case KEY_CAPSLOCK: return Key::CapsLock;
+        case KEY_NUMLOCK: return Key::NumLock;
+        case KEY_KP0: return Key::Numpad0;
+        case KEY_KP1: return Key::Numpad1;
+        case KEY_KP2: return Key::Numpad2;
+        case KEY_KP3: return Key::Numpad3;
+        case KEY_KP4: return Key::Numpad4;
+        case KEY_KP5: return Key::Numpad5;
+        case KEY_KP6: return Key::Numpad6;
+        case KEY_KP7: return Key::Numpad7;
+        case KEY_KP8: return Key::Numpad8;
+        case KEY_KP9: return Key::Numpad9;
+        case KEY_F1: return Key::F1;
+        case KEY_F2: return Key::F2;
+        case KEY_F3: return Key::F3;
+        case KEY_F4: return Key::F4;
+        case KEY_F5: return Key::F5;
+        case KEY_F6: return Key::F6;
+        case KEY_F7: return Key::F7;
+        case KEY_F8: return Key::F8;
+        case KEY_F9: return Key::F9;
+        case KEY_F10: return Key::F10;
+        case KEY_F11: return Key::F11;
+        case KEY_F12: return Key::F12;
+        default:
+            // key code not supported by IWindow
+            return Key::Max;
+        }
+    }
 #endif
+}
\ No newline at end of file
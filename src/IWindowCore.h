@@ -11,6 +11,8 @@
 #else
 #define IWINDOW_API
 #endif
+#else
+#define IWINDOW_API
 #endif
 
 
@@ -26,5 +28,8 @@
 				if (shouldReturn) return returnVal;																\
 			}
 #else
-#define IWINDOW_CHECK_ERROR(result, badVal, type, severity, source, message, shouldReturn, returnVal) result;
+#define IWINDOW_CHECK_ERROR(result, nType, nSeverity, nMessage, shouldReturn, returnVal)		\
+			if (result) {																				\
+				if (shouldReturn) return returnVal;																\
+			}
 #endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace IWindow {
+    template<typename Signature>
+    class Delegate;
+
+    /// <summary>
+    /// A callable stored inside the object, so setting, copying and calling one never allocates. Used for the callbacks of IWindow::Window and IWindow::GamepadManager.
+    /// Takes function pointers, lambdas, std::function and any other callable that fits into STORAGE_SIZE bytes. Bigger callables don't compile.
+    /// An empty delegate does nothing when called and returns R{}.
+    /// </summary>
+    template<typename R, typename... Args>
+    class Delegate<R(Args...)> {
+    public:
+        // At least a std::function so code written for the callbacks when they were std::function keeps compiling.
+        static constexpr size_t STORAGE_SIZE = sizeof(std::function<R(Args...)>) > sizeof(void*) * 4 ? sizeof(std::function<R(Args...)>) : sizeof(void*) * 4;
+
+        Delegate() = default;
+        Delegate(std::nullptr_t) {}
+
+        template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, Delegate>::value && std::is_invocable_r<R, std::decay_t<F>&, Args...>::value>>
+        Delegate(F&& function) {
+            using Function = std::decay_t<F>;
+
+            static_assert(sizeof(Function) <= STORAGE_SIZE && alignof(Function) <= alignof(std::max_align_t), 
+                "The callable is too big for IWindow::Delegate. Capture a pointer to the state instead of the state, or wrap the callable in a std::function.");
+
+            if (IsNull(function)) return;
+
+            ::new ((void*)m_storage) Function(std::forward<F>(function));
+            m_invoker = &Invoke<Function>;
+
+            // Trivially copyable callables (function pointers, lambdas capturing pointers or references) are copied with memcpy.
+            if (!std::is_trivially_copyable<Function>::value) m_manager = &Manage<Function>;
+        }
+
+        /// <summary>
+        /// Calls function(userData, args...). For C style callbacks.
+        /// </summary>
+        Delegate(R(*function)(void*, Args...), void* userData) 
+            : Delegate(function ? Delegate([function, userData](Args... args) -> R { return function(userData, std::forward<Args>(args)...); }) : Delegate()) {}
+
+        Delegate(const Delegate& other) { CopyFrom(other); }
+        Delegate(Delegate&& other) noexcept { MoveFrom(other); }
+
+        ~Delegate() { Reset(); }
+
+        Delegate& operator=(const Delegate& other) {
+            if (this != &other) {
+                Reset();
+                CopyFrom(other);
+            }
+            return *this;
+        }
+
+        Delegate& operator=(Delegate&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        R operator()(Args... args) const { return m_invoker(m_storage, std::forward<Args>(args)...); }
+
+        explicit operator bool() const { return m_invoker != &InvokeEmpty; }
+
+        friend bool operator==(const Delegate& delegate, std::nullptr_t) { return !delegate; }
+        friend bool operator!=(const Delegate& delegate, std::nullptr_t) { return (bool)delegate; }
+        friend bool operator==(std::nullptr_t, const Delegate& delegate) { return !delegate; }
+        friend bool operator!=(std::nullptr_t, const Delegate& delegate) { return (bool)delegate; }
+    private:
+        enum struct Operation { Copy, Move, Destroy };
+
+        typedef R(*Invoker)(void* storage, Args... args);
+        typedef void(*Manager)(Operation operation, void* destination, void* source);
+
+        template<typename F>
+        static bool IsNull(const F& function) {
+            if constexpr (std::is_pointer<F>::value || std::is_member_pointer<F>::value) return function == nullptr;
+            else if constexpr (std::is_same<F, std::function<R(Args...)>>::value) return !function;
+            else return false;
+        }
+
+        static R InvokeEmpty(void*, Args...) {
+            if constexpr (std::is_void<R>::value) return;
+            else return R{};
+        }
+
+        template<typename F>
+        static R Invoke(void* storage, Args... args) {
+            if constexpr (std::is_void<R>::value) std::invoke(*(F*)storage, std::forward<Args>(args)...);
+            else return std::invoke(*(F*)storage, std::forward<Args>(args)...);
+        }
+
+        template<typename F>
+        static void Manage(Operation operation, void* destination, void* source) {
+            switch (operation)
+            {
+            case Operation::Copy: ::new (destination) F(*(const F*)source); break;
+            case Operation::Move: ::new (destination) F(std::move(*(F*)source)); break;
+            case Operation::Destroy: ((F*)source)->~F(); break;
+            }
+        }
+
+        void CopyFrom(const Delegate& other) {
+            if (other.m_manager) other.m_manager(Operation::Copy, m_storage, other.m_storage);
+            else std::memcpy(m_storage, other.m_storage, STORAGE_SIZE);
+
+            m_invoker = other.m_invoker;
+            m_manager = other.m_manager;
+        }
+
+        void MoveFrom(Delegate& other) {
+            if (other.m_manager) other.m_manager(Operation::Move, m_storage, other.m_storage);
+            else std::memcpy(m_storage, other.m_storage, STORAGE_SIZE);
+
+            m_invoker = other.m_invoker;
+            m_manager = other.m_manager;
+            other.Reset();
+        }
+
+        void Reset() {
+            if (m_manager) m_manager(Operation::Destroy, nullptr, m_storage);
+
+            m_invoker = &InvokeEmpty;
+            m_manager = nullptr;
+        }
+
+        // Mutable because calling the delegate may change the state of the callable, the same as std::function.
+        alignas(std::max_align_t) mutable unsigned char m_storage[STORAGE_SIZE]{};
+        Invoker m_invoker = &InvokeEmpty;
+        // nullptr for trivially copyable callables.
+        Manager m_manager = nullptr;
+    };
+}
@@ -0,0 +1,422 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(__linux__)
+
+#include "IWindowEvdevGamepad.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace IWindow {
+    static_assert(EvdevGamepad::AXIS_COUNT == ABS_CNT, "EvdevGamepad::AXIS_COUNT has to match ABS_CNT.");
+
+    // Events read with one read(2).
+    static constexpr size_t EVENTS_PER_READ = 64;
+
+    struct EvdevButton {
+        uint16_t code;
+        GamepadButton button;
+    };
+
+    // BTN_X and BTN_Y are BTN_NORTH and BTN_WEST of the kernel's gamepad layout, but xpad and most XInput style pads report the buttons labeled X and Y with them.
+    static constexpr EvdevButton BUTTONS[] = {
+        { BTN_A, GamepadButton::A },
+        { BTN_B, GamepadButton::B },
+        { BTN_X, GamepadButton::X },
+        { BTN_Y, GamepadButton::Y },
+        { BTN_TL, GamepadButton::LeftShoulder },
+        { BTN_TR, GamepadButton::RightShoulder },
+        { BTN_SELECT, GamepadButton::Back },
+        { BTN_START, GamepadButton::Start },
+        { BTN_THUMBL, GamepadButton::LeftStick },
+        { BTN_THUMBR, GamepadButton::RightStick },
+        // Pads without a hat report the d-pad as buttons.
+        { BTN_DPAD_UP, GamepadButton::DpadUp },
+        { BTN_DPAD_DOWN, GamepadButton::DpadDown },
+        { BTN_DPAD_LEFT, GamepadButton::DpadLeft },
+        { BTN_DPAD_RIGHT, GamepadButton::DpadRight },
+    };
+
+    template<size_t N>
+    static bool TestBit(const unsigned long (&bits)[N], uint32_t bit) { 
+        return bit / (sizeof(unsigned long) * CHAR_BIT) < N && (bits[bit / (sizeof(unsigned long) * CHAR_BIT)] >> (bit % (sizeof(unsigned long) * CHAR_BIT))) & 1; 
+    }
+
+    // -1 to 1 from the axis range.
+    static float Normalize(int32_t value, const EvdevAxisRange& range) {
+        return 2.0f * (float)((int64_t)value - range.minimum) / (float)((int64_t)range.maximum - range.minimum) - 1.0f;
+    }
+
+    static int16_t ToStick(float value) { return (int16_t)std::lround(std::clamp(value, -1.0f, 1.0f) * SHRT_MAX); }
+
+    static void SetButton(NativeGamepadState& state, GamepadButton button, bool down) {
+        if (down) state.Gamepad.wButtons |= (uint16_t)button;
+        else state.Gamepad.wButtons &= (uint16_t)~(uint16_t)button;
+    }
+
+    EvdevGamepad::~EvdevGamepad() { Close(); }
+
+    EvdevGamepad::EvdevGamepad(EvdevGamepad&& other) noexcept { *this = std::move(other); }
+
+    EvdevGamepad& EvdevGamepad::operator=(EvdevGamepad&& other) noexcept {
+        if (this == &other) return *this;
+
+        Close();
+        m_fd = other.m_fd;
+        m_path = std::move(other.m_path);
+        m_name = std::move(other.m_name);
+        m_axes = other.m_axes;
+        m_state = other.m_state;
+        m_pending = other.m_pending;
+        m_dropped = other.m_dropped;
+        m_canRumble = other.m_canRumble;
+        m_rumbleEffect = other.m_rumbleEffect;
+
+        other.m_fd = -1;
+        other.m_rumbleEffect = -1;
+        return *this;
+    }
+
+    bool EvdevGamepad::Open(const std::string& path) {
+        Close();
+
+        bool writable = true;
+        int fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0 && (errno == EACCES || errno == EROFS)) {
+            writable = false;
+            fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        }
+        if (fd < 0) return false;
+
+        unsigned long keyBits[KEY_CNT / (sizeof(unsigned long) * CHAR_BIT) + 1]{};
+        unsigned long absBits[ABS_CNT / (sizeof(unsigned long) * CHAR_BIT) + 1]{};
+        unsigned long ffBits[FF_CNT / (sizeof(unsigned long) * CHAR_BIT) + 1]{};
+
+        // Joysticks, keyboards and mice are event nodes too.
+        if (::ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) < 0 || !TestBit(keyBits, BTN_GAMEPAD)) {
+            ::close(fd);
+            return false;
+        }
+
+        ::ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+        ::ioctl(fd, EVIOCGBIT(EV_FF, sizeof(ffBits)), ffBits);
+
+        m_fd = fd;
+        m_path = path;
+        m_axes = {};
+        for (uint32_t code = 0; code < ABS_CNT; code++) {
+            input_absinfo info{};
+            if (TestBit(absBits, code) && ::ioctl(fd, EVIOCGABS(code), &info) == 0) m_axes[code] = { info.minimum, info.maximum };
+        }
+
+        char name[256]{};
+        m_name = ::ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name) >= 0 ? name : "";
+
+        m_canRumble = writable && TestBit(ffBits, FF_RUMBLE);
+        m_rumbleEffect = -1;
+        m_dropped = false;
+        m_pending = NativeGamepadState{};
+        Resync();
+        m_state = m_pending;
+
+        return true;
+    }
+
+    void EvdevGamepad::Attach(int fd, const std::array<EvdevAxisRange, AXIS_COUNT>& axes, const std::string& name) {
+        Close();
+
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        m_fd = fd;
+        m_path.clear();
+        m_name = name;
+        m_axes = axes;
+        m_canRumble = false;
+        m_dropped = false;
+        m_state = m_pending = NativeGamepadState{};
+    }
+
+    void EvdevGamepad::Close() {
+        if (m_fd < 0) return;
+
+        if (m_rumbleEffect >= 0) ::ioctl(m_fd, EVIOCRMFF, (int)m_rumbleEffect);
+        ::close(m_fd);
+
+        m_fd = -1;
+        m_rumbleEffect = -1;
+        m_state = m_pending = NativeGamepadState{};
+    }
+
+    bool EvdevGamepad::IsOpen() const { return m_fd >= 0; }
+
+    bool EvdevGamepad::Read() {
+        if (m_fd < 0) return false;
+
+        input_event events[EVENTS_PER_READ];
+        for (;;) {
+            const ssize_t bytes = ::read(m_fd, events, sizeof(events));
+            if (bytes < 0 && errno == EINTR) continue;
+            if (bytes < 0 && errno == EAGAIN) return true;
+            // ENODEV once the gamepad is unplugged, the end of the file for a replayed capture.
+            if (bytes <= 0) {
+                Close();
+                return false;
+            }
+
+            const size_t count = (size_t)bytes / sizeof(input_event);
+            for (size_t i = 0; i < count; i++) {
+                const input_event& event = events[i];
+
+                if (event.type == EV_SYN && event.code == SYN_DROPPED) {
+                    m_dropped = true;
+                }
+                else if (event.type == EV_SYN && event.code == SYN_REPORT) {
+                    if (m_dropped) {
+                        m_dropped = false;
+                        Resync();
+                    }
+
+                    m_pending.dwPacketNumber = m_state.dwPacketNumber + 1;
+                    m_state = m_pending;
+                }
+                else if (!m_dropped) {
+                    if (event.type == EV_KEY) ApplyKey(event.code, event.value);
+                    else if (event.type == EV_ABS) ApplyAxis(event.code, event.value);
+                }
+            }
+
+            // The read didn't fill the buffer, so nothing else is pending.
+            if (count < EVENTS_PER_READ) return true;
+        }
+    }
+
+    const NativeGamepadState& EvdevGamepad::GetState() const { return m_state; }
+
+    void EvdevGamepad::Rumble(float rumble) {
+        if (!m_canRumble) return;
+
+        if (rumble <= 0.0f) {
+            if (m_rumbleEffect < 0) return;
+
+            input_event stop{};
+            stop.type = EV_FF;
+            stop.code = (uint16_t)m_rumbleEffect;
+            stop.value = 0;
+            (void)!::write(m_fd, &stop, sizeof(stop));
+            return;
+        }
+
+        // Uploading with the id of the last effect changes it in place.
+        ff_effect effect{};
+        effect.type = FF_RUMBLE;
+        effect.id = m_rumbleEffect;
+        effect.u.rumble.strong_magnitude = (uint16_t)(std::min(rumble, 1.0f) * 65535.0f);
+        effect.u.rumble.weak_magnitude = effect.u.rumble.strong_magnitude;
+        // Until it is stopped, like XInput.
+        effect.replay.length = 0;
+        if (::ioctl(m_fd, EVIOCSFF, &effect) < 0) return;
+        m_rumbleEffect = effect.id;
+
+        input_event play{};
+        play.type = EV_FF;
+        play.code = (uint16_t)m_rumbleEffect;
+        play.value = 1;
+        (void)!::write(m_fd, &play, sizeof(play));
+    }
+
+    const std::string& EvdevGamepad::GetPath() const { return m_path; }
+
+    const std::string& EvdevGamepad::GetName() const { return m_name; }
+
+    void EvdevGamepad::Resync() {
+        unsigned long keys[KEY_CNT / (sizeof(unsigned long) * CHAR_BIT) + 1]{};
+        if (::ioctl(m_fd, EVIOCGKEY(sizeof(keys)), keys) < 0) return;
+
+        m_pending.Gamepad.wButtons = 0;
+        for (const EvdevButton& button : BUTTONS) ApplyKey(button.code, TestBit(keys, button.code));
+        ApplyKey(BTN_TL2, TestBit(keys, BTN_TL2));
+        ApplyKey(BTN_TR2, TestBit(keys, BTN_TR2));
+
+        for (uint32_t code = 0; code < ABS_CNT; code++) {
+            input_absinfo info{};
+            if (m_axes[code].minimum != m_axes[code].maximum && ::ioctl(m_fd, EVIOCGABS(code), &info) == 0) ApplyAxis((uint16_t)code, info.value);
+        }
+    }
+
+    void EvdevGamepad::ApplyKey(uint16_t code, int32_t value) {
+        for (const EvdevButton& button : BUTTONS) {
+            if (button.code != code) continue;
+
+            SetButton(m_pending, button.button, value != 0);
+            return;
+        }
+
+        // Digital triggers, only if the pad has no analog ones.
+        if (code == BTN_TL2 && m_axes[ABS_Z].minimum == m_axes[ABS_Z].maximum) m_pending.Gamepad.bLeftTrigger = value ? 255 : 0;
+        else if (code == BTN_TR2 && m_axes[ABS_RZ].minimum == m_axes[ABS_RZ].maximum) m_pending.Gamepad.bRightTrigger = value ? 255 : 0;
+    }
+
+    void EvdevGamepad::ApplyAxis(uint16_t code, int32_t value) {
+        if (code >= ABS_CNT) return;
+
+        const EvdevAxisRange& range = m_axes[code];
+        if (range.minimum == range.maximum) return;
+
+        const float normalized = Normalize(value, range);
+        // 0 to 255, from the bottom of the range.
+        const uint8_t trigger = (uint8_t)std::lround(std::clamp((normalized + 1.0f) * 0.5f, 0.0f, 1.0f) * 255.0f);
+
+        switch (code) {
+            case ABS_X: m_pending.Gamepad.sThumbLX = ToStick(normalized); break;
+            // Down is positive on evdev and negative on XInput.
+            case ABS_Y: m_pending.Gamepad.sThumbLY = ToStick(-normalized); break;
+            case ABS_RX: m_pending.Gamepad.sThumbRX = ToStick(normalized); break;
+            case ABS_RY: m_pending.Gamepad.sThumbRY = ToStick(-normalized); break;
+            // Some drivers report the triggers as gas and brake.
+            case ABS_Z: 
+            case ABS_BRAKE: m_pending.Gamepad.bLeftTrigger = trigger; break;
+            case ABS_RZ: 
+            case ABS_GAS: m_pending.Gamepad.bRightTrigger = trigger; break;
+            case ABS_HAT0X:
+                SetButton(m_pending, GamepadButton::DpadLeft, value < 0);
+                SetButton(m_pending, GamepadButton::DpadRight, value > 0);
+                break;
+            case ABS_HAT0Y:
+                SetButton(m_pending, GamepadButton::DpadUp, value < 0);
+                SetButton(m_pending, GamepadButton::DpadDown, value > 0);
+                break;
+            default: break;
+        }
+    }
+
+    EvdevGamepadBackend::EvdevGamepadBackend(const std::string& directory) : m_directory{ directory } {
+        m_inotify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        // The node is made with IN_CREATE, udev gives it its permissions afterwards with IN_ATTRIB.
+        if (m_inotify >= 0 && ::inotify_add_watch(m_inotify, m_directory.c_str(), IN_CREATE | IN_ATTRIB | IN_MOVED_TO) < 0) {
+            ::close(m_inotify);
+            m_inotify = -1;
+        }
+
+        Scan();
+    }
+
+    EvdevGamepadBackend::~EvdevGamepadBackend() {
+        if (m_inotify >= 0) ::close(m_inotify);
+    }
+
+    bool EvdevGamepadBackend::Poll(GamepadID gid, NativeGamepadState& state) {
+        EvdevGamepad& gamepad = m_gamepads[(size_t)gid];
+
+        // Without inotify empty slots are probed on the manager's backoff schedule.
+        if (!gamepad.IsOpen() && m_inotify < 0) Scan();
+        if (!gamepad.Read()) return false;
+
+        state = gamepad.GetState();
+        return true;
+    }
+
+    void EvdevGamepadBackend::Rumble(GamepadID gid, float rumble) { m_gamepads[(size_t)gid].Rumble(rumble); }
+
+    bool EvdevGamepadBackend::HasDeviceNotifications() { return m_inotify >= 0; }
+
+    bool EvdevGamepadBackend::PollDeviceChanges() {
+        if (m_inotify >= 0) {
+            alignas(inotify_event) char buffer[4096];
+            for (;;) {
+                const ssize_t bytes = ::read(m_inotify, buffer, sizeof(buffer));
+                if (bytes <= 0) break;
+
+                for (ssize_t offset = 0; offset < bytes;) {
+                    const inotify_event* event = (const inotify_event*)(buffer + offset);
+                    offset += (ssize_t)(sizeof(inotify_event) + event->len);
+
+                    if (event->len && std::strncmp(event->name, "event", 5) == 0) TryOpen(m_directory + "/" + event->name);
+                }
+            }
+        }
+
+        const bool added = m_added;
+        m_added = false;
+        return added;
+    }
+
+    bool EvdevGamepadBackend::AddGamepad(EvdevGamepad&& gamepad) {
+        for (EvdevGamepad& slot : m_gamepads) {
+            if (slot.IsOpen()) continue;
+
+            slot = std::move(gamepad);
+            m_added = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    const EvdevGamepad& EvdevGamepadBackend::GetGamepad(GamepadID gid) const { return m_gamepads[(size_t)gid]; }
+
+    void EvdevGamepadBackend::Scan() {
+        DIR* directory = ::opendir(m_directory.c_str());
+        if (!directory) return;
+
+        while (const dirent* entry = ::readdir(directory))
+            if (std::strncmp(entry->d_name, "event", 5) == 0) TryOpen(m_directory + "/" + entry->d_name);
+
+        ::closedir(directory);
+    }
+
+    void EvdevGamepadBackend::TryOpen(const std::string& path) {
+        bool free = false;
+        for (const EvdevGamepad& gamepad : m_gamepads) {
+            if (gamepad.IsOpen() && gamepad.GetPath() == path) return;
+            free |= !gamepad.IsOpen();
+        }
+        if (!free) return;
+
+        EvdevGamepad gamepad{};
+        if (gamepad.Open(path)) AddGamepad(std::move(gamepad));
+    }
+
+#if !defined(IWINDOW_NULL)
+    GamepadBackend& GamepadManager::GetPlatformBackend() {
+        static EvdevGamepadBackend s_backend{};
+        return s_backend;
+    }
+#endif
+}
+
+#endif
@@ -0,0 +1,161 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#if defined(__linux__)
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "IWindowGamepadManager.h"
+
+namespace IWindow {
+    /// <summary>
+    /// Range of an evdev absolute axis, from EVIOCGABS.
+    /// </summary>
+    struct EvdevAxisRange {
+        int32_t minimum;
+        int32_t maximum;
+    };
+
+    /// <summary>
+    /// One evdev gamepad, a /dev/input/event* node with BTN_GAMEPAD. Reads the node non-blocking, up to 64 input_events per read, 
+    /// and keeps the state of the last complete SYN_REPORT in the layout of XINPUT_STATE.
+    /// Sticks and triggers are scaled from the axis ranges the driver reports to the ranges XInput uses. Y axes point up like XInput's.
+    /// </summary>
+    class IWINDOW_API EvdevGamepad {
+    public:
+        // ABS_CNT of linux/input.h.
+        static constexpr uint32_t AXIS_COUNT = 0x40;
+
+        EvdevGamepad() = default;
+        ~EvdevGamepad();
+
+        EvdevGamepad(EvdevGamepad&& other) noexcept;
+        EvdevGamepad& operator=(EvdevGamepad&& other) noexcept;
+        EvdevGamepad(const EvdevGamepad&) = delete;
+        EvdevGamepad& operator=(const EvdevGamepad&) = delete;
+
+        /// <summary>
+        /// Opens an evdev node and reads its axis ranges and current state. Opened for writing too if it can be, for rumble.
+        /// </summary>
+        /// <returns>
+        /// true if it was opened.
+        /// false if it can't be opened or isn't a gamepad.
+        /// </returns>
+        bool Open(const std::string& path);
+        /// <summary>
+        /// Reads input_events from a file descriptor that isn't an evdev node, e.g. the read end of a pipe a capture is replayed into.
+        /// Takes ownership of fd and makes it non-blocking. The end of the file disconnects the gamepad.
+        /// </summary>
+        /// <param name="axes">Range of every axis by its ABS_ code. Axes with an empty range are ignored.</param>
+        void Attach(int fd, const std::array<EvdevAxisRange, AXIS_COUNT>& axes, const std::string& name = "");
+        void Close();
+        bool IsOpen() const;
+
+        /// <summary>
+        /// Reads every event that is pending.
+        /// </summary>
+        /// <returns>
+        /// true if the gamepad is still there.
+        /// false if it was unplugged. It is closed then.
+        /// </returns>
+        bool Read();
+
+        /// <returns>The state after the last SYN_REPORT. dwPacketNumber counts the reports.</returns>
+        const NativeGamepadState& GetState() const;
+        /// <summary>
+        /// 0.0f = cancel, 1.0f max speed. Needs FF_RUMBLE and write access to the node.
+        /// </summary>
+        void Rumble(float rumble);
+
+        const std::string& GetPath() const;
+        /// <returns>The name the driver gives the device, from EVIOCGNAME.</returns>
+        const std::string& GetName() const;
+    private:
+        // Reads the state of every button and axis with ioctls. Nodes that aren't evdev keep their state.
+        void Resync();
+        void ApplyKey(uint16_t code, int32_t value);
+        void ApplyAxis(uint16_t code, int32_t value);
+
+        int m_fd = -1;
+        std::string m_path, m_name;
+        std::array<EvdevAxisRange, AXIS_COUNT> m_axes{};
+
+        NativeGamepadState m_state{};
+        // Events since the last SYN_REPORT.
+        NativeGamepadState m_pending{};
+        // After a SYN_DROPPED the events up to the next SYN_REPORT are incomplete and the state is read again.
+        bool m_dropped = false;
+
+        bool m_canRumble = false;
+        int16_t m_rumbleEffect = -1;
+    };
+
+    /// <summary>
+    /// IWindow::GamepadBackend for evdev gamepads, the gamepad backend of the Linux window backends.
+    /// New nodes in the directory are reported by inotify, so empty slots are only probed after a device was added. Every slot holds one IWindow::EvdevGamepad.
+    /// </summary>
+    class IWINDOW_API EvdevGamepadBackend final : public GamepadBackend {
+    public:
+        /// <param name="directory">Where the evdev nodes are.</param>
+        explicit EvdevGamepadBackend(const std::string& directory = "/dev/input");
+        ~EvdevGamepadBackend();
+
+        EvdevGamepadBackend(const EvdevGamepadBackend&) = delete;
+        EvdevGamepadBackend& operator=(const EvdevGamepadBackend&) = delete;
+
+        bool Poll(GamepadID gid, NativeGamepadState& state) override;
+        void Rumble(GamepadID gid, float rumble) override;
+
+        bool HasDeviceNotifications() override;
+        bool PollDeviceChanges() override;
+
+        /// <summary>
+        /// Puts a gamepad in the first free slot, e.g. one that replays a capture (EvdevGamepad::Attach).
+        /// </summary>
+        /// <returns>false if every slot is taken.</returns>
+        bool AddGamepad(EvdevGamepad&& gamepad);
+        const EvdevGamepad& GetGamepad(GamepadID gid) const;
+    private:
+        // Opens every event node in the directory that isn't open yet.
+        void Scan();
+        void TryOpen(const std::string& path);
+
+        std::string m_directory;
+        // inotify instance watching m_directory. -1 if inotify isn't there, empty slots are then probed by scanning the directory.
+        int m_inotify = -1;
+        std::array<EvdevGamepad, (size_t)GamepadID::Max> m_gamepads{};
+        // A gamepad was put in a slot since the last PollDeviceChanges.
+        bool m_added = false;
+    };
+}
+
+#endif
@@ -0,0 +1,230 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "IWindowBitSet.h"
+#include "IWindowCodes.h"
+#include "IWindowUtils.h"
+
+namespace IWindow {
+    enum struct EventType {
+        None,
+        Key,
+        Char,
+        MouseMove,
+        MouseButton,
+        MouseScroll,
+        MouseEntered,
+        WindowFocus,
+        WindowPos,
+        WindowSize,
+        FramebufferSize,
+        WindowIconified,
+        WindowMaximized,
+        PathDrop,
+        DPIChanged,
+        RawMouseMotion,
+        Max
+    };
+
+    struct KeyEvent {
+        Key key;
+        KeyModifier mods;
+        InputState state;
+        bool repeat;
+    };
+
+    struct CharEvent {
+        char32_t c;
+        KeyModifier mods;
+    };
+
+    struct MouseButtonEvent {
+        MouseButton button;
+        KeyModifier mods;
+        InputState state;
+    };
+
+    /// <summary>
+    /// Relative mouse motion straight from the device, without pointer acceleration. See IWindow::Window::SetRawMouseMotion.
+    /// </summary>
+    struct RawMouseMotion {
+        // In device units (counts). Not clamped to the screen.
+        Vector2<float> delta;
+        // When the motion happened. Window::GetTime clock, in milliseconds.
+        double time;
+    };
+
+    /// <summary>
+    /// The paths are not stored in the event. Get them with IWindow::Window::GetDroppedPaths before the next PathDrop event is read.
+    /// </summary>
+    struct PathDropEvent {
+        Vector2<int32_t> position;
+        uint32_t pathCount;
+    };
+
+    /// <summary>
+    /// An event read with IWindow::Window::PollEvent. type says which member of the union is set.
+    /// Carries the same values as the matching callback.
+    /// </summary>
+    struct Event {
+        EventType type;
+        // When the input happened, in nanoseconds on the clock of Window::GetTime. Taken from the OS event where it has one.
+        uint64_t timestamp;
+
+        union {
+            // Key
+            KeyEvent key;
+            // Char
+            CharEvent character;
+            // MouseButton
+            MouseButtonEvent mouseButton;
+            // MouseMove. In client space.
+            Vector2<int32_t> mousePosition;
+            // MouseScroll
+            Vector2<float> scrollOffset;
+            // WindowPos. In screen space.
+            Vector2<int32_t> position;
+            // WindowSize in screen coordinates and FramebufferSize in pixels.
+            Vector2<int32_t> size;
+            // MouseEntered, WindowFocus, WindowIconified and WindowMaximized
+            bool value;
+            // PathDrop
+            PathDropEvent pathDrop;
+            // DPIChanged
+            Vector2<uint32_t> dpi;
+            // RawMouseMotion
+            RawMouseMotion rawMouseMotion;
+        };
+    };
+
+    // A bit per IWindow::Key and IWindow::MouseButton. Set while the key or button is down.
+    typedef BitSet<(size_t)Key::Max> KeyBitSet;
+    typedef BitSet<(size_t)MouseButton::Max> MouseButtonBitSet;
+
+    /// <summary>
+    /// Settings for IWindow::Window::SetInputThread.
+    /// </summary>
+    struct InputThreadInfo {
+        // Number of events the input thread can hand to the render thread between two Window::Update calls. Rounded up to a power of two.
+        // Events that don't fit are dropped. The snapshot from Window::GetLatestInput still has the latest state.
+        uint32_t eventCapacity = 1024;
+        // Run the input thread with real-time priority (THREAD_PRIORITY_TIME_CRITICAL on Windows, SCHED_FIFO on Linux).
+        // Linux needs CAP_SYS_NICE or an rtprio limit for this. If it is not allowed a warning is reported and the thread keeps normal priority.
+        bool realtimePriority = false;
+        // Bit n pins the input thread to CPU n. 0 lets the OS choose.
+        uint64_t affinityMask = 0;
+    };
+
+    /// <summary>
+    /// Input and window state of a window. Published by the input thread after every batch of events (see IWindow::Window::GetLatestInput)
+    /// or taken after an update with IWindow::Window::CaptureInputSnapshot.
+    /// Plain data without pointers, so a copy can be read on any thread while the window keeps updating.
+    /// </summary>
+    struct InputSnapshot {
+        // Increases every time the input thread publishes. Equal sequences mean nothing changed.
+        uint64_t sequence;
+        // Number of updates the window started. Only set by Window::CaptureInputSnapshot.
+        uint64_t frame;
+        // Window::GetTime when the snapshot was published. From Window::CaptureInputSnapshot, when the last update started.
+        double time;
+
+        KeyBitSet keys;
+        MouseButtonBitSet mouseButtons;
+        KeyModifier mods;
+
+        // In client space.
+        Vector2<int32_t> mousePosition;
+        // Offset of the last scroll event.
+        Vector2<float> scrollOffset;
+        // Sum of the offsets of every scroll event in the last update. Only set by Window::CaptureInputSnapshot.
+        Vector2<float> scrollDelta;
+
+        Vector2<int32_t> size, position, framebufferSize;
+
+        bool running;
+        bool focused;
+        bool mouseEntered;
+        bool iconified;
+        bool maximized;
+        bool fullscreen;
+    };
+
+    static_assert(std::is_trivially_copyable<InputSnapshot>::value, "IWindow::InputSnapshot has to stay plain data so it can be copied to other threads.");
+
+    /// <summary>
+    /// Histogram of input-to-present latency: for every presented frame that handled input, the time from the oldest input event of the frame 
+    /// (IWindow::Event::timestamp) to Window::MarkPresent. See IWindow::Window::GetLatencyStats.
+    /// Bucket i counts latencies from BucketLowerBound(i) up to BucketLowerBound(i + 1), four buckets per doubling from 62.5 us to 4 s.
+    /// The first and last buckets also count everything below and above.
+    /// </summary>
+    struct LatencyStats {
+        static constexpr uint32_t BUCKET_COUNT = 64;
+        static constexpr double FIRST_BUCKET_MS = 0.0625;
+
+        // Frames that were presented with input.
+        uint64_t count;
+        double minMs, maxMs, totalMs;
+        uint64_t buckets[BUCKET_COUNT];
+
+        static double BucketLowerBound(uint32_t bucket) { return FIRST_BUCKET_MS * std::exp2((double)bucket / 4.0); }
+
+        static uint32_t BucketOf(double ms) {
+            if (ms < FIRST_BUCKET_MS) return 0;
+            const double bucket = std::floor(std::log2(ms / FIRST_BUCKET_MS) * 4.0);
+            return bucket < (double)BUCKET_COUNT ? (uint32_t)bucket : BUCKET_COUNT - 1;
+        }
+
+        double GetMeanMs() const { return count ? totalMs / (double)count : 0.0; }
+
+        /// <summary>
+        /// Gets the latency that a fraction of the frames are at or below, e.g. 0.99 for the 99th percentile.
+        /// Accurate to the bucket, about 19%, and never above the largest latency recorded.
+        /// </summary>
+        /// <returns>The upper bound of the bucket the percentile is in, in milliseconds. 0 if nothing was recorded.</returns>
+        double GetPercentileMs(double percentile) const {
+            if (!count) return 0.0;
+
+            const double target = percentile * (double)count;
+            uint64_t seen = 0;
+            for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+                seen += buckets[i];
+                if ((double)seen >= target && seen) return std::fmin(BucketLowerBound(i + 1), maxMs);
+            }
+
+            return maxMs;
+        }
+    };
+
+    static_assert(std::is_trivially_copyable<LatencyStats>::value, "IWindow::LatencyStats has to stay plain data so it can be copied to other threads.");
+}
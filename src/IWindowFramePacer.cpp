@@ -0,0 +1,193 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "IWindowFramePacer.h"
+
+#include "IWindow.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+// Windows 10 1803 and newer. Older SDKs don't have it.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#elif defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace IWindow {
+    // The spin starts this long before a frame is due until the OS was seen to wake up. ::Sleep wakes up to a whole tick late.
+#if defined(_WIN32)
+    static constexpr uint64_t INITIAL_SPIN_NS = 2'000'000;
+#else
+    static constexpr uint64_t INITIAL_SPIN_NS = 1'000'000;
+#endif
+    // Headroom on top of the oversleep.
+    static constexpr uint64_t SPIN_MARGIN_NS = 20'000;
+    static constexpr uint64_t MAX_SPIN_NS = 4'000'000;
+
+    // The deadlines are on IWindow::GetTimeNs. After IWindow::UseTscTimer it runs on the TSC, which drifts away from the clocks the OS sleeps on,
+    // so every sleep is measured from now.
+    static uint64_t Now() { return IWindow::GetTimeNs(); }
+
+    // Tells the core it is spinning, which saves power and leaves the pipeline to the other hyper-thread.
+    static inline void CpuRelax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    FramePacer::FramePacer() : m_spinNs{ INITIAL_SPIN_NS }, m_oversleepMean{ (double)INITIAL_SPIN_NS } {
+#if defined(_WIN32)
+        m_timer = ::CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+    }
+
+    FramePacer::FramePacer(double targetFps) : FramePacer() { SetTargetFps(targetFps); }
+
+    FramePacer::~FramePacer() {
+#if defined(_WIN32)
+        if (m_timer) ::CloseHandle(m_timer);
+#endif
+    }
+
+    void FramePacer::SetTargetFps(double targetFps) {
+        m_targetFps = targetFps > 0.0 ? targetFps : 0.0;
+        m_periodNs = targetFps > 0.0 ? (uint64_t)(1'000'000'000.0 / targetFps) : 0;
+        m_deadline = 0;
+    }
+
+    bool FramePacer::SetTargetFps(const Monitor& monitor) {
+        const VideoMode mode = monitor.GetCurrentVideoMode();
+        if (mode.refreshRate <= 0.0) return false;
+
+        SetTargetFps(mode.refreshRate);
+        return true;
+    }
+
+    double FramePacer::GetTargetFps() const { return m_targetFps; }
+
+    void FramePacer::SleepUntil(uint64_t time) {
+#if defined(_WIN32)
+        const uint64_t now = Now();
+        if (time <= now) return;
+
+        if (m_timer) {
+            // Negative due times are relative, in 100 nanosecond steps.
+            LARGE_INTEGER due{};
+            due.QuadPart = -(LONGLONG)((time - now) / 100);
+            if (::SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE)) {
+                ::WaitForSingleObject(m_timer, INFINITE);
+                return;
+            }
+        }
+
+        ::Sleep((DWORD)((time - now) / 1'000'000));
+#elif defined(__linux__)
+        const uint64_t now = Now();
+        if (time <= now) return;
+
+        // The wake-up on CLOCK_MONOTONIC is absolute, so it doesn't drift when a signal interrupts the sleep.
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        const uint64_t wake = (uint64_t)ts.tv_sec * 1'000'000'000 + (uint64_t)ts.tv_nsec + (time - now);
+        ts.tv_sec = (time_t)(wake / 1'000'000'000);
+        ts.tv_nsec = (long)(wake % 1'000'000'000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR);
+#else
+        const uint64_t now = Now();
+        if (time > now) std::this_thread::sleep_for(std::chrono::nanoseconds{ time - now });
+#endif
+    }
+
+    void FramePacer::Wait() {
+        if (!m_periodNs) return;
+
+        uint64_t now = Now();
+
+        // The first frame starts the schedule.
+        if (!m_deadline) {
+            m_deadline = now + m_periodNs;
+            return;
+        }
+
+        if (now >= m_deadline) {
+            m_stats.missed++;
+        }
+        else {
+            if (m_deadline - now > m_spinNs) {
+                const uint64_t wake = m_deadline - m_spinNs;
+                SleepUntil(wake);
+                now = Now();
+
+                // The spin covers the usual oversleep plus two standard deviations, averaged over the last few dozen sleeps. 
+                // Taking the worst oversleep instead would make one preemption spin for seconds.
+                const double overslept = (double)(now > wake ? now - wake : 0);
+                const double difference = overslept - m_oversleepMean;
+                m_oversleepMean += difference / 16.0;
+                m_oversleepVariance = (m_oversleepVariance + difference * difference / 16.0) * (15.0 / 16.0);
+
+                const double spin = m_oversleepMean + 2.0 * std::sqrt(m_oversleepVariance) + (double)SPIN_MARGIN_NS;
+                m_spinNs = (uint64_t)std::fmin(spin, (double)MAX_SPIN_NS);
+            }
+
+            while ((now = Now()) < m_deadline) CpuRelax();
+        }
+
+        const double errorUs = (double)(now - m_deadline) / 1'000.0;
+        FramePacingStats& stats = m_stats;
+        stats.minErrorUs = stats.count ? std::fmin(stats.minErrorUs, errorUs) : errorUs;
+        stats.maxErrorUs = std::fmax(stats.maxErrorUs, errorUs);
+        stats.totalErrorUs += errorUs;
+        stats.buckets[FramePacingStats::BucketOf(errorUs)]++;
+        stats.count++;
+
+        // Frames behind by more than a whole interval are not made up by rushing the next ones.
+        m_deadline = now - m_deadline > m_periodNs ? now + m_periodNs : m_deadline + m_periodNs;
+    }
+
+    void FramePacer::Reset() { m_deadline = 0; }
+
+    uint64_t FramePacer::GetSpinTimeNs() const { return m_spinNs; }
+
+    FramePacingStats FramePacer::GetStats() const { return m_stats; }
+
+    void FramePacer::ResetStats() { m_stats = {}; }
+}
@@ -0,0 +1,152 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "IWindowCore.h"
+#include "IWindowUtils.h"
+
+namespace IWindow {
+    /// <summary>
+    /// Histogram of how late FramePacer::Wait returned after the time the frame was due. See IWindow::FramePacer::GetStats.
+    /// Bucket i counts errors from BucketLowerBound(i) up to BucketLowerBound(i + 1), four buckets per doubling from 1 us to 65 ms.
+    /// The first and last buckets also count everything below and above.
+    /// </summary>
+    struct FramePacingStats {
+        static constexpr uint32_t BUCKET_COUNT = 64;
+        static constexpr double FIRST_BUCKET_US = 1.0;
+
+        // Frames Wait returned for.
+        uint64_t count;
+        // Frames that were already late when Wait was called, so there was nothing to wait for.
+        uint64_t missed;
+        double minErrorUs, maxErrorUs, totalErrorUs;
+        uint64_t buckets[BUCKET_COUNT];
+
+        static double BucketLowerBound(uint32_t bucket) { return FIRST_BUCKET_US * std::exp2((double)bucket / 4.0); }
+
+        static uint32_t BucketOf(double us) {
+            if (us < FIRST_BUCKET_US) return 0;
+            const double bucket = std::floor(std::log2(us / FIRST_BUCKET_US) * 4.0);
+            return bucket < (double)BUCKET_COUNT ? (uint32_t)bucket : BUCKET_COUNT - 1;
+        }
+
+        double GetMeanErrorUs() const { return count ? totalErrorUs / (double)count : 0.0; }
+
+        /// <summary>
+        /// Gets the error that a fraction of the frames are at or below, e.g. 0.99 for the 99th percentile.
+        /// Accurate to the bucket, about 19%, and never above the largest error recorded.
+        /// </summary>
+        /// <returns>The upper bound of the bucket the percentile is in, in microseconds. 0 if nothing was recorded.</returns>
+        double GetPercentileUs(double percentile) const {
+            if (!count) return 0.0;
+
+            const double target = percentile * (double)count;
+            uint64_t seen = 0;
+            for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+                seen += buckets[i];
+                if ((double)seen >= target && seen) return std::fmin(BucketLowerBound(i + 1), maxErrorUs);
+            }
+
+            return maxErrorUs;
+        }
+    };
+
+    static_assert(std::is_trivially_copyable<FramePacingStats>::value, "IWindow::FramePacingStats has to stay plain data so it can be copied to other threads.");
+
+    /// <summary>
+    /// Limits a loop to a frame rate. Call FramePacer::Wait once per frame, e.g. right before presenting.
+    /// Wait sleeps with the OS (clock_nanosleep on Linux, a high resolution waitable timer on Windows 10 1803 and newer) until shortly before the frame is due 
+    /// and spins for the rest. The spin is as long as the OS usually oversleeps, so it shrinks on an idle system and grows under load.
+    /// Frames are due at fixed intervals, so a frame that took longer than others doesn't shift the ones after it. 
+    /// After a frame that missed its time by more than a whole interval, e.g. a loading hitch, the schedule starts again from it.
+    /// Only the thread that calls Wait may use the pacer.
+    /// </summary>
+    class IWINDOW_API FramePacer {
+    public:
+        FramePacer();
+        /// <param name="targetFps">Frames per second. 0 or less makes Wait return right away.</param>
+        explicit FramePacer(double targetFps);
+        ~FramePacer();
+
+        FramePacer(const FramePacer&) = delete;
+        FramePacer& operator=(const FramePacer&) = delete;
+
+        /// <summary>
+        /// Set how many frames per second Wait lets through. Starts a new schedule.
+        /// </summary>
+        /// <param name="targetFps">Frames per second. 0 or less makes Wait return right away.</param>
+        void SetTargetFps(double targetFps);
+        /// <summary>
+        /// Set the target frame rate to the refresh rate of a monitor's current video mode.
+        /// </summary>
+        /// <returns>
+        /// true if the monitor reported a refresh rate.
+        /// false if it didn't. The target frame rate is not changed.
+        /// </returns>
+        bool SetTargetFps(const Monitor& monitor);
+        double GetTargetFps() const;
+
+        /// <summary>
+        /// Waits until the next frame is due and records how late it returned.
+        /// </summary>
+        void Wait();
+        /// <summary>
+        /// Starts a new schedule from now, e.g. after a loading screen or while the window was iconified, so the pause isn't counted as a missed frame.
+        /// </summary>
+        void Reset();
+
+        /// <returns>How far before a frame is due Wait stops sleeping and starts spinning, in nanoseconds.</returns>
+        uint64_t GetSpinTimeNs() const;
+
+        /// <returns>How late Wait returned for every frame since the pacer was made or FramePacer::ResetStats was called.</returns>
+        FramePacingStats GetStats() const;
+        void ResetStats();
+    private:
+        // Sleeps with the OS until IWindow::GetTimeNs reaches time. May return late, never early.
+        void SleepUntil(uint64_t time);
+
+        double m_targetFps = 0.0;
+        uint64_t m_periodNs = 0;
+        // When the next frame is due on IWindow::GetTimeNs. 0 starts a new schedule on the next Wait.
+        uint64_t m_deadline = 0;
+        // How long before a frame is due the spin starts. Follows how much the OS overslept recently, in nanoseconds.
+        uint64_t m_spinNs;
+        double m_oversleepMean, m_oversleepVariance = 0.0;
+        FramePacingStats m_stats{};
+
+#if defined(_WIN32)
+        // High resolution waitable timer. nullptr before Windows 10 1803, ::Sleep is used instead.
+        void* m_timer = nullptr;
+#endif
+    };
+}
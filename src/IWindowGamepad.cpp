@@ -0,0 +1,120 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "IWindowGamepad.h"
+
+// IWindow::Gamepad reads IWindow::GamepadManager. The backends are in the backend files.
+namespace IWindow {
+    std::array<void*, (int)GamepadID::Max> Gamepad::m_userPtrs{nullptr};
+
+    Gamepad::Gamepad(GamepadID gamepadIndex, float triggerDeadzone, float stickDeadzone) 
+    : m_gamepadIndex { (int)gamepadIndex }
+    {
+        m_axisSettings.triggerDeadzone = triggerDeadzone;
+        m_axisSettings.stickDeadzone = stickDeadzone;
+    }
+
+    Gamepad::~Gamepad() { }
+
+    GamepadID Gamepad::GetID() { return (GamepadID)m_gamepadIndex; }
+
+    NativeGamepadState Gamepad::GetState() { return GamepadManager::Get().GetState((GamepadID)m_gamepadIndex); }
+
+    bool Gamepad::IsConnected() { return GamepadManager::Get().IsConnected((GamepadID)m_gamepadIndex); }
+
+    void Gamepad::Rumble(float rumble) { GamepadManager::Get().Rumble((GamepadID)m_gamepadIndex, rumble); }
+
+    void Gamepad::Update() {
+        GamepadManager& manager = GamepadManager::Get();
+
+        // This gamepad already copied the state of the last update, so a new frame started. 
+        // The other gamepads find the count changed and only copy, so the pads are polled once per frame however many gamepads there are.
+        if (m_updateCount == manager.GetUpdateCount()) manager.Update();
+
+        m_updateCount = manager.GetUpdateCount();
+        m_previousButtons = m_state.Gamepad.wButtons;
+        m_state = manager.GetState((GamepadID)m_gamepadIndex);
+        m_rawAxes = manager.GetAxes((GamepadID)m_gamepadIndex);
+        m_axes = ApplyGamepadDeadzone(m_rawAxes, m_axisSettings);
+    }
+
+    float Gamepad::LeftStickX() { return m_axes[(size_t)GamepadAxis::LeftStickX]; }
+    float Gamepad::LeftStickY() { return m_axes[(size_t)GamepadAxis::LeftStickY]; }
+    float Gamepad::RightStickX() { return m_axes[(size_t)GamepadAxis::RightStickX]; }
+    float Gamepad::RightStickY() { return m_axes[(size_t)GamepadAxis::RightStickY]; }
+
+    float Gamepad::LeftTrigger() { return m_axes[(size_t)GamepadAxis::LeftTrigger]; }
+    float Gamepad::RightTrigger() { return m_axes[(size_t)GamepadAxis::RightTrigger]; }
+
+    float Gamepad::GetAxis(GamepadAxis axis) { return m_axes[(size_t)axis]; }
+
+    bool Gamepad::IsButtonDown(GamepadButton button) { return m_state.Gamepad.wButtons & (int)button; }
+    bool Gamepad::IsButtonUp(GamepadButton button) { return !IsButtonDown(button); }
+
+    bool Gamepad::IsButtonJustPressed(GamepadButton button) { return IsButtonDown(button) && !(m_previousButtons & (int)button); }
+    bool Gamepad::IsButtonJustReleased(GamepadButton button) { return IsButtonUp(button) && (m_previousButtons & (int)button); }
+
+    void Gamepad::SetConnectedCallback(GamepadConnectedCallback callback) { GamepadManager::Get().SetConnectedCallback(std::move(callback)); }
+
+    void Gamepad::SetUserPointer(GamepadID gid, void* ptr) { m_userPtrs[(int)gid] = ptr; }
+
+    void* Gamepad::GetUserPointer(GamepadID gid) { return m_userPtrs[(int)gid]; }
+
+    void Gamepad::SetTriggerDeadzone(float deadzone) { 
+        m_axisSettings.triggerDeadzone = deadzone; 
+        m_axes = ApplyGamepadDeadzone(m_rawAxes, m_axisSettings);
+    }
+    float Gamepad::GetTriggerDeadzone() { return m_axisSettings.triggerDeadzone; }
+
+    void Gamepad::SetStickDeadzone(float deadzone) { 
+        m_axisSettings.stickDeadzone = deadzone; 
+        m_axes = ApplyGamepadDeadzone(m_rawAxes, m_axisSettings);
+    }
+
+    float Gamepad::GetStickDeadzone() { return m_axisSettings.stickDeadzone; }
+
+    void Gamepad::SetStickDeadzoneType(StickDeadzone type) {
+        m_axisSettings.stickDeadzoneType = type;
+        m_axes = ApplyGamepadDeadzone(m_rawAxes, m_axisSettings);
+    }
+
+    StickDeadzone Gamepad::GetStickDeadzoneType() { return m_axisSettings.stickDeadzoneType; }
+
+    void Gamepad::SetStickResponseCurve(float exponent) {
+        m_axisSettings.stickResponseCurve = exponent;
+        m_axes = ApplyGamepadDeadzone(m_rawAxes, m_axisSettings);
+    }
+
+    float Gamepad::GetStickResponseCurve() { return m_axisSettings.stickResponseCurve; }
+
+    void Gamepad::SetAxisSettings(const GamepadAxisSettings& settings) {
+        m_axisSettings = settings;
+        m_axes = ApplyGamepadDeadzone(m_rawAxes, m_axisSettings);
+    }
+
+    const GamepadAxisSettings& Gamepad::GetAxisSettings() { return m_axisSettings; }
+}
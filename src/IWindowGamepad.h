@@ -36,11 +36,15 @@
 #include "IWindowCodes.h"
 #include "IWindowPlatform.h"
 #include "IWindowCore.h"
+#include "IWindowGamepadManager.h"
+#include "IWindowBitSet.h"
 
 
 namespace IWindow {
-    typedef std::function<void(GamepadID, bool)> GamepadConnectedCallback;
-
+    /// <summary>
+    /// View of a gamepad slot in IWindow::GamepadManager. Copying the state on Update is all a gamepad does, the manager talks to the driver.
+    /// Update also applies the deadzones to the axes the manager converted, so the stick and trigger getters only read floats.
+    /// </summary>
     class IWINDOW_API Gamepad {
     public:
         Gamepad() = default;
@@ -55,6 +59,9 @@ namespace IWindow {
         float LeftTrigger(); 
         float RightTrigger();
 
+        /// <returns>An axis at the last Update, with the deadzones and the response curve applied.</returns>
+        float GetAxis(GamepadAxis axis);
+
         bool IsButtonDown(GamepadButton button);
         template <typename ... Args>
         bool IsButtonDown(GamepadButton button, Args... args) { return IsButtonDown(button) && IsButtonDown(args...); }
@@ -63,10 +70,30 @@ namespace IWindow {
         template <typename ... Args>
         bool IsButtonUp(GamepadButton button, Args... args) { return IsButtonUp(button) && IsButtonUp(args...); }
 
+        /// <returns>true if the button went down in the last Update.</returns>
+        bool IsButtonJustPressed(GamepadButton button);
+        /// <returns>true if the button went up in the last Update.</returns>
+        bool IsButtonJustReleased(GamepadButton button);
+        /// <summary>
+        /// Calls function(GamepadButton button, bool down) for every button that was pressed or released in the last Update.
+        /// Only visits the buttons that changed, found by XOR-ing the button masks.
+        /// </summary>
+        template<typename F>
+        void ForEachChangedButton(F&& function) const {
+            for (uint32_t changed = (uint32_t)(m_previousButtons ^ m_state.Gamepad.wButtons); changed; changed &= changed - 1) {
+                const uint32_t bit = 1u << CountTrailingZeros(changed);
+                function((GamepadButton)bit, (m_state.Gamepad.wButtons & bit) != 0);
+            }
+        }
+
+        /// <returns>The state of the gamepad at the last GamepadManager update. Empty if it isn't connected.</returns>
         NativeGamepadState GetState();
         GamepadID GetID();
         bool IsConnected();
 
+        /// <summary>
+        /// Same as GamepadManager::Get().SetConnectedCallback.
+        /// </summary>
         static void SetConnectedCallback(GamepadConnectedCallback callback);
 
         static void SetUserPointer(GamepadID gid, void* ptr);
@@ -78,27 +105,46 @@ namespace IWindow {
         void SetStickDeadzone(float deadzone);
         float GetStickDeadzone();
 
+        /// <summary>
+        /// Set the shape of the stick deadzone. StickDeadzone::Axial by default, StickDeadzone::ScaledRadial feels the smoothest in most games.
+        /// </summary>
+        void SetStickDeadzoneType(StickDeadzone type);
+        StickDeadzone GetStickDeadzoneType();
+
+        /// <summary>
+        /// Set the exponent the stick's distance from the middle is raised to. 1 by default, which is linear.
+        /// </summary>
+        void SetStickResponseCurve(float exponent);
+        float GetStickResponseCurve();
+
+        void SetAxisSettings(const GamepadAxisSettings& settings);
+        const GamepadAxisSettings& GetAxisSettings();
+
         /*
             0.0f = cancel, 1.0f max speed
             Windows only for now
         */
         void Rumble(float rumble);
 
+        /// <summary>
+        /// Copies the gamepad's state from IWindow::GamepadManager. Updates the manager first unless another gamepad already did this frame.
+        /// For changes without polling see GamepadManager::SetButtonCallback and GamepadManager::SetAxisCallback.
+        /// </summary>
         void Update();
     private:
-        NativeGamepadState m_state;
-        int m_gamepadIndex;
-
-        static void DefaultGamepadConnectedCallback(GamepadID, bool) {}
-
-        static GamepadConnectedCallback m_connectedCallback;
-
-        static std::array<bool, (int)GamepadID::Max> m_connectedGamepads;
+        NativeGamepadState m_state{};
+        int m_gamepadIndex = 0;
+        // wButtons before the last Update.
+        uint16_t m_previousButtons = 0;
+        // GamepadManager::GetUpdateCount when m_state was copied.
+        uint64_t m_updateCount = 0;
 
         static std::array<void*, (int)GamepadID::Max> m_userPtrs;
 
-        float m_triggerDeadzone;
-        float m_stickDeadzone;
+        GamepadAxisSettings m_axisSettings{};
+        // The axes from GamepadManager::GetAxes, and with the settings applied. Changing a setting applies it again.
+        GamepadAxes m_rawAxes{};
+        GamepadAxes m_axes{};
     };
     
 }
\ No newline at end of file
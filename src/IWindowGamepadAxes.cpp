@@ -0,0 +1,147 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "IWindowGamepadAxes.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define IWINDOW_GAMEPAD_SSE2
+#endif
+
+namespace IWindow {
+    typedef decltype(NativeGamepadState::Gamepad) GamepadFields;
+    static_assert(offsetof(GamepadFields, sThumbRY) == offsetof(GamepadFields, sThumbLX) + 3 * sizeof(int16_t), "The four stick axes are loaded with one 64 bit load.");
+
+#if defined(IWINDOW_GAMEPAD_SSE2)
+    static __m128 Pow(__m128 base, float exponent) {
+        alignas(16) float values[4];
+        _mm_store_ps(values, base);
+        for (float& value : values) value = std::pow(value, exponent);
+        return _mm_load_ps(values);
+    }
+#else
+    // What the SSE2 path does for one stick.
+    static void ApplyStickDeadzone(float& x, float& y, const GamepadAxisSettings& settings) {
+        const float deadzone = settings.stickDeadzone, curve = settings.stickResponseCurve;
+
+        if (settings.stickDeadzoneType == StickDeadzone::Axial) {
+            for (float* axis : { &x, &y }) {
+                const float magnitude = std::fabs(*axis);
+                *axis = magnitude > deadzone ? (curve == 1.0f ? *axis : *axis * std::pow(magnitude, curve - 1.0f)) : 0.0f;
+            }
+            return;
+        }
+
+        const float magnitude = std::sqrt(x * x + y * y);
+        float scale = 0.0f;
+        if (magnitude > deadzone) {
+            if (settings.stickDeadzoneType == StickDeadzone::Radial) scale = curve == 1.0f ? 1.0f : std::pow(magnitude, curve - 1.0f);
+            else scale = std::pow(std::min((magnitude - deadzone) / (1.0f - deadzone), 1.0f), curve) / magnitude;
+        }
+
+        x *= scale;
+        y *= scale;
+    }
+#endif
+
+    void NormalizeGamepadAxes(const NativeGamepadState* states, GamepadAxes* axes, size_t count) {
+#if defined(IWINDOW_GAMEPAD_SSE2)
+        const __m128 stickRange = _mm_set1_ps((float)SHRT_MAX);
+        const __m128 minusOne = _mm_set1_ps(-1.0f);
+#endif
+
+        for (size_t i = 0; i < count; i++) {
+            const auto& gamepad = states[i].Gamepad;
+
+#if defined(IWINDOW_GAMEPAD_SSE2)
+            // sThumbLX, sThumbLY, sThumbRX and sThumbRY lie next to each other, as in XINPUT_GAMEPAD. Sign extended to 32 bits by shifting them down from the top half.
+            const __m128i sticks = _mm_loadl_epi64((const __m128i*)&gamepad.sThumbLX);
+            const __m128 values = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(sticks, sticks), 16));
+            // -32768 would be a little below -1.
+            _mm_storeu_ps(axes[i].data(), _mm_max_ps(_mm_div_ps(values, stickRange), minusOne));
+#else
+            axes[i][(size_t)GamepadAxis::LeftStickX] = std::max((float)gamepad.sThumbLX / SHRT_MAX, -1.0f);
+            axes[i][(size_t)GamepadAxis::LeftStickY] = std::max((float)gamepad.sThumbLY / SHRT_MAX, -1.0f);
+            axes[i][(size_t)GamepadAxis::RightStickX] = std::max((float)gamepad.sThumbRX / SHRT_MAX, -1.0f);
+            axes[i][(size_t)GamepadAxis::RightStickY] = std::max((float)gamepad.sThumbRY / SHRT_MAX, -1.0f);
+#endif
+
+            axes[i][(size_t)GamepadAxis::LeftTrigger] = (float)gamepad.bLeftTrigger / 255.0f;
+            axes[i][(size_t)GamepadAxis::RightTrigger] = (float)gamepad.bRightTrigger / 255.0f;
+        }
+    }
+
+    GamepadAxes ApplyGamepadDeadzone(const GamepadAxes& axes, const GamepadAxisSettings& settings) {
+        GamepadAxes result = axes;
+
+#if defined(IWINDOW_GAMEPAD_SSE2)
+        // Left x, left y, right x, right y. Lanes that are inside the deadzone are masked to 0, which also drops the NaNs of a division by a length of 0.
+        const __m128 sticks = _mm_loadu_ps(axes.data());
+        const __m128 deadzone = _mm_set1_ps(settings.stickDeadzone);
+        const float curve = settings.stickResponseCurve;
+
+        __m128 live, scale;
+        if (settings.stickDeadzoneType == StickDeadzone::Axial) {
+            const __m128 magnitudes = _mm_andnot_ps(_mm_set1_ps(-0.0f), sticks);
+            live = _mm_cmpgt_ps(magnitudes, deadzone);
+            scale = curve == 1.0f ? _mm_set1_ps(1.0f) : Pow(magnitudes, curve - 1.0f);
+        }
+        else {
+            // The length of each stick in both of its lanes.
+            const __m128 squares = _mm_mul_ps(sticks, sticks);
+            const __m128 magnitudes = _mm_sqrt_ps(_mm_add_ps(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 3, 0, 1))));
+            live = _mm_cmpgt_ps(magnitudes, deadzone);
+
+            if (settings.stickDeadzoneType == StickDeadzone::Radial) {
+                scale = curve == 1.0f ? _mm_set1_ps(1.0f) : Pow(magnitudes, curve - 1.0f);
+            }
+            else {
+                __m128 scaled = _mm_div_ps(_mm_sub_ps(magnitudes, deadzone), _mm_set1_ps(1.0f - settings.stickDeadzone));
+                scaled = _mm_min_ps(scaled, _mm_set1_ps(1.0f));
+                if (curve != 1.0f) scaled = Pow(scaled, curve);
+                scale = _mm_div_ps(scaled, magnitudes);
+            }
+        }
+
+        _mm_storeu_ps(result.data(), _mm_and_ps(_mm_mul_ps(sticks, scale), live));
+#else
+        ApplyStickDeadzone(result[(size_t)GamepadAxis::LeftStickX], result[(size_t)GamepadAxis::LeftStickY], settings);
+        ApplyStickDeadzone(result[(size_t)GamepadAxis::RightStickX], result[(size_t)GamepadAxis::RightStickY], settings);
+#endif
+
+        for (GamepadAxis trigger : { GamepadAxis::LeftTrigger, GamepadAxis::RightTrigger })
+            if (result[(size_t)trigger] <= settings.triggerDeadzone) result[(size_t)trigger] = 0.0f;
+
+        return result;
+    }
+}
@@ -0,0 +1,79 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "IWindowCodes.h"
+#include "IWindowCore.h"
+#include "IWindowPlatform.h"
+
+namespace IWindow {
+    // Indexed by IWindow::GamepadAxis. Sticks from -1 to 1 with up positive, triggers from 0 to 1.
+    typedef std::array<float, (size_t)GamepadAxis::Max> GamepadAxes;
+
+    /// <summary>
+    /// The shape of the area around the middle of a stick that reads as 0.
+    /// </summary>
+    enum struct StickDeadzone {
+        // Each axis is 0 while it is inside the deadzone. The deadzone is a cross, so a stick pushed along a diagonal snaps to the axes.
+        Axial,
+        // The stick is 0 while its distance from the middle is inside the deadzone. Outside it the stick reads as it is.
+        Radial,
+        // Like Radial, but the distance from the edge of the deadzone to the edge of the stick is stretched to 0 to 1, 
+        // so the stick doesn't jump from 0 to the deadzone and reaches 1 at its edge.
+        ScaledRadial,
+    };
+
+    /// <summary>
+    /// How IWindow::ApplyGamepadDeadzone and IWindow::Gamepad turn the axes of a gamepad into the values a game reads.
+    /// </summary>
+    struct GamepadAxisSettings {
+        StickDeadzone stickDeadzoneType = StickDeadzone::Axial;
+        float stickDeadzone = 0.15f;
+        // Triggers at or below it read as 0.
+        float triggerDeadzone = 0.15f;
+        // The stick's distance from the middle, or each axis with StickDeadzone::Axial, is raised to this power. 
+        // 1 is linear, above 1 gives finer control near the middle.
+        float stickResponseCurve = 1.0f;
+    };
+
+    /// <summary>
+    /// Turns the raw axes of gamepads into floats, the sticks of a gamepad with one SIMD conversion. Without a deadzone.
+    /// IWindow::GamepadManager does it for every gamepad once per update, see GamepadManager::GetAxes.
+    /// </summary>
+    void IWINDOW_API NormalizeGamepadAxes(const NativeGamepadState* states, GamepadAxes* axes, size_t count);
+
+    /// <summary>
+    /// Applies the deadzones and the response curve to axes from IWindow::NormalizeGamepadAxes. Both sticks are handled together in one SIMD register.
+    /// </summary>
+    GamepadAxes IWINDOW_API ApplyGamepadDeadzone(const GamepadAxes& axes, const GamepadAxisSettings& settings);
+}
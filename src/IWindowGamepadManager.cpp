@@ -0,0 +1,429 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "IWindowGamepadManager.h"
+
+#include "IWindow.h"
+#include "IWindowBitSet.h"
+#include "IWindowSPSCQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace IWindow {
+    static const NativeGamepadState s_emptyState{};
+
+    static constexpr uint32_t DEFAULT_HISTORY_CAPACITY = 256;
+
+    static bool SameInput(const NativeGamepadState& left, const NativeGamepadState& right) { return std::memcmp(&left.Gamepad, &right.Gamepad, sizeof(left.Gamepad)) == 0; }
+
+    struct GamepadManager::PollingThread {
+        explicit PollingThread(const GamepadPollingInfo& info) : info{ info }, samples{ info.sampleCapacity } {}
+
+        GamepadPollingInfo info;
+        // Samples from the polling thread to Update.
+        SPSCQueue<GamepadSample> samples;
+        // Set when a sample didn't fit into the queue.
+        std::atomic<bool> dropped{ false };
+
+        std::atomic<bool> stop{ false };
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::thread thread;
+    };
+
+    GamepadManager& GamepadManager::Get() {
+        static GamepadManager s_manager{};
+        return s_manager;
+    }
+
+    GamepadManager::GamepadManager() 
+    : m_backend{ &GetPlatformBackend() },
+      m_history(DEFAULT_HISTORY_CAPACITY)
+    {
+        for (Slot& slot : m_slots) slot.probeIntervalNs = m_minProbeIntervalNs;
+        for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) m_current[i].gid = (GamepadID)i;
+    }
+
+    GamepadManager::~GamepadManager() { StopPollingThread(); }
+
+    void GamepadManager::SetBackend(GamepadBackend* backend) {
+        StopPollingThread();
+
+        m_backend = backend ? backend : &GetPlatformBackend();
+
+        for (Slot& slot : m_slots) slot = Slot{ NativeGamepadState{}, false, 0, m_minProbeIntervalNs };
+        m_nextProbeSlot = 0;
+
+        for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) {
+            m_current[i] = GamepadSample{ 0, NativeGamepadState{}, (GamepadID)i, false };
+            Publish(m_current[i]);
+        }
+        NormalizeAxes();
+    }
+
+    GamepadBackend& GamepadManager::GetBackend() { return *m_backend; }
+
+    void GamepadManager::Update() { Update(IWindow::GetTimeNs()); }
+
+    void GamepadManager::Update(uint64_t timeNs) {
+        m_updateCount++;
+
+        if (!m_pollingThread) {
+            std::lock_guard<std::mutex> lock(m_backendMutex);
+            PollSlots(timeNs, [this](const GamepadSample& sample) { ApplySample(sample); });
+        }
+        else {
+            PollingThread& thread = *m_pollingThread;
+
+            GamepadSample sample{};
+            while (thread.samples.Pop(sample)) ApplySample(sample);
+
+            // Samples were lost, so continue from the newest state. Only changes are applied, so slots that didn't change are left alone.
+            if (thread.dropped.exchange(false, std::memory_order_acquire)) {
+                while (thread.samples.Pop(sample)) ApplySample(sample);
+                for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) ApplySample(GetLatestSample((GamepadID)i));
+            }
+        }
+
+        NormalizeAxes();
+    }
+
+    void GamepadManager::NormalizeAxes() {
+        std::array<NativeGamepadState, (size_t)GamepadID::Max> states;
+        for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) states[i] = m_current[i].connected ? m_current[i].state : s_emptyState;
+
+        NormalizeGamepadAxes(states.data(), m_axes.data(), states.size());
+    }
+
+    template<typename F>
+    void GamepadManager::PollSlots(uint64_t timeNs, F&& onSample) {
+        const bool notifies = m_backend->HasDeviceNotifications();
+        const bool added = m_backend->PollDeviceChanges();
+
+        if (m_resetProbeBackoff.exchange(false, std::memory_order_acquire) || added) {
+            for (Slot& slot : m_slots) {
+                slot.nextProbeNs = 0;
+                slot.probeIntervalNs = m_minProbeIntervalNs;
+            }
+        }
+
+        std::array<bool, (size_t)GamepadID::Max> polled{};
+        std::array<GamepadSample, (size_t)GamepadID::Max> previous{};
+        for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) previous[i] = { 0, m_slots[i].state, (GamepadID)i, m_slots[i].connected };
+
+        for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) {
+            Slot& slot = m_slots[i];
+            if (!slot.connected) continue;
+
+            polled[i] = true;
+            if (!m_backend->Poll((GamepadID)i, slot.state)) Disconnect(slot, timeNs);
+        }
+
+        // One empty slot per update, so a frame never waits for more than one slow probe. 
+        // Probing is cheap when the backend is told about new devices, so then every slot that is due is.
+        for (uint32_t n = 0; n < (uint32_t)GamepadID::Max; n++) {
+            const uint32_t i = (m_nextProbeSlot + n) % (uint32_t)GamepadID::Max;
+            Slot& slot = m_slots[i];
+            if (slot.connected || polled[i] || slot.nextProbeNs > timeNs) continue;
+
+            m_nextProbeSlot = (i + 1) % (uint32_t)GamepadID::Max;
+
+            if (m_backend->Poll((GamepadID)i, slot.state)) {
+                slot.connected = true;
+            }
+            else if (notifies) {
+                slot.state = NativeGamepadState{};
+                slot.nextProbeNs = UINT64_MAX;
+            }
+            else {
+                slot.state = NativeGamepadState{};
+                slot.nextProbeNs = timeNs + slot.probeIntervalNs;
+                slot.probeIntervalNs = std::min(slot.probeIntervalNs * 2, m_maxProbeIntervalNs);
+            }
+
+            if (!notifies) break;
+        }
+
+        for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) {
+            const Slot& slot = m_slots[i];
+            const GamepadSample sample{ timeNs, slot.state, (GamepadID)i, slot.connected };
+            Publish(sample);
+
+            if (slot.connected != previous[i].connected || !SameInput(slot.state, previous[i].state)) onSample(sample);
+        }
+    }
+
+    void GamepadManager::Disconnect(Slot& slot, uint64_t timeNs) {
+        slot.connected = false;
+        slot.state = NativeGamepadState{};
+        // Often the cable only wiggled, so look for it again soon. A backend with device notifications reports it when it is back.
+        slot.probeIntervalNs = m_minProbeIntervalNs;
+        slot.nextProbeNs = m_backend->HasDeviceNotifications() ? UINT64_MAX : timeNs + m_minProbeIntervalNs;
+    }
+
+    void GamepadManager::Publish(const GamepadSample& sample) {
+        PublishedSample& published = m_published[(size_t)sample.gid];
+
+        uint64_t words[sizeof(GamepadSample) / 8];
+        std::memcpy(words, &sample, sizeof(GamepadSample));
+
+        const uint32_t sequence = published.sequence.load(std::memory_order_relaxed);
+        published.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < published.words.size(); i++) published.words[i].store(words[i], std::memory_order_relaxed);
+
+        published.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    GamepadSample GamepadManager::GetLatestSample(GamepadID gid) const {
+        const PublishedSample& published = m_published[(size_t)gid];
+
+        uint64_t words[sizeof(GamepadSample) / 8];
+        for (;;) {
+            const uint32_t before = published.sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+
+            for (size_t i = 0; i < published.words.size(); i++) words[i] = published.words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (published.sequence.load(std::memory_order_relaxed) == before) break;
+        }
+
+        GamepadSample sample;
+        std::memcpy(&sample, words, sizeof(GamepadSample));
+        sample.gid = gid;
+        return sample;
+    }
+
+    void GamepadManager::ApplySample(const GamepadSample& sample) {
+        GamepadSample& current = m_current[(size_t)sample.gid];
+        if (sample.connected == current.connected && SameInput(sample.state, current.state)) return;
+
+        const GamepadSample previous = current;
+        current = sample;
+
+        m_history[m_historyCount % m_history.size()] = sample;
+        m_historyCount++;
+
+        // A gamepad that was just connected presses what it holds, one that was disconnected releases it.
+        if (sample.connected && !previous.connected) m_connectedCallback(sample.gid, true);
+        if (m_buttonCallback || m_axisCallback) ReportChanges(sample.gid, previous.connected ? previous.state : s_emptyState, sample.connected ? sample.state : s_emptyState);
+        if (!sample.connected && previous.connected) m_connectedCallback(sample.gid, false);
+    }
+
+    void GamepadManager::ReportChanges(GamepadID gid, const NativeGamepadState& previous, const NativeGamepadState& current) {
+        if (SameInput(previous, current)) return;
+
+        if (m_buttonCallback) {
+            // Only the bits that changed are visited.
+            for (uint32_t changed = (uint32_t)(previous.Gamepad.wButtons ^ current.Gamepad.wButtons); changed; changed &= changed - 1) {
+                const uint32_t bit = 1u << CountTrailingZeros(changed);
+                m_buttonCallback(gid, (GamepadButton)bit, current.Gamepad.wButtons & bit ? InputState::Down : InputState::Up);
+            }
+        }
+
+        if (m_axisCallback) {
+            GamepadAxes axes;
+            NormalizeGamepadAxes(&current, &axes, 1);
+            GamepadAxes& reported = m_reportedAxes[(size_t)gid];
+
+            for (uint32_t i = 0; i < (uint32_t)GamepadAxis::Max; i++) {
+                if (axes[i] == reported[i]) continue;
+
+                // Rest and the ends of the range are always reported, so the last value a game sees for a released stick is 0.
+                const bool settled = axes[i] == 0.0f || std::fabs(axes[i]) == 1.0f;
+                if (!settled && std::fabs(axes[i] - reported[i]) < m_axisThreshold) continue;
+
+                reported[i] = axes[i];
+                m_axisCallback(gid, (GamepadAxis)i, axes[i]);
+            }
+        }
+    }
+
+    uint64_t GamepadManager::GetUpdateCount() const { return m_updateCount; }
+
+    const GamepadAxes& GamepadManager::GetAxes(GamepadID gid) const { return m_axes[(size_t)gid]; }
+
+    bool GamepadManager::IsConnected(GamepadID gid) const { return m_current[(size_t)gid].connected; }
+
+    const NativeGamepadState& GamepadManager::GetState(GamepadID gid) const { 
+        const GamepadSample& sample = m_current[(size_t)gid];
+        return sample.connected ? sample.state : s_emptyState;
+    }
+
+    void GamepadManager::Rumble(GamepadID gid, float rumble) {
+        if (!m_current[(size_t)gid].connected) return;
+
+        std::lock_guard<std::mutex> lock(m_backendMutex);
+        m_backend->Rumble(gid, rumble);
+    }
+
+    static void ApplyPollingThreadInfo(const GamepadPollingInfo& info) {
+#if defined(_WIN32)
+        if (info.realtimePriority) 
+            IWINDOW_CHECK_ERROR(!::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL), ErrorType::WindowApi, ErrorSeverity::Warning, "SetThreadPriority() failed. The gamepad polling thread keeps normal priority.", false, );
+
+        if (info.affinityMask)
+            IWINDOW_CHECK_ERROR(!::SetThreadAffinityMask(::GetCurrentThread(), (DWORD_PTR)info.affinityMask), ErrorType::WindowApi, ErrorSeverity::Warning, "SetThreadAffinityMask() failed. The gamepad polling thread can run on any CPU.", false, );
+#else
+        if (info.realtimePriority) {
+            sched_param param{};
+            param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+            IWINDOW_CHECK_ERROR(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0, ErrorType::WindowApi, ErrorSeverity::Warning, "pthread_setschedparam() failed. The gamepad polling thread keeps normal priority.", false, );
+        }
+
+        if (info.affinityMask) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (size_t cpu = 0; cpu < 64; cpu++)
+                if (info.affinityMask & (1ull << cpu)) CPU_SET(cpu, &cpus);
+
+            IWINDOW_CHECK_ERROR(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0, ErrorType::WindowApi, ErrorSeverity::Warning, "pthread_setaffinity_np() failed. The gamepad polling thread can run on any CPU.", false, );
+        }
+#endif
+    }
+
+    bool GamepadManager::StartPollingThread(const GamepadPollingInfo& info) {
+        IWINDOW_CHECK_ERROR(m_pollingThread, ErrorType::WindowApi, ErrorSeverity::Warning, "The gamepad polling thread is already running.", true, false);
+        IWINDOW_CHECK_ERROR(info.rate <= 0.0, ErrorType::WindowApi, ErrorSeverity::Error, "IWindow::GamepadPollingInfo::rate has to be above 0.", true, false);
+
+        m_pollingThread = std::make_unique<PollingThread>(info);
+        m_pollingThread->thread = std::thread([this] { RunPollingThread(); });
+
+        return true;
+    }
+
+    void GamepadManager::StopPollingThread() {
+        if (!m_pollingThread) return;
+
+        PollingThread& thread = *m_pollingThread;
+        {
+            std::lock_guard<std::mutex> lock(thread.mutex);
+            thread.stop.store(true, std::memory_order_relaxed);
+        }
+        thread.wake.notify_one();
+        thread.thread.join();
+
+        // Whatever the thread read last is still handed out by the next update.
+        GamepadSample sample{};
+        while (thread.samples.Pop(sample)) ApplySample(sample);
+        for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) ApplySample(GetLatestSample((GamepadID)i));
+        NormalizeAxes();
+
+        m_pollingThread.reset();
+    }
+
+    bool GamepadManager::IsPollingThreadRunning() const { return (bool)m_pollingThread; }
+
+    void GamepadManager::RunPollingThread() {
+        PollingThread& thread = *m_pollingThread;
+        ApplyPollingThreadInfo(thread.info);
+
+        const std::chrono::nanoseconds period{ (int64_t)(1'000'000'000.0 / thread.info.rate) };
+        std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(m_backendMutex);
+                PollSlots(IWindow::GetTimeNs(), [&thread](const GamepadSample& sample) {
+                    if (!thread.samples.Push(sample)) thread.dropped.store(true, std::memory_order_release);
+                });
+            }
+
+            // A late wake-up doesn't make the next readings come faster to catch up.
+            next = std::max(next + period, std::chrono::steady_clock::now());
+
+            std::unique_lock<std::mutex> lock(thread.mutex);
+            if (thread.wake.wait_until(lock, next, [&thread] { return thread.stop.load(std::memory_order_relaxed); })) return;
+        }
+    }
+
+    size_t GamepadManager::GetHistory(GamepadID gid, uint64_t sinceNs, GamepadSample* samples, size_t count) const {
+        // Walks from the newest sample back, then turns the copies around.
+        size_t copied = 0;
+        const uint64_t kept = std::min<uint64_t>(m_historyCount, m_history.size());
+        for (uint64_t n = 0; n < kept && copied < count; n++) {
+            const GamepadSample& sample = m_history[(m_historyCount - 1 - n) % m_history.size()];
+            if (sample.timestamp <= sinceNs) break;
+            if (sample.gid == gid) samples[copied++] = sample;
+        }
+
+        std::reverse(samples, samples + copied);
+        return copied;
+    }
+
+    void GamepadManager::SetHistoryCapacity(uint32_t capacity) {
+        m_history.assign(std::max(capacity, 1u), GamepadSample{});
+        m_historyCount = 0;
+    }
+
+    void GamepadManager::SetProbeInterval(uint64_t minNs, uint64_t maxNs) {
+        std::lock_guard<std::mutex> lock(m_backendMutex);
+
+        m_minProbeIntervalNs = minNs;
+        m_maxProbeIntervalNs = std::max(minNs, maxNs);
+
+        for (Slot& slot : m_slots) slot.probeIntervalNs = std::clamp(slot.probeIntervalNs, m_minProbeIntervalNs, m_maxProbeIntervalNs);
+    }
+
+    void GamepadManager::ResetProbeBackoff() { m_resetProbeBackoff.store(true, std::memory_order_release); }
+
+    void GamepadManager::SetConnectedCallback(GamepadConnectedCallback callback) { m_connectedCallback = std::move(callback); }
+
+    GamepadButtonCallback GamepadManager::SetButtonCallback(GamepadButtonCallback callback) {
+        GamepadButtonCallback oldCallback = std::move(m_buttonCallback);
+        m_buttonCallback = std::move(callback);
+        return oldCallback;
+    }
+
+    GamepadAxisCallback GamepadManager::SetAxisCallback(GamepadAxisCallback callback) {
+        GamepadAxisCallback oldCallback = std::move(m_axisCallback);
+        m_axisCallback = std::move(callback);
+        // The new callback hears about axes that move from here.
+        m_reportedAxes = m_axes;
+        return oldCallback;
+    }
+
+    void GamepadManager::SetAxisThreshold(float threshold) { m_axisThreshold = threshold; }
+
+    float GamepadManager::GetAxisThreshold() const { return m_axisThreshold; }
+}
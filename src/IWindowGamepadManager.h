@@ -0,0 +1,291 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "IWindowCodes.h"
+#include "IWindowPlatform.h"
+#include "IWindowCore.h"
+#include "IWindowDelegate.h"
+#include "IWindowGamepadAxes.h"
+
+namespace IWindow {
+    typedef Delegate<void(GamepadID, bool)> GamepadConnectedCallback;
+    typedef Delegate<void(GamepadID, GamepadButton, InputState)> GamepadButtonCallback;
+    // Sticks from -1 to 1 with up positive, triggers from 0 to 1. Without a deadzone.
+    typedef Delegate<void(GamepadID, GamepadAxis, float)> GamepadAxisCallback;
+
+    /// <summary>
+    /// One reading of a gamepad slot that changed it. See GamepadManager::GetHistory and GamepadManager::GetLatestSample.
+    /// </summary>
+    struct GamepadSample {
+        // When the slot was read, on IWindow::GetTimeNs or the clock given to GamepadManager::Update.
+        uint64_t timestamp;
+        // Empty if the gamepad isn't connected.
+        NativeGamepadState state;
+        GamepadID gid;
+        bool connected;
+    };
+
+    static_assert(std::is_trivially_copyable<GamepadSample>::value && sizeof(GamepadSample) % 8 == 0, "IWindow::GamepadSample is published in 64 bit words.");
+
+    /// <summary>
+    /// Settings for IWindow::GamepadManager::StartPollingThread.
+    /// </summary>
+    struct GamepadPollingInfo {
+        // Readings of every gamepad per second. The OS timer has to be fine enough for it, on Windows raise it with timeBeginPeriod.
+        double rate = 1000.0;
+        // Samples the polling thread can hand to GamepadManager::Update between two updates. Rounded up to a power of two.
+        // Samples that don't fit are dropped and the update continues from the latest state.
+        uint32_t sampleCapacity = 1024;
+        // Run the thread with real-time priority (THREAD_PRIORITY_TIME_CRITICAL on Windows, SCHED_FIFO on Linux). Like IWindow::InputThreadInfo.
+        bool realtimePriority = false;
+        // Bit n pins the thread to CPU n. 0 lets the OS choose.
+        uint64_t affinityMask = 0;
+    };
+
+    /// <summary>
+    /// Reads gamepads from the OS for IWindow::GamepadManager: XInput on Win32 and the injected gamepads of IWindow::Null with the null backend.
+    /// Tests and benchmarks can replace it with GamepadManager::SetBackend, e.g. with one that counts the calls.
+    /// </summary>
+    class IWINDOW_API GamepadBackend {
+    public:
+        virtual ~GamepadBackend() = default;
+
+        /// <summary>
+        /// Reads the state of the gamepad in a slot. Called once per update for connected gamepads and on a backoff schedule for empty slots.
+        /// </summary>
+        /// <returns>
+        /// true if a gamepad is in the slot.
+        /// false if the slot is empty. state is ignored then.
+        /// </returns>
+        virtual bool Poll(GamepadID gid, NativeGamepadState& state) = 0;
+
+        /// <summary>
+        /// 0.0f = cancel, 1.0f max speed.
+        /// </summary>
+        virtual void Rumble(GamepadID gid, float rumble) = 0;
+
+        /// <returns>
+        /// true if the OS tells the backend about new devices, e.g. with inotify. Empty slots are then only probed after PollDeviceChanges returned true, never on a timer.
+        /// false by default.
+        /// </returns>
+        virtual bool HasDeviceNotifications() { return false; }
+        /// <summary>
+        /// Called at the start of every update.
+        /// </summary>
+        /// <returns>true if a device was added since the last call, so the empty slots are probed.</returns>
+        virtual bool PollDeviceChanges() { return false; }
+    };
+
+    /// <summary>
+    /// Process-wide gamepad state that every IWindow::Gamepad reads.
+    /// GamepadManager::Update polls each connected gamepad once and probes at most one empty slot. Asking the driver about an empty slot is slow, 
+    /// close to a millisecond with XInput, so an empty slot is probed again after a backoff that doubles with every probe that finds nothing, 
+    /// from 250 milliseconds up to 2 seconds by default (GamepadManager::SetProbeInterval). 
+    /// GamepadManager::ResetProbeBackoff makes the next updates probe every empty slot, e.g. when the OS reports a new device. Win32 windows call it on WM_DEVICECHANGE.
+    /// Backends that are told about new devices (GamepadBackend::HasDeviceNotifications), like evdev with inotify, have their empty slots probed only then, all in the same update.
+    /// Gamepad::Update updates the manager once per frame however many gamepads call it, or call GamepadManager::Update yourself once per frame.
+    /// The button and axis callbacks are called from GamepadManager::Update for what changed since the last update, found by comparing the states. 
+    /// A gamepad that is connected or disconnected changes from or to the empty state, so nothing stays held.
+    /// Only one thread may update and read the manager. ResetProbeBackoff and GetLatestSample may be called from any thread. Gamepads must not be updated from the callbacks.
+    /// 
+    /// By default the gamepads are read by GamepadManager::Update, so they are as fresh as the frame. GamepadManager::StartPollingThread reads them on a thread
+    /// of its own at a fixed rate instead. Every reading that changed a gamepad is handed to the next update through a lock-free queue, so the callbacks 
+    /// see presses shorter than a frame, and GamepadManager::GetHistory keeps the timestamped readings.
+    /// </summary>
+    class IWINDOW_API GamepadManager {
+    public:
+        static constexpr uint64_t DEFAULT_MIN_PROBE_INTERVAL_NS = 250'000'000;
+        static constexpr uint64_t DEFAULT_MAX_PROBE_INTERVAL_NS = 2'000'000'000;
+
+        static GamepadManager& Get();
+
+        ~GamepadManager();
+
+        GamepadManager(const GamepadManager&) = delete;
+        GamepadManager& operator=(const GamepadManager&) = delete;
+
+        /// <summary>
+        /// Read gamepads from another backend. Forgets every gamepad without calling the connected callback, the next updates probe all slots again.
+        /// Stops the polling thread.
+        /// </summary>
+        /// <param name="backend">Has to live until it is replaced. nullptr goes back to the backend of the platform.</param>
+        void SetBackend(GamepadBackend* backend);
+        GamepadBackend& GetBackend();
+
+        /// <summary>
+        /// Polls the connected gamepads and probes the next empty slot that is due. Calls the connected callback for every gamepad that was connected or disconnected.
+        /// With the polling thread it takes the thread's samples instead and calls the callbacks for each of them in order.
+        /// </summary>
+        void Update();
+        /// <summary>
+        /// Update at a time on IWindow::GetTimeNs, or on any other clock in nanoseconds that is used for every update. Lets tests step through the probe schedule.
+        /// The polling thread uses IWindow::GetTimeNs.
+        /// </summary>
+        void Update(uint64_t timeNs);
+        /// <returns>How many times the manager was updated. Gamepad::Update uses it to find out if the manager was updated this frame.</returns>
+        uint64_t GetUpdateCount() const;
+
+        bool IsConnected(GamepadID gid) const;
+        /// <returns>The state of the gamepad at the last update. Empty if it isn't connected.</returns>
+        const NativeGamepadState& GetState(GamepadID gid) const;
+        /// <returns>The axes of the gamepad at the last update as floats, without a deadzone. All gamepads are converted together once per update.</returns>
+        const GamepadAxes& GetAxes(GamepadID gid) const;
+        /// <summary>
+        /// 0.0f = cancel, 1.0f max speed. Does nothing if the gamepad isn't connected.
+        /// </summary>
+        void Rumble(GamepadID gid, float rumble);
+
+        /// <summary>
+        /// Reads the gamepads on a thread at info.rate until GamepadManager::StopPollingThread. 
+        /// </summary>
+        /// <returns>false if the thread is already running.</returns>
+        bool StartPollingThread(const GamepadPollingInfo& info = {});
+        void StopPollingThread();
+        bool IsPollingThreadRunning() const;
+
+        /// <summary>
+        /// Gets the newest reading of a gamepad without waiting for an update, e.g. right before rendering. May be called from any thread.
+        /// With the polling thread it is at most one polling interval old, otherwise it is the reading of the last update.
+        /// </summary>
+        GamepadSample GetLatestSample(GamepadID gid) const;
+        /// <summary>
+        /// Copies the readings of a gamepad after a time, oldest first. Only the newest GamepadManager::SetHistoryCapacity readings of all gamepads are kept.
+        /// </summary>
+        /// <param name="sinceNs">Readings with this timestamp or older are skipped, e.g. the time of the last frame.</param>
+        /// <param name="samples">Gets at most count readings, the newest ones if there are more.</param>
+        /// <returns>The number of readings copied.</returns>
+        size_t GetHistory(GamepadID gid, uint64_t sinceNs, GamepadSample* samples, size_t count) const;
+        /// <summary>
+        /// Set how many readings GetHistory keeps, 256 by default. Clears the history.
+        /// </summary>
+        void SetHistoryCapacity(uint32_t capacity);
+
+        /// <summary>
+        /// Set how long an empty slot waits between probes. The wait starts at minNs and doubles with every probe that finds nothing, up to maxNs.
+        /// A slot whose gamepad was disconnected starts at minNs again.
+        /// </summary>
+        void SetProbeInterval(uint64_t minNs, uint64_t maxNs);
+        /// <summary>
+        /// Makes the next updates probe every empty slot, one per update, and starts their backoff again. May be called from any thread.
+        /// </summary>
+        void ResetProbeBackoff();
+
+        void SetConnectedCallback(GamepadConnectedCallback callback);
+        /// <summary>
+        /// Called for every button that was pressed or released. The changed buttons are found 16 at a time by XOR-ing the button masks.
+        /// </summary>
+        /// <returns>The callback that was set before.</returns>
+        GamepadButtonCallback SetButtonCallback(GamepadButtonCallback callback);
+        /// <summary>
+        /// Called for every axis that moved at least the axis threshold since it was last reported, or came to rest at 0 or to the end of its range.
+        /// Axes are compared with their values when the callback was set.
+        /// </summary>
+        /// <returns>The callback that was set before.</returns>
+        GamepadAxisCallback SetAxisCallback(GamepadAxisCallback callback);
+        /// <summary>
+        /// Set how far an axis has to move before the axis callback is called again, 0.01 by default. Small values report the noise of worn sticks.
+        /// </summary>
+        void SetAxisThreshold(float threshold);
+        float GetAxisThreshold() const;
+    private:
+        GamepadManager();
+
+        // XInput on Win32, IWindow::Null's gamepads with the null backend. Defined in the backend's gamepad file.
+        static GamepadBackend& GetPlatformBackend();
+
+        struct Slot {
+            NativeGamepadState state;
+            bool connected;
+            // When the empty slot is probed next, on the clock Update was given.
+            uint64_t nextProbeNs;
+            uint64_t probeIntervalNs;
+        };
+
+        // A seqlock per slot for GetLatestSample. sequence is odd while the sample is written.
+        struct alignas(64) PublishedSample {
+            std::atomic<uint32_t> sequence{ 0 };
+            std::array<std::atomic<uint64_t>, sizeof(GamepadSample) / 8> words{};
+        };
+
+        struct PollingThread;
+
+        // Reads the slots once and calls onSample for every slot that changed. Runs on the polling thread if there is one, in Update if not. 
+        // The caller holds m_backendMutex.
+        template<typename F>
+        void PollSlots(uint64_t timeNs, F&& onSample);
+        void Disconnect(Slot& slot, uint64_t timeNs);
+        void Publish(const GamepadSample& sample);
+        void RunPollingThread();
+
+        // Takes a sample into the state the getters read. Calls the callbacks and adds it to the history.
+        void ApplySample(const GamepadSample& sample);
+        // Converts the axes of every gamepad for GetAxes.
+        void NormalizeAxes();
+        // Calls the button and axis callbacks for what changed between two states of a gamepad.
+        void ReportChanges(GamepadID gid, const NativeGamepadState& previous, const NativeGamepadState& current);
+
+        GamepadBackend* m_backend;
+        // Guards the backend, the slots and the probe intervals while the polling thread runs.
+        std::mutex m_backendMutex;
+        // The poller's view of the slots.
+        std::array<Slot, (size_t)GamepadID::Max> m_slots{};
+        std::array<PublishedSample, (size_t)GamepadID::Max> m_published{};
+        std::unique_ptr<PollingThread> m_pollingThread;
+
+        // What the getters read. Changed by Update only.
+        std::array<GamepadSample, (size_t)GamepadID::Max> m_current{};
+        std::array<GamepadAxes, (size_t)GamepadID::Max> m_axes{};
+        // Ring of the last samples of every slot. m_historyCount is the number of samples ever added.
+        std::vector<GamepadSample> m_history;
+        uint64_t m_historyCount = 0;
+        // Empty slots are probed round robin from here, so a slot that is always due can't starve the others.
+        uint32_t m_nextProbeSlot = 0;
+        uint64_t m_updateCount = 0;
+
+        uint64_t m_minProbeIntervalNs = DEFAULT_MIN_PROBE_INTERVAL_NS;
+        uint64_t m_maxProbeIntervalNs = DEFAULT_MAX_PROBE_INTERVAL_NS;
+        std::atomic<bool> m_resetProbeBackoff{ false };
+
+        GamepadConnectedCallback m_connectedCallback{};
+        GamepadButtonCallback m_buttonCallback{};
+        GamepadAxisCallback m_axisCallback{};
+        float m_axisThreshold = 0.01f;
+        // The value of every axis the axis callback was last called with.
+        std::array<GamepadAxes, (size_t)GamepadID::Max> m_reportedAxes{};
+    };
+}
@@ -0,0 +1,145 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "IWindowUtils.h"
+
+#include "IWindow.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+
+namespace IWindow {
+    // Process-wide cache of the monitors. Guarded by s_monitorMutex because windows with an input thread read and drop it on their own thread.
+    static std::mutex s_monitorMutex;
+    static std::vector<Monitor> s_monitors{};
+    static bool s_monitorsValid = false;
+    static uint64_t s_monitorGeneration = 0;
+
+    bool Monitor::LoadCache() {
+        // A failed query already reported its error and is tried again on the next call.
+        if (s_monitorsValid) return true;
+
+        std::vector<Monitor> monitors{};
+        if (!QueryMonitorsNative(monitors)) return false;
+
+        s_monitors = std::move(monitors);
+        s_monitorsValid = true;
+        return true;
+    }
+
+    std::vector<Monitor> Monitor::GetAllMonitors() {
+        std::lock_guard<std::mutex> lock(s_monitorMutex);
+        return LoadCache() ? s_monitors : std::vector<Monitor>{};
+    }
+
+    Monitor Monitor::GetPrimaryMonitor() {
+        std::lock_guard<std::mutex> lock(s_monitorMutex);
+        IWINDOW_CHECK_ERROR(!LoadCache() || s_monitors.empty(), ErrorType::Monitor, ErrorSeverity::Error, "There are no monitors. Failed to get primary monitor!", true, Monitor{});
+
+        return s_monitors[0];
+    }
+
+    bool Monitor::FindMonitor(uint64_t id, Monitor& monitor) {
+        for (Monitor& connected : GetAllMonitors()) {
+            if (connected.id != id) continue;
+
+            monitor = std::move(connected);
+            return true;
+        }
+
+        return false;
+    }
+
+    void Monitor::InvalidateCache() {
+        std::lock_guard<std::mutex> lock(s_monitorMutex);
+        s_monitorsValid = false;
+        s_monitorGeneration++;
+    }
+
+    uint64_t Monitor::GetCacheGeneration() {
+        std::lock_guard<std::mutex> lock(s_monitorMutex);
+        return s_monitorGeneration;
+    }
+
+    uint64_t Monitor::IdFromName(const std::string& name) {
+        // FNV-1a. 0 is kept for empty monitors.
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : name) {
+            hash ^= (uint8_t)c;
+            hash *= 1099511628211ull;
+        }
+
+        return hash ? hash : 1;
+    }
+
+    std::vector<VideoMode> Monitor::GetVideoModes() const {
+        std::vector<VideoMode> modes{};
+        if (!GetVideoModesNative(modes)) return {};
+
+        std::sort(modes.begin(), modes.end(), [](const VideoMode& left, const VideoMode& right) {
+            if (left.size.width != right.size.width) return left.size.width < right.size.width;
+            if (left.size.height != right.size.height) return left.size.height < right.size.height;
+            if (left.refreshRate != right.refreshRate) return left.refreshRate < right.refreshRate;
+            return left.bitsPerPixel < right.bitsPerPixel;
+        });
+
+        // The OS lists a mode once per scaling and interlacing option.
+        modes.erase(std::unique(modes.begin(), modes.end(), [](const VideoMode& left, const VideoMode& right) {
+            return left.size.width == right.size.width && left.size.height == right.size.height && left.refreshRate == right.refreshRate && left.bitsPerPixel == right.bitsPerPixel;
+        }), modes.end());
+
+        return modes;
+    }
+
+    VideoMode Monitor::GetCurrentVideoMode() const {
+        VideoMode mode{};
+        return GetCurrentVideoModeNative(mode) ? mode : VideoMode{};
+    }
+
+    VideoMode Monitor::GetClosestVideoMode(const Vector2<int32_t>& size, double refreshRate) const {
+        VideoMode closest{};
+        int64_t closestSize = INT64_MAX;
+        double closestRefreshRate = 0.0;
+
+        for (const VideoMode& mode : GetVideoModes()) {
+            const int64_t sizeDifference = std::llabs((int64_t)mode.size.width - size.width) + std::llabs((int64_t)mode.size.height - size.height);
+            const double refreshRateDifference = std::abs(mode.refreshRate - refreshRate);
+
+            // Modes are sorted by bits per pixel last, so ties go to the most bits.
+            if (sizeDifference < closestSize || (sizeDifference == closestSize && refreshRateDifference <= closestRefreshRate)) {
+                closest = mode;
+                closestSize = sizeDifference;
+                closestRefreshRate = refreshRateDifference;
+            }
+        }
+
+        return closest;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,575 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_NULL)
+
+#include "IWindowNull.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+
+#if defined(__linux__)
+#include "IWindowUtilsLinux.h"
+#endif
+
+namespace IWindow {
+    // Ids start at 1 so a window that was never created never compares equal to one that was.
+    static uint64_t s_nextWindowID = 1;
+
+    // Shared by every window like a real clipboard.
+    static std::string s_clipboardText{};
+
+    // Guards the events and woken flag of every DeviceContext. Every wait of the null backend sleeps on s_eventCondition 
+    // so IWindow::PostEmptyEvent can wake all of them without knowing the windows. s_emptyEventCount is guarded by s_eventMutex too.
+    static std::mutex s_eventMutex;
+    static std::condition_variable s_eventCondition;
+    static uint64_t s_emptyEventCount;
+
+#if defined(__linux__)
+    // The fd of IWindow::GetEventFd. Null::PushEvent makes it readable.
+    static int GetPushEventFd() {
+        static const int pushEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        return pushEventFd;
+    }
+#endif
+
+    namespace Null {
+        void PushEvent(Window& window, const Event& event) {
+            DeviceContext* deviceContext = window.GetNativeDeviceContext();
+
+            IWINDOW_CHECK_ERROR(!deviceContext, ErrorType::WindowApi, ErrorSeverity::Error, "IWindow::Null::PushEvent was called on a window that was not created!", true, );
+
+            // Like an OS event the event happened when it was pushed, not when the window reads it.
+            const uint64_t timestamp = event.timestamp ? event.timestamp : std::max((uint64_t)(window.GetTime() * 1'000'000.0), (uint64_t)1);
+
+            {
+                std::lock_guard<std::mutex> lock(s_eventMutex);
+                deviceContext->events.push_back(event);
+                deviceContext->events.back().timestamp = timestamp;
+            }
+
+            s_eventCondition.notify_all();
+
+#if defined(__linux__)
+            SignalEventFd(GetPushEventFd());
+#endif
+        }
+
+        void PushKeyEvent(Window& window, Key key, InputState state, KeyModifier mods) {
+            Event event{};
+            event.type = EventType::Key;
+            event.key = key;
+            event.state = state;
+            event.mods = mods;
+            PushEvent(window, event);
+        }
+
+        void PushCharEvent(Window& window, char32_t c, KeyModifier mods) {
+            Event event{};
+            event.type = EventType::Char;
+            event.character = c;
+            event.mods = mods;
+            PushEvent(window, event);
+        }
+
+        void PushMouseMoveEvent(Window& window, Vector2<int32_t> position) {
+            Event event{};
+            event.type = EventType::MouseMove;
+            event.position = position;
+            PushEvent(window, event);
+        }
+
+        void PushMouseButtonEvent(Window& window, MouseButton button, InputState state, KeyModifier mods) {
+            Event event{};
+            event.type = EventType::MouseButton;
+            event.button = button;
+            event.state = state;
+            event.mods = mods;
+            PushEvent(window, event);
+        }
+
+        void PushMouseScrollEvent(Window& window, Vector2<float> offset) {
+            Event event{};
+            event.type = EventType::MouseScroll;
+            event.scrollOffset = offset;
+            PushEvent(window, event);
+        }
+
+        void PushRawMouseMotionEvent(Window& window, Vector2<float> delta) {
+            Event event{};
+            event.type = EventType::RawMouseMotion;
+            event.scrollOffset = delta;
+            PushEvent(window, event);
+        }
+
+        void PushSizeEvent(Window& window, Vector2<int32_t> size) {
+            Event event{};
+            event.type = EventType::Size;
+            event.size = size;
+            PushEvent(window, event);
+        }
+
+        void PushFocusEvent(Window& window, bool focused) {
+            Event event{};
+            event.type = EventType::Focus;
+            event.value = focused;
+            PushEvent(window, event);
+        }
+
+        void PushCloseEvent(Window& window) {
+            Event event{};
+            event.type = EventType::Close;
+            PushEvent(window, event);
+        }
+
+        uint8_t* GetFramebuffer(Window& window) { 
+            DeviceContext* deviceContext = window.GetNativeDeviceContext();
+            return deviceContext ? deviceContext->framebuffer.data() : nullptr; 
+        }
+
+        bool SaveFramebuffer(Window& window, const std::string& path) {
+            DeviceContext* deviceContext = window.GetNativeDeviceContext();
+            if (!deviceContext) return false;
+
+            std::ofstream file{ path, std::ios::binary };
+
+            IWINDOW_CHECK_ERROR(!file, ErrorType::WindowApi, ErrorSeverity::Error, "Failed to open the file to save the framebuffer to!", true, false);
+
+            const Vector2<int32_t> size = window.GetFramebufferSize();
+            file << "P6\n" << size.width << ' ' << size.height << "\n255\n";
+
+            for (size_t i = 0; i < deviceContext->framebuffer.size(); i += 4)
+                file.write((const char*)&deviceContext->framebuffer[i], 3);
+
+            return (bool)file;
+        }
+
+        void PresentFramebuffer(Window& window) {
+            IWINDOW_CHECK_ERROR(!window.GetNativeDeviceContext(), ErrorType::WindowApi, ErrorSeverity::Error, "IWindow::Null::PresentFramebuffer was called on a window that was not created!", true, );
+
+            // Nothing shows the pixels, so the present is only the moment the frame is done.
+            window.MarkPresent();
+        }
+    }
+
+    bool Window::CreateNative(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) {
+        // User did not call IWindow::Initialize
+        std::string setVersion = GetVersion();
+
+        IWINDOW_CHECK_ERROR(setVersion == "", ErrorType::WindowApi, ErrorSeverity::Warning, "You have to call IWindow::Initialize before creating a window! The version is set the current version.", false, false);
+
+        if (setVersion == "") IWindow::Initialize(IWindow::CurrentVersion);
+
+        m_size = size;
+        m_oldSize = size;
+        m_framebufferSize = size;
+        m_position = position;
+        m_userPtr = nullptr;
+        m_running = true;
+        m_fullscreen = false;
+        m_focused = false;
+        m_mouseEntered = false;
+        m_iconified = false;
+        m_maximized = false;
+        m_mods = KeyModifier::None;
+        m_windowStyle = 0;
+        m_icon = 0;
+        m_cursor = CursorID::Arrow;
+
+        m_deviceContext = new Null::DeviceContext{};
+        m_window = s_nextWindowID++;
+
+        // for multi-window support. Windows with an input thread are created on it, so the count is atomic.
+        m_windowIndex = ++m_sWindowCount;
+
+        ResizeFramebuffer();
+
+        SetTitle(title);
+        SetStyle(style);
+
+        // Put window to middle of the screen if the user didn't provide a position.
+        if (position.IsEmpty()) {
+            Center(monitor);
+        }
+        else {
+            SetWindowPosition(position);
+        }
+
+        // Window managers focus new windows. The focus event arrives on the first update like it would on a real system.
+        if (!(NativeStyle)(style & Style::NotVisible))
+            Null::PushFocusEvent(*this, true);
+
+        AddToRegistry();
+
+        m_createTimeNs = IWindow::GetTimeNs();
+
+        m_monitorGeneration = Monitor::GetCacheGeneration();
+        m_prevMonitors = Monitor::GetAllMonitors();
+
+        return true;
+    }
+
+    void Window::DestroyNative() {
+        RemoveFromRegistry();
+
+        delete m_deviceContext;
+        m_deviceContext = nullptr;
+        m_running = false;
+    }
+
+    void Window::UpdateNative() {
+        // Null::SetMonitors dropped the monitor cache.
+        const uint64_t monitorGeneration = Monitor::GetCacheGeneration();
+        if (monitorGeneration != m_monitorGeneration) {
+            m_monitorGeneration = monitorGeneration;
+            UpdateMonitors();
+        }
+
+        // Events pushed by callbacks are handled on the next update.
+        std::deque<Null::Event> events{};
+        {
+            std::lock_guard<std::mutex> lock(s_eventMutex);
+            events.swap(m_deviceContext->events);
+        }
+
+        for (const Null::Event& event : events)
+            WindowCallback(event);
+    }
+
+    void Window::WaitForEventNative(double timeoutSeconds) {
+        // Without an input thread events usually come from this thread so waiting forever on an empty queue would never return. 
+        // A timeout bounds the wait, during which another thread may push an event or call IWindow::PostEmptyEvent.
+        if (m_inputThread || timeoutSeconds >= 0.0) {
+            std::unique_lock<std::mutex> lock(s_eventMutex);
+            const uint64_t emptyEventCount = s_emptyEventCount;
+
+            // The input thread leaves IWindow::PostEmptyEvent to the thread waiting in IWindow::WaitEvents or Window::WaitForEvent.
+            auto ready = [&] { return !m_deviceContext->events.empty() || m_deviceContext->woken || (!m_inputThread && s_emptyEventCount != emptyEventCount); };
+
+            if (timeoutSeconds < 0.0) s_eventCondition.wait(lock, ready);
+            else s_eventCondition.wait_for(lock, std::chrono::duration<double>(timeoutSeconds), ready);
+
+            m_deviceContext->woken = false;
+        }
+
+        UpdateNative();
+    }
+
+    void Window::WakeEventLoop() {
+        {
+            std::lock_guard<std::mutex> lock(s_eventMutex);
+            m_deviceContext->woken = true;
+        }
+
+        s_eventCondition.notify_all();
+    }
+
+    void Window::PostEmptyEventNative() {
+        {
+            std::lock_guard<std::mutex> lock(s_eventMutex);
+            s_emptyEventCount++;
+        }
+
+        s_eventCondition.notify_all();
+    }
+
+    void Window::PollEventsNative() {
+        // Indexed because a callback may create or destroy a window.
+        for (size_t i = 0; i < m_sWindows.size(); i++)
+            m_sWindows[i]->UpdateNative();
+    }
+
+    void Window::WaitEventsNative(double timeoutSeconds) {
+        // See Window::WaitForEventNative.
+        if (timeoutSeconds >= 0.0) {
+            std::unique_lock<std::mutex> lock(s_eventMutex);
+            const uint64_t emptyEventCount = s_emptyEventCount;
+
+            s_eventCondition.wait_for(lock, std::chrono::duration<double>(timeoutSeconds), [&] {
+                for (Window* window : m_sWindows)
+                    if (!window->m_deviceContext->events.empty()) return true;
+
+                return s_emptyEventCount != emptyEventCount;
+            });
+        }
+
+        PollEventsNative();
+    }
+
+#if defined(__linux__)
+    int GetEventFd() { return GetPushEventFd(); }
+
+    void Window::DispatchPendingNative() {
+        DrainEventFd(GetPushEventFd());
+
+        PollEventsNative();
+
+        // Events pushed by callbacks are handled on the next update so the fd has to stay readable for them.
+        std::lock_guard<std::mutex> lock(s_eventMutex);
+        for (Window* window : m_sWindows) {
+            if (!window->m_deviceContext->events.empty()) {
+                SignalEventFd(GetPushEventFd());
+                break;
+            }
+        }
+    }
+#endif
+
+    void Window::ResizeFramebuffer() {
+        const size_t width = (size_t)std::max(m_framebufferSize.width, 0);
+        const size_t height = (size_t)std::max(m_framebufferSize.height, 0);
+
+        // The contents of a resized window are undefined on every backend. Clearing them keeps the output deterministic.
+        m_deviceContext->framebuffer.assign(width * height * 4, 0);
+    }
+
+    void Window::WindowCallback(const Null::Event& event) {
+        m_eventTimestamp = event.timestamp;
+
+        switch (event.type)
+        {
+        case Null::EventType::Key: {
+            if (event.key >= Key::Max) break;
+
+            m_mods = event.mods;
+
+            // A press while the key is still down is a repeat.
+            bool repeat = event.state == InputState::Down && m_keys.Test((size_t)event.key);
+
+            m_keys.Set((size_t)event.key, event.state == InputState::Down);
+
+            EmitKeyEvent(event.key, m_mods, event.state, repeat);
+
+            break;
+        }
+        case Null::EventType::Char: {
+            EmitCharEvent(event.character, event.mods);
+            break;
+        }
+        case Null::EventType::MouseMove: {
+            m_mousePosition = event.position;
+            EmitMouseMoveEvent(m_mousePosition);
+
+            break;
+        }
+        case Null::EventType::MouseButton: {
+            if (event.button >= MouseButton::Max) break;
+
+            m_mods = event.mods;
+
+            m_mouseButtons.Set((size_t)event.button, event.state == InputState::Down);
+            EmitMouseButtonEvent(event.button, m_mods, event.state);
+
+            break;
+        }
+        case Null::EventType::MouseScroll: {
+            m_scrollOffset = event.scrollOffset;
+            EmitMouseScrollEvent(m_scrollOffset);
+
+            break;
+        }
+        case Null::EventType::RawMouseMotion: {
+            if (m_rawMouseMotion) EmitRawMouseMotionEvent(event.scrollOffset);
+
+            break;
+        }
+        case Null::EventType::MouseEntered: {
+            m_mouseEntered = event.value;
+            EmitMouseEnteredEvent(m_mouseEntered);
+
+            break;
+        }
+        case Null::EventType::Focus: {
+            m_focused = event.value;
+            EmitWindowFocusEvent(m_focused);
+
+            break;
+        }
+        case Null::EventType::Position: {
+            if (event.position.x == m_position.x && event.position.y == m_position.y) break;
+
+            m_position = event.position;
+            EmitWindowPosEvent(m_position);
+
+            break;
+        }
+        case Null::EventType::Size: {
+            if (event.size.width == m_size.width && event.size.height == m_size.height) break;
+
+            // There is no scaling so framebuffer size and window size are the same.
+            m_size = event.size;
+            m_framebufferSize = m_size;
+            ResizeFramebuffer();
+
+            EmitWindowSizeEvent(m_size);
+            EmitFramebufferSizeEvent(m_framebufferSize);
+
+            break;
+        }
+        case Null::EventType::Iconified: {
+            m_iconified = event.value;
+            EmitWindowIconifiedEvent(m_iconified);
+
+            break;
+        }
+        case Null::EventType::Maximized: {
+            m_maximized = event.value;
+            EmitWindowMaximizedEvent(m_maximized);
+
+            break;
+        }
+        case Null::EventType::PathDrop: {
+            std::vector<std::wstring> paths = event.paths;
+
+            m_mousePosition = event.position;
+            EmitMouseMoveEvent(m_mousePosition);
+            EmitPathDropEvent(paths, m_mousePosition);
+
+            break;
+        }
+        case Null::EventType::DPIChanged: {
+            EmitDPIChangedEvent(event.dpi);
+            break;
+        }
+        case Null::EventType::Close: {
+            m_running = false;
+            break;
+        }
+        default:
+            break;
+        }
+
+        m_eventTimestamp = 0;
+    }
+
+    void Window::SetWindowSize(const Vector2<int32_t>& size) {
+        if (size.width == m_size.width && size.height == m_size.height) return;
+
+        // Applied right away like SetWindowPos on Win32 which sends WM_SIZE before returning.
+        m_size = size;
+        m_framebufferSize = size;
+        ResizeFramebuffer();
+
+        EmitWindowSizeEvent(m_size);
+        EmitFramebufferSizeEvent(m_framebufferSize);
+    }
+
+    void Window::SetWindowPosition(const Vector2<int32_t>& position) {
+        if (position.x == m_position.x && position.y == m_position.y) return;
+
+        m_position = position;
+        EmitWindowPosEvent(m_position);
+    }
+
+    void Window::SetMousePosition(const Vector2<int32_t>& position) { m_mousePosition = position; }
+
+    void Window::Fullscreen(bool fullscreen, Monitor monitor) {
+        if (m_fullscreen == fullscreen)
+            return;
+
+        m_fullscreen = fullscreen;
+
+        // No fullscreen
+        if (!m_fullscreen) {
+            RestoreVideoMode();
+            SetWindowSize(m_oldSize);
+            Center(monitor);
+            return;
+        }
+
+        // Fullscreen
+        m_oldSize = m_size;
+
+        SetWindowPosition(monitor.position);
+        SetWindowSize(monitor.size);
+    }
+
+    void Window::SetIcon(Image) { m_icon = 1; }
+
+    void Window::SetCursor(Image, Vector2<int32_t>) { m_cursor = CursorID::Max; }
+
+    void Window::SetIcon(IconID) { m_icon = 0; }
+
+    void Window::SetCursor(CursorID cursorID) { m_cursor = cursorID; }
+
+    bool Window::SetRawMouseMotionNative(bool enabled) {
+        m_rawMouseMotion = enabled;
+        return enabled;
+    }
+
+    bool Window::IsRawMouseMotionSupportedNative() const { return true; }
+
+    std::string Window::GetClipboardText() const { return s_clipboardText; }
+
+    void Window::SetClipboardText(const std::string& text) { s_clipboardText = text; }
+
+    void Window::SetTitle(const std::wstring& title) { m_title = title; }
+
+    void Window::SetStyle(Style style) {
+        // All styles ignored when in fullscreen.
+        if (m_fullscreen) return;
+
+        // m_windowStyle stores IWindow::Style::Resizable, IWindow::Style::Decorated and IWindow::Style::Visible.
+        if ((NativeStyle)(style & Style::Default)) {
+            m_windowStyle = (NativeStyle)(Style::Resizable | Style::Decorated | Style::Visible);
+        }
+
+        if ((NativeStyle)(style & Style::Resizable)) {
+            m_windowStyle |= (NativeStyle)Style::Resizable;
+        }
+        if ((NativeStyle)(style & Style::NotResizable)) {
+            m_windowStyle &= ~(NativeStyle)Style::Resizable;
+        }
+
+        if ((NativeStyle)(style & Style::Visible)) {
+            m_windowStyle |= (NativeStyle)Style::Visible;
+        }
+        if ((NativeStyle)(style & Style::NotVisible)) {
+            m_windowStyle &= ~(NativeStyle)Style::Visible;
+        }
+
+        if ((NativeStyle)(style & Style::Decorated)) {
+            m_windowStyle |= (NativeStyle)Style::Decorated;
+        }
+        if ((NativeStyle)(style & Style::NotDecorated)) {
+            m_windowStyle &= ~(NativeStyle)Style::Decorated;
+        }
+
+        if ((NativeStyle)(style & Style::Maximize) && !m_maximized) {
+            m_maximized = true;
+            EmitWindowMaximizedEvent(m_maximized);
+        }
+        if ((NativeStyle)(style & Style::Restore) && m_maximized) {
+            m_maximized = false;
+            EmitWindowMaximizedEvent(m_maximized);
+        }
+    }
+}
+#endif
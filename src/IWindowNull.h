@@ -0,0 +1,165 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+// The null backend has no window system. Windows, monitors and gamepads only exist in memory, 
+// which makes it usable on CI machines and servers without a display.
+// Input is injected with the functions below and read back with Window::Update like on any other backend.
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "IWindow.h"
+#include "IWindowGamepad.h"
+
+namespace IWindow {
+    namespace Null {
+        enum struct EventType {
+            Key,
+            Char,
+            MouseMove,
+            MouseButton,
+            MouseScroll,
+            MouseEntered,
+            Focus,
+            Position,
+            Size,
+            Iconified,
+            Maximized,
+            PathDrop,
+            DPIChanged,
+            RawMouseMotion,
+            Close,
+            Max
+        };
+
+        /// <summary>
+        /// A synthetic event. Only the members used by type have to be set.
+        /// </summary>
+        struct Event {
+            EventType type;
+            // Reported as IWindow::Event::timestamp. 0 uses the time of the push.
+            uint64_t timestamp;
+
+            // Key, Char and MouseButton
+            Key key;
+            MouseButton button;
+            InputState state;
+            KeyModifier mods;
+            char32_t character;
+
+            // MouseMove, Position and PathDrop use position. Size uses size.
+            Vector2<int32_t> position;
+            Vector2<int32_t> size;
+            // MouseScroll and RawMouseMotion
+            Vector2<float> scrollOffset;
+            Vector2<uint32_t> dpi;
+
+            // MouseEntered, Focus, Iconified and Maximized
+            bool value;
+
+            std::vector<std::wstring> paths;
+        };
+
+        /// <summary>
+        /// The state behind IWindow::Window::GetNativeDeviceContext on the null backend.
+        /// </summary>
+        struct DeviceContext {
+            // Events waiting for the next Window::Update. Guarded by a mutex of the null backend so events can be pushed from any thread.
+            std::deque<Event> events;
+            // Set by the wake-up of an input thread. Guarded by the same mutex.
+            bool woken;
+            // RGBA pixels, 4 bytes each, rows from top to bottom. Always GetFramebufferSize().width * GetFramebufferSize().height * 4 bytes.
+            std::vector<uint8_t> framebuffer;
+        };
+
+        /// <summary>
+        /// Queue an event. It is handled on the next Window::Update or Window::WaitForEvent, the same way a real window system event would be.
+        /// </summary>
+        void IWINDOW_API PushEvent(Window& window, const Event& event);
+        void IWINDOW_API PushKeyEvent(Window& window, Key key, InputState state, KeyModifier mods = KeyModifier::None);
+        void IWINDOW_API PushCharEvent(Window& window, char32_t c, KeyModifier mods = KeyModifier::None);
+        void IWINDOW_API PushMouseMoveEvent(Window& window, Vector2<int32_t> position);
+        void IWINDOW_API PushMouseButtonEvent(Window& window, MouseButton button, InputState state, KeyModifier mods = KeyModifier::None);
+        void IWINDOW_API PushMouseScrollEvent(Window& window, Vector2<float> offset);
+        /// <summary>
+        /// Queue relative motion from the mouse. Only recorded while Window::SetRawMouseMotion is on. The window doesn't have to be focused.
+        /// </summary>
+        void IWINDOW_API PushRawMouseMotionEvent(Window& window, Vector2<float> delta);
+        void IWINDOW_API PushSizeEvent(Window& window, Vector2<int32_t> size);
+        void IWINDOW_API PushFocusEvent(Window& window, bool focused);
+        /// <summary>
+        /// Queue a close request. Window::IsRunning returns false after the next update.
+        /// </summary>
+        void IWINDOW_API PushCloseEvent(Window& window);
+
+        /// <returns>The window's framebuffer. See IWindow::Null::DeviceContext::framebuffer. Invalidated when the window is resized.</returns>
+        uint8_t* IWINDOW_API GetFramebuffer(Window& window);
+        /// <summary>
+        /// Write the framebuffer to a binary PPM file. Alpha is dropped.
+        /// </summary>
+        /// <returns>
+        /// true if the file was written.
+        /// false if the file could not be opened.
+        /// </returns>
+        bool IWINDOW_API SaveFramebuffer(Window& window, const std::string& path);
+        /// <summary>
+        /// Present the framebuffer, the null backend's SwapBuffers. Call it once per frame after drawing into GetFramebuffer.
+        /// Records the present for Window::GetLatencyStats, so the histogram fills up headless without a call to Window::MarkPresent.
+        /// </summary>
+        void IWINDOW_API PresentFramebuffer(Window& window);
+
+        /// <summary>
+        /// Replace the monitors returned by Monitor::GetAllMonitors. The first monitor is the primary monitor and monitors are identified by name.
+        /// Like a hot-plug, every window reports the monitors that were connected and disconnected on its next update.
+        /// By default there is one 1920x1080 monitor at 96 dpi.
+        /// </summary>
+        void IWINDOW_API SetMonitors(const std::vector<Monitor>& monitors);
+
+        /// <summary>
+        /// Replace the video modes of a monitor. Switching to one changes the monitor's size like a real mode switch.
+        /// By default a monitor has one mode, its size at 60 hertz and 32 bits per pixel.
+        /// </summary>
+        /// <param name="monitorName">Monitor::name of the monitor.</param>
+        /// <param name="modes">The modes. The first one is the current mode.</param>
+        void IWINDOW_API SetVideoModes(const std::string& monitorName, const std::vector<VideoMode>& modes);
+
+        /// <summary>
+        /// Set what Gamepad::GetState returns for a gamepad and connect it. 
+        /// A new gamepad resets the probe backoff of IWindow::GamepadManager, so it is found within one update per empty slot.
+        /// </summary>
+        void IWINDOW_API SetGamepadState(GamepadID gid, const NativeGamepadState& state);
+        /// <summary>
+        /// Connect or disconnect a gamepad. Disconnected gamepads report an empty state. GamepadManager finds out on its next update.
+        /// </summary>
+        void IWINDOW_API SetGamepadConnected(GamepadID gid, bool connected);
+        /// <returns>The last value passed to Gamepad::Rumble for the gamepad.</returns>
+        float IWINDOW_API GetGamepadRumble(GamepadID gid);
+    }
+}
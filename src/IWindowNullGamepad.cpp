@@ -0,0 +1,80 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_NULL)
+
+#include "IWindowNull.h"
+
+namespace IWindow {
+    // Gamepads only exist when IWindow::Null::SetGamepadState or SetGamepadConnected is called.
+    static std::array<NativeGamepadState, (size_t)GamepadID::Max> s_gamepadStates{};
+    static std::array<bool, (size_t)GamepadID::Max> s_gamepadsConnected{};
+    static std::array<float, (size_t)GamepadID::Max> s_gamepadRumble{};
+
+    namespace Null {
+        void SetGamepadState(GamepadID gid, const NativeGamepadState& state) {
+            NativeGamepadState& gamepadState = s_gamepadStates[(size_t)gid];
+
+            // Like XInput the packet number changes every time the state does.
+            const uint32_t packetNumber = gamepadState.dwPacketNumber + 1;
+            gamepadState = state;
+            gamepadState.dwPacketNumber = packetNumber;
+
+            SetGamepadConnected(gid, true);
+        }
+
+        void SetGamepadConnected(GamepadID gid, bool connected) {
+            // Like a device arrival notification from the OS.
+            if (connected && !s_gamepadsConnected[(size_t)gid]) GamepadManager::Get().ResetProbeBackoff();
+
+            s_gamepadsConnected[(size_t)gid] = connected;
+
+            if (!connected) {
+                s_gamepadStates[(size_t)gid] = NativeGamepadState{};
+                s_gamepadRumble[(size_t)gid] = 0.0f;
+            }
+        }
+
+        float GetGamepadRumble(GamepadID gid) { return s_gamepadRumble[(size_t)gid]; }
+    }
+
+    class NullGamepadBackend final : public GamepadBackend {
+    public:
+        bool Poll(GamepadID gid, NativeGamepadState& state) override {
+            state = s_gamepadStates[(size_t)gid];
+            return s_gamepadsConnected[(size_t)gid];
+        }
+
+        void Rumble(GamepadID gid, float rumble) override { s_gamepadRumble[(size_t)gid] = rumble; }
+    };
+
+    GamepadBackend& GamepadManager::GetPlatformBackend() {
+        static NullGamepadBackend s_backend{};
+        return s_backend;
+    }
+}
+#endif
@@ -27,20 +27,9 @@
 */
 #pragma once
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#include <Xinput.h>
-#include <windowsx.h>
-
+#include <cstdint>
 
 namespace IWindow {
-    typedef HWND NativeWindowHandle; 
-    typedef HDC NativeDeviceContext;
-    typedef HGLRC NativeGLRendereringContext;
-    typedef HCURSOR NativeCursor;
-    typedef HICON NativeIcon; 
-    typedef int32_t NativeStyle;
-
     enum struct CursorID {
         Arrow,
         IBeam,
@@ -56,6 +45,23 @@ namespace IWindow {
         Hidden,
         Max
     };
+}
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <Xinput.h>
+#include <windowsx.h>
+
+
+namespace IWindow {
+    typedef HWND NativeWindowHandle; 
+    typedef HDC NativeDeviceContext;
+    typedef HGLRC NativeGLRendereringContext;
+    typedef HCURSOR NativeCursor;
+    typedef HICON NativeIcon; 
+    typedef int32_t NativeStyle;
 
     inline wchar_t* CursorIDToWin32ID(CursorID cursorID) {
         switch (cursorID)
@@ -97,4 +103,401 @@ namespace IWindow {
     typedef XINPUT_STATE NativeGamepadState;
 };
 
+#elif defined(IWINDOW_XCB) || defined(IWINDOW_XLIB)
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Shared by the XCB and Xlib backends.
+namespace IWindow {
+    // _NET_WM_ICON is a property of the window so there is no icon handle.
+    typedef uint32_t NativeIcon;
+    typedef uint32_t NativeStyle;
+
+    /// <summary>
+    /// Convert IWindow::CursorID to a glyph in the X core cursor font. See X11/cursorfont.h.
+    /// </summary>
+    inline uint16_t CursorIDToX11Glyph(CursorID cursorID) {
+        switch (cursorID)
+        {
+        case IWindow::CursorID::Arrow:
+            return 68;  // XC_left_ptr
+        case IWindow::CursorID::IBeam:
+            return 152; // XC_xterm
+        case IWindow::CursorID::Hand:
+            return 60;  // XC_hand2
+        case IWindow::CursorID::Busy:
+            return 150; // XC_watch
+        case IWindow::CursorID::BusyBackground:
+            return 150; // XC_watch
+        case IWindow::CursorID::DiagonalResize1:
+            return 14;  // XC_bottom_right_corner
+        case IWindow::CursorID::DiagonalResize2:
+            return 12;  // XC_bottom_left_corner
+        case IWindow::CursorID::HorizontalResize:
+            return 108; // XC_sb_h_double_arrow
+        case IWindow::CursorID::VerticalResize:
+            return 116; // XC_sb_v_double_arrow
+        case IWindow::CursorID::Move:
+            return 52;  // XC_fleur
+        case IWindow::CursorID::No:
+            return 0;   // XC_X_cursor
+        default:
+            return 68;
+        }
+    }
+
+    enum struct IconID {
+        Default,
+        Max = 2
+    };
+
+    /// <summary>
+    /// Atoms IWindow interns when a window is created.
+    /// </summary>
+    enum struct X11Atom {
+        WmProtocols,
+        WmDeleteWindow,
+        NetWmName,
+        NetWmIcon,
+        NetWmState,
+        NetWmStateFullscreen,
+        NetWmStateMaximizedVert,
+        NetWmStateMaximizedHorz,
+        NetWmStateHidden,
+        MotifWmHints,
+        Utf8String,
+        Clipboard,
+        Targets,
+        IWindowSelection,
+        XdndAware,
+        XdndEnter,
+        XdndPosition,
+        XdndStatus,
+        XdndActionCopy,
+        XdndDrop,
+        XdndFinished,
+        XdndSelection,
+        TextUriList,
+        Max
+    };
+
+    // Must be in the same order as IWindow::X11Atom.
+    inline constexpr std::array<const char*, (size_t)X11Atom::Max> X11_ATOM_NAMES = {
+        "WM_PROTOCOLS",
+        "WM_DELETE_WINDOW",
+        "_NET_WM_NAME",
+        "_NET_WM_ICON",
+        "_NET_WM_STATE",
+        "_NET_WM_STATE_FULLSCREEN",
+        "_NET_WM_STATE_MAXIMIZED_VERT",
+        "_NET_WM_STATE_MAXIMIZED_HORZ",
+        "_NET_WM_STATE_HIDDEN",
+        "_MOTIF_WM_HINTS",
+        "UTF8_STRING",
+        "CLIPBOARD",
+        "TARGETS",
+        "IWINDOW_SELECTION",
+        "XdndAware",
+        "XdndEnter",
+        "XdndPosition",
+        "XdndStatus",
+        "XdndActionCopy",
+        "XdndDrop",
+        "XdndFinished",
+        "XdndSelection",
+        "text/uri-list",
+    };
+};
+
+#if defined(IWINDOW_XCB)
+
+#include <xcb/xcb.h>
+
+namespace IWindow {
+    typedef xcb_window_t NativeWindowHandle;
+    typedef xcb_connection_t* NativeDeviceContext;
+    typedef void* NativeGLRendereringContext;
+    typedef xcb_cursor_t NativeCursor;
+
+    /// <summary>
+    /// State the XCB backend keeps for every window.
+    /// </summary>
+    struct XcbWindowData {
+        xcb_screen_t* screen;
+        std::array<xcb_atom_t, (size_t)X11Atom::Max> atoms;
+
+        // Keyboard mapping from xcb_get_keyboard_mapping.
+        std::vector<xcb_keysym_t> keysyms;
+        xcb_keycode_t minKeyCode;
+        uint8_t keysymsPerKeyCode;
+
+        // Text we own in the CLIPBOARD selection.
+        std::string clipboardText;
+
+        // Events read while another window was updating or outside of Window::Update (e.g. while waiting for a selection). 
+        // They are dispatched on the next update.
+        std::vector<xcb_generic_event_t*> pendingEvents;
+
+        // true if the window has its own connection instead of the shared one. Windows with an input thread have.
+        bool ownsConnection;
+
+        // Major opcode of XInput 2 on the window's connection. 0 if the X server doesn't have it.
+        uint8_t xinputOpcode;
+        // First event of RandR on the window's connection. 0 if the X server doesn't have it.
+        uint8_t randrEventBase;
+
+        // Xdnd drag and drop state.
+        xcb_window_t dndSource;
+        uint32_t dndVersion;
+        int16_t dndX, dndY;
+    };
+};
+
+#else
+
+// X11/Xlib.h is not included here because its macros (None, Bool, Status, True, ...) 
+// would leak into every file that includes IWindow.h. These match the typedefs in Xlib.h.
+typedef struct _XDisplay Display;
+typedef union _XEvent XEvent;
+typedef struct _XIM* XIM;
+typedef struct _XIC* XIC;
+
+namespace IWindow {
+    // Window, Cursor and Atom are XIDs which are unsigned long on the client side.
+    typedef unsigned long NativeWindowHandle;
+    typedef Display* NativeDeviceContext;
+    typedef void* NativeGLRendereringContext;
+    typedef unsigned long NativeCursor;
+
+    /// <summary>
+    /// State the Xlib backend keeps for every window.
+    /// </summary>
+    struct XlibWindowData {
+        int32_t screen;
+        unsigned long root;
+        std::array<unsigned long, (size_t)X11Atom::Max> atoms;
+
+        // Input method used to turn key presses into text. Both are null when no input method is available.
+        XIM inputMethod;
+        XIC inputContext;
+
+        // Text we own in the CLIPBOARD selection.
+        std::string clipboardText;
+
+        // true if the window has its own display instead of the shared one. Windows with an input thread have.
+        bool ownsDisplay;
+
+        // Major opcode of XInput 2 on the window's display. 0 if the X server doesn't have it.
+        int32_t xinputOpcode;
+        // First event of RandR on the window's display. 0 if the X server doesn't have it.
+        int32_t randrEventBase;
+
+        // Xdnd drag and drop state.
+        unsigned long dndSource;
+        uint32_t dndVersion;
+        int32_t dndX, dndY;
+    };
+};
+
+#endif
+
+#elif defined(IWINDOW_WAYLAND)
+
+#include <wayland-client.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Defined in the headers generated by wayland-scanner and in wayland-cursor.h / xkbcommon.h. Only the backend source files need them.
+struct xdg_wm_base;
+struct xdg_surface;
+struct xdg_toplevel;
+struct wl_cursor_theme;
+struct xkb_context;
+struct xkb_keymap;
+struct xkb_state;
+
+namespace IWindow {
+    typedef wl_surface* NativeWindowHandle;
+    typedef wl_display* NativeDeviceContext;
+    typedef void* NativeGLRendereringContext;
+    // The buffer attached to the cursor surface.
+    typedef wl_buffer* NativeCursor;
+    // Wayland has no stable protocol for window icons.
+    typedef uint32_t NativeIcon;
+    typedef uint32_t NativeStyle;
+
+    /// <summary>
+    /// Convert IWindow::CursorID to a cursor name in the cursor theme.
+    /// </summary>
+    inline const char* CursorIDToWaylandCursorName(CursorID cursorID) {
+        switch (cursorID)
+        {
+        case IWindow::CursorID::Arrow:
+            return "left_ptr";
+        case IWindow::CursorID::IBeam:
+            return "xterm";
+        case IWindow::CursorID::Hand:
+            return "hand2";
+        case IWindow::CursorID::Busy:
+            return "watch";
+        case IWindow::CursorID::BusyBackground:
+            return "left_ptr_watch";
+        case IWindow::CursorID::DiagonalResize1:
+            return "bottom_right_corner";
+        case IWindow::CursorID::DiagonalResize2:
+            return "bottom_left_corner";
+        case IWindow::CursorID::HorizontalResize:
+            return "sb_h_double_arrow";
+        case IWindow::CursorID::VerticalResize:
+            return "sb_v_double_arrow";
+        case IWindow::CursorID::Move:
+            return "fleur";
+        case IWindow::CursorID::No:
+            return "X_cursor";
+        default:
+            return "left_ptr";
+        }
+    }
+
+    enum struct IconID {
+        Default,
+        Max = 2
+    };
+
+    /// <summary>
+    /// A wl_output and the scale the compositor reported for it.
+    /// </summary>
+    struct WaylandOutput {
+        wl_output* output;
+        // Name of the wl_output global. Used to find the output when it is removed.
+        uint32_t name;
+        int32_t scale;
+    };
+
+    /// <summary>
+    /// State the Wayland backend keeps for every window.
+    /// </summary>
+    struct WaylandWindowData {
+        // Globals
+        wl_registry* registry;
+        wl_compositor* compositor;
+        wl_shm* shm;
+        xdg_wm_base* wmBase;
+        wl_seat* seat;
+        wl_data_device_manager* dataDeviceManager;
+        std::vector<WaylandOutput> outputs;
+
+        xdg_surface* xdgSurface;
+        xdg_toplevel* toplevel;
+
+        // Set by the first xdg_surface.configure. Nothing may be drawn before it.
+        bool configured;
+        // Values from the last xdg_toplevel.configure. Applied when the xdg_surface.configure that follows it arrives.
+        int32_t pendingWidth, pendingHeight;
+        bool pendingMaximized, pendingFullscreen;
+
+        // Outputs the surface is on. The buffer scale is the largest scale of these outputs.
+        std::vector<wl_output*> surfaceOutputs;
+        int32_t scale;
+
+        // wl_surface.frame callback. frameReady is false while the compositor has not asked for the next frame.
+        wl_callback* frameCallback;
+        bool frameReady;
+
+        // Keyboard
+        wl_keyboard* keyboard;
+        xkb_context* xkbContext;
+        xkb_keymap* keymap;
+        xkb_state* xkbState;
+        // Wayland leaves key repeat to the client. repeatKey is the evdev key code being repeated or 0.
+        uint32_t repeatKey;
+        int32_t repeatRate, repeatDelay;
+        std::chrono::steady_clock::time_point nextRepeat;
+
+        // Pointer
+        wl_pointer* pointer;
+        uint32_t pointerSerial;
+        wl_surface* cursorSurface;
+        wl_cursor_theme* cursorTheme;
+        int32_t cursorHotX, cursorHotY;
+        // Buffers from the cursor theme are owned by the theme.
+        bool ownsCursorBuffer;
+        bool cursorHidden;
+
+        // Serial of the last key or button press. Setting the selection needs it.
+        uint32_t inputSerial;
+
+        // Clipboard and drag and drop
+        wl_data_device* dataDevice;
+        wl_data_offer* selectionOffer;
+        wl_data_offer* dndOffer;
+        wl_data_source* clipboardSource;
+        std::string clipboardText;
+        int32_t dndX, dndY;
+
+        // eventfd polled next to the display. Window::WakeEventLoop writes to it.
+        int wakeFd;
+    };
+};
+
+#elif defined(IWINDOW_NULL)
+
+namespace IWindow {
+    // Defined in IWindowNull.h.
+    namespace Null { 
+        struct DeviceContext;
+        struct Event;
+    }
+
+    // There is no window system. Every window gets a unique id instead of a handle.
+    typedef uint64_t NativeWindowHandle;
+    // The window's synthetic event queue and framebuffer.
+    typedef Null::DeviceContext* NativeDeviceContext;
+    typedef void* NativeGLRendereringContext;
+    // The cursor that was set last. CursorID::Max if it is a custom image.
+    typedef CursorID NativeCursor;
+    // 0 for the default icon, 1 for a custom image.
+    typedef uint32_t NativeIcon;
+    typedef uint32_t NativeStyle;
+
+    enum struct IconID {
+        Default,
+        Max = 2
+    };
+};
+
+#else
+#error "No IWindow backend selected. Define IWINDOW_XCB, IWINDOW_XLIB, IWINDOW_WAYLAND or IWINDOW_NULL in your preprocessor defines."
+#endif
+
+#if !defined(_WIN32)
+
+namespace IWindow {
+    /// <summary>
+    /// Gamepad state with the same layout as XINPUT_STATE so IWindow::Gamepad reads it the same way on every platform.
+    /// </summary>
+    struct GamepadState {
+        uint32_t dwPacketNumber;
+
+        struct {
+            // Bitmask of IWindow::GamepadButton.
+            uint16_t wButtons;
+            uint8_t bLeftTrigger;
+            uint8_t bRightTrigger;
+            int16_t sThumbLX;
+            int16_t sThumbLY;
+            int16_t sThumbRX;
+            int16_t sThumbRY;
+        } Gamepad;
+    };
+
+    typedef GamepadState NativeGamepadState;
+};
+
+#endif
+
 
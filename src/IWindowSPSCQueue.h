@@ -0,0 +1,117 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace IWindow {
+    // Keeps the indices the two threads write on separate cache lines so they don't invalidate each other's line on every push and pop.
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /// <summary>
+    /// Lock-free fixed-size ring buffer for exactly one producer thread and one consumer thread.
+    /// Push and IsFull are only called by the producer and Pop and IsEmpty only by the consumer. None of them ever blocks or allocates.
+    /// </summary>
+    template<typename T>
+    class SPSCQueue {
+    public:
+        /// <param name="capacity">Rounded up to a power of two so the indices can be wrapped with a mask.</param>
+        explicit SPSCQueue(uint32_t capacity) {
+            uint32_t size = 1;
+            while (size < capacity) size <<= 1;
+
+            m_items.resize(size);
+            m_mask = size - 1;
+        }
+
+        /// <returns>
+        /// true if item was added.
+        /// false if the queue is full. item is left untouched.
+        /// </returns>
+        template<typename U>
+        bool Push(U&& item) {
+            const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+
+            // Only read the consumer's index when the cached one says the queue is full.
+            if (tail - m_cachedHead > m_mask) {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail - m_cachedHead > m_mask) return false;
+            }
+
+            m_items[tail & m_mask] = std::forward<U>(item);
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /// <returns>
+        /// true if item was set to the oldest item.
+        /// false if the queue is empty.
+        /// </returns>
+        bool Pop(T& item) {
+            const uint32_t head = m_head.load(std::memory_order_relaxed);
+
+            // Only read the producer's index when the cached one says the queue is empty.
+            if (head == m_cachedTail) {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head == m_cachedTail) return false;
+            }
+
+            item = std::move(m_items[head & m_mask]);
+            m_head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        bool IsEmpty() const { return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire); }
+        /// <summary>
+        /// Only called by the producer. The consumer only makes room, so a Push after IsFull returned false succeeds.
+        /// </summary>
+        bool IsFull() { 
+            const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cachedHead <= m_mask) return false;
+
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            return tail - m_cachedHead > m_mask;
+        }
+    private:
+        std::vector<T> m_items;
+        uint32_t m_mask;
+
+        // Consumer side. m_cachedTail is the last m_tail the consumer read.
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> m_head{ 0 };
+        uint32_t m_cachedTail = 0;
+
+        // Producer side. m_cachedHead is the last m_head the producer read.
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> m_tail{ 0 };
+        uint32_t m_cachedHead = 0;
+    };
+}
@@ -2,10 +2,13 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include "IWindowCore.h"
 
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#endif
 
 #define IWINDOW_CREATE_FLAGS_FROM_ENUM_STRUCT(Struct)																	            \
 		inline Struct operator|(Struct left, Struct right) {														                \
@@ -120,16 +123,37 @@ namespace IWindow {
         }
     };
 
+    /// <summary>
+    /// A resolution and refresh rate a monitor can be switched to.
+    /// size is a Vector2<int32_t> of the width and height in pixels.
+    /// refreshRate is in hertz, e.g. 59.94 or 143.98. Win32 only reports whole hertz.
+    /// bitsPerPixel is the colour depth of the mode.
+    /// </summary>
+    struct VideoMode {
+        Vector2<int32_t> size;
+        double refreshRate;
+        uint32_t bitsPerPixel;
+
+        /// <summary>
+        /// Checks if size is empty and refreshRate is zero.
+        /// </summary>
+        inline bool IsEmpty() const {
+            return size.IsEmpty() && refreshRate == 0.0;
+        }
+    };
+
     /// <summary>
     /// size is a Vector2<int32_t> of the width and height of the monitor in screen coordinates.
     /// position is a Vector2<int32_t> of the x and y coordinate of monitor in screen coordinates.
     /// name is the name the OS provides when querying all the monitors.
     /// dpi is the x and y dpi scale of this monitor.
+    /// id identifies the monitor while it is connected, even when its size, position or order changes. 0 for an empty monitor.
     /// </summary>
     struct IWINDOW_API Monitor {
         Vector2<int32_t> size, position;
         std::string name;
         Vector2<uint32_t> dpi;
+        uint64_t id;
 
         /// <summary>
         /// Checks if size is empty, position is empty and name is empty.
@@ -138,10 +162,62 @@ namespace IWindow {
             return size.IsEmpty() && position.IsEmpty() && name.empty();
         }
 
+        /// <summary>
+        /// The monitors are asked from the OS once and cached for the whole process. 
+        /// The cache is dropped when the OS reports a change (WM_DISPLAYCHANGE, RandR screen and output changes, wl_output globals) to a window.
+        /// </summary>
         /// <returns>The primary monitors information.</returns>
         static Monitor GetPrimaryMonitor();
-        /// <returns>A vector of all the monitors information.</returns>
+        /// <returns>A vector of all the monitors information. The primary monitor is first.</returns>
         static std::vector<Monitor> GetAllMonitors();
+        /// <summary>
+        /// Finds a connected monitor by its id.
+        /// </summary>
+        /// <param name="id">Monitor::id of the monitor.</param>
+        /// <param name="monitor">Set to the monitor if it is connected.</param>
+        /// <returns>
+        /// true if the monitor is connected.
+        /// false if it was disconnected.
+        /// </returns>
+        static bool FindMonitor(uint64_t id, Monitor& monitor);
+        /// <summary>
+        /// Drops the cached monitors so the next call asks the OS again. 
+        /// Windows do it when the OS reports a change, so it is only needed for changes the OS doesn't report (e.g. a Wayland output that changed its mode).
+        /// </summary>
+        static void InvalidateCache();
+
+        /// <summary>
+        /// Asks the OS for every video mode the monitor supports. Wayland compositors may only report the current mode.
+        /// </summary>
+        /// <returns>The video modes sorted by width, height, refresh rate and then bits per pixel, smallest first. Empty if the monitor was disconnected.</returns>
+        std::vector<VideoMode> GetVideoModes() const;
+        /// <returns>The video mode the monitor is in. Empty if the monitor was disconnected.</returns>
+        VideoMode GetCurrentVideoMode() const;
+        /// <summary>
+        /// Picks the video mode closest to a size and refresh rate, e.g. { 1920, 1080 } and 144.0 on a 4K monitor.
+        /// The size is matched first, then the refresh rate, then the most bits per pixel.
+        /// </summary>
+        /// <returns>The closest video mode. Empty if the monitor has none.</returns>
+        VideoMode GetClosestVideoMode(const Vector2<int32_t>& size, double refreshRate) const;
+    private:
+        friend class Window;
+
+        // Asks the OS for every monitor, primary first, with their ids. Implemented by every backend in IWindowUtils*.cpp.
+        static bool QueryMonitorsNative(std::vector<Monitor>& monitors);
+        // Fills the cache if it was dropped. Called with the cache locked.
+        static bool LoadCache();
+        // For backends that identify monitors by name.
+        static uint64_t IdFromName(const std::string& name);
+        // Increases every time the cache is dropped.
+        static uint64_t GetCacheGeneration();
+
+        // Implemented by every backend in IWindowUtils*.cpp. The monitor is found again by id or name, so a monitor from before a mode change works.
+        bool GetVideoModesNative(std::vector<VideoMode>& modes) const;
+        bool GetCurrentVideoModeNative(VideoMode& mode) const;
+        // Switches the monitor to the mode with the same size and the closest refresh rate. The mode the monitor had before the first switch is kept for RestoreVideoModeNative.
+        bool SetVideoModeNative(const VideoMode& mode) const;
+        // Puts back the mode the monitor had before SetVideoModeNative. Does nothing if it was never switched.
+        void RestoreVideoModeNative() const;
     };
 
     /// <summary>
@@ -152,39 +228,39 @@ namespace IWindow {
         /// <summary>
         /// A default decorated window.
         /// </summary>
-        Default = 0x1i32,
+        Default = 0x1,
         /// <summary>
         /// Makes the window resizable. Does not apply in an undecorated window.
         /// </summary>
-        Resizable = 0x2i32,
+        Resizable = 0x2,
         /// <summary>
         /// Makes the window not resizable. Does not apply in an undecorated window.
         /// </summary>
-        NotResizable = 0x4i32,
+        NotResizable = 0x4,
         /// <summary>
         /// Makes the window visible.
         /// </summary>
-        Visible = 0x8i32,
+        Visible = 0x8,
         /// <summary>
         /// Make the window not visible.
         /// </summary>
-        NotVisible = 0x10i32,
+        NotVisible = 0x10,
         /// <summary>
         /// Make the window decorated. Does not apply to fullscreen windows.
         /// </summary>
-        Decorated = 0x20i32,
+        Decorated = 0x20,
         /// <summary>
         /// Make the window not decorated. Does not apply to fullscreen windows.
         /// </summary>
-        NotDecorated = 0x40i32,
+        NotDecorated = 0x40,
         /// <summary>
         /// Maximize the window to fill the screen with decoration.
         /// </summary>
-        Maximize = 0x80i32,
+        Maximize = 0x80,
         /// <summary>
         /// Restores the window out of the maximize state.
         /// </summary>
-        Restore = 0x100i32,
+        Restore = 0x100,
         /// <summary>
         /// Do not use.
         /// </summary>
@@ -257,4 +333,82 @@ namespace IWindow {
         ErrorType type;
         ErrorSeverity severity;
     };
+
+    /// <summary>
+    /// Convert a std::wstring into a utf-8 std::string.
+    /// wchar_t is utf-16 on Windows and utf-32 everywhere else, both are handled.
+    /// </summary>
+    inline std::string WStringToUTF8(const std::wstring& wstr) {
+        std::string str{};
+        str.reserve(wstr.size());
+
+        for (size_t i = 0; i < wstr.size(); i++) {
+            uint32_t c = (uint32_t)wstr[i];
+
+            // utf-16 surrogate pair
+            if (c >= 0xD800 && c <= 0xDBFF && i + 1 < wstr.size()) {
+                c = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t)wstr[i + 1] - 0xDC00);
+                i++;
+            }
+
+            if (c < 0x80) 
+                str += (char)c;
+            else if (c < 0x800) {
+                str += (char)(0xC0 | (c >> 6));
+                str += (char)(0x80 | (c & 0x3F));
+            }
+            else if (c < 0x10000) {
+                str += (char)(0xE0 | (c >> 12));
+                str += (char)(0x80 | ((c >> 6) & 0x3F));
+                str += (char)(0x80 | (c & 0x3F));
+            }
+            else {
+                str += (char)(0xF0 | (c >> 18));
+                str += (char)(0x80 | ((c >> 12) & 0x3F));
+                str += (char)(0x80 | ((c >> 6) & 0x3F));
+                str += (char)(0x80 | (c & 0x3F));
+            }
+        }
+
+        return str;
+    }
+
+    /// <summary>
+    /// Convert a utf-8 std::string into a std::wstring.
+    /// </summary>
+    inline std::wstring UTF8ToWString(const std::string& str) {
+        std::wstring wstr{};
+        wstr.reserve(str.size());
+
+        for (size_t i = 0; i < str.size();) {
+            uint8_t lead = (uint8_t)str[i];
+            uint32_t c = 0;
+            size_t length = 1;
+
+            if (lead < 0x80) c = lead;
+            else if ((lead >> 5) == 0x6) { c = lead & 0x1F; length = 2; }
+            else if ((lead >> 4) == 0xE) { c = lead & 0x0F; length = 3; }
+            else if ((lead >> 3) == 0x1E) { c = lead & 0x07; length = 4; }
+            // Invalid lead byte
+            else { i++; continue; }
+
+            if (i + length > str.size()) break;
+
+            for (size_t j = 1; j < length; j++)
+                c = (c << 6) | ((uint8_t)str[i + j] & 0x3F);
+
+            i += length;
+
+            if (sizeof(wchar_t) == 2 && c >= 0x10000) {
+                c -= 0x10000;
+                wstr += (wchar_t)(0xD800 + (c >> 10));
+                wstr += (wchar_t)(0xDC00 + (c & 0x3FF));
+                continue;
+            }
+
+            wstr += (wchar_t)c;
+        }
+
+        return wstr;
+    }
 }
\ No newline at end of file
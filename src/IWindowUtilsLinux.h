@@ -0,0 +1,248 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+// Helpers shared by the Linux backends (XCB, Xlib, Wayland and the null backend on Linux). Only included by backend source files.
+
+#include "IWindowCodes.h"
+#include "IWindowUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace IWindow {
+    // Modifier bits in the state field of X key and button events. See X11/X.h.
+    constexpr uint32_t X11_SHIFT_MASK = 1 << 0;
+    constexpr uint32_t X11_LOCK_MASK = 1 << 1;
+    constexpr uint32_t X11_CONTROL_MASK = 1 << 2;
+    constexpr uint32_t X11_MOD1_MASK = 1 << 3;
+    constexpr uint32_t X11_MOD2_MASK = 1 << 4;
+    constexpr uint32_t X11_MOD4_MASK = 1 << 6;
+
+    /// <summary>
+    /// Convert the state of an X key or button event to IWindow::KeyModifier.
+    /// </summary>
+    inline KeyModifier X11StateToKeyModifiers(uint32_t state) {
+        KeyModifier mods{};
+
+        if (state & X11_SHIFT_MASK)
+            mods |= KeyModifier::Shift;
+        if (state & X11_CONTROL_MASK)
+            mods |= KeyModifier::Control;
+        if (state & X11_MOD1_MASK)
+            mods |= KeyModifier::Alt;
+        if (state & X11_MOD4_MASK)
+            mods |= KeyModifier::Super;
+        if (state & X11_LOCK_MASK)
+            mods |= KeyModifier::CapsLock;
+        // Mod2 is num lock on every X server that matters.
+        if (state & X11_MOD2_MASK)
+            mods |= KeyModifier::NumLock;
+
+        return mods;
+    }
+
+    /// <summary>
+    /// The state in a key event is the state before the key was pressed. 
+    /// Returns the modifier a key sets so callbacks see the same modifiers as on Win32.
+    /// </summary>
+    inline KeyModifier KeyToKeyModifier(Key key) {
+        switch (key)
+        {
+        case Key::LShift: case Key::RShift:
+            return KeyModifier::Shift;
+        case Key::LControl: case Key::RControl:
+            return KeyModifier::Control;
+        case Key::LAlt: case Key::RAlt:
+            return KeyModifier::Alt;
+        case Key::LSuper: case Key::RSuper:
+            return KeyModifier::Super;
+        default:
+            return KeyModifier{};
+        }
+    }
+
+    /// <summary>
+    /// Convert an X pointer button to IWindow::MouseButton. Returns MouseButton::Max for scroll and unknown buttons.
+    /// </summary>
+    inline MouseButton X11ButtonToMouseButton(uint32_t button) {
+        switch (button)
+        {
+        case 1:
+            return MouseButton::Left;
+        case 2:
+            return MouseButton::Middle;
+        case 3:
+            return MouseButton::Right;
+        case 8:
+            return MouseButton::Side1;
+        case 9:
+            return MouseButton::Side2;
+        default:
+            return MouseButton::Max;
+        }
+    }
+
+    /// <summary>
+    /// Convert a keysym to a unicode code point. Only Latin-1, keypad and the direct unicode range of keysyms are supported.
+    /// </summary>
+    /// <returns>0 if the keysym has no character.</returns>
+    inline char32_t X11KeysymToUnicode(uint32_t keysym) {
+        if ((keysym >= 0x20 && keysym <= 0x7e) || (keysym >= 0xa0 && keysym <= 0xff))
+            return (char32_t)keysym;
+        if ((keysym & 0xff000000) == 0x01000000)
+            return (char32_t)(keysym & 0x00ffffff);
+        if (keysym >= 0xffb0 && keysym <= 0xffb9)
+            return (char32_t)('0' + (keysym - 0xffb0));
+
+        switch (keysym)
+        {
+        case 0xff80: return U' ';
+        case 0xffaa: return U'*';
+        case 0xffab: return U'+';
+        case 0xffac: return U',';
+        case 0xffad: return U'-';
+        case 0xffae: return U'.';
+        case 0xffaf: return U'/';
+        case 0xffbd: return U'=';
+        default:
+            return 0;
+        }
+    }
+
+    inline uint8_t HexToNibble(char c) {
+        if (c >= '0' && c <= '9') return (uint8_t)(c - '0');
+        if (c >= 'a' && c <= 'f') return (uint8_t)(c - 'a' + 10);
+        if (c >= 'A' && c <= 'F') return (uint8_t)(c - 'A' + 10);
+        return 0;
+    }
+
+    /// <summary>
+    /// Parses a text/uri-list into file paths. See RFC 2483.
+    /// </summary>
+    inline std::vector<std::wstring> ParseUriList(const std::string& uriList) {
+        std::vector<std::wstring> paths{};
+        size_t start = 0;
+
+        while (start < uriList.size()) {
+            size_t end = uriList.find('\n', start);
+            if (end == std::string::npos) end = uriList.size();
+
+            std::string uri = uriList.substr(start, end - start);
+            start = end + 1;
+
+            if (!uri.empty() && uri.back() == '\r') uri.pop_back();
+            if (uri.empty() || uri[0] == '#') continue;
+
+            // Remove file://hostname
+            if (uri.compare(0, 7, "file://") == 0) {
+                size_t pathStart = uri.find('/', 7);
+                if (pathStart == std::string::npos) continue;
+                uri = uri.substr(pathStart);
+            }
+
+            std::string path{};
+            for (size_t i = 0; i < uri.size(); i++) {
+                if (uri[i] == '%' && i + 2 < uri.size()) {
+                    path += (char)((HexToNibble(uri[i + 1]) << 4) | HexToNibble(uri[i + 2]));
+                    i += 2;
+                    continue;
+                }
+                path += uri[i];
+            }
+
+            paths.emplace_back(UTF8ToWString(path));
+        }
+
+        return paths;
+    }
+
+    /// <summary>
+    /// The eventfd IWindow::PostEmptyEvent writes to. Created on first use and shared by every window.
+    /// </summary>
+    inline int GetEmptyEventFd() {
+        static const int emptyEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        return emptyEventFd;
+    }
+
+    inline void SignalEventFd(int fd) {
+        // Only fails if the counter is about to overflow, in which case the reader wakes up anyway.
+        const uint64_t one = 1;
+        ssize_t count = write(fd, &one, sizeof(one));
+        (void)count;
+    }
+
+    inline void DrainEventFd(int fd) {
+        // Reading resets the counter so the next poll blocks again.
+        uint64_t value = 0;
+        ssize_t count = read(fd, &value, sizeof(value));
+        (void)count;
+    }
+
+    /// <summary>
+    /// Converts a timeout in seconds to a poll() timeout. Negative waits forever. 
+    /// Rounded up so a timeout below a millisecond doesn't turn a wait loop into a busy loop.
+    /// </summary>
+    inline int32_t TimeoutToMS(double timeoutSeconds) {
+        if (timeoutSeconds < 0.0) return -1;
+        return (int32_t)std::min(std::ceil(timeoutSeconds * 1000.0), (double)INT_MAX);
+    }
+
+    /// <summary>
+    /// What is left of a timeout that started at start. Stays negative for a wait without timeout.
+    /// </summary>
+    inline double RemainingTimeout(double timeoutSeconds, std::chrono::steady_clock::time_point start) {
+        if (timeoutSeconds < 0.0) return -1.0;
+        return std::max(timeoutSeconds - std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 0.0);
+    }
+
+    /// <summary>
+    /// How long ago an event with a millisecond timestamp of the X server or the Wayland compositor happened, in nanoseconds.
+    /// Both take their timestamps from CLOCK_MONOTONIC on Linux, truncated to 32 bits. 
+    /// A server on another machine uses another clock, so ages that make no sense are reported as UINT64_MAX.
+    /// </summary>
+    inline uint64_t MonotonicEventAge(uint32_t eventTimeMs) {
+        timespec now{};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        const uint64_t nowNs = (uint64_t)now.tv_sec * 1'000'000'000 + (uint64_t)now.tv_nsec;
+        const uint32_t ageMs = (uint32_t)(nowNs / 1'000'000) - eventTimeMs;
+
+        // Events are read long before 10 seconds are up.
+        if (ageMs > 10'000) return UINT64_MAX;
+
+        return (uint64_t)ageMs * 1'000'000 + nowNs % 1'000'000;
+    }
+}
@@ -0,0 +1,154 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_NULL)
+
+#include "IWindowNull.h"
+
+#include <cmath>
+
+namespace IWindow {
+    static Monitor DefaultMonitor() {
+        Monitor monitor{};
+        monitor.size = { 1920, 1080 };
+        monitor.position = { 0, 0 };
+        monitor.name = "Null";
+        monitor.dpi = { 96, 96 };
+
+        return monitor;
+    }
+
+    static std::vector<Monitor> s_monitors{ DefaultMonitor() };
+
+    // Video modes of a monitor set with Null::SetVideoModes or switched by SetVideoModeNative.
+    struct NullVideoModes {
+        std::string monitorName;
+        std::vector<VideoMode> modes;
+        VideoMode current, original;
+    };
+
+    static std::vector<NullVideoModes> s_videoModes{};
+
+    static Monitor* FindNullMonitor(const std::string& name) {
+        for (Monitor& monitor : s_monitors)
+            if (monitor.name == name) return &monitor;
+
+        return nullptr;
+    }
+
+    // Monitors without modes of their own get one on first use.
+    static NullVideoModes& GetNullVideoModes(const Monitor& monitor) {
+        for (NullVideoModes& videoModes : s_videoModes)
+            if (videoModes.monitorName == monitor.name) return videoModes;
+
+        const VideoMode mode{ monitor.size, 60.0, 32 };
+        s_videoModes.push_back({ monitor.name, { mode }, mode, {} });
+        return s_videoModes.back();
+    }
+
+    namespace Null {
+        void SetMonitors(const std::vector<Monitor>& monitors) { 
+            s_monitors = monitors; 
+            // Stands in for the OS telling the windows. Each window reports the changes on its next update.
+            Monitor::InvalidateCache();
+        }
+
+        void SetVideoModes(const std::string& monitorName, const std::vector<VideoMode>& modes) {
+            for (NullVideoModes& videoModes : s_videoModes) {
+                if (videoModes.monitorName != monitorName) continue;
+
+                videoModes.modes = modes;
+                videoModes.current = modes.empty() ? VideoMode{} : modes[0];
+                videoModes.original = {};
+                return;
+            }
+
+            s_videoModes.push_back({ monitorName, modes, modes.empty() ? VideoMode{} : modes[0], {} });
+        }
+    }
+
+    // Monitors are identified by name.
+    bool Monitor::QueryMonitorsNative(std::vector<Monitor>& monitors) {
+        IWINDOW_CHECK_ERROR(s_monitors.empty(), ErrorType::Monitor, ErrorSeverity::Error, "IWindow::Null::SetMonitors was given no monitors. Failed to get monitor information!", true, false);
+
+        monitors = s_monitors;
+        for (Monitor& monitor : monitors) monitor.id = IdFromName(monitor.name);
+
+        return true;
+    }
+
+    bool Monitor::GetVideoModesNative(std::vector<VideoMode>& modes) const {
+        IWINDOW_CHECK_ERROR(!FindNullMonitor(name), ErrorType::Monitor, ErrorSeverity::Error, "The monitor was disconnected. Failed to get video modes!", true, false);
+
+        modes = GetNullVideoModes(*this).modes;
+        return true;
+    }
+
+    bool Monitor::GetCurrentVideoModeNative(VideoMode& mode) const {
+        IWINDOW_CHECK_ERROR(!FindNullMonitor(name), ErrorType::Monitor, ErrorSeverity::Error, "The monitor was disconnected. Failed to get the current video mode!", true, false);
+
+        mode = GetNullVideoModes(*this).current;
+        return true;
+    }
+
+    bool Monitor::SetVideoModeNative(const VideoMode& mode) const {
+        Monitor* monitor = FindNullMonitor(name);
+        IWINDOW_CHECK_ERROR(!monitor, ErrorType::Monitor, ErrorSeverity::Error, "The monitor was disconnected. Failed to set the video mode!", true, false);
+
+        NullVideoModes& videoModes = GetNullVideoModes(*monitor);
+
+        const VideoMode* closest = nullptr;
+        for (const VideoMode& supported : videoModes.modes) {
+            if (supported.size.width != mode.size.width || supported.size.height != mode.size.height) continue;
+            if (!closest || std::abs(supported.refreshRate - mode.refreshRate) < std::abs(closest->refreshRate - mode.refreshRate)) closest = &supported;
+        }
+        IWINDOW_CHECK_ERROR(!closest, ErrorType::Monitor, ErrorSeverity::Error, "The monitor has no video mode of that size. Failed to set the video mode!", true, false);
+
+        if (videoModes.original.IsEmpty()) videoModes.original = videoModes.current;
+        videoModes.current = *closest;
+        monitor->size = closest->size;
+
+        // Stands in for the OS telling the windows.
+        Monitor::InvalidateCache();
+        return true;
+    }
+
+    void Monitor::RestoreVideoModeNative() const {
+        Monitor* monitor = FindNullMonitor(name);
+        if (!monitor) return;
+
+        NullVideoModes& videoModes = GetNullVideoModes(*monitor);
+        if (videoModes.original.IsEmpty()) return;
+
+        videoModes.current = videoModes.original;
+        videoModes.original = {};
+        monitor->size = videoModes.current.size;
+
+        Monitor::InvalidateCache();
+    }
+}
+#endif
@@ -0,0 +1,173 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_WAYLAND)
+
+#include "IWindowUtils.h"
+
+#include "IWindow.h"
+
+#include <wayland-client.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace IWindow {
+    struct WaylandMonitor {
+        wl_output* output;
+        // Name of the wl_output global. The compositor never reuses it.
+        uint32_t name;
+        Monitor monitor;
+        int32_t widthMM, heightMM;
+        int32_t scale;
+        // Compositors only have to send the current mode. Older ones send every mode.
+        std::vector<VideoMode> modes;
+        VideoMode currentMode;
+    };
+
+    static void OutputGeometry(void* data, wl_output*, int32_t x, int32_t y, int32_t widthMM, int32_t heightMM, int32_t, const char* make, const char* model, int32_t) {
+        WaylandMonitor& waylandMonitor = *(WaylandMonitor*)data;
+
+        waylandMonitor.monitor.position = { x, y };
+        waylandMonitor.widthMM = widthMM;
+        waylandMonitor.heightMM = heightMM;
+
+        // wl_output.name replaces this when the compositor supports version 4.
+        if (waylandMonitor.monitor.name.empty())
+            waylandMonitor.monitor.name = std::string{ make } + " " + model;
+    }
+
+    static void OutputMode(void* data, wl_output*, uint32_t flags, int32_t width, int32_t height, int32_t refresh) {
+        WaylandMonitor& waylandMonitor = *(WaylandMonitor*)data;
+
+        // refresh is in millihertz. Wayland has no colour depth, every buffer format the compositor takes works.
+        const VideoMode mode{ { width, height }, refresh / 1000.0, 32 };
+        waylandMonitor.modes.push_back(mode);
+
+        if (flags & WL_OUTPUT_MODE_CURRENT) {
+            waylandMonitor.monitor.size = { width, height };
+            waylandMonitor.currentMode = mode;
+        }
+    }
+
+    static void OutputDone(void*, wl_output*) {}
+    static void OutputScale(void* data, wl_output*, int32_t scale) { ((WaylandMonitor*)data)->scale = scale; }
+    static void OutputName(void* data, wl_output*, const char* name) { ((WaylandMonitor*)data)->monitor.name = name; }
+    static void OutputDescription(void*, wl_output*, const char*) {}
+
+    static const wl_output_listener s_outputListener = { OutputGeometry, OutputMode, OutputDone, OutputScale, OutputName, OutputDescription };
+
+    static void Global(void* data, wl_registry* registry, uint32_t name, const char* interface, uint32_t version) {
+        if (strcmp(interface, wl_output_interface.name) != 0) return;
+
+        std::unique_ptr<WaylandMonitor> waylandMonitor = std::make_unique<WaylandMonitor>();
+        waylandMonitor->name = name;
+        waylandMonitor->scale = 1;
+        // Version 4 for wl_output.name.
+        waylandMonitor->output = (wl_output*)wl_registry_bind(registry, name, &wl_output_interface, std::min(version, 4u));
+        wl_output_add_listener(waylandMonitor->output, &s_outputListener, waylandMonitor.get());
+
+        ((std::vector<std::unique_ptr<WaylandMonitor>>*)data)->push_back(std::move(waylandMonitor));
+    }
+
+    static void GlobalRemove(void*, wl_registry*, uint32_t) {}
+
+    static const wl_registry_listener s_registryListener = { Global, GlobalRemove };
+
+    // Every wl_output is a monitor. Wayland has no primary monitor, the first output is used instead.
+    // The modes of the output named modesOf go into modes, its current mode into currentMode.
+    static bool QueryMonitors(std::vector<Monitor>& monitors, uint64_t modesOf = 0, std::vector<VideoMode>* modes = nullptr, VideoMode* currentMode = nullptr) {
+        wl_display* display = wl_display_connect(nullptr);
+        if (!display) return false;
+
+        std::vector<std::unique_ptr<WaylandMonitor>> waylandMonitors{};
+
+        wl_registry* registry = wl_display_get_registry(display);
+        wl_registry_add_listener(registry, &s_registryListener, &waylandMonitors);
+
+        // The first roundtrip gets the outputs. The second gets their geometry, modes and names.
+        wl_display_roundtrip(display);
+        wl_display_roundtrip(display);
+
+        for (std::unique_ptr<WaylandMonitor>& waylandMonitor : waylandMonitors) {
+            Monitor& monitor = waylandMonitor->monitor;
+
+            // 25.4 millimeters in an inch
+            if (waylandMonitor->widthMM > 0 && waylandMonitor->heightMM > 0) {
+                monitor.dpi.x = (uint32_t)(monitor.size.x * 25.4f / waylandMonitor->widthMM + 0.5f);
+                monitor.dpi.y = (uint32_t)(monitor.size.y * 25.4f / waylandMonitor->heightMM + 0.5f);
+            }
+            else {
+                monitor.dpi = { 96 * (uint32_t)waylandMonitor->scale, 96 * (uint32_t)waylandMonitor->scale };
+            }
+
+            monitor.id = waylandMonitor->name;
+            if (monitor.id == modesOf && modes) *modes = waylandMonitor->modes;
+            if (monitor.id == modesOf && currentMode) *currentMode = waylandMonitor->currentMode;
+
+            monitors.push_back(monitor);
+            wl_output_destroy(waylandMonitor->output);
+        }
+
+        wl_registry_destroy(registry);
+        wl_display_disconnect(display);
+
+        return true;
+    }
+
+    bool Monitor::QueryMonitorsNative(std::vector<Monitor>& monitors) {
+        IWINDOW_CHECK_ERROR(!QueryMonitors(monitors), ErrorType::Monitor, ErrorSeverity::Error, "wl_display_connect() failed. Failed to get monitor information!", true, false);
+
+        return true;
+    }
+
+    bool Monitor::GetVideoModesNative(std::vector<VideoMode>& modes) const {
+        std::vector<Monitor> monitors{};
+        IWINDOW_CHECK_ERROR(!QueryMonitors(monitors, id, &modes), ErrorType::Monitor, ErrorSeverity::Error, "wl_display_connect() failed. Failed to get video modes!", true, false);
+        IWINDOW_CHECK_ERROR(modes.empty(), ErrorType::Monitor, ErrorSeverity::Error, "The monitor was disconnected. Failed to get video modes!", true, false);
+
+        return true;
+    }
+
+    bool Monitor::GetCurrentVideoModeNative(VideoMode& mode) const {
+        std::vector<Monitor> monitors{};
+        IWINDOW_CHECK_ERROR(!QueryMonitors(monitors, id, nullptr, &mode), ErrorType::Monitor, ErrorSeverity::Error, "wl_display_connect() failed. Failed to get the current video mode!", true, false);
+        IWINDOW_CHECK_ERROR(mode.IsEmpty(), ErrorType::Monitor, ErrorSeverity::Error, "The monitor was disconnected. Failed to get the current video mode!", true, false);
+
+        return true;
+    }
+
+    // Wayland leaves modes to the compositor. A fullscreen window that is smaller than the output is scaled or centered by it instead.
+    bool Monitor::SetVideoModeNative(const VideoMode&) const {
+        IWINDOW_CHECK_ERROR(true, ErrorType::Monitor, ErrorSeverity::Warning, "Wayland compositors don't let clients change video modes. Failed to set the video mode!", true, false);
+
+        return false;
+    }
+
+    void Monitor::RestoreVideoModeNative() const {}
+}
+#endif
\ No newline at end of file
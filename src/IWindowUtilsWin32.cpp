@@ -5,16 +5,19 @@
 #include <shellscalingapi.h>
 
 namespace IWindow {
-    Monitor Monitor::GetPrimaryMonitor()  {
-        // The primary montitors top left corner is always 0, 0
-        const POINT p = { 0, 0 };
-        HMONITOR hmonitor = ::MonitorFromPoint(p, MONITOR_DEFAULTTOPRIMARY);
+    struct MonitorQuery {
+        std::vector<Monitor> monitors;
+        bool ok;
+    };
+
+    static BOOL CALLBACK MonitorCallback(HMONITOR hmonitor, HDC, LPRECT rc, LPARAM lparam) {
+        MonitorQuery& query = *(MonitorQuery*)lparam;
 
         MONITORINFOEX monitorInfo{}; // EX has the monitor name
         monitorInfo.cbSize = sizeof(MONITORINFOEX);
         if (!::GetMonitorInfo(hmonitor, &monitorInfo)) {
-            MessageBox(nullptr, L"Failed to get primary monitor!", L"Error", MB_ICONEXCLAMATION | MB_OK);
-            return Monitor{};
+            query.ok = false;
+            IWINDOW_CHECK_ERROR(true, ErrorType::Monitor, ErrorSeverity::Error, "GetMonitorInfo() failed. Failed to get monitor information!", true, false);
         }
 
         Monitor monitor{};
@@ -23,40 +26,97 @@ namespace IWindow {
         monitor.size.y = (int32_t)monitorInfo.rcMonitor.bottom - monitorInfo.rcMonitor.top;
         monitor.position.x = (int32_t)monitorInfo.rcMonitor.left;
         monitor.position.y = (int32_t)monitorInfo.rcMonitor.top;
+        // The size includes the null terminator.
         int32_t size = ::WideCharToMultiByte(CP_UTF8, 0, monitorInfo.szDevice, -1, nullptr, 0, 0, 0);
-        monitor.name.resize(size);
-        ::WideCharToMultiByte(CP_UTF8, 0, monitorInfo.szDevice, -1, monitor.name.data(), (int32_t)monitor.name.size() * sizeof(char), 0, 0);
+        monitor.name.resize(size > 0 ? size - 1 : 0);
+        ::WideCharToMultiByte(CP_UTF8, 0, monitorInfo.szDevice, -1, monitor.name.data(), size, 0, 0);
+
+        if (::GetDpiForMonitor(hmonitor, MDT_EFFECTIVE_DPI, (UINT*)&monitor.dpi.x, (UINT*)&monitor.dpi.y) != S_OK) {
+            query.ok = false;
+            IWINDOW_CHECK_ERROR(true, ErrorType::Monitor, ErrorSeverity::Error, "GetDpiForMonitor() failed. Failed to get monitor dpi scale! Are you using Windows 8.1 or higher?", true, false);
+        }
 
-        return monitor;
+        // The primary monitor goes first.
+        if (monitorInfo.dwFlags & MONITORINFOF_PRIMARY) query.monitors.insert(query.monitors.begin(), std::move(monitor));
+        else query.monitors.emplace_back(std::move(monitor));
+
+        return true;
     }
 
-    static BOOL CALLBACK MonitorCallback(HMONITOR hmonitor, HDC, LPRECT rc, LPARAM lparam) {
-        std::vector<Monitor>* monitorsVec = (std::vector<Monitor>*)lparam;
+    bool Monitor::QueryMonitorsNative(std::vector<Monitor>& monitors) {
+        MonitorQuery query{ {}, true };
+        if (!::EnumDisplayMonitors(nullptr, nullptr, MonitorCallback, (LPARAM)&query) || !query.ok) return false;
 
-        MONITORINFOEX monitorInfo{}; // EX has the monitor name
-        monitorInfo.cbSize = sizeof(MONITORINFOEX);
-        IWINDOW_CHECK_ERROR(!::GetMonitorInfo(hmonitor, &monitorInfo), ErrorType::Monitor, ErrorSeverity::Error, "GetMonitorInfo() failed. Failed to get monitor information!", true, false);
+        // HMONITORs change when the displays change. The device name (\\.\DISPLAY1, ...) stays with the output.
+        for (Monitor& monitor : query.monitors) monitor.id = IdFromName(monitor.name);
 
-        Monitor monitor{};
+        monitors = std::move(query.monitors);
+        return true;
+    }
 
-        monitor.size.x = (size_t)monitorInfo.rcMonitor.right - monitorInfo.rcMonitor.left;
-        monitor.size.y = (size_t)monitorInfo.rcMonitor.bottom - monitorInfo.rcMonitor.top;
-        monitor.position.x = (size_t)monitorInfo.rcMonitor.left;
-        monitor.position.y = (size_t)monitorInfo.rcMonitor.top;
-        int32_t size = ::WideCharToMultiByte(CP_UTF8, 0, monitorInfo.szDevice, -1, nullptr, 0, 0, 0);
-        monitor.name.resize(size);
-        ::WideCharToMultiByte(CP_UTF8, 0, monitorInfo.szDevice, -1, monitor.name.data(), (int32_t)monitor.name.size() * sizeof(char), 0, 0);
+    static VideoMode ToVideoMode(const DEVMODEW& devMode) {
+        VideoMode mode{};
+        mode.size = { (int32_t)devMode.dmPelsWidth, (int32_t)devMode.dmPelsHeight };
+        mode.refreshRate = (double)devMode.dmDisplayFrequency;
+        mode.bitsPerPixel = (uint32_t)devMode.dmBitsPerPel;
+
+        return mode;
+    }
 
-        IWINDOW_CHECK_ERROR(!::GetDpiForMonitor(hmonitor, MDT_EFFECTIVE_DPI, (UINT*)&monitor.dpi.x, (UINT*)&monitor.dpi.y), ErrorType::Monitor, ErrorSeverity::Error, "GetMonitorInfo() failed. Failed to get monitor dpi scale! Are you using Windows 8.1 or higher?", true, false);
+    bool Monitor::GetVideoModesNative(std::vector<VideoMode>& modes) const {
+        // Monitor::name is the device name EnumDisplaySettings takes.
+        const std::wstring device = UTF8ToWString(name);
+
+        DEVMODEW devMode{};
+        devMode.dmSize = sizeof(devMode);
+        for (DWORD i = 0; ::EnumDisplaySettingsW(device.c_str(), i, &devMode); i++) {
+            // Palette modes.
+            if (devMode.dmBitsPerPel < 15) continue;
+
+            modes.push_back(ToVideoMode(devMode));
+        }
+
+        IWINDOW_CHECK_ERROR(modes.empty(), ErrorType::Monitor, ErrorSeverity::Error, "EnumDisplaySettings() failed. Failed to get video modes!", true, false);
+
+        return true;
+    }
+
+    bool Monitor::GetCurrentVideoModeNative(VideoMode& mode) const {
+        const std::wstring device = UTF8ToWString(name);
+
+        DEVMODEW devMode{};
+        devMode.dmSize = sizeof(devMode);
+        IWINDOW_CHECK_ERROR(!::EnumDisplaySettingsW(device.c_str(), ENUM_CURRENT_SETTINGS, &devMode), ErrorType::Monitor, ErrorSeverity::Error, "EnumDisplaySettings() failed. Failed to get the current video mode!", true, false);
+
+        mode = ToVideoMode(devMode);
+        return true;
+    }
+
+    bool Monitor::SetVideoModeNative(const VideoMode& mode) const {
+        const std::wstring device = UTF8ToWString(name);
+
+        DEVMODEW devMode{};
+        devMode.dmSize = sizeof(devMode);
+        devMode.dmPelsWidth = (DWORD)mode.size.width;
+        devMode.dmPelsHeight = (DWORD)mode.size.height;
+        // Windows only knows whole hertz and lists 59.94 hertz modes as 59.
+        devMode.dmDisplayFrequency = (DWORD)(mode.refreshRate + 0.5);
+        devMode.dmFields = DM_PELSWIDTH | DM_PELSHEIGHT | DM_DISPLAYFREQUENCY;
+        if (mode.bitsPerPixel) {
+            devMode.dmBitsPerPel = (DWORD)mode.bitsPerPixel;
+            devMode.dmFields |= DM_BITSPERPEL;
+        }
 
-        monitorsVec->emplace_back(std::move(monitor));
+        // CDS_FULLSCREEN keeps the registry untouched, so Windows puts the old mode back if the process ends without RestoreVideoModeNative.
+        const LONG result = ::ChangeDisplaySettingsExW(device.c_str(), &devMode, nullptr, CDS_FULLSCREEN, nullptr);
+        IWINDOW_CHECK_ERROR(result != DISP_CHANGE_SUCCESSFUL, ErrorType::Monitor, ErrorSeverity::Error, "ChangeDisplaySettingsEx() failed. Failed to set the video mode!", true, false);
 
         return true;
     }
 
-    std::vector<Monitor> Monitor::GetAllMonitors() {
-        std::vector<Monitor> monitors{};
-        ::EnumDisplayMonitors(nullptr, nullptr, MonitorCallback, (LPARAM)&monitors);
-        return monitors;
+    void Monitor::RestoreVideoModeNative() const {
+        // Without a mode the registry mode comes back.
+        const std::wstring device = UTF8ToWString(name);
+        ::ChangeDisplaySettingsExW(device.c_str(), nullptr, nullptr, CDS_FULLSCREEN, nullptr);
     }
 }
\ No newline at end of file
@@ -0,0 +1,354 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_XCB)
+
+#include "IWindowUtils.h"
+
+#include "IWindow.h"
+
+#include <xcb/xcb.h>
+#include <xcb/randr.h>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+
+namespace IWindow {
+    // 25.4 millimeters in an inch
+    static Vector2<uint32_t> Dpi(Vector2<int32_t> size, uint32_t widthMM, uint32_t heightMM) {
+        if (!widthMM || !heightMM) return {};
+        return { (uint32_t)(size.x * 25.4f / widthMM + 0.5f), (uint32_t)(size.y * 25.4f / heightMM + 0.5f) };
+    }
+
+    // Without RandR every X screen is reported as one monitor.
+    static Monitor ScreenToMonitor(const xcb_screen_t* screen, int32_t screenIndex) {
+        Monitor monitor{};
+
+        monitor.size.x = (int32_t)screen->width_in_pixels;
+        monitor.size.y = (int32_t)screen->height_in_pixels;
+        monitor.position.x = 0;
+        monitor.position.y = 0;
+
+        const char* display = std::getenv("DISPLAY");
+        monitor.name = std::string{ display ? display : ":0" } + "." + std::to_string(screenIndex);
+
+        monitor.dpi = Dpi(monitor.size, screen->width_in_millimeters, screen->height_in_millimeters);
+
+        return monitor;
+    }
+
+    // RandR 1.5 monitors of a screen, primary first. Each is identified by its name atom (the output name or the name given to xrandr --setmonitor),
+    // which the X server keeps for as long as it runs. false if the X server has no RandR 1.5.
+    static bool HasRandR15(xcb_connection_t* connection) {
+        const xcb_query_extension_reply_t* extension = xcb_get_extension_data(connection, &xcb_randr_id);
+        if (!extension || !extension->present) return false;
+
+        xcb_randr_query_version_reply_t* version = xcb_randr_query_version_reply(connection, xcb_randr_query_version(connection, 1, 5), nullptr);
+        const bool supported = version && (version->major_version > 1 || version->minor_version >= 5);
+        free(version);
+        return supported;
+    }
+
+    static bool QueryRandRMonitors(xcb_connection_t* connection, const xcb_screen_t* screen, std::vector<Monitor>& monitors) {
+        if (!HasRandR15(connection)) return false;
+
+        xcb_randr_get_monitors_reply_t* reply = xcb_randr_get_monitors_reply(connection, xcb_randr_get_monitors(connection, screen->root, 1), nullptr);
+        if (!reply) return false;
+
+        // Ask for every name at once.
+        const size_t first = monitors.size();
+        std::vector<xcb_get_atom_name_cookie_t> names{};
+        for (xcb_randr_monitor_info_iterator_t it = xcb_randr_get_monitors_monitors_iterator(reply); it.rem; xcb_randr_monitor_info_next(&it)) {
+            const xcb_randr_monitor_info_t& info = *it.data;
+
+            Monitor monitor{};
+            monitor.size = { (int32_t)info.width, (int32_t)info.height };
+            monitor.position = { (int32_t)info.x, (int32_t)info.y };
+            monitor.dpi = Dpi(monitor.size, info.width_in_millimeters, info.height_in_millimeters);
+            monitor.id = (uint64_t)info.name;
+
+            if (info.primary) {
+                monitors.insert(monitors.begin() + first, monitor);
+                names.insert(names.begin(), xcb_get_atom_name(connection, info.name));
+            }
+            else {
+                monitors.push_back(monitor);
+                names.push_back(xcb_get_atom_name(connection, info.name));
+            }
+        }
+
+        for (size_t i = 0; i < names.size(); i++) {
+            xcb_get_atom_name_reply_t* name = xcb_get_atom_name_reply(connection, names[i], nullptr);
+            if (name) monitors[first + i].name.assign(xcb_get_atom_name_name(name), (size_t)xcb_get_atom_name_name_length(name));
+            free(name);
+        }
+
+        free(reply);
+        return true;
+    }
+
+    bool Monitor::QueryMonitorsNative(std::vector<Monitor>& monitors) {
+        int32_t primaryScreen = 0;
+        xcb_connection_t* connection = xcb_connect(nullptr, &primaryScreen);
+
+        if (xcb_connection_has_error(connection)) {
+            xcb_disconnect(connection);
+            IWINDOW_CHECK_ERROR(true, ErrorType::Monitor, ErrorSeverity::Error, "xcb_connect() failed. Failed to get monitor information!", true, false);
+        }
+
+        // The default screen goes first so its primary monitor is the primary monitor.
+        std::vector<const xcb_screen_t*> screens{};
+        for (xcb_screen_iterator_t it = xcb_setup_roots_iterator(xcb_get_setup(connection)); it.rem; xcb_screen_next(&it))
+            screens.push_back(it.data);
+
+        for (size_t i = 0; i < screens.size(); i++) {
+            const size_t screenIndex = i == 0 ? (size_t)primaryScreen : i == (size_t)primaryScreen ? 0 : i;
+            if (screenIndex >= screens.size()) continue;
+
+            if (QueryRandRMonitors(connection, screens[screenIndex], monitors)) continue;
+
+            Monitor monitor = ScreenToMonitor(screens[screenIndex], (int32_t)screenIndex);
+            monitor.id = IdFromName(monitor.name);
+            monitors.push_back(std::move(monitor));
+        }
+
+        xcb_disconnect(connection);
+
+        return true;
+    }
+
+    // The CRTC showing a RandR 1.5 monitor, found again on every call by the monitor's name atom.
+    struct RandRCrtc {
+        xcb_window_t root;
+        uint8_t depth;
+        xcb_randr_crtc_t crtc;
+        xcb_randr_get_screen_resources_current_reply_t* resources;
+        xcb_randr_get_output_info_reply_t* output;
+        xcb_randr_get_crtc_info_reply_t* info;
+
+        ~RandRCrtc() {
+            free(resources);
+            free(output);
+            free(info);
+        }
+    };
+
+    // false for monitors without an output (xrandr --setmonitor) and outputs that are off.
+    static bool FindRandRCrtc(xcb_connection_t* connection, uint64_t id, RandRCrtc& crtc) {
+        if (!HasRandR15(connection)) return false;
+
+        xcb_randr_output_t output = XCB_NONE;
+        for (xcb_screen_iterator_t it = xcb_setup_roots_iterator(xcb_get_setup(connection)); it.rem && output == XCB_NONE; xcb_screen_next(&it)) {
+            xcb_randr_get_monitors_reply_t* reply = xcb_randr_get_monitors_reply(connection, xcb_randr_get_monitors(connection, it.data->root, 1), nullptr);
+            if (!reply) continue;
+
+            for (xcb_randr_monitor_info_iterator_t monitor = xcb_randr_get_monitors_monitors_iterator(reply); monitor.rem; xcb_randr_monitor_info_next(&monitor)) {
+                if ((uint64_t)monitor.data->name != id || !xcb_randr_monitor_info_outputs_length(monitor.data)) continue;
+
+                output = xcb_randr_monitor_info_outputs(monitor.data)[0];
+                crtc.root = it.data->root;
+                crtc.depth = it.data->root_depth;
+                break;
+            }
+
+            free(reply);
+        }
+        if (output == XCB_NONE) return false;
+
+        crtc.resources = xcb_randr_get_screen_resources_current_reply(connection, xcb_randr_get_screen_resources_current(connection, crtc.root), nullptr);
+        if (!crtc.resources) return false;
+
+        crtc.output = xcb_randr_get_output_info_reply(connection, xcb_randr_get_output_info(connection, output, crtc.resources->config_timestamp), nullptr);
+        if (!crtc.output || crtc.output->crtc == XCB_NONE) return false;
+
+        crtc.crtc = crtc.output->crtc;
+        crtc.info = xcb_randr_get_crtc_info_reply(connection, xcb_randr_get_crtc_info(connection, crtc.crtc, crtc.resources->config_timestamp), nullptr);
+        return crtc.info != nullptr;
+    }
+
+    static VideoMode ToVideoMode(const RandRCrtc& crtc, xcb_randr_mode_t id) {
+        const xcb_randr_mode_info_t* modes = xcb_randr_get_screen_resources_current_modes(crtc.resources);
+        for (int32_t i = 0; i < xcb_randr_get_screen_resources_current_modes_length(crtc.resources); i++) {
+            const xcb_randr_mode_info_t& info = modes[i];
+            if (info.id != id) continue;
+
+            VideoMode mode{};
+            mode.size = { (int32_t)info.width, (int32_t)info.height };
+            // The monitor is as wide as the mode is high when it is turned on its side.
+            if (crtc.info->rotation & (XCB_RANDR_ROTATION_ROTATE_90 | XCB_RANDR_ROTATION_ROTATE_270))
+                mode.size = { mode.size.height, mode.size.width };
+
+            double lines = (double)info.vtotal;
+            if (info.mode_flags & XCB_RANDR_MODE_FLAG_DOUBLE_SCAN) lines *= 2.0;
+            if (info.mode_flags & XCB_RANDR_MODE_FLAG_INTERLACE) lines /= 2.0;
+            mode.refreshRate = info.htotal && info.vtotal ? (double)info.dot_clock / ((double)info.htotal * lines) : 0.0;
+
+            mode.bitsPerPixel = crtc.depth;
+            return mode;
+        }
+
+        return {};
+    }
+
+    // The modes the CRTCs had before SetVideoModeNative, by monitor id.
+    struct SavedCrtc {
+        uint64_t monitorId;
+        xcb_window_t root;
+        xcb_randr_crtc_t crtc;
+        xcb_randr_mode_t mode;
+        int16_t x, y;
+        uint16_t rotation;
+        std::vector<xcb_randr_output_t> outputs;
+    };
+
+    static std::mutex s_savedCrtcMutex;
+    static std::vector<SavedCrtc> s_savedCrtcs{};
+
+    // Every call opens its own connection like QueryMonitorsNative. The X server keeps the modes after it is closed.
+    static xcb_connection_t* ConnectRandR() {
+        xcb_connection_t* connection = xcb_connect(nullptr, nullptr);
+        if (!xcb_connection_has_error(connection)) return connection;
+
+        xcb_disconnect(connection);
+        return nullptr;
+    }
+
+    static bool SetCrtcConfig(xcb_connection_t* connection, xcb_randr_crtc_t crtc, xcb_timestamp_t configTimestamp, int16_t x, int16_t y, xcb_randr_mode_t mode, uint16_t rotation, const std::vector<xcb_randr_output_t>& outputs) {
+        xcb_randr_set_crtc_config_reply_t* reply = xcb_randr_set_crtc_config_reply(connection, 
+            xcb_randr_set_crtc_config(connection, crtc, XCB_CURRENT_TIME, configTimestamp, x, y, mode, rotation, (uint32_t)outputs.size(), outputs.data()), nullptr);
+
+        const bool set = reply && reply->status == XCB_RANDR_SET_CONFIG_SUCCESS;
+        free(reply);
+        return set;
+    }
+
+    bool Monitor::GetVideoModesNative(std::vector<VideoMode>& modes) const {
+        xcb_connection_t* connection = ConnectRandR();
+        IWINDOW_CHECK_ERROR(!connection, ErrorType::Monitor, ErrorSeverity::Error, "xcb_connect() failed. Failed to get video modes!", true, false);
+
+        RandRCrtc crtc{};
+        const bool found = FindRandRCrtc(connection, id, crtc);
+        if (found) {
+            const xcb_randr_mode_t* outputModes = xcb_randr_get_output_info_modes(crtc.output);
+            for (int32_t i = 0; i < xcb_randr_get_output_info_modes_length(crtc.output); i++) {
+                const VideoMode mode = ToVideoMode(crtc, outputModes[i]);
+                if (!mode.IsEmpty()) modes.push_back(mode);
+            }
+        }
+
+        xcb_disconnect(connection);
+        IWINDOW_CHECK_ERROR(!found, ErrorType::Monitor, ErrorSeverity::Error, "The monitor has no RandR 1.5 output. Failed to get video modes!", true, false);
+
+        return true;
+    }
+
+    bool Monitor::GetCurrentVideoModeNative(VideoMode& mode) const {
+        xcb_connection_t* connection = ConnectRandR();
+        IWINDOW_CHECK_ERROR(!connection, ErrorType::Monitor, ErrorSeverity::Error, "xcb_connect() failed. Failed to get the current video mode!", true, false);
+
+        RandRCrtc crtc{};
+        const bool found = FindRandRCrtc(connection, id, crtc);
+        if (found) mode = ToVideoMode(crtc, crtc.info->mode);
+
+        xcb_disconnect(connection);
+        IWINDOW_CHECK_ERROR(!found, ErrorType::Monitor, ErrorSeverity::Error, "The monitor has no RandR 1.5 output. Failed to get the current video mode!", true, false);
+
+        return true;
+    }
+
+    // Called with the connection open. Returns the error message, nullptr if the mode was set.
+    static const char* SetVideoMode(xcb_connection_t* connection, uint64_t id, const VideoMode& mode) {
+        RandRCrtc crtc{};
+        if (!FindRandRCrtc(connection, id, crtc)) return "The monitor has no RandR 1.5 output. Failed to set the video mode!";
+
+        // The mode of the output with the same size and the closest refresh rate.
+        xcb_randr_mode_t closest = XCB_NONE;
+        double closestDifference = 0.0;
+        const xcb_randr_mode_t* outputModes = xcb_randr_get_output_info_modes(crtc.output);
+        for (int32_t i = 0; i < xcb_randr_get_output_info_modes_length(crtc.output); i++) {
+            const VideoMode supported = ToVideoMode(crtc, outputModes[i]);
+            if (supported.size.width != mode.size.width || supported.size.height != mode.size.height) continue;
+
+            const double difference = std::abs(supported.refreshRate - mode.refreshRate);
+            if (closest == XCB_NONE || difference < closestDifference) {
+                closest = outputModes[i];
+                closestDifference = difference;
+            }
+        }
+        if (closest == XCB_NONE) return "The monitor has no video mode of that size. Failed to set the video mode!";
+
+        const xcb_randr_output_t* outputs = xcb_randr_get_crtc_info_outputs(crtc.info);
+        const std::vector<xcb_randr_output_t> crtcOutputs(outputs, outputs + xcb_randr_get_crtc_info_outputs_length(crtc.info));
+
+        // Modes bigger than the screen are refused. The X server doesn't grow the screen for them.
+        if (!SetCrtcConfig(connection, crtc.crtc, crtc.resources->config_timestamp, crtc.info->x, crtc.info->y, closest, crtc.info->rotation, crtcOutputs))
+            return "xcb_randr_set_crtc_config() failed. Failed to set the video mode!";
+
+        std::lock_guard<std::mutex> lock(s_savedCrtcMutex);
+        for (const SavedCrtc& saved : s_savedCrtcs)
+            if (saved.monitorId == id) return nullptr;
+
+        s_savedCrtcs.push_back({ id, crtc.root, crtc.crtc, crtc.info->mode, crtc.info->x, crtc.info->y, crtc.info->rotation, crtcOutputs });
+        return nullptr;
+    }
+
+    bool Monitor::SetVideoModeNative(const VideoMode& mode) const {
+        xcb_connection_t* connection = ConnectRandR();
+        IWINDOW_CHECK_ERROR(!connection, ErrorType::Monitor, ErrorSeverity::Error, "xcb_connect() failed. Failed to set the video mode!", true, false);
+
+        const char* error = SetVideoMode(connection, id, mode);
+
+        xcb_disconnect(connection);
+        IWINDOW_CHECK_ERROR(error, ErrorType::Monitor, ErrorSeverity::Error, error, true, false);
+
+        return true;
+    }
+
+    void Monitor::RestoreVideoModeNative() const {
+        SavedCrtc saved{};
+        {
+            std::lock_guard<std::mutex> lock(s_savedCrtcMutex);
+            std::vector<SavedCrtc>::iterator it = s_savedCrtcs.begin();
+            while (it != s_savedCrtcs.end() && it->monitorId != id) ++it;
+            if (it == s_savedCrtcs.end()) return;
+
+            saved = std::move(*it);
+            s_savedCrtcs.erase(it);
+        }
+
+        xcb_connection_t* connection = ConnectRandR();
+        if (!connection) return;
+
+        // The configuration changed with the switch, so its timestamp is asked for again.
+        xcb_randr_get_screen_resources_current_reply_t* resources = xcb_randr_get_screen_resources_current_reply(connection, xcb_randr_get_screen_resources_current(connection, saved.root), nullptr);
+        if (resources) SetCrtcConfig(connection, saved.crtc, resources->config_timestamp, saved.x, saved.y, saved.mode, saved.rotation, saved.outputs);
+
+        free(resources);
+        xcb_disconnect(connection);
+    }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,317 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_XLIB)
+
+#include "IWindowUtils.h"
+
+#include "IWindow.h"
+
+#include <X11/Xlib.h>
+#include <X11/extensions/Xrandr.h>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+
+namespace IWindow {
+    // 25.4 millimeters in an inch
+    static Vector2<uint32_t> Dpi(Vector2<int32_t> size, int32_t widthMM, int32_t heightMM) {
+        if (widthMM <= 0 || heightMM <= 0) return {};
+        return { (uint32_t)(size.x * 25.4f / widthMM + 0.5f), (uint32_t)(size.y * 25.4f / heightMM + 0.5f) };
+    }
+
+    // Without RandR every X screen is reported as one monitor.
+    static Monitor ScreenToMonitor(Display* display, int32_t screenIndex) {
+        Monitor monitor{};
+
+        monitor.size.x = (int32_t)DisplayWidth(display, screenIndex);
+        monitor.size.y = (int32_t)DisplayHeight(display, screenIndex);
+        monitor.position.x = 0;
+        monitor.position.y = 0;
+
+        const char* name = std::getenv("DISPLAY");
+        monitor.name = std::string{ name ? name : ":0" } + "." + std::to_string(screenIndex);
+
+        monitor.dpi = Dpi(monitor.size, DisplayWidthMM(display, screenIndex), DisplayHeightMM(display, screenIndex));
+
+        return monitor;
+    }
+
+    // RandR 1.5 monitors of a screen, primary first. Each is identified by its name atom (the output name or the name given to xrandr --setmonitor),
+    // which the X server keeps for as long as it runs. false if the X server has no RandR 1.5.
+    static bool HasRandR15(Display* display) {
+        int event, error, major = 1, minor = 5;
+        return XRRQueryExtension(display, &event, &error) && XRRQueryVersion(display, &major, &minor) && (major > 1 || minor >= 5);
+    }
+
+    static bool QueryRandRMonitors(Display* display, int32_t screenIndex, std::vector<Monitor>& monitors) {
+        if (!HasRandR15(display)) return false;
+
+        int count = 0;
+        XRRMonitorInfo* infos = XRRGetMonitors(display, RootWindow(display, screenIndex), True, &count);
+        if (!infos) return false;
+
+        const size_t first = monitors.size();
+        for (int i = 0; i < count; i++) {
+            const XRRMonitorInfo& info = infos[i];
+
+            Monitor monitor{};
+            monitor.size = { info.width, info.height };
+            monitor.position = { info.x, info.y };
+            monitor.dpi = Dpi(monitor.size, info.mwidth, info.mheight);
+            monitor.id = (uint64_t)info.name;
+
+            if (char* name = XGetAtomName(display, info.name)) {
+                monitor.name = name;
+                XFree(name);
+            }
+
+            if (info.primary) monitors.insert(monitors.begin() + first, std::move(monitor));
+            else monitors.push_back(std::move(monitor));
+        }
+
+        XRRFreeMonitors(infos);
+        return true;
+    }
+
+    bool Monitor::QueryMonitorsNative(std::vector<Monitor>& monitors) {
+        Display* display = XOpenDisplay(nullptr);
+
+        IWINDOW_CHECK_ERROR(!display, ErrorType::Monitor, ErrorSeverity::Error, "XOpenDisplay() failed. Failed to get monitor information!", true, false);
+
+        // The default screen goes first so its primary monitor is the primary monitor.
+        const int32_t defaultScreen = DefaultScreen(display);
+        for (int32_t i = 0; i < ScreenCount(display); i++) {
+            const int32_t screenIndex = i == 0 ? defaultScreen : i == defaultScreen ? 0 : i;
+
+            if (QueryRandRMonitors(display, screenIndex, monitors)) continue;
+
+            Monitor monitor = ScreenToMonitor(display, screenIndex);
+            monitor.id = IdFromName(monitor.name);
+            monitors.push_back(std::move(monitor));
+        }
+
+        XCloseDisplay(display);
+
+        return true;
+    }
+
+    // The CRTC showing a RandR 1.5 monitor, found again on every call by the monitor's name atom.
+    struct RandRCrtc {
+        ::Window root;
+        uint32_t depth;
+        RRCrtc crtc;
+        XRRScreenResources* resources;
+        XRROutputInfo* output;
+        XRRCrtcInfo* info;
+
+        ~RandRCrtc() {
+            if (info) XRRFreeCrtcInfo(info);
+            if (output) XRRFreeOutputInfo(output);
+            if (resources) XRRFreeScreenResources(resources);
+        }
+    };
+
+    // false for monitors without an output (xrandr --setmonitor) and outputs that are off.
+    static bool FindRandRCrtc(Display* display, uint64_t id, RandRCrtc& crtc) {
+        if (!HasRandR15(display)) return false;
+
+        RROutput output = None;
+        for (int32_t screenIndex = 0; screenIndex < ScreenCount(display) && output == None; screenIndex++) {
+            int count = 0;
+            XRRMonitorInfo* infos = XRRGetMonitors(display, RootWindow(display, screenIndex), True, &count);
+            if (!infos) continue;
+
+            for (int i = 0; i < count; i++) {
+                if ((uint64_t)infos[i].name != id || !infos[i].noutput) continue;
+
+                output = infos[i].outputs[0];
+                crtc.root = RootWindow(display, screenIndex);
+                crtc.depth = (uint32_t)DefaultDepth(display, screenIndex);
+                break;
+            }
+
+            XRRFreeMonitors(infos);
+        }
+        if (output == None) return false;
+
+        crtc.resources = XRRGetScreenResourcesCurrent(display, crtc.root);
+        if (!crtc.resources) return false;
+
+        crtc.output = XRRGetOutputInfo(display, crtc.resources, output);
+        if (!crtc.output || crtc.output->crtc == None) return false;
+
+        crtc.crtc = crtc.output->crtc;
+        crtc.info = XRRGetCrtcInfo(display, crtc.resources, crtc.crtc);
+        return crtc.info != nullptr;
+    }
+
+    static VideoMode ToVideoMode(const RandRCrtc& crtc, RRMode id) {
+        for (int i = 0; i < crtc.resources->nmode; i++) {
+            const XRRModeInfo& info = crtc.resources->modes[i];
+            if (info.id != id) continue;
+
+            VideoMode mode{};
+            mode.size = { (int32_t)info.width, (int32_t)info.height };
+            // The monitor is as wide as the mode is high when it is turned on its side.
+            if (crtc.info->rotation & (RR_Rotate_90 | RR_Rotate_270))
+                mode.size = { mode.size.height, mode.size.width };
+
+            double lines = (double)info.vTotal;
+            if (info.modeFlags & RR_DoubleScan) lines *= 2.0;
+            if (info.modeFlags & RR_Interlace) lines /= 2.0;
+            mode.refreshRate = info.hTotal && info.vTotal ? (double)info.dotClock / ((double)info.hTotal * lines) : 0.0;
+
+            mode.bitsPerPixel = crtc.depth;
+            return mode;
+        }
+
+        return {};
+    }
+
+    // The modes the CRTCs had before SetVideoModeNative, by monitor id.
+    struct SavedCrtc {
+        uint64_t monitorId;
+        ::Window root;
+        RRCrtc crtc;
+        RRMode mode;
+        int x, y;
+        Rotation rotation;
+        std::vector<RROutput> outputs;
+    };
+
+    static std::mutex s_savedCrtcMutex;
+    static std::vector<SavedCrtc> s_savedCrtcs{};
+
+    bool Monitor::GetVideoModesNative(std::vector<VideoMode>& modes) const {
+        // Every call opens its own display like QueryMonitorsNative. The X server keeps the modes after it is closed.
+        Display* display = XOpenDisplay(nullptr);
+        IWINDOW_CHECK_ERROR(!display, ErrorType::Monitor, ErrorSeverity::Error, "XOpenDisplay() failed. Failed to get video modes!", true, false);
+
+        bool found = false;
+        {
+            RandRCrtc crtc{};
+            found = FindRandRCrtc(display, id, crtc);
+            for (int i = 0; found && i < crtc.output->nmode; i++) {
+                const VideoMode mode = ToVideoMode(crtc, crtc.output->modes[i]);
+                if (!mode.IsEmpty()) modes.push_back(mode);
+            }
+        }
+
+        XCloseDisplay(display);
+        IWINDOW_CHECK_ERROR(!found, ErrorType::Monitor, ErrorSeverity::Error, "The monitor has no RandR 1.5 output. Failed to get video modes!", true, false);
+
+        return true;
+    }
+
+    bool Monitor::GetCurrentVideoModeNative(VideoMode& mode) const {
+        Display* display = XOpenDisplay(nullptr);
+        IWINDOW_CHECK_ERROR(!display, ErrorType::Monitor, ErrorSeverity::Error, "XOpenDisplay() failed. Failed to get the current video mode!", true, false);
+
+        bool found = false;
+        {
+            RandRCrtc crtc{};
+            found = FindRandRCrtc(display, id, crtc);
+            if (found) mode = ToVideoMode(crtc, crtc.info->mode);
+        }
+
+        XCloseDisplay(display);
+        IWINDOW_CHECK_ERROR(!found, ErrorType::Monitor, ErrorSeverity::Error, "The monitor has no RandR 1.5 output. Failed to get the current video mode!", true, false);
+
+        return true;
+    }
+
+    // Called with the display open. Returns the error message, nullptr if the mode was set.
+    static const char* SetVideoMode(Display* display, uint64_t id, const VideoMode& mode) {
+        RandRCrtc crtc{};
+        if (!FindRandRCrtc(display, id, crtc)) return "The monitor has no RandR 1.5 output. Failed to set the video mode!";
+
+        // The mode of the output with the same size and the closest refresh rate.
+        RRMode closest = None;
+        double closestDifference = 0.0;
+        for (int i = 0; i < crtc.output->nmode; i++) {
+            const VideoMode supported = ToVideoMode(crtc, crtc.output->modes[i]);
+            if (supported.size.width != mode.size.width || supported.size.height != mode.size.height) continue;
+
+            const double difference = std::abs(supported.refreshRate - mode.refreshRate);
+            if (closest == None || difference < closestDifference) {
+                closest = crtc.output->modes[i];
+                closestDifference = difference;
+            }
+        }
+        if (closest == None) return "The monitor has no video mode of that size. Failed to set the video mode!";
+
+        // Modes bigger than the screen are refused. The X server doesn't grow the screen for them.
+        if (XRRSetCrtcConfig(display, crtc.resources, crtc.crtc, CurrentTime, crtc.info->x, crtc.info->y, closest, crtc.info->rotation, crtc.info->outputs, crtc.info->noutput) != RRSetConfigSuccess)
+            return "XRRSetCrtcConfig() failed. Failed to set the video mode!";
+
+        std::lock_guard<std::mutex> lock(s_savedCrtcMutex);
+        for (const SavedCrtc& saved : s_savedCrtcs)
+            if (saved.monitorId == id) return nullptr;
+
+        s_savedCrtcs.push_back({ id, crtc.root, crtc.crtc, crtc.info->mode, crtc.info->x, crtc.info->y, crtc.info->rotation, 
+            std::vector<RROutput>(crtc.info->outputs, crtc.info->outputs + crtc.info->noutput) });
+        return nullptr;
+    }
+
+    bool Monitor::SetVideoModeNative(const VideoMode& mode) const {
+        Display* display = XOpenDisplay(nullptr);
+        IWINDOW_CHECK_ERROR(!display, ErrorType::Monitor, ErrorSeverity::Error, "XOpenDisplay() failed. Failed to set the video mode!", true, false);
+
+        const char* error = SetVideoMode(display, id, mode);
+
+        XCloseDisplay(display);
+        IWINDOW_CHECK_ERROR(error, ErrorType::Monitor, ErrorSeverity::Error, error, true, false);
+
+        return true;
+    }
+
+    void Monitor::RestoreVideoModeNative() const {
+        SavedCrtc saved{};
+        {
+            std::lock_guard<std::mutex> lock(s_savedCrtcMutex);
+            std::vector<SavedCrtc>::iterator it = s_savedCrtcs.begin();
+            while (it != s_savedCrtcs.end() && it->monitorId != id) ++it;
+            if (it == s_savedCrtcs.end()) return;
+
+            saved = std::move(*it);
+            s_savedCrtcs.erase(it);
+        }
+
+        Display* display = XOpenDisplay(nullptr);
+        if (!display) return;
+
+        // The configuration changed with the switch, so the resources are asked for again.
+        if (XRRScreenResources* resources = XRRGetScreenResourcesCurrent(display, saved.root)) {
+            XRRSetCrtcConfig(display, resources, saved.crtc, CurrentTime, saved.x, saved.y, saved.mode, saved.rotation, saved.outputs.data(), (int)saved.outputs.size());
+            XRRFreeScreenResources(resources);
+        }
+
+        XCloseDisplay(display);
+    }
+}
+#endif
\ No newline at end of file
@@ -47,5 +47,18 @@ namespace IWindow {
         /// <param name="surface">The VkSurfaceKHR handle that IWindow will store the surface in.</param>
         /// <returns>Return the value of the vkCreateXXXXSurfaceKHR function.</returns>
         VkResult IWINDOW_API CreateSurface(Window& window, VkInstance& instance, VkSurfaceKHR& surface);
+        /// <summary>
+        /// Calls vkQueuePresentKHR and records the present for Window::GetLatencyStats. Use it instead of vkQueuePresentKHR to fill the latency histogram.
+        /// Only call from the thread that calls Window::Update.
+        /// </summary>
+        /// <param name="window">The window the swapchain was created for.</param>
+        /// <param name="queue">A queue that can present to the window's surface.</param>
+        /// <param name="presentInfo">Passed to vkQueuePresentKHR.</param>
+        /// <returns>Return the value of vkQueuePresentKHR.</returns>
+        inline VkResult QueuePresent(Window& window, VkQueue queue, const VkPresentInfoKHR& presentInfo) {
+            // The same for every backend, so it doesn't need a translation unit per platform.
+            window.MarkPresent();
+            return vkQueuePresentKHR(queue, &presentInfo);
+        }
     }
 }
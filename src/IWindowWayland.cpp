@@ -0,0 +1,1199 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_WAYLAND)
+
+#include "IWindowWindow.h"
+#include "IWindowUtilsLinux.h"
+
+// Generated by wayland-scanner from xdg-shell.xml. See premake5.lua.
+#include "xdg-shell-client-protocol.h"
+
+#include <wayland-cursor.h>
+#include <xkbcommon/xkbcommon.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace IWindow {
+    // Mime types IWindow offers and asks for when using the clipboard.
+    static const char* UTF8_MIME_TYPE = "text/plain;charset=utf-8";
+    static const char* URI_LIST_MIME_TYPE = "text/uri-list";
+
+    // Linux button codes. See linux/input-event-codes.h.
+    static MouseButton WaylandButtonToMouseButton(uint32_t button) {
+        switch (button)
+        {
+        case 0x110: // BTN_LEFT
+            return MouseButton::Left;
+        case 0x111: // BTN_RIGHT
+            return MouseButton::Right;
+        case 0x112: // BTN_MIDDLE
+            return MouseButton::Middle;
+        case 0x113: // BTN_SIDE
+            return MouseButton::Side1;
+        case 0x114: // BTN_EXTRA
+            return MouseButton::Side2;
+        default:
+            return MouseButton::Max;
+        }
+    }
+
+    // Reads what the other client writes for a wl_data_offer. Waits at most a second for every chunk.
+    static std::string ReceiveDataOffer(wl_display* display, wl_data_offer* offer, const char* mimeType) {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0) return std::string{};
+
+        wl_data_offer_receive(offer, mimeType, fds[1]);
+        close(fds[1]);
+        wl_display_flush(display);
+
+        std::string data{};
+        char buffer[4096];
+
+        while (true) {
+            pollfd fd{ fds[0], POLLIN, 0 };
+            if (::poll(&fd, 1, 1000) <= 0) break;
+
+            ssize_t count = read(fds[0], buffer, sizeof(buffer));
+            if (count <= 0) break;
+
+            data.append(buffer, (size_t)count);
+        }
+
+        close(fds[0]);
+
+        return data;
+    }
+
+    static wl_buffer* CreateShmBuffer(wl_shm* shm, Image image) {
+        const int32_t stride = (int32_t)image.size.width * 4;
+        const int32_t size = stride * (int32_t)image.size.height;
+
+        int fd = memfd_create("IWindow", MFD_CLOEXEC);
+        if (fd < 0) return nullptr;
+
+        if (ftruncate(fd, size) != 0) {
+            close(fd);
+            return nullptr;
+        }
+
+        uint8_t* pixels = (uint8_t*)mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (pixels == MAP_FAILED) {
+            close(fd);
+            return nullptr;
+        }
+
+        // WL_SHM_FORMAT_ARGB8888 is little endian so the bytes are B, G, R, A. The alpha is premultiplied.
+        const uint8_t* source = image.data;
+        for (int32_t i = 0; i < size; i += 4) {
+            const uint32_t alpha = source[3];
+            pixels[i + 0] = (uint8_t)(source[2] * alpha / 255);
+            pixels[i + 1] = (uint8_t)(source[1] * alpha / 255);
+            pixels[i + 2] = (uint8_t)(source[0] * alpha / 255);
+            pixels[i + 3] = (uint8_t)alpha;
+            source += 4;
+        }
+
+        munmap(pixels, (size_t)size);
+
+        wl_shm_pool* pool = wl_shm_create_pool(shm, fd, size);
+        wl_buffer* buffer = wl_shm_pool_create_buffer(pool, 0, (int32_t)image.size.width, (int32_t)image.size.height, stride, WL_SHM_FORMAT_ARGB8888);
+        wl_shm_pool_destroy(pool);
+        close(fd);
+
+        return buffer;
+    }
+
+    /// <summary>
+    /// Wayland listeners. Every listener gets the IWindow::Window as its user data.
+    /// </summary>
+    struct WaylandListeners {
+        static const wl_registry_listener registryListener;
+        static const wl_output_listener outputListener;
+        static const wl_surface_listener surfaceListener;
+        static const wl_callback_listener frameListener;
+        static const xdg_wm_base_listener wmBaseListener;
+        static const xdg_surface_listener xdgSurfaceListener;
+        static const xdg_toplevel_listener toplevelListener;
+        static const wl_seat_listener seatListener;
+        static const wl_keyboard_listener keyboardListener;
+        static const wl_pointer_listener pointerListener;
+        static const wl_data_device_listener dataDeviceListener;
+        static const wl_data_source_listener dataSourceListener;
+
+        // wl_registry
+
+        static void Global(void* data, wl_registry* registry, uint32_t name, const char* interface, uint32_t version) {
+            Window& window = *(Window*)data;
+            WaylandWindowData& wl = window.m_wl;
+
+            if (strcmp(interface, wl_compositor_interface.name) == 0) {
+                wl.compositor = (wl_compositor*)wl_registry_bind(registry, name, &wl_compositor_interface, std::min(version, 4u));
+            }
+            else if (strcmp(interface, wl_shm_interface.name) == 0) {
+                wl.shm = (wl_shm*)wl_registry_bind(registry, name, &wl_shm_interface, 1);
+            }
+            else if (strcmp(interface, xdg_wm_base_interface.name) == 0) {
+                wl.wmBase = (xdg_wm_base*)wl_registry_bind(registry, name, &xdg_wm_base_interface, 1);
+                xdg_wm_base_add_listener(wl.wmBase, &wmBaseListener, data);
+            }
+            else if (strcmp(interface, wl_seat_interface.name) == 0 && !wl.seat) {
+                // Version 4 for wl_keyboard.repeat_info.
+                wl.seat = (wl_seat*)wl_registry_bind(registry, name, &wl_seat_interface, std::min(version, 4u));
+                wl_seat_add_listener(wl.seat, &seatListener, data);
+            }
+            else if (strcmp(interface, wl_data_device_manager_interface.name) == 0) {
+                wl.dataDeviceManager = (wl_data_device_manager*)wl_registry_bind(registry, name, &wl_data_device_manager_interface, std::min(version, 3u));
+            }
+            else if (strcmp(interface, wl_output_interface.name) == 0) {
+                // Version 2 for wl_output.scale.
+                wl_output* output = (wl_output*)wl_registry_bind(registry, name, &wl_output_interface, std::min(version, 2u));
+                wl_output_add_listener(output, &outputListener, data);
+                wl.outputs.push_back({ output, name, 1 });
+
+                // Outputs announced after the window was configured are hot-plugs.
+                if (wl.configured) {
+                    Monitor::InvalidateCache();
+                    window.UpdateMonitors();
+                }
+            }
+        }
+
+        static void GlobalRemove(void* data, wl_registry*, uint32_t name) {
+            Window& window = *(Window*)data;
+            WaylandWindowData& wl = window.m_wl;
+
+            auto it = std::find_if(wl.outputs.begin(), wl.outputs.end(), [name](const WaylandOutput& output) { return output.name == name; });
+            if (it == wl.outputs.end()) return;
+
+            wl.surfaceOutputs.erase(std::remove(wl.surfaceOutputs.begin(), wl.surfaceOutputs.end(), it->output), wl.surfaceOutputs.end());
+            wl_output_destroy(it->output);
+            wl.outputs.erase(it);
+
+            UpdateScale(window);
+
+            Monitor::InvalidateCache();
+            window.UpdateMonitors();
+        }
+
+        // wl_output
+
+        static void OutputGeometry(void*, wl_output*, int32_t, int32_t, int32_t, int32_t, int32_t, const char*, const char*, int32_t) {}
+        static void OutputMode(void*, wl_output*, uint32_t, int32_t, int32_t, int32_t) {}
+        static void OutputDone(void* data, wl_output*) { UpdateScale(*(Window*)data); }
+        static void OutputName(void*, wl_output*, const char*) {}
+        static void OutputDescription(void*, wl_output*, const char*) {}
+
+        static void OutputScale(void* data, wl_output* output, int32_t scale) {
+            for (WaylandOutput& waylandOutput : ((Window*)data)->m_wl.outputs)
+                if (waylandOutput.output == output) waylandOutput.scale = scale;
+        }
+
+        // The buffer scale is the largest scale of the outputs the window is on.
+        static void UpdateScale(Window& window) {
+            WaylandWindowData& wl = window.m_wl;
+
+            int32_t scale = 1;
+            for (const WaylandOutput& output : wl.outputs)
+                if (std::find(wl.surfaceOutputs.begin(), wl.surfaceOutputs.end(), output.output) != wl.surfaceOutputs.end())
+                    scale = std::max(scale, output.scale);
+
+            if (scale == wl.scale || !window.m_window) return;
+
+            wl.scale = scale;
+            wl_surface_set_buffer_scale(window.m_window, scale);
+
+            window.m_framebufferSize = { window.m_size.width * scale, window.m_size.height * scale };
+            window.EmitFramebufferSizeEvent(window.m_framebufferSize);
+            window.EmitDPIChangedEvent({ 96 * (uint32_t)scale, 96 * (uint32_t)scale });
+        }
+
+        // wl_surface
+
+        static void SurfaceEnter(void* data, wl_surface*, wl_output* output) {
+            Window& window = *(Window*)data;
+            window.m_wl.surfaceOutputs.push_back(output);
+            UpdateScale(window);
+        }
+
+        static void SurfaceLeave(void* data, wl_surface*, wl_output* output) {
+            Window& window = *(Window*)data;
+            std::vector<wl_output*>& outputs = window.m_wl.surfaceOutputs;
+            outputs.erase(std::remove(outputs.begin(), outputs.end(), output), outputs.end());
+            UpdateScale(window);
+        }
+
+        // wl_surface.frame
+
+        static void FrameDone(void* data, wl_callback* callback, uint32_t) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            wl_callback_destroy(callback);
+            wl.frameCallback = nullptr;
+            wl.frameReady = true;
+        }
+
+        // xdg_wm_base
+
+        static void Ping(void*, xdg_wm_base* wmBase, uint32_t serial) { xdg_wm_base_pong(wmBase, serial); }
+
+        // xdg_surface and xdg_toplevel
+
+        static void XdgSurfaceConfigure(void* data, xdg_surface* xdgSurface, uint32_t serial) {
+            Window& window = *(Window*)data;
+            WaylandWindowData& wl = window.m_wl;
+
+            xdg_surface_ack_configure(xdgSurface, serial);
+
+            // 0 means the client picks the size.
+            if (wl.pendingWidth > 0 && wl.pendingHeight > 0 && (wl.pendingWidth != window.m_size.width || wl.pendingHeight != window.m_size.height)) {
+                window.m_size = { wl.pendingWidth, wl.pendingHeight };
+                window.m_framebufferSize = { window.m_size.width * wl.scale, window.m_size.height * wl.scale };
+
+                window.EmitWindowSizeEvent(window.m_size);
+                window.EmitFramebufferSizeEvent(window.m_framebufferSize);
+            }
+
+            if (wl.pendingMaximized != window.m_maximized) {
+                window.m_maximized = wl.pendingMaximized;
+                window.EmitWindowMaximizedEvent(window.m_maximized);
+            }
+
+            window.m_fullscreen = wl.pendingFullscreen;
+            wl.configured = true;
+        }
+
+        static void ToplevelConfigure(void* data, xdg_toplevel*, int32_t width, int32_t height, wl_array* states) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            wl.pendingWidth = width;
+            wl.pendingHeight = height;
+            wl.pendingMaximized = false;
+            wl.pendingFullscreen = false;
+
+            const uint32_t* state = (const uint32_t*)states->data;
+            for (size_t i = 0; i < states->size / sizeof(uint32_t); i++) {
+                if (state[i] == XDG_TOPLEVEL_STATE_MAXIMIZED) wl.pendingMaximized = true;
+                if (state[i] == XDG_TOPLEVEL_STATE_FULLSCREEN) wl.pendingFullscreen = true;
+            }
+        }
+
+        static void ToplevelClose(void* data, xdg_toplevel*) { ((Window*)data)->m_running = false; }
+
+        // wl_seat
+
+        static void SeatCapabilities(void* data, wl_seat* seat, uint32_t capabilities) {
+            Window& window = *(Window*)data;
+            WaylandWindowData& wl = window.m_wl;
+
+            if ((capabilities & WL_SEAT_CAPABILITY_KEYBOARD) && !wl.keyboard) {
+                wl.keyboard = wl_seat_get_keyboard(seat);
+                wl_keyboard_add_listener(wl.keyboard, &keyboardListener, data);
+            }
+            else if (!(capabilities & WL_SEAT_CAPABILITY_KEYBOARD) && wl.keyboard) {
+                wl_keyboard_destroy(wl.keyboard);
+                wl.keyboard = nullptr;
+                wl.repeatKey = 0;
+            }
+
+            if ((capabilities & WL_SEAT_CAPABILITY_POINTER) && !wl.pointer) {
+                wl.pointer = wl_seat_get_pointer(seat);
+                wl_pointer_add_listener(wl.pointer, &pointerListener, data);
+            }
+            else if (!(capabilities & WL_SEAT_CAPABILITY_POINTER) && wl.pointer) {
+                wl_pointer_destroy(wl.pointer);
+                wl.pointer = nullptr;
+            }
+        }
+
+        static void SeatName(void*, wl_seat*, const char*) {}
+
+        // wl_keyboard
+
+        static void KeyboardKeymap(void* data, wl_keyboard*, uint32_t format, int32_t fd, uint32_t size) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            if (format != WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1 || !wl.xkbContext) {
+                close(fd);
+                return;
+            }
+
+            char* keymapString = (char*)mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+
+            if (keymapString == MAP_FAILED) return;
+
+            xkb_keymap* keymap = xkb_keymap_new_from_string(wl.xkbContext, keymapString, XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS);
+            munmap(keymapString, size);
+
+            IWINDOW_CHECK_ERROR(!keymap, ErrorType::WindowApi, ErrorSeverity::Error, "xkb_keymap_new_from_string() failed. Failed to compile the keymap!", true, ;);
+
+            if (wl.xkbState) xkb_state_unref(wl.xkbState);
+            if (wl.keymap) xkb_keymap_unref(wl.keymap);
+
+            wl.keymap = keymap;
+            wl.xkbState = xkb_state_new(keymap);
+        }
+
+        static void KeyboardEnter(void* data, wl_keyboard*, uint32_t, wl_surface*, wl_array*) {
+            Window& window = *(Window*)data;
+
+            window.m_focused = true;
+            window.EmitWindowFocusEvent(window.m_focused);
+        }
+
+        static void KeyboardLeave(void* data, wl_keyboard*, uint32_t, wl_surface*) {
+            Window& window = *(Window*)data;
+
+            window.m_wl.repeatKey = 0;
+            window.m_focused = false;
+            window.EmitWindowFocusEvent(window.m_focused);
+        }
+
+        // Input events carry the compositor time in milliseconds. Events emitted until ClearEventTime get it.
+        static void SetEventTime(Window& window, uint32_t time) { window.m_eventTimestamp = window.TimestampFromAge(MonotonicEventAge(time)); }
+        static void ClearEventTime(Window& window) { window.m_eventTimestamp = 0; }
+
+        static void KeyboardKey(void* data, wl_keyboard*, uint32_t serial, uint32_t time, uint32_t key, uint32_t state) {
+            Window& window = *(Window*)data;
+            WaylandWindowData& wl = window.m_wl;
+
+            const InputState inputState = state == WL_KEYBOARD_KEY_STATE_PRESSED ? InputState::Down : InputState::Up;
+
+            if (inputState == InputState::Down) {
+                wl.inputSerial = serial;
+
+                // xkb key codes are evdev key codes + 8.
+                if (wl.keymap && wl.repeatRate > 0 && xkb_keymap_key_repeats(wl.keymap, key + 8)) {
+                    wl.repeatKey = key;
+                    wl.nextRepeat = std::chrono::steady_clock::now() + std::chrono::milliseconds(wl.repeatDelay);
+                }
+            }
+            else if (key == wl.repeatKey) {
+                wl.repeatKey = 0;
+            }
+
+            SetEventTime(window, time);
+            HandleKey(window, key, inputState);
+            ClearEventTime(window);
+        }
+
+        static void KeyboardModifiers(void* data, wl_keyboard*, uint32_t, uint32_t depressed, uint32_t latched, uint32_t locked, uint32_t group) {
+            Window& window = *(Window*)data;
+            WaylandWindowData& wl = window.m_wl;
+
+            if (!wl.xkbState) return;
+
+            xkb_state_update_mask(wl.xkbState, depressed, latched, locked, 0, 0, group);
+
+            KeyModifier mods{};
+
+            if (xkb_state_mod_name_is_active(wl.xkbState, XKB_MOD_NAME_SHIFT, XKB_STATE_MODS_EFFECTIVE) > 0)
+                mods |= KeyModifier::Shift;
+            if (xkb_state_mod_name_is_active(wl.xkbState, XKB_MOD_NAME_CTRL, XKB_STATE_MODS_EFFECTIVE) > 0)
+                mods |= KeyModifier::Control;
+            if (xkb_state_mod_name_is_active(wl.xkbState, XKB_MOD_NAME_ALT, XKB_STATE_MODS_EFFECTIVE) > 0)
+                mods |= KeyModifier::Alt;
+            if (xkb_state_mod_name_is_active(wl.xkbState, XKB_MOD_NAME_LOGO, XKB_STATE_MODS_EFFECTIVE) > 0)
+                mods |= KeyModifier::Super;
+            if (xkb_state_mod_name_is_active(wl.xkbState, XKB_MOD_NAME_CAPS, XKB_STATE_MODS_EFFECTIVE) > 0)
+                mods |= KeyModifier::CapsLock;
+            if (xkb_state_mod_name_is_active(wl.xkbState, XKB_MOD_NAME_NUM, XKB_STATE_MODS_EFFECTIVE) > 0)
+                mods |= KeyModifier::NumLock;
+
+            window.m_mods = mods;
+        }
+
+        static void KeyboardRepeatInfo(void* data, wl_keyboard*, int32_t rate, int32_t delay) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            // A rate of 0 turns key repeat off.
+            wl.repeatRate = rate;
+            wl.repeatDelay = delay;
+        }
+
+        static void HandleKey(Window& window, uint32_t keyCode, InputState inputState) {
+            WaylandWindowData& wl = window.m_wl;
+
+            Key key = EvdevKeyCodeToIWindowKey(keyCode);
+
+            // wl_keyboard.modifiers comes after the key. Include the modifier key itself so callbacks see the same modifiers as on Win32.
+            if (inputState == InputState::Down)
+                window.m_mods |= KeyToKeyModifier(key);
+            else
+                window.m_mods &= (KeyModifier)~(int64_t)KeyToKeyModifier(key);
+
+            if (key != Key::Max) {
+                // A press while the key is still down is a repeat.
+                bool repeat = inputState == InputState::Down && window.m_keys.Test((size_t)key);
+
+                window.m_keys.Set((size_t)key, inputState == InputState::Down);
+
+                window.EmitKeyEvent(key, window.m_mods, inputState, repeat);
+            }
+
+            if (inputState == InputState::Up || !wl.xkbState) return;
+
+            // Control and alt combinations are shortcuts not text.
+            if ((uint64_t)(window.m_mods & (KeyModifier::Control | KeyModifier::Alt))) return;
+
+            char32_t c = (char32_t)xkb_state_key_get_utf32(wl.xkbState, keyCode + 8);
+
+            // Dont input char if its backspace, ...
+            if (c < 32 || (c > 126 && c < 160))
+                return;
+
+            window.EmitCharEvent(c, window.m_mods);
+        }
+
+        // Wayland leaves key repeat to the client. Called after every dispatch.
+        static void RepeatKeys(Window& window) {
+            WaylandWindowData& wl = window.m_wl;
+
+            if (!wl.repeatKey || wl.repeatRate <= 0) return;
+
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            const std::chrono::microseconds interval{ 1000000 / wl.repeatRate };
+
+            // Don't send a burst of repeats after the application stalled.
+            if (now - wl.nextRepeat > std::chrono::seconds(1))
+                wl.nextRepeat = now;
+
+            while (wl.repeatKey && now >= wl.nextRepeat) {
+                HandleKey(window, wl.repeatKey, InputState::Down);
+                wl.nextRepeat += interval;
+            }
+        }
+
+        // wl_pointer
+
+        static void ApplyCursor(Window& window) {
+            WaylandWindowData& wl = window.m_wl;
+
+            if (!wl.pointer || !window.m_mouseEntered) return;
+
+            if (wl.cursorHidden) {
+                wl_pointer_set_cursor(wl.pointer, wl.pointerSerial, nullptr, 0, 0);
+                return;
+            }
+
+            // No cursor theme. Keep whatever cursor the compositor shows.
+            if (!window.m_cursor || !wl.cursorSurface) return;
+
+            wl_pointer_set_cursor(wl.pointer, wl.pointerSerial, wl.cursorSurface, wl.cursorHotX, wl.cursorHotY);
+            wl_surface_attach(wl.cursorSurface, window.m_cursor, 0, 0);
+            wl_surface_damage(wl.cursorSurface, 0, 0, INT32_MAX, INT32_MAX);
+            wl_surface_commit(wl.cursorSurface);
+        }
+
+        static void PointerEnter(void* data, wl_pointer*, uint32_t serial, wl_surface*, wl_fixed_t x, wl_fixed_t y) {
+            Window& window = *(Window*)data;
+
+            window.m_wl.pointerSerial = serial;
+            window.m_mousePosition = { wl_fixed_to_int(x), wl_fixed_to_int(y) };
+            window.m_mouseEntered = true;
+
+            ApplyCursor(window);
+
+            window.EmitMouseEnteredEvent(window.m_mouseEntered);
+        }
+
+        static void PointerLeave(void* data, wl_pointer*, uint32_t, wl_surface*) {
+            Window& window = *(Window*)data;
+
+            window.m_mouseEntered = false;
+            window.EmitMouseEnteredEvent(window.m_mouseEntered);
+        }
+
+        static void PointerMotion(void* data, wl_pointer*, uint32_t time, wl_fixed_t x, wl_fixed_t y) {
+            Window& window = *(Window*)data;
+
+            window.m_mousePosition = { wl_fixed_to_int(x), wl_fixed_to_int(y) };
+
+            SetEventTime(window, time);
+            window.EmitMouseMoveEvent(window.m_mousePosition);
+            ClearEventTime(window);
+        }
+
+        static void PointerButton(void* data, wl_pointer*, uint32_t serial, uint32_t time, uint32_t waylandButton, uint32_t state) {
+            Window& window = *(Window*)data;
+
+            const InputState inputState = state == WL_POINTER_BUTTON_STATE_PRESSED ? InputState::Down : InputState::Up;
+            if (inputState == InputState::Down) window.m_wl.inputSerial = serial;
+
+            MouseButton button = WaylandButtonToMouseButton(waylandButton);
+            if (button == MouseButton::Max) return;
+
+            window.m_mouseButtons.Set((size_t)button, inputState == InputState::Down);
+
+            SetEventTime(window, time);
+            window.EmitMouseButtonEvent(button, window.m_mods, inputState);
+            ClearEventTime(window);
+        }
+
+        static void PointerAxis(void* data, wl_pointer*, uint32_t time, uint32_t axis, wl_fixed_t value) {
+            Window& window = *(Window*)data;
+
+            // One wheel click is 10 units. Positive is down and right, IWindow uses up and left like Win32.
+            const float offset = (float)(-wl_fixed_to_double(value) / 10.0);
+
+            window.m_scrollOffset = { 0.0f, 0.0f };
+            if (axis == WL_POINTER_AXIS_VERTICAL_SCROLL) window.m_scrollOffset.y = offset;
+            else window.m_scrollOffset.x = offset;
+
+            SetEventTime(window, time);
+            window.EmitMouseScrollEvent(window.m_scrollOffset);
+            ClearEventTime(window);
+        }
+
+        // wl_data_device
+
+        static void DataOffer(void*, wl_data_device*, wl_data_offer*) {
+            // The offer is used by the enter or selection event that follows.
+        }
+
+        static void DataEnter(void* data, wl_data_device*, uint32_t serial, wl_surface*, wl_fixed_t x, wl_fixed_t y, wl_data_offer* offer) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            if (wl.dndOffer) wl_data_offer_destroy(wl.dndOffer);
+            wl.dndOffer = offer;
+            wl.dndX = wl_fixed_to_int(x);
+            wl.dndY = wl_fixed_to_int(y);
+
+            if (!offer) return;
+
+            wl_data_offer_accept(offer, serial, URI_LIST_MIME_TYPE);
+            if (wl_data_offer_get_version(offer) >= 3)
+                wl_data_offer_set_actions(offer, WL_DATA_DEVICE_MANAGER_DND_ACTION_COPY, WL_DATA_DEVICE_MANAGER_DND_ACTION_COPY);
+        }
+
+        static void DataLeave(void* data, wl_data_device*) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            if (wl.dndOffer) wl_data_offer_destroy(wl.dndOffer);
+            wl.dndOffer = nullptr;
+        }
+
+        static void DataMotion(void* data, wl_data_device*, uint32_t, wl_fixed_t x, wl_fixed_t y) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            wl.dndX = wl_fixed_to_int(x);
+            wl.dndY = wl_fixed_to_int(y);
+        }
+
+        static void DataDrop(void* data, wl_data_device*) {
+            Window& window = *(Window*)data;
+            WaylandWindowData& wl = window.m_wl;
+
+            if (!wl.dndOffer) return;
+
+            std::vector<std::wstring> paths = ParseUriList(ReceiveDataOffer(window.m_deviceContext, wl.dndOffer, URI_LIST_MIME_TYPE));
+            Vector2<int32_t> dropPosition{ wl.dndX, wl.dndY };
+
+            window.EmitMouseMoveEvent(dropPosition);
+            window.EmitPathDropEvent(paths, dropPosition);
+
+            if (wl_data_offer_get_version(wl.dndOffer) >= 3)
+                wl_data_offer_finish(wl.dndOffer);
+
+            wl_data_offer_destroy(wl.dndOffer);
+            wl.dndOffer = nullptr;
+        }
+
+        static void DataSelection(void* data, wl_data_device*, wl_data_offer* offer) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            if (wl.selectionOffer) wl_data_offer_destroy(wl.selectionOffer);
+            wl.selectionOffer = offer;
+        }
+
+        // wl_data_source
+
+        static void SourceTarget(void*, wl_data_source*, const char*) {}
+        static void SourceDndDropPerformed(void*, wl_data_source*) {}
+        static void SourceDndFinished(void*, wl_data_source*) {}
+        static void SourceAction(void*, wl_data_source*, uint32_t) {}
+
+        static void SourceSend(void* data, wl_data_source*, const char*, int32_t fd) {
+            const std::string& text = ((Window*)data)->m_wl.clipboardText;
+
+            size_t written = 0;
+            while (written < text.size()) {
+                ssize_t count = write(fd, text.data() + written, text.size() - written);
+                if (count <= 0) break;
+                written += (size_t)count;
+            }
+
+            close(fd);
+        }
+
+        static void SourceCancelled(void* data, wl_data_source* source) {
+            WaylandWindowData& wl = ((Window*)data)->m_wl;
+
+            // Another client owns the clipboard now.
+            if (source == wl.clipboardSource) {
+                wl.clipboardSource = nullptr;
+                wl.clipboardText.clear();
+            }
+
+            wl_data_source_destroy(source);
+        }
+    };
+
+    const wl_registry_listener WaylandListeners::registryListener = { Global, GlobalRemove };
+    const wl_output_listener WaylandListeners::outputListener = { OutputGeometry, OutputMode, OutputDone, OutputScale, OutputName, OutputDescription };
+    const wl_surface_listener WaylandListeners::surfaceListener = { SurfaceEnter, SurfaceLeave };
+    const wl_callback_listener WaylandListeners::frameListener = { FrameDone };
+    const xdg_wm_base_listener WaylandListeners::wmBaseListener = { Ping };
+    const xdg_surface_listener WaylandListeners::xdgSurfaceListener = { XdgSurfaceConfigure };
+    const xdg_toplevel_listener WaylandListeners::toplevelListener = { ToplevelConfigure, ToplevelClose };
+    const wl_seat_listener WaylandListeners::seatListener = { SeatCapabilities, SeatName };
+    const wl_keyboard_listener WaylandListeners::keyboardListener = { KeyboardKeymap, KeyboardEnter, KeyboardLeave, KeyboardKey, KeyboardModifiers, KeyboardRepeatInfo };
+    // wl_seat is bound at version 4 so only the version 1 pointer events are sent.
+    const wl_pointer_listener WaylandListeners::pointerListener = { PointerEnter, PointerLeave, PointerMotion, PointerButton, PointerAxis };
+    const wl_data_device_listener WaylandListeners::dataDeviceListener = { DataOffer, DataEnter, DataLeave, DataMotion, DataDrop, DataSelection };
+    const wl_data_source_listener WaylandListeners::dataSourceListener = { SourceTarget, SourceSend, SourceCancelled, SourceDndDropPerformed, SourceDndFinished, SourceAction };
+
+    // The fd of IWindow::GetEventFd. An epoll fd over the connection of every window in the registry and s_repeatTimerFd. 
+    // Both are created by the first IWindow::GetEventFd call.
+    static int s_eventFd = -1;
+    // Armed by IWindow::DispatchPending for the next key repeat because the compositor doesn't send repeated keys.
+    static int s_repeatTimerFd = -1;
+
+    static void WatchFd(int fd) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(s_eventFd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    bool Window::CreateNative(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) {
+        // User did not call IWindow::Initialize
+        std::string setVersion = GetVersion();
+
+        IWINDOW_CHECK_ERROR(setVersion == "", ErrorType::WindowApi, ErrorSeverity::Warning, "You have to call IWindow::Initialize before creating a window! The version is set the current version.", false, false);
+
+        if (setVersion == "") IWindow::Initialize(IWindow::CurrentVersion);
+
+        m_size = size;
+        m_oldSize = size;
+        m_framebufferSize = size;
+        m_position = position;
+        m_title = title;
+        m_userPtr = nullptr;
+        m_running = true;
+        m_fullscreen = false;
+        m_focused = false;
+        m_mouseEntered = false;
+        m_iconified = false;
+        m_maximized = false;
+        m_mods = KeyModifier::None;
+        m_windowStyle = 0;
+        m_icon = 0;
+        m_cursor = nullptr;
+        m_window = nullptr;
+
+        m_wl = WaylandWindowData{};
+        m_wl.scale = 1;
+        m_wl.frameReady = true;
+        // Used until the compositor sends wl_keyboard.repeat_info.
+        m_wl.repeatRate = 25;
+        m_wl.repeatDelay = 600;
+        m_wl.wakeFd = -1;
+
+        m_deviceContext = wl_display_connect(nullptr);
+
+        IWINDOW_CHECK_ERROR(!m_deviceContext, ErrorType::WindowApi, ErrorSeverity::FatalError, "wl_display_connect() failed. Failed to connect to the Wayland compositor!", true, false);
+
+        m_wl.wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        IWINDOW_CHECK_ERROR(m_wl.wakeFd < 0, ErrorType::WindowApi, ErrorSeverity::FatalError, "eventfd() failed. Failed to create a window!", true, false);
+
+        m_wl.xkbContext = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+
+        m_wl.registry = wl_display_get_registry(m_deviceContext);
+        wl_registry_add_listener(m_wl.registry, &WaylandListeners::registryListener, this);
+
+        // The first roundtrip gets the globals. The second gets the events of the globals that were bound (seat capabilities, keymap, output scale).
+        wl_display_roundtrip(m_deviceContext);
+        wl_display_roundtrip(m_deviceContext);
+
+        IWINDOW_CHECK_ERROR(!m_wl.compositor || !m_wl.wmBase, ErrorType::WindowApi, ErrorSeverity::FatalError, "The compositor does not support wl_compositor or xdg_wm_base. Failed to create a window!", true, false);
+
+        // for multi-window support. Windows with an input thread are created on it, so the count is atomic.
+        m_windowIndex = ++m_sWindowCount;
+
+        if (m_wl.dataDeviceManager && m_wl.seat) {
+            m_wl.dataDevice = wl_data_device_manager_get_data_device(m_wl.dataDeviceManager, m_wl.seat);
+            wl_data_device_add_listener(m_wl.dataDevice, &WaylandListeners::dataDeviceListener, this);
+        }
+
+        m_window = wl_compositor_create_surface(m_wl.compositor);
+        wl_surface_add_listener(m_window, &WaylandListeners::surfaceListener, this);
+
+        m_wl.xdgSurface = xdg_wm_base_get_xdg_surface(m_wl.wmBase, m_window);
+        xdg_surface_add_listener(m_wl.xdgSurface, &WaylandListeners::xdgSurfaceListener, this);
+
+        m_wl.toplevel = xdg_surface_get_toplevel(m_wl.xdgSurface);
+        xdg_toplevel_add_listener(m_wl.toplevel, &WaylandListeners::toplevelListener, this);
+
+        SetTitle(title);
+
+        if (m_wl.shm) {
+            const char* cursorSize = std::getenv("XCURSOR_SIZE");
+            int32_t size = cursorSize ? std::atoi(cursorSize) : 0;
+
+            m_wl.cursorSurface = wl_compositor_create_surface(m_wl.compositor);
+            m_wl.cursorTheme = wl_cursor_theme_load(std::getenv("XCURSOR_THEME"), size > 0 ? size : 24, m_wl.shm);
+        }
+
+        SetCursor(CursorID::Arrow);
+
+        SetStyle(style);
+
+        // Put window to middle of the screen if the user didn't provide a position.
+        if (position.IsEmpty()) { 
+            Center(monitor); 
+        }
+        else {
+            SetWindowPosition(position);
+        }
+
+        // The first commit without a buffer makes the compositor configure the window. Nothing may be drawn before that.
+        wl_surface_commit(m_window);
+
+        while (!m_wl.configured && wl_display_dispatch(m_deviceContext) != -1) {}
+
+        IWINDOW_CHECK_ERROR(!m_wl.configured, ErrorType::WindowApi, ErrorSeverity::FatalError, "The compositor did not configure the window. Failed to create a window!", true, false);
+
+        AddToRegistry();
+
+        if (s_eventFd >= 0 && !m_inputThread) WatchFd(wl_display_get_fd(m_deviceContext));
+
+        m_createTimeNs = IWindow::GetTimeNs();
+
+        m_prevMonitors = Monitor::GetAllMonitors();
+
+        return true;
+    }
+
+    void Window::DestroyNative() {
+        RemoveFromRegistry();
+
+        if (m_wl.frameCallback) wl_callback_destroy(m_wl.frameCallback);
+
+        if (m_wl.clipboardSource) wl_data_source_destroy(m_wl.clipboardSource);
+        if (m_wl.selectionOffer) wl_data_offer_destroy(m_wl.selectionOffer);
+        if (m_wl.dndOffer) wl_data_offer_destroy(m_wl.dndOffer);
+        if (m_wl.dataDevice) wl_data_device_destroy(m_wl.dataDevice);
+
+        if (m_wl.ownsCursorBuffer && m_cursor) wl_buffer_destroy(m_cursor);
+        if (m_wl.cursorTheme) wl_cursor_theme_destroy(m_wl.cursorTheme);
+        if (m_wl.cursorSurface) wl_surface_destroy(m_wl.cursorSurface);
+
+        if (m_wl.keyboard) wl_keyboard_destroy(m_wl.keyboard);
+        if (m_wl.pointer) wl_pointer_destroy(m_wl.pointer);
+
+        if (m_wl.xkbState) xkb_state_unref(m_wl.xkbState);
+        if (m_wl.keymap) xkb_keymap_unref(m_wl.keymap);
+        if (m_wl.xkbContext) xkb_context_unref(m_wl.xkbContext);
+
+        if (m_wl.toplevel) xdg_toplevel_destroy(m_wl.toplevel);
+        if (m_wl.xdgSurface) xdg_surface_destroy(m_wl.xdgSurface);
+        if (m_window) wl_surface_destroy(m_window);
+
+        for (WaylandOutput& output : m_wl.outputs)
+            wl_output_destroy(output.output);
+
+        if (m_wl.dataDeviceManager) wl_data_device_manager_destroy(m_wl.dataDeviceManager);
+        if (m_wl.seat) wl_seat_destroy(m_wl.seat);
+        if (m_wl.shm) wl_shm_destroy(m_wl.shm);
+        if (m_wl.wmBase) xdg_wm_base_destroy(m_wl.wmBase);
+        if (m_wl.compositor) wl_compositor_destroy(m_wl.compositor);
+        if (m_wl.registry) wl_registry_destroy(m_wl.registry);
+
+        if (s_eventFd >= 0 && !m_inputThread) epoll_ctl(s_eventFd, EPOLL_CTL_DEL, wl_display_get_fd(m_deviceContext), nullptr);
+
+        wl_display_disconnect(m_deviceContext);
+
+        if (m_wl.wakeFd >= 0) close(m_wl.wakeFd);
+    }
+
+    bool Window::PrepareRead() {
+        bool dispatched = false;
+
+        // Events that were already read (e.g. during a roundtrip) have to be dispatched before we are allowed to read.
+        while (wl_display_prepare_read(m_deviceContext) != 0)
+            dispatched = wl_display_dispatch_pending(m_deviceContext) > 0 || dispatched;
+
+        // If the socket is full the rest of the requests are sent next time.
+        wl_display_flush(m_deviceContext);
+
+        return dispatched;
+    }
+
+    void Window::FinishRead(bool readable) {
+        if (readable)
+            wl_display_read_events(m_deviceContext);
+        else
+            wl_display_cancel_read(m_deviceContext);
+
+        wl_display_dispatch_pending(m_deviceContext);
+
+        WaylandListeners::RepeatKeys(*this);
+
+        // The compositor went away or killed the connection.
+        if (wl_display_get_error(m_deviceContext))
+            m_running = false;
+    }
+
+    int32_t Window::GetRepeatTimeout() const {
+        if (!m_wl.repeatKey || m_wl.repeatRate <= 0) 
+            return -1;
+
+        std::chrono::milliseconds untilRepeat = std::chrono::duration_cast<std::chrono::milliseconds>(m_wl.nextRepeat - std::chrono::steady_clock::now());
+        return (int32_t)std::max<int64_t>(untilRepeat.count(), 0);
+    }
+
+    // The shorter of two poll() timeouts. -1 waits forever.
+    static int32_t EarlierTimeout(int32_t a, int32_t b) {
+        if (a < 0) return b;
+        if (b < 0) return a;
+        return std::min(a, b);
+    }
+
+    void Window::DispatchEvents(int32_t timeoutMS) {
+        // Don't wait if there were events to handle already.
+        if (PrepareRead()) timeoutMS = 0;
+
+        // The input thread leaves IWindow::PostEmptyEvent to the thread waiting in IWindow::WaitEvents or Window::WaitForEvent. poll() skips negative fds.
+        pollfd fds[3] = {
+            { wl_display_get_fd(m_deviceContext), POLLIN, 0 },
+            { m_wl.wakeFd, POLLIN, 0 },
+            { m_inputThread ? -1 : GetEmptyEventFd(), POLLIN, 0 },
+        };
+
+        const bool polled = ::poll(fds, 3, timeoutMS) > 0;
+
+        if (polled && (fds[1].revents & POLLIN)) DrainEventFd(fds[1].fd);
+        if (polled && (fds[2].revents & POLLIN)) DrainEventFd(fds[2].fd);
+
+        FinishRead(polled && (fds[0].revents & POLLIN));
+    }
+
+    void Window::DispatchAllEvents(int32_t timeoutMS) {
+        if (m_sWindows.empty()) return;
+
+        // Every window has its own connection. All of them are polled together so waiting on one never delays another.
+        // Copied because a callback may create a window.
+        std::vector<Window*> windows = m_sWindows;
+        // The last fd is the one of IWindow::PostEmptyEvent.
+        std::vector<pollfd> fds(windows.size() + 1);
+
+        for (size_t i = 0; i < windows.size(); i++) {
+            if (windows[i]->PrepareRead()) timeoutMS = 0;
+
+            // Wake up for the next key repeat.
+            timeoutMS = EarlierTimeout(timeoutMS, windows[i]->GetRepeatTimeout());
+
+            fds[i] = pollfd{ wl_display_get_fd(windows[i]->m_deviceContext), POLLIN, 0 };
+        }
+
+        fds.back() = pollfd{ GetEmptyEventFd(), POLLIN, 0 };
+
+        const bool polled = ::poll(fds.data(), (nfds_t)fds.size(), timeoutMS) > 0;
+
+        if (polled && (fds.back().revents & POLLIN)) DrainEventFd(fds.back().fd);
+
+        for (size_t i = 0; i < windows.size(); i++)
+            windows[i]->FinishRead(polled && (fds[i].revents & POLLIN));
+    }
+
+    void Window::UpdateNative() {
+        // Never blocks. Only what is already on the socket is read.
+        DispatchEvents(0);
+    }
+
+    void Window::WaitForEventNative(double timeoutSeconds) {
+        DispatchEvents(EarlierTimeout(TimeoutToMS(timeoutSeconds), GetRepeatTimeout()));
+    }
+
+    void Window::WakeEventLoop() { SignalEventFd(m_wl.wakeFd); }
+
+    void Window::PostEmptyEventNative() { SignalEventFd(GetEmptyEventFd()); }
+
+    void Window::PollEventsNative() { DispatchAllEvents(0); }
+
+    void Window::WaitEventsNative(double timeoutSeconds) { DispatchAllEvents(TimeoutToMS(timeoutSeconds)); }
+
+    int GetEventFd() {
+        if (s_eventFd >= 0) return s_eventFd;
+
+        s_eventFd = epoll_create1(EPOLL_CLOEXEC);
+        IWINDOW_CHECK_ERROR(s_eventFd < 0, ErrorType::WindowApi, ErrorSeverity::Error, "epoll_create1() failed. IWindow::GetEventFd has no fd to return!", true, -1);
+
+        s_repeatTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        IWINDOW_CHECK_ERROR(s_repeatTimerFd < 0, ErrorType::WindowApi, ErrorSeverity::Warning, "timerfd_create() failed. Held keys only repeat when another event arrives!", false, s_eventFd);
+        if (s_repeatTimerFd >= 0) WatchFd(s_repeatTimerFd);
+
+        for (Window* window : Window::m_sWindows)
+            WatchFd(wl_display_get_fd(window->m_deviceContext));
+
+        return s_eventFd;
+    }
+
+    void Window::DispatchPendingNative() {
+        DispatchAllEvents(0);
+
+        // Every window has its own connection. PrepareRead dispatches what a roundtrip in a callback read and sends the requests of the callbacks.
+        int32_t repeatTimeout = -1;
+        for (Window* window : m_sWindows) {
+            window->PrepareRead();
+            wl_display_cancel_read(window->m_deviceContext);
+
+            repeatTimeout = EarlierTimeout(repeatTimeout, window->GetRepeatTimeout());
+        }
+
+        if (s_repeatTimerFd < 0) return;
+
+        DrainEventFd(s_repeatTimerFd);
+
+        // A zero it_value disarms the timer so a repeat that is due fires after a nanosecond.
+        itimerspec timer{};
+        if (repeatTimeout >= 0) {
+            timer.it_value.tv_sec = repeatTimeout / 1000;
+            timer.it_value.tv_nsec = (repeatTimeout % 1000) * 1000000 + 1;
+        }
+
+        timerfd_settime(s_repeatTimerFd, 0, &timer, nullptr);
+    }
+
+    bool Window::IsReadyForNextFrame() const { return m_wl.frameReady; }
+
+    void Window::RequestFrame() {
+        // Already waiting on the compositor.
+        if (m_wl.frameCallback) return;
+
+        // The callback is committed together with the next frame (e.g. by vkQueuePresentKHR).
+        m_wl.frameCallback = wl_surface_frame(m_window);
+        wl_callback_add_listener(m_wl.frameCallback, &WaylandListeners::frameListener, this);
+        m_wl.frameReady = false;
+    }
+
+    void Window::SetWindowSize(const Vector2<int32_t>& size) {
+        // The client picks its own size on Wayland. It is used by the next buffer the application presents.
+        m_size = size;
+        m_framebufferSize = { size.width * m_wl.scale, size.height * m_wl.scale };
+
+        if (!(m_windowStyle & (NativeStyle)Style::Resizable)) {
+            xdg_toplevel_set_min_size(m_wl.toplevel, m_size.width, m_size.height);
+            xdg_toplevel_set_max_size(m_wl.toplevel, m_size.width, m_size.height);
+        }
+
+        EmitWindowSizeEvent(m_size);
+        EmitFramebufferSizeEvent(m_framebufferSize);
+    }
+
+    void Window::SetWindowPosition(const Vector2<int32_t>& position) {
+        // Wayland does not let clients position their windows.
+        m_position = position;
+    }
+
+    void Window::SetMousePosition(const Vector2<int32_t>& position) { 
+        // Wayland does not let clients warp the pointer.
+        m_mousePosition = position;
+    }
+
+    void Window::Fullscreen(bool fullscreen, Monitor monitor) {
+        if (m_fullscreen == fullscreen)
+            return;
+
+        m_fullscreen = fullscreen;
+
+        // No fullscreen
+        if (!m_fullscreen) {
+            RestoreVideoMode();
+            xdg_toplevel_unset_fullscreen(m_wl.toplevel);
+            SetWindowSize(m_oldSize);
+            Center(monitor);
+            wl_display_flush(m_deviceContext);
+            return;
+        }
+
+        // Fullscreen
+        m_oldSize = m_size;
+
+        // The compositor picks the output. The size arrives with the next configure.
+        xdg_toplevel_set_fullscreen(m_wl.toplevel, nullptr);
+        wl_display_flush(m_deviceContext);
+    }
+
+    void Window::SetIcon(Image image) {
+        // Wayland has no stable protocol for window icons. The compositor uses the icon of the desktop entry.
+    }
+
+    void Window::SetCursor(Image image, Vector2<int32_t> hot) {
+        if (m_wl.ownsCursorBuffer && m_cursor) wl_buffer_destroy(m_cursor);
+
+        m_cursor = m_wl.shm ? CreateShmBuffer(m_wl.shm, image) : nullptr;
+        m_wl.ownsCursorBuffer = true;
+        m_wl.cursorHidden = false;
+        m_wl.cursorHotX = hot.x;
+        m_wl.cursorHotY = hot.y;
+
+        WaylandListeners::ApplyCursor(*this);
+        wl_display_flush(m_deviceContext);
+    }
+
+    void Window::SetIcon(IconID iconID) {
+        // Wayland has no stable protocol for window icons.
+    }
+
+    bool Window::SetRawMouseMotionNative(bool enabled) {
+        // Needs zwp_relative_pointer_manager_v1, which isn't generated yet.
+        IWINDOW_CHECK_ERROR(enabled, ErrorType::WindowApi, ErrorSeverity::Warning, "The Wayland backend has no raw mouse motion yet!", true, false);
+
+        return false;
+    }
+
+    bool Window::IsRawMouseMotionSupportedNative() const { return false; }
+
+    void Window::SetCursor(CursorID cursorID) {
+        if (m_wl.ownsCursorBuffer && m_cursor) wl_buffer_destroy(m_cursor);
+
+        m_cursor = nullptr;
+        m_wl.ownsCursorBuffer = false;
+        m_wl.cursorHidden = cursorID == CursorID::Hidden;
+
+        if (!m_wl.cursorHidden && m_wl.cursorTheme) {
+            wl_cursor* cursor = wl_cursor_theme_get_cursor(m_wl.cursorTheme, CursorIDToWaylandCursorName(cursorID));
+            if (!cursor) cursor = wl_cursor_theme_get_cursor(m_wl.cursorTheme, CursorIDToWaylandCursorName(CursorID::Arrow));
+
+            if (cursor && cursor->image_count) {
+                wl_cursor_image* image = cursor->images[0];
+                m_cursor = wl_cursor_image_get_buffer(image);
+                m_wl.cursorHotX = (int32_t)image->hotspot_x;
+                m_wl.cursorHotY = (int32_t)image->hotspot_y;
+            }
+        }
+
+        WaylandListeners::ApplyCursor(*this);
+        wl_display_flush(m_deviceContext);
+    }
+
+    std::string Window::GetClipboardText() const {
+        if (m_wl.clipboardSource) return m_wl.clipboardText;
+        if (!m_wl.selectionOffer) return std::string{};
+
+        return ReceiveDataOffer(m_deviceContext, m_wl.selectionOffer, UTF8_MIME_TYPE);
+    }
+
+    void Window::SetClipboardText(const std::string& text) {
+        IWINDOW_CHECK_ERROR(!m_wl.dataDevice, ErrorType::WindowApi, ErrorSeverity::Error, "The compositor does not support wl_data_device_manager. Could not set clipboard text.", true, ;);
+
+        if (m_wl.clipboardSource) wl_data_source_destroy(m_wl.clipboardSource);
+
+        m_wl.clipboardText = text;
+
+        // The text is sent when another client asks for it. See WaylandListeners::SourceSend.
+        m_wl.clipboardSource = wl_data_device_manager_create_data_source(m_wl.dataDeviceManager);
+        wl_data_source_add_listener(m_wl.clipboardSource, &WaylandListeners::dataSourceListener, this);
+        wl_data_source_offer(m_wl.clipboardSource, UTF8_MIME_TYPE);
+        wl_data_source_offer(m_wl.clipboardSource, "UTF8_STRING");
+        wl_data_source_offer(m_wl.clipboardSource, "text/plain");
+
+        // The compositor only accepts the selection with the serial of a recent input event.
+        wl_data_device_set_selection(m_wl.dataDevice, m_wl.clipboardSource, m_wl.inputSerial);
+        wl_display_flush(m_deviceContext);
+    }
+
+    void Window::SetTitle(const std::wstring& title) {  
+        m_title = title;
+
+        xdg_toplevel_set_title(m_wl.toplevel, WStringToUTF8(title).c_str());
+        wl_display_flush(m_deviceContext);
+    }
+
+    void Window::SetStyle(Style style) {
+        // All styles ignored when in fullscreen.
+        if (m_fullscreen) return;
+
+        // On Wayland m_windowStyle stores IWindow::Style::Resizable and IWindow::Style::Decorated.
+        // Decorations are drawn by the client on Wayland so Decorated is only stored.
+        // A toplevel can't be hidden without destroying it so Visible and NotVisible are ignored.
+        if ((NativeStyle)(style & Style::Default)) {
+            m_windowStyle = (NativeStyle)(Style::Resizable | Style::Decorated);
+        }
+
+        if ((NativeStyle)(style & Style::Resizable)) {
+            m_windowStyle |= (NativeStyle)Style::Resizable;
+        }
+        if ((NativeStyle)(style & Style::NotResizable)) {
+            m_windowStyle &= ~(NativeStyle)Style::Resizable;
+        }
+
+        if ((NativeStyle)(style & Style::Decorated)) {
+            m_windowStyle |= (NativeStyle)Style::Decorated;
+        }
+        if ((NativeStyle)(style & Style::NotDecorated)) {
+            m_windowStyle &= ~(NativeStyle)Style::Decorated;
+        }
+
+        if ((NativeStyle)(style & Style::Maximize)) {
+            xdg_toplevel_set_maximized(m_wl.toplevel);
+        }
+        if ((NativeStyle)(style & Style::Restore)) {
+            xdg_toplevel_unset_maximized(m_wl.toplevel);
+        }
+
+        // 0 means no limit.
+        if (m_windowStyle & (NativeStyle)Style::Resizable) {
+            xdg_toplevel_set_min_size(m_wl.toplevel, 0, 0);
+            xdg_toplevel_set_max_size(m_wl.toplevel, 0, 0);
+        }
+        else {
+            xdg_toplevel_set_min_size(m_wl.toplevel, m_size.width, m_size.height);
+            xdg_toplevel_set_max_size(m_wl.toplevel, m_size.width, m_size.height);
+        }
+
+        // Size limits are applied on commit. Window::Create does the first commit itself.
+        if (m_wl.configured) wl_surface_commit(m_window);
+
+        wl_display_flush(m_deviceContext);
+    }
+}
+#endif
@@ -28,16 +28,13 @@
 #if defined(_WIN32)
 
 #include "IWindowWindow.h"
+#include "IWindowGamepadManager.h"
 
 #include <Shellapi.h>
 #include <iostream>
 
 namespace IWindow {
-    uint32_t Window::m_sWindowCount;
-
-    Window::Window(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) { Create(size, title, monitor, position, style); }
-
-    bool Window::Create(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) {
+    bool Window::CreateNative(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) {
         // User did not call IWindow::Initialize
         std::string setVersion = GetVersion();
 
@@ -57,19 +54,13 @@ namespace IWindow {
         m_iconified = false;
         m_windowStyle = 0;
 
-        m_keys.resize((size_t)Key::Max);
-        m_keysPressedOnce.resize((size_t)Key::Max);
-        m_mouseButtons.resize((size_t)MouseButton::Max);
-
         m_cursor = ::LoadCursor(nullptr, IDC_ARROW);
         m_icon = ::LoadIcon(nullptr, IDI_APPLICATION);
 
         HINSTANCE instance = GetModuleHandle(nullptr);
 
-        // for multi-window support
-        m_sWindowCount++;
-
-        m_windowIndex = m_sWindowCount;
+        // for multi-window support. Windows with an input thread are created on it, so the count is atomic.
+        m_windowIndex = ++m_sWindowCount;
 
         std::wstring className = L"IWindow::Window" + m_windowIndex;
 
@@ -115,20 +106,24 @@ namespace IWindow {
 
         ::SetWindowLongPtr(m_window, GWLP_USERDATA, (LONG_PTR)this);
 
+        AddToRegistry();
+
         ::ShowWindow(m_window, SW_SHOW);
 
         m_deviceContext = ::GetDC(m_window);
 
         IWINDOW_CHECK_ERROR(!m_deviceContext, ErrorType::WindowApi, ErrorSeverity::FatalError, "GetDC() failed. Failed to obtain device context!", true, false);
 
-        m_timeMS = std::chrono::high_resolution_clock::now();
+        m_createTimeNs = IWindow::GetTimeNs();
 
         m_prevMonitors = Monitor::GetAllMonitors();
 
         return true;
     }
 
-    void Window::Destroy() {
+    void Window::DestroyNative() {
+        RemoveFromRegistry();
+
         ::DestroyIcon(m_icon);
         ::DestroyCursor(m_cursor);
         ::ReleaseDC(m_window, m_deviceContext);
@@ -136,7 +131,7 @@ namespace IWindow {
         ::DestroyWindow(m_window);
     }
 
-    void Window::Update() {
+    void Window::UpdateNative() {
         MSG msg;
 
         // Get all messages
@@ -147,25 +142,78 @@ namespace IWindow {
         } 
     }
 
-    void Window::WaitForEvent() {
-        ::WaitMessage();
-        Update();
+    // Auto-reset event set by IWindow::PostEmptyEvent. Created on first use so any thread can set it.
+    static HANDLE GetEmptyEvent() {
+        static const HANDLE emptyEvent = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        return emptyEvent;
+    }
+
+    // Sleeps until this thread gets a message, the empty event is set or the timeout passed. A negative timeout waits forever.
+    static void WaitForMessage(double timeoutSeconds, bool wakeOnEmptyEvent) {
+        DWORD timeoutMS = INFINITE;
+        if (timeoutSeconds >= 0.0) {
+            // Rounded up so a timeout below a millisecond doesn't turn a wait loop into a busy loop.
+            const double milliseconds = timeoutSeconds * 1000.0 + 0.999;
+            timeoutMS = milliseconds < (double)(INFINITE - 1) ? (DWORD)milliseconds : INFINITE - 1;
+        }
+
+        const HANDLE emptyEvent = GetEmptyEvent();
+        const DWORD handleCount = (wakeOnEmptyEvent && emptyEvent) ? 1 : 0;
+
+        // Unlike WaitMessage, MWMO_INPUTAVAILABLE also returns for messages a PeekMessage already saw but left in the queue.
+        ::MsgWaitForMultipleObjectsEx(handleCount, &emptyEvent, timeoutMS, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    }
+
+    void Window::WaitForEventNative(double timeoutSeconds) {
+        // The input thread leaves the empty event to the thread waiting in IWindow::WaitEvents or Window::WaitForEvent.
+        WaitForMessage(timeoutSeconds, !m_inputThread);
+        UpdateNative();
+    }
+
+    // WM_NULL does nothing but MsgWaitForMultipleObjectsEx returns for it.
+    void Window::WakeEventLoop() { ::PostMessage(m_window, WM_NULL, 0, 0); }
+
+    void Window::PostEmptyEventNative() { ::SetEvent(GetEmptyEvent()); }
+
+    void Window::PollEventsNative() {
+        MSG msg;
+
+        // A null HWND gets the messages of every window on this thread and thread messages in one pass. 
+        // DispatchMessage finds the IWindow::Window through GWLP_USERDATA.
+        while (::PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+            if (msg.message == WM_QUIT) {
+                for (Window* window : m_sWindows)
+                    window->m_running = false;
+                continue;
+            }
+
+            ::TranslateMessage(&msg);
+            ::DispatchMessage(&msg);
+        }
+    }
+
+    void Window::WaitEventsNative(double timeoutSeconds) {
+        WaitForMessage(timeoutSeconds, true);
+        PollEventsNative();
     }
 
-    bool Window::IsRunning() const { return m_running; }
+    static bool IsInputMessage(UINT msg) { return (msg >= WM_KEYFIRST && msg <= WM_KEYLAST) || (msg >= WM_MOUSEFIRST && msg <= WM_MOUSELAST) || msg == WM_INPUT; }
 
     LRESULT CALLBACK Window::s_WindowCallback(HWND window, UINT msg, WPARAM wparam, LPARAM lparam) {
         Window* iWindow = (Window*)GetWindowLongPtr(window, GWLP_USERDATA);
 
         if (!iWindow) 
             return ::DefWindowProc(window, msg, wparam, lparam);
-        
 
-        return iWindow->WindowCallback(window, msg, wparam, lparam);
-    }
+        // Posted input messages carry the GetTickCount time they were queued at. Messages may be sent while one is handled, so the outer time is restored.
+        const uint64_t outerTimestamp = iWindow->m_eventTimestamp;
+        iWindow->m_eventTimestamp = IsInputMessage(msg) ? iWindow->TimestampFromAge((uint64_t)(DWORD)(::GetTickCount() - (DWORD)::GetMessageTime()) * 1'000'000) : 0;
 
-    bool Window::operator==(IWindow::Window& window) { return m_window == window.GetNativeWindowHandle(); }
-    bool Window::operator!=(IWindow::Window& window) { return m_window != window.GetNativeWindowHandle(); }
+        const LRESULT result = iWindow->WindowCallback(window, msg, wparam, lparam);
+
+        iWindow->m_eventTimestamp = outerTimestamp;
+        return result;
+    }
 
     static KeyModifier GetKeyModifiers() {
         KeyModifier mods = KeyModifier::None;
@@ -203,16 +251,8 @@ namespace IWindow {
             break;
         }
         case WM_DISPLAYCHANGE: {
-            std::vector<Monitor> currentMonitors = Monitor::GetAllMonitors();
-
-            // Monitor disconnected
-            if (currentMonitors.size() < m_prevMonitors.size()) 
-                for (std::vector<Monitor>::iterator it = m_prevMonitors.begin() + currentMonitors.size(); it < m_prevMonitors.end(); it++) 
-                    m_monitorCallback(*this, *it, false);
-            // Monitor connected
-            else if (currentMonitors.size() > m_prevMonitors.size()) 
-                for (std::vector<Monitor>::iterator it = currentMonitors.begin() + m_prevMonitors.size(); it < m_prevMonitors.end(); it++)
-                    m_monitorCallback(*this, *it, true);
+            Monitor::InvalidateCache();
+            UpdateMonitors();
 
             // Set window size to monitor size if resolution changes while window is in maximized state or fullscreen state.
             if (m_windowStyle == SW_MAXIMIZE || m_fullscreen) {
@@ -224,16 +264,19 @@ namespace IWindow {
                 sizeOfDeceration.y = (rWindow.bottom - rWindow.top) - rClient.bottom;
                 SetWindowSize({ (LOWORD(lparam)) - sizeOfDeceration.x, (HIWORD(lparam)) - sizeOfDeceration.y });
             }
-                
 
-            m_prevMonitors = currentMonitors;
+            break;
+        }
+        case WM_DEVICECHANGE: {
+            // Sent to top-level windows when a device was added or removed, which might be a gamepad.
+            GamepadManager::Get().ResetProbeBackoff();
             break;
         }
         case WM_MOVE: {
             // if lparam is less than zero than it will act like a uint
             m_position.x = GET_X_LPARAM(lparam);
             m_position.y = GET_Y_LPARAM(lparam);
-            m_posCallback(*this, m_position);
+            EmitWindowPosEvent(m_position);
 
             return 0;
         }
@@ -249,17 +292,17 @@ namespace IWindow {
                 ::TrackMouseEvent(&mouseEvent);
 
                 m_mouseEntered = true;
-                m_mouseEnteredCallback(*this, m_mouseEntered);
+                EmitMouseEnteredEvent(m_mouseEntered);
             }
             m_mousePosition.x = GET_X_LPARAM(lparam);
             m_mousePosition.y = GET_Y_LPARAM(lparam);
-            m_mouseMovecallback(*this, m_mousePosition);
+            EmitMouseMoveEvent(m_mousePosition);
 
             return 0;
         }
         case WM_MOUSELEAVE: {
             m_mouseEntered = false;
-            m_mouseEnteredCallback(*this, m_mouseEntered);
+            EmitMouseEnteredEvent(m_mouseEntered);
 
             return 0;
         }
@@ -269,7 +312,7 @@ namespace IWindow {
             SetWindowPosition({ suggestedSize->left, suggestedSize->top });
             SetWindowSize({ suggestedSize->right - suggestedSize->left, suggestedSize->bottom - suggestedSize->top });
 
-            m_dpiChangedCallback(*this, Vector2<uint32_t>{ (uint32_t)(LOWORD(wparam)), (uint32_t)(HIWORD(wparam)) });
+            EmitDPIChangedEvent(Vector2<uint32_t>{ (uint32_t)(LOWORD(wparam)), (uint32_t)(HIWORD(wparam)) });
 
             return 0;
         }
@@ -297,11 +340,11 @@ namespace IWindow {
 
             if (iconified != iconified) {
                 m_iconified = iconified;
-                m_inconifiedCallback(*this, false);
+                EmitWindowIconifiedEvent(false);
             }
             if (maximized != maximized) {
                 m_maximized = maximized;
-                m_maximizedCallback(*this, false);
+                EmitWindowMaximizedEvent(false);
             }
 
 
@@ -309,8 +352,8 @@ namespace IWindow {
             m_size = { (int32_t)(LOWORD(lparam)), (int32_t)(HIWORD(lparam)) };
             m_framebufferSize = m_size;
 
-            m_sizeCallback(*this, m_size);
-            m_framebufferSizeCallback(*this, m_framebufferSize);
+            EmitWindowSizeEvent(m_size);
+            EmitFramebufferSizeEvent(m_framebufferSize);
             return 0;        
         }
 
@@ -341,20 +384,13 @@ namespace IWindow {
             // Unsupported Key
             if (key == Key::Max) break;
 
-            if (inputState == InputState::Down) {
-                m_keys[(uint64_t)key] = true;
-                m_keysPressedOnce[(uint64_t)key] = repeat > 0 ? false : true;
-            }
-            else {
-                m_keys[(uint64_t)key] = false;
-                m_keysPressedOnce[(uint64_t)key] = false;
-            }
+            m_keys.Set((size_t)key, inputState == InputState::Down);
 
             // Auto iconify if super key is pressed and window is fullscreen.
             if ((key == Key::LSuper || key == Key::RSuper) && (msg == WM_KEYDOWN || msg == WM_SYSKEYDOWN) && m_fullscreen)
                 ::ShowWindow(m_window, SW_MINIMIZE);
 
-            m_keyCallback(*this, key, m_mods, inputState, repeat > 0);
+            EmitKeyEvent(key, m_mods, inputState, repeat > 0);
 
             return 0;
         }
@@ -389,8 +425,8 @@ namespace IWindow {
             else
                 inputState = InputState::Up;
 
-            m_mouseButtons[(int)button] = true;
-            m_mouseButtonCallback(*this, button, m_mods, inputState);
+            m_mouseButtons.Set((size_t)button, inputState == InputState::Down);
+            EmitMouseButtonEvent(button, m_mods, inputState);
 
             if (msg == WM_XBUTTONDOWN || msg == WM_XBUTTONUP)
                 return 1;
@@ -409,7 +445,7 @@ namespace IWindow {
         case WM_MOUSEWHEEL: {
             m_scrollOffset.y = (int16_t)HIWORD(wparam) / (float)WHEEL_DELTA;
             m_scrollOffset.x = 0.0f;
-            m_mouseScrollCallback(*this, m_scrollOffset);
+            EmitMouseScrollEvent(m_scrollOffset);
             return 0;
         }
         // X axis
@@ -417,20 +453,35 @@ namespace IWindow {
             // X axis inverted for consistency with x11
             m_scrollOffset.x = -((int16_t)HIWORD(wparam) / (float)WHEEL_DELTA);
             m_scrollOffset.y = 0.0f;
-            m_mouseScrollCallback(*this, m_scrollOffset);
+            EmitMouseScrollEvent(m_scrollOffset);
             return 0;
         }
+        // Raw mouse motion. Only sent while the window is in the foreground because RIDEV_INPUTSINK isn't used.
+        case WM_INPUT: {
+            if (!m_rawMouseMotion) break;
+
+            RAWINPUT input{};
+            UINT size = sizeof(input);
+            if (::GetRawInputData((HRAWINPUT)lparam, RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) == (UINT)-1) break;
+
+            // Absolute motion comes from tablets and remote desktop sessions, which have no relative motion to report.
+            if (input.header.dwType == RIM_TYPEMOUSE && !(input.data.mouse.usFlags & MOUSE_MOVE_ABSOLUTE) && (input.data.mouse.lLastX || input.data.mouse.lLastY))
+                EmitRawMouseMotionEvent({ (float)input.data.mouse.lLastX, (float)input.data.mouse.lLastY });
+
+            // DefWindowProc frees the input.
+            break;
+        }
         // User focused on the window
         case WM_SETFOCUS: {
             m_focused = true;
-            m_windowFocusCallback(*this, m_focused);
+            EmitWindowFocusEvent(m_focused);
             return 0;
         }
 
         // User is not focused on the window
         case WM_KILLFOCUS: {
             m_focused = false;
-            m_windowFocusCallback(*this, m_focused);
+            EmitWindowFocusEvent(m_focused);
             return 0;
         }
 
@@ -446,7 +497,7 @@ namespace IWindow {
             if (wparam < 32 || (wparam > 126 && wparam < 160))
                 return 0;
 
-            m_charCallback(*this, (char32_t)wparam, GetKeyModifiers());
+            EmitCharEvent((char32_t)wparam, GetKeyModifiers());
 
             return 0;
         }
@@ -456,7 +507,7 @@ namespace IWindow {
 
             ::DragQueryPoint(drop, &mousePosition);
 
-            m_mouseMovecallback(*this, { mousePosition.x, mousePosition.y });
+            EmitMouseMoveEvent({ mousePosition.x, mousePosition.y });
 
             const uint32_t amountOfFiles = ::DragQueryFile(drop, 0xFFFFFFFF, nullptr, 0);
             std::vector<std::wstring> paths{};
@@ -469,11 +520,17 @@ namespace IWindow {
                 ::DragQueryFile(drop, i, paths[i].data(), (size_t)(length + 1));
             }
 
-            m_pathDropCallback(*this, paths, { (int32_t)mousePosition.x, (int32_t)mousePosition.y });
+            EmitPathDropEvent(paths, { (int32_t)mousePosition.x, (int32_t)mousePosition.y });
 
             ::DragFinish(drop);
             return 0;
         }
+        case WM_PAINT: {
+            // Dragging or resizing the window runs a modal loop inside Update that paints after every step. 
+            // Without this merged events would wait for the end of the drag. With an input thread they are merged by DispatchInputThreadEvents.
+            if (!m_inputThread) FlushCoalescedEvents();
+            break;
+        }
 
         default:
             break;
@@ -482,8 +539,6 @@ namespace IWindow {
         return ::DefWindowProc(window, msg, wparam, lparam);
     }
 
-    Vector2<int32_t> Window::GetWindowSize() const { return m_size; }
-
     void Window::SetWindowSize(const Vector2<int32_t>& size) {
         m_size = size;
 
@@ -512,52 +567,6 @@ namespace IWindow {
         ::SetCursorPos(pt.x, pt.y); 
     }
 
-    Vector2<int32_t> Window::GetMousePosition() const { return m_mousePosition; }
-    Vector2<float> Window::GetMouseScrollOffset() const { return m_scrollOffset; }
-    Vector2<int32_t> Window::GetWindowPosition() const { return m_position; }
-    Vector2<int32_t> Window::GetFramebufferSize() const { return m_framebufferSize; }
-
-    bool Window::IsKeyDown(Key key, KeyModifier mods) { return m_keys[(int64_t)key] && IsKeyModifiersDown(mods); }
-    bool Window::IsKeyUp(Key key, KeyModifier mods) { return !IsKeyDown(key) && IsKeyModifiersUp(mods); }
-
-    bool Window::IsKeyJustPressed(Key key, KeyModifier mods) { return m_keysPressedOnce[(int64_t)key] && IsKeyModifiersDown(mods); }
-
-    bool Window::IsMouseButtonDown(MouseButton button, KeyModifier mods) {  return m_mouseButtons[(int)button] && IsKeyModifiersDown(mods); }
-    bool Window::IsMouseButtonUp(MouseButton button, KeyModifier mods) { return !IsMouseButtonDown(button) && IsKeyModifiersUp(mods); }
-
-    bool Window::IsKeyModifiersDown(KeyModifier mods)
-    {
-        if ((uint64_t)(mods & KeyModifier::Alt) && !(uint64_t)(m_mods & KeyModifier::Alt)) return false;
-        if ((uint64_t)(mods & KeyModifier::CapsLock) && !(uint64_t)(m_mods & KeyModifier::CapsLock)) return false;
-        if ((uint64_t)(mods & KeyModifier::Control) && !(uint64_t)(m_mods & KeyModifier::Control)) return false;
-        if ((uint64_t)(mods & KeyModifier::Shift) && !(uint64_t)(m_mods & KeyModifier::Shift)) return false;
-        if ((uint64_t)(mods & KeyModifier::NumLock) && !(uint64_t)(m_mods & KeyModifier::NumLock)) return false;
-        if ((uint64_t)(mods & KeyModifier::Super) && !(uint64_t)(m_mods & KeyModifier::Super)) return false;
-
-        return true;
-    }
-
-    bool Window::IsKeyModifiersUp(KeyModifier mods)
-    {
-        if ((uint64_t)(mods & KeyModifier::Alt) && (uint64_t)(m_mods & KeyModifier::Alt)) return false;
-        if ((uint64_t)(mods & KeyModifier::CapsLock) && (uint64_t)(m_mods & KeyModifier::CapsLock)) return false;
-        if ((uint64_t)(mods & KeyModifier::Control) && (uint64_t)(m_mods & KeyModifier::Control)) return false;
-        if ((uint64_t)(mods & KeyModifier::Shift) && (uint64_t)(m_mods & KeyModifier::Shift)) return false;
-        if ((uint64_t)(mods & KeyModifier::NumLock) && (uint64_t)(m_mods & KeyModifier::NumLock)) return false;
-        if ((uint64_t)(mods & KeyModifier::Super) && (uint64_t)(m_mods & KeyModifier::Super)) return false;
-
-        return true;
-    }
-
-    void Window::SetUserPointer(void* ptr) { m_userPtr = ptr; }
-    void* Window::GetUserPointer() const { return m_userPtr; }
-
-    void Window::Center(Monitor monitor) {
-        // If the monitor is not a primary monitor we have to offset the position.
-        Vector2<int32_t> offset = monitor.position != Monitor::GetPrimaryMonitor().position ? monitor.position : Vector2<int32_t>{ 0, 0 };
-        SetWindowPosition({ ((monitor.size.x - m_size.width) / 2) + offset.x , ((monitor.size.y - m_size.height) / 2) + offset.y });
-    }
-
     void Window::Fullscreen(bool fullscreen, Monitor monitor) {
         if (m_fullscreen == fullscreen)
             return;
@@ -566,6 +575,7 @@ namespace IWindow {
 
         // No fullscreen
         if (!m_fullscreen) {
+            RestoreVideoMode();
             ::SetWindowLongPtr(m_window, GWL_EXSTYLE, WS_EX_LEFT);
             ::SetWindowLongPtr(m_window, GWL_STYLE, m_windowStyle);
             SetWindowSize(m_oldSize);
@@ -585,8 +595,6 @@ namespace IWindow {
             SWP_NOOWNERZORDER | SWP_FRAMECHANGED | SWP_SHOWWINDOW);
     }
 
-    bool Window::IsFullscreen() const { return m_fullscreen; }
-
     // Orignally was glfw3's implementation reworked to work with IWindow
     HANDLE CreateImage(Image image, uint32_t hotX, uint32_t hotY, bool isIcon) {
         HANDLE imageHandle;
@@ -680,6 +688,22 @@ namespace IWindow {
             m_cursor = nullptr;    
     }
 
+    bool Window::SetRawMouseMotionNative(bool enabled) {
+        // Raw input is registered per process, so the last window that turns it on gets the mouse.
+        RAWINPUTDEVICE device{};
+        device.usUsagePage = 0x01; // HID_USAGE_PAGE_GENERIC
+        device.usUsage = 0x02;     // HID_USAGE_GENERIC_MOUSE
+        device.dwFlags = enabled ? 0 : RIDEV_REMOVE;
+        device.hwndTarget = enabled ? m_window : nullptr;
+
+        IWINDOW_CHECK_ERROR(!::RegisterRawInputDevices(&device, 1, sizeof(device)), ErrorType::WindowApi, ErrorSeverity::Error, "RegisterRawInputDevices() failed. Failed to change raw mouse motion!", true, false);
+
+        m_rawMouseMotion = enabled;
+        return enabled;
+    }
+
+    bool Window::IsRawMouseMotionSupportedNative() const { return true; }
+
     std::string Window::GetClipboardText() const {
         if (!::OpenClipboard(nullptr)) return std::string{};
 
@@ -723,23 +747,11 @@ namespace IWindow {
         ::CloseClipboard();
     }
 
-    double Window::GetTime() const { 
-        std::chrono::duration<double, std::milli> dur = std::chrono::high_resolution_clock::now() - m_timeMS;
-        return dur.count(); 
-    }
-
-    bool Window::IsFocused() const { return m_focused; }
-    bool Window::IsIconified() const { return m_iconified; }
-    bool Window::IsMaximized() const { return m_maximized; }
-
     void Window::SetTitle(const std::wstring& title) {  
         m_title = title;
         IWINDOW_CHECK_ERROR(!::SetWindowText(m_window, (LPCWSTR)title.c_str()), ErrorType::WindowApi, ErrorSeverity::Error, "SetWindowLong() failed! Could not set window style.", false,;);
     }
 
-    std::wstring Window::GetTitle() const { return m_title; }
-
-
     void Window::SetStyle(Style style) {
         // All styles ignored when in fullscreen.
         if (m_fullscreen) return;
@@ -783,105 +795,5 @@ namespace IWindow {
 
         IWINDOW_CHECK_ERROR(!::SetWindowLong(m_window, GWL_STYLE, m_windowStyle), ErrorType::WindowApi, ErrorSeverity::Error, "SetWindowLong failed! Could not set window style.", false, ;);
     }
-
-    Window::WindowPosCallback Window::SetPositionCallback(WindowPosCallback callback) {
-        WindowPosCallback oldCallback = m_posCallback;
-        m_posCallback = callback;
-        return oldCallback;
-    }
-
-    Window::WindowSizeCallback Window::SetSizeCallback(WindowSizeCallback callback) {
-        WindowPosCallback oldCallback = m_sizeCallback;
-        m_sizeCallback = callback;
-        return oldCallback;
-    }
-
-    Window::KeyCallback Window::SetKeyCallback(KeyCallback callback) {
-        KeyCallback oldCallback = m_keyCallback;
-        m_keyCallback = callback;
-        return oldCallback;
-    }
-
-    Window::MouseMoveCallback Window::SetMouseMoveCallback(MouseMoveCallback callback) {
-        MouseMoveCallback oldCallback = m_mouseMovecallback;
-        m_mouseMovecallback = callback;
-        return oldCallback;
-    }
-
-    Window::MouseButtonCallback Window::SetMouseButtonCallback(MouseButtonCallback callback) {
-        MouseButtonCallback oldCallback = m_mouseButtonCallback;
-        m_mouseButtonCallback = callback;
-        return oldCallback;
-    }
-
-    Window::MouseScrollCallback Window::SetMouseScrollCallback(MouseScrollCallback callback) {
-        MouseScrollCallback oldCallback = m_mouseScrollCallback;
-        m_mouseScrollCallback = callback;
-        return oldCallback;
-    }
-
-    Window::WindowFocusCallback Window::SetWindowFocusCallback(WindowFocusCallback callback)
-    {
-        WindowFocusCallback oldCallback = m_windowFocusCallback;
-        m_windowFocusCallback = callback;
-        return oldCallback;
-    }
-
-    Window::MouseEnteredCallback Window::SetMouseEnteredCallback(MouseEnteredCallback callback)
-    {
-        MouseEnteredCallback oldCallback = m_mouseEnteredCallback;
-        m_mouseEnteredCallback = callback;
-        return oldCallback;
-    }
-
-    Window::CharCallback Window::SetCharCallback(CharCallback callback)
-    {
-        CharCallback oldcallback = m_charCallback;
-        m_charCallback = callback;
-        return oldcallback;
-    }
-
-    Window::FramebufferSizeCallback Window::SetFramebufferSizeCallback(FramebufferSizeCallback callback)
-    {
-        FramebufferSizeCallback oldcallback = m_framebufferSizeCallback;
-        m_framebufferSizeCallback = callback;
-        return oldcallback;
-    }
-
-    Window::WindowIconifiedCallback Window::SetWindowIconifiedCallback(WindowIconifiedCallback callback) {
-        WindowIconifiedCallback oldcallback = m_inconifiedCallback;
-        m_inconifiedCallback = callback;
-        return oldcallback;
-    }
-
-    Window::WindowMaximizedCallback Window::SetWindowMaximizedCallback(WindowMaximizedCallback callback) {
-        WindowMaximizedCallback oldcallback = m_maximizedCallback;
-        m_maximizedCallback = callback;
-        return oldcallback;
-    }
-
-    Window::PathDropCallback Window::SetPathDropCallback(PathDropCallback callback)
-    {
-        PathDropCallback oldCallback = m_pathDropCallback;
-        m_pathDropCallback = callback;
-        return oldCallback;
-    }
-
-    Window::MonitorCallback Window::SetMonitorCallback(MonitorCallback callback)
-    {
-        MonitorCallback oldCallback = m_monitorCallback;
-        m_monitorCallback = callback;
-        return oldCallback;
-    }
-
-    Window::DPIChangedCallback Window::SetDPIChangedCallback(DPIChangedCallback callback)
-    {
-        DPIChangedCallback oldCallback = m_dpiChangedCallback;
-        m_dpiChangedCallback = callback;
-        return oldCallback;
-    }
-
-    const NativeWindowHandle& Window::GetNativeWindowHandle() const { return m_window; };
-    const NativeDeviceContext& Window::GetNativeDeviceContext() const { return m_deviceContext; }
 }
 #endif
\ No newline at end of file
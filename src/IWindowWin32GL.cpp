@@ -238,6 +238,7 @@ namespace IWindow {
       
 
         void Context::SwapFramebuffers() const {
+            m_window->MarkPresent();
             ::SwapBuffers(m_window->GetNativeDeviceContext());
         }
 
@@ -30,155 +30,35 @@
 #include "IWindowGamepad.h"
 
 namespace IWindow {
-    GamepadConnectedCallback Gamepad::m_connectedCallback = DefaultGamepadConnectedCallback;
+    class XInputGamepadBackend final : public GamepadBackend {
+    public:
+        bool Poll(GamepadID gid, NativeGamepadState& state) override {
+            ::ZeroMemory(&state, sizeof(XINPUT_STATE));
 
-    std::array<bool, (int)GamepadID::Max> Gamepad::m_connectedGamepads{false};
-
-    std::array<void*, (int)GamepadID::Max> Gamepad::m_userPtrs{nullptr};
-
-    Gamepad::Gamepad(GamepadID gamepadIndex, float triggerDeadzone, float stickDeadzone) 
-    : m_gamepadIndex { (int)gamepadIndex },
-      m_triggerDeadzone { triggerDeadzone },
-      m_stickDeadzone { stickDeadzone }
-    {
-    }
-
-    Gamepad::~Gamepad() { }
-
-    XINPUT_STATE Gamepad::GetState() {
-        XINPUT_STATE state{};
-
-        ::ZeroMemory(&state, sizeof(XINPUT_STATE));
-
-        XInputGetState(m_gamepadIndex, &state);
-
-        return state;
-    }
-
-    GamepadID Gamepad::GetID() { return (GamepadID)m_gamepadIndex; }
-
-    bool Gamepad::IsConnected() {
-        ::ZeroMemory(&m_state, sizeof(XINPUT_STATE));
-        DWORD result = XInputGetState(m_gamepadIndex, &m_state);
-        return result == ERROR_SUCCESS;
-    }
-
-    float Gamepad::LeftStickX() { 
-        // sThumb_X_X is a short and the value goes from -SHORT_MAX -> SHORT_MAX
-        // but we want a value between -1 and 1 with decimals 
-        float leftThumbstickX = (float)m_state.Gamepad.sThumbLX;
-        leftThumbstickX /= SHRT_MAX;
-
-        // Check if values are in deadzone
-        if (leftThumbstickX > m_stickDeadzone || leftThumbstickX < -m_stickDeadzone)
-            return leftThumbstickX;
-
-        return 0;
-    }
-
-    float Gamepad::LeftStickY() {
-        float leftThumbstickY = (float)m_state.Gamepad.sThumbLY;
-        leftThumbstickY /= SHRT_MAX;
-
-        if (leftThumbstickY > m_stickDeadzone || leftThumbstickY < -m_stickDeadzone)
-            return leftThumbstickY;
-
-        return 0;
-    }
-
-    float Gamepad::RightStickX() {
-        float rightThumbstickX = (float)m_state.Gamepad.sThumbRX;
-        rightThumbstickX /= SHRT_MAX;
-
-        if (rightThumbstickX > m_stickDeadzone || rightThumbstickX < -m_stickDeadzone)
-            return rightThumbstickX;
-
-        return 0;
-    }
-    float Gamepad::RightStickY() {
-        float rightThumbstickY = (float)m_state.Gamepad.sThumbRY;
-        rightThumbstickY /= SHRT_MAX;
-
-        if (rightThumbstickY > m_stickDeadzone || rightThumbstickY < -m_stickDeadzone)
-            return rightThumbstickY;
-
-        return 0;
-    }
-
-    float Gamepad::LeftTrigger() {
-        float trigger = (float)m_state.Gamepad.bLeftTrigger;
-        // Range is usually 0 - 255 we want the range to be 0 - 1
-        trigger /= 255.0f;
-
-        if (trigger > m_triggerDeadzone)
-            return trigger;
-
-        return 0.0f;
-    }
-
-    float Gamepad::RightTrigger() {
-        float trigger = (float)m_state.Gamepad.bRightTrigger;
-        trigger /= 255.0f;
-
-        if (trigger > m_triggerDeadzone)
-            return trigger;
-
-        return 0.0f;
-    }
-
-    void Gamepad::Rumble(float rumble) {
-        XINPUT_VIBRATION vibrationState{};
-
-        ::ZeroMemory(&vibrationState, sizeof(XINPUT_VIBRATION));
-
-        // calculate real XInput rumble values
-        int iLeftMotor = int(rumble * 65535.0f);
-        int iRightMotor = int(rumble * 65535.0f);
-
-        // Set vibration values
-        vibrationState.wLeftMotorSpeed  = iLeftMotor;
-        vibrationState.wRightMotorSpeed = iRightMotor;
-    
-        // Set the vibration state
-        XInputSetState(m_gamepadIndex, &vibrationState);
-
-    }
-
-    bool Gamepad::IsButtonDown(GamepadButton button) { return m_state.Gamepad.wButtons & (int)button; }
-    bool Gamepad::IsButtonUp(GamepadButton button) { return !IsButtonDown(button); }
-
-    void Gamepad::SetConnectedCallback(GamepadConnectedCallback callback) { m_connectedCallback = callback; }
-
-    void Gamepad::SetUserPointer(GamepadID gid, void* ptr) { m_userPtrs[(int)gid] = ptr; }
-
-    void* Gamepad::GetUserPointer(GamepadID gid) { return m_userPtrs[(int)gid]; }
-
-    void Gamepad::SetTriggerDeadzone(float deadzone) { m_triggerDeadzone = deadzone; }
-    float Gamepad::GetTriggerDeadzone() { return m_triggerDeadzone; }
+            return XInputGetState((DWORD)gid, &state) == ERROR_SUCCESS;
+        }
 
-    void Gamepad::SetStickDeadzone(float deadzone) { m_stickDeadzone = deadzone; }
+        void Rumble(GamepadID gid, float rumble) override {
+            XINPUT_VIBRATION vibrationState{};
 
-    float Gamepad::GetStickDeadzone() { return m_stickDeadzone; }
+            ::ZeroMemory(&vibrationState, sizeof(XINPUT_VIBRATION));
 
-    void Gamepad::Update() { 
-        for (uint32_t i = 0; i < (uint32_t)GamepadID::Max; i++) {
-            DWORD result = XInputGetState(i, &m_state);
-            // Connected
-            if (result == ERROR_SUCCESS && !m_connectedGamepads[i]) {
-                m_connectedCallback((GamepadID)i, true);
-                m_connectedGamepads[i] = true;
-            } 
-            // Disconnected
-            else if (result != ERROR_SUCCESS && m_connectedGamepads[i]) {
-                m_connectedCallback((GamepadID)i, false);
-                m_connectedGamepads[i] = false;
-            }
+            // calculate real XInput rumble values
+            int iLeftMotor = int(rumble * 65535.0f);
+            int iRightMotor = int(rumble * 65535.0f);
 
+            // Set vibration values
+            vibrationState.wLeftMotorSpeed  = iLeftMotor;
+            vibrationState.wRightMotorSpeed = iRightMotor;
+        
+            // Set the vibration state
+            XInputSetState((DWORD)gid, &vibrationState);
         }
+    };
 
-        ::ZeroMemory(&m_state, sizeof(XINPUT_STATE));
-
-        m_state = GetState(); 
+    GamepadBackend& GamepadManager::GetPlatformBackend() {
+        static XInputGamepadBackend s_backend{};
+        return s_backend;
     }
 }
-#endif
+#endif
\ No newline at end of file
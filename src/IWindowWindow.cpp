@@ -0,0 +1,989 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "IWindowWindow.h"
+#include "IWindowSPSCQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace IWindow {
+    std::atomic<uint32_t> Window::m_sWindowCount{ 0 };
+    std::vector<Window*> Window::m_sWindows;
+
+    // Defined here because InputThread is only complete in this file.
+    Window::Window() = default;
+
+    Window::Window(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) { Create(size, title, monitor, position, style); }
+
+    // Without a callback (e.g. SetKeyCallback(nullptr)) the event is only written to the event queue.
+    static void SetCallbackBit(uint32_t& setCallbacks, EventType type, bool set) {
+        if (set) setCallbacks |= 1u << (uint32_t)type;
+        else setCallbacks &= ~(1u << (uint32_t)type);
+    }
+
+    static bool IsCallbackSet(uint32_t setCallbacks, EventType type) { return setCallbacks & (1u << (uint32_t)type); }
+
+    // The triple buffer of InputThread::snapshots keeps its indices in 2 bits. SNAPSHOT_FRESH is set on the middle index until the render thread takes it.
+    constexpr uint32_t SNAPSHOT_INDEX_MASK = 0x3;
+    constexpr uint32_t SNAPSHOT_FRESH = 0x4;
+
+    // Capacity of the queues for paths and monitors. Both events are rare.
+    constexpr uint32_t INPUT_THREAD_SIDE_QUEUE_CAPACITY = 16;
+
+    /// <summary>
+    /// State shared by the input thread and the render thread (the thread that calls Window::Update).
+    /// </summary>
+    struct Window::InputThread {
+        explicit InputThread(const InputThreadInfo& threadInfo) : info(threadInfo), events(threadInfo.eventCapacity), 
+            paths(INPUT_THREAD_SIDE_QUEUE_CAPACITY), monitors(INPUT_THREAD_SIDE_QUEUE_CAPACITY) {}
+
+        InputThreadInfo info;
+        std::thread thread;
+        // Set by the input thread before it creates the window. Only read after Create returned.
+        std::thread::id id;
+        std::atomic<bool> stop{ false };
+        // Set once CreateNative returned on the input thread.
+        std::promise<bool> created;
+
+        // Input thread to render thread.
+        SPSCQueue<Event> events;
+        SPSCQueue<std::vector<std::wstring>> paths;
+        SPSCQueue<std::pair<Monitor, bool>> monitors;
+
+        // Triple buffer. The input thread writes snapshots[backIndex] and swaps it with middleIndex.
+        // The render thread swaps frontIndex with middleIndex when it is fresh. Neither side ever waits.
+        std::array<InputSnapshot, 3> snapshots{};
+        uint32_t backIndex = 0;
+        uint32_t frontIndex = 1;
+        std::atomic<uint32_t> middleIndex{ 2 };
+        // Sequence of the last snapshot. Only used by the input thread.
+        uint64_t sequence = 0;
+
+        // Only used to sleep. The input thread waits on it after the window closed.
+        std::mutex mutex;
+        std::condition_variable condition;
+        // Guarded by mutex.
+        std::vector<std::function<void(Window&)>> tasks;
+    };
+
+    // Render threads of windows with an input thread wait on s_waitCondition in Window::WaitForEvent. 
+    // It is shared so IWindow::PostEmptyEvent can wake all of them without knowing the windows. s_emptyEventCount is guarded by s_waitMutex.
+    static std::mutex s_waitMutex;
+    static std::condition_variable s_waitCondition;
+    static uint64_t s_emptyEventCount;
+
+    Window::~Window() { 
+        if (m_inputThread) Destroy();
+
+        RemoveFromRegistry(); 
+    }
+
+    // Windows with an input thread are only touched by their own thread so IWindow::PollEvents never sees them.
+    // The registry belongs to the thread that updates the windows, so the input thread doesn't read or change it either.
+    void Window::AddToRegistry() { if (!m_inputThread) m_sWindows.push_back(this); }
+
+    void Window::RemoveFromRegistry() { 
+        if (m_inputThread) return;
+        m_sWindows.erase(std::remove(m_sWindows.begin(), m_sWindows.end(), this), m_sWindows.end()); 
+    }
+
+    bool Window::Create(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) {
+        if (!m_inputThread) return CreateNative(size, title, monitor, position, style);
+
+        std::future<bool> created = m_inputThread->created.get_future();
+        m_inputThread->thread = std::thread(&Window::RunInputThread, this, size, title, monitor, position, style);
+
+        if (created.get()) {
+            DispatchInputThreadEvents();
+            return true;
+        }
+
+        m_inputThread->thread.join();
+        m_inputThread.reset();
+        return false;
+    }
+
+    void Window::Destroy() {
+        RestoreVideoMode();
+
+        if (!m_inputThread) {
+            DestroyNative();
+            return;
+        }
+
+        {
+            // Woken while holding the lock because the input thread takes it before destroying the window WakeEventLoop uses.
+            std::lock_guard<std::mutex> lock(m_inputThread->mutex);
+            m_inputThread->stop.store(true, std::memory_order_release);
+            WakeEventLoop();
+        }
+
+        m_inputThread->condition.notify_all();
+
+        // The input thread destroys the window before it exits.
+        m_inputThread->thread.join();
+        m_inputThread.reset();
+
+        m_inputState.running = false;
+    }
+
+    void Window::Update() {
+        if (m_inputThread) {
+            DispatchInputThreadEvents();
+            return;
+        }
+
+        BeginInputFrame();
+        UpdateNative();
+        FlushCoalescedEvents();
+    }
+
+    void Window::WaitForEvent() { WaitForEvent(-1.0); }
+
+    void Window::WaitForEvent(double timeoutSeconds) {
+        if (!m_inputThread) {
+            BeginInputFrame();
+            WaitForEventNative(timeoutSeconds);
+            FlushCoalescedEvents();
+            return;
+        }
+
+        {
+            InputThread& thread = *m_inputThread;
+            std::unique_lock<std::mutex> lock(s_waitMutex);
+            const uint64_t emptyEventCount = s_emptyEventCount;
+
+            // A closed window gets no more events.
+            auto ready = [&] { 
+                return !thread.events.IsEmpty() || !thread.monitors.IsEmpty() || (thread.middleIndex.load(std::memory_order_acquire) & SNAPSHOT_FRESH) || 
+                    !m_inputState.running || s_emptyEventCount != emptyEventCount;
+            };
+
+            if (timeoutSeconds < 0.0) s_waitCondition.wait(lock, ready);
+            else s_waitCondition.wait_for(lock, std::chrono::duration<double>(timeoutSeconds), ready);
+        }
+
+        DispatchInputThreadEvents();
+    }
+
+    void PollEvents() {
+        Window::BeginInputFrames();
+        Window::PollEventsNative();
+        Window::FlushCoalescedEventsOfAll();
+    }
+
+    void WaitEvents() { WaitEvents(-1.0); }
+
+    void WaitEvents(double timeoutSeconds) {
+        Window::BeginInputFrames();
+        Window::WaitEventsNative(timeoutSeconds);
+        Window::FlushCoalescedEventsOfAll();
+    }
+
+#if defined(__linux__)
+    void DispatchPending() {
+        Window::BeginInputFrames();
+        Window::DispatchPendingNative();
+        Window::FlushCoalescedEventsOfAll();
+    }
+#endif
+
+    void PostEmptyEvent() {
+        {
+            std::lock_guard<std::mutex> lock(s_waitMutex);
+            s_emptyEventCount++;
+        }
+
+        s_waitCondition.notify_all();
+        Window::PostEmptyEventNative();
+    }
+
+    void Window::SetInputThread(const InputThreadInfo& info) {
+        IWINDOW_CHECK_ERROR(m_inputThread, ErrorType::WindowApi, ErrorSeverity::Error, "IWindow::Window::SetInputThread has to be called before IWindow::Window::Create!", true, );
+
+        m_inputThread = std::make_unique<InputThread>(info);
+    }
+
+    bool Window::HasInputThread() const { return (bool)m_inputThread; }
+
+    InputSnapshot Window::GetLatestInput() {
+        if (!m_inputThread) return CaptureState();
+
+        InputThread& thread = *m_inputThread;
+
+        if (thread.middleIndex.load(std::memory_order_relaxed) & SNAPSHOT_FRESH)
+            thread.frontIndex = thread.middleIndex.exchange(thread.frontIndex, std::memory_order_acq_rel) & SNAPSHOT_INDEX_MASK;
+
+        return thread.snapshots[thread.frontIndex];
+    }
+
+    void Window::RunOnInputThread(std::function<void(Window&)> task) {
+        if (!m_inputThread) {
+            task(*this);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_inputThread->mutex);
+            m_inputThread->tasks.push_back(std::move(task));
+        }
+
+        m_inputThread->condition.notify_all();
+        WakeEventLoop();
+    }
+
+    static void ApplyInputThreadInfo(const InputThreadInfo& info) {
+#if defined(_WIN32)
+        if (info.realtimePriority) 
+            IWINDOW_CHECK_ERROR(!::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL), ErrorType::WindowApi, ErrorSeverity::Warning, "SetThreadPriority() failed. The input thread keeps normal priority.", false, );
+
+        if (info.affinityMask)
+            IWINDOW_CHECK_ERROR(!::SetThreadAffinityMask(::GetCurrentThread(), (DWORD_PTR)info.affinityMask), ErrorType::WindowApi, ErrorSeverity::Warning, "SetThreadAffinityMask() failed. The input thread can run on any CPU.", false, );
+#else
+        if (info.realtimePriority) {
+            // The lowest real-time priority already runs before every normal thread.
+            sched_param param{};
+            param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+            IWINDOW_CHECK_ERROR(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0, ErrorType::WindowApi, ErrorSeverity::Warning, "pthread_setschedparam() failed. The input thread keeps normal priority.", false, );
+        }
+
+        if (info.affinityMask) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (size_t cpu = 0; cpu < 64; cpu++)
+                if (info.affinityMask & (1ull << cpu)) CPU_SET(cpu, &cpus);
+
+            IWINDOW_CHECK_ERROR(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0, ErrorType::WindowApi, ErrorSeverity::Warning, "pthread_setaffinity_np() failed. The input thread can run on any CPU.", false, );
+        }
+#endif
+    }
+
+    void Window::RunInputThread(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) {
+        InputThread& thread = *m_inputThread;
+        thread.id = std::this_thread::get_id();
+
+        ApplyInputThreadInfo(thread.info);
+
+        const bool created = CreateNative(size, title, monitor, position, style);
+        if (created) PublishInput();
+
+        thread.created.set_value(created);
+        if (!created) return;
+
+        std::vector<std::function<void(Window&)>> tasks{};
+        while (!thread.stop.load(std::memory_order_acquire)) {
+            if (m_running) {
+                WaitForEventNative(-1.0);
+            }
+            else {
+                // A closed or lost window would make WaitForEventNative return right away. Sleep until there is a task or Destroy is called.
+                std::unique_lock<std::mutex> lock(thread.mutex);
+                thread.condition.wait(lock, [&] { return !thread.tasks.empty() || thread.stop.load(std::memory_order_relaxed); });
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(thread.mutex);
+                tasks.swap(thread.tasks);
+            }
+
+            for (std::function<void(Window&)>& task : tasks)
+                task(*this);
+            tasks.clear();
+
+            PublishInput();
+
+            // Taking the lock makes sure a render thread that just found the queue empty is already waiting.
+            { std::lock_guard<std::mutex> lock(s_waitMutex); }
+            s_waitCondition.notify_all();
+        }
+
+        // Destroy may still be waking us. It holds the lock while it does.
+        { std::lock_guard<std::mutex> lock(thread.mutex); }
+
+        DestroyNative();
+    }
+
+    bool Window::IsInputThread() const { return std::this_thread::get_id() == m_inputThread->id; }
+
+    void Window::PublishInput() {
+        InputThread& thread = *m_inputThread;
+
+        InputSnapshot& snapshot = thread.snapshots[thread.backIndex];
+        snapshot = CaptureState();
+        snapshot.sequence = ++thread.sequence;
+
+        thread.backIndex = thread.middleIndex.exchange(thread.backIndex | SNAPSHOT_FRESH, std::memory_order_acq_rel) & SNAPSHOT_INDEX_MASK;
+    }
+
+    InputSnapshot Window::CaptureInputSnapshot() const {
+        InputSnapshot snapshot = m_inputThread ? m_inputState : CaptureState();
+        snapshot.frame = m_frame;
+        snapshot.time = m_frameTime;
+        snapshot.scrollDelta = m_scrollDelta;
+
+        return snapshot;
+    }
+
+    InputSnapshot Window::CaptureState() const {
+        InputSnapshot snapshot{};
+        snapshot.time = GetTime();
+        snapshot.keys = m_keys;
+        snapshot.mouseButtons = m_mouseButtons;
+        snapshot.mods = m_mods;
+        snapshot.mousePosition = m_mousePosition;
+        snapshot.scrollOffset = m_scrollOffset;
+        snapshot.size = m_size;
+        snapshot.position = m_position;
+        snapshot.framebufferSize = m_framebufferSize;
+        snapshot.running = m_running;
+        snapshot.focused = m_focused;
+        snapshot.mouseEntered = m_mouseEntered;
+        snapshot.iconified = m_iconified;
+        snapshot.maximized = m_maximized;
+        snapshot.fullscreen = m_fullscreen;
+
+        return snapshot;
+    }
+
+    void Window::DispatchInputThreadEvents() {
+        InputThread& thread = *m_inputThread;
+
+        BeginInputFrame();
+
+        std::pair<Monitor, bool> monitor{};
+        while (thread.monitors.Pop(monitor))
+            m_monitorCallback(*this, monitor.first, monitor.second);
+
+        // A callback may call Update again. Every event is still dispatched once because Pop removes it first.
+        Event event{};
+        std::vector<std::wstring> paths{};
+        while (thread.events.Pop(event)) {
+            if (event.type == EventType::PathDrop) {
+                thread.paths.Pop(paths);
+                DispatchEvent(event, &paths);
+            }
+            else {
+                DispatchEvent(event, nullptr);
+            }
+        }
+
+        FlushCoalescedEvents();
+        m_inputState = GetLatestInput();
+    }
+
+    Window* Window::FromNativeWindowHandle(const NativeWindowHandle& handle) {
+        // A linear search is faster than a map for the handful of windows an application has.
+        for (Window* window : m_sWindows)
+            if (window->m_window == handle) return window;
+
+        return nullptr;
+    }
+
+    bool Window::IsRunning() const { return m_inputThread ? m_inputState.running : m_running; }
+
+#if !defined(IWINDOW_WAYLAND)
+    // Only Wayland compositors tell the client when to draw.
+    bool Window::IsReadyForNextFrame() const { return true; }
+
+    void Window::RequestFrame() {}
+#endif
+
+    bool Window::operator==(IWindow::Window& window) { return m_window == window.GetNativeWindowHandle(); }
+    bool Window::operator!=(IWindow::Window& window) { return m_window != window.GetNativeWindowHandle(); }
+
+    // With an input thread the members belong to that thread. The getters read the copy Update took instead.
+    Vector2<int32_t> Window::GetWindowSize() const { return m_inputThread ? m_inputState.size : m_size; }
+
+    Vector2<int32_t> Window::GetMousePosition() const { return m_inputThread ? m_inputState.mousePosition : m_mousePosition; }
+    Vector2<float> Window::GetMouseScrollOffset() const { return m_inputThread ? m_inputState.scrollOffset : m_scrollOffset; }
+    Vector2<float> Window::GetMouseScrollDelta() const { return m_scrollDelta; }
+
+    bool Window::SetRawMouseMotion(bool enabled, uint32_t sampleCapacity) {
+        uint32_t size = 0;
+        if (enabled && sampleCapacity > 0) {
+            size = 1;
+            while (size < sampleCapacity) size <<= 1;
+        }
+
+        m_rawMotionSamples.assign(size, RawMouseMotion{});
+        m_rawMotionCount = 0;
+
+        if (!m_inputThread) return SetRawMouseMotionNative(enabled);
+
+        // Samples arrive as events, so the ring buffer stays on this thread.
+        RunOnInputThread([enabled](Window& window) { window.SetRawMouseMotionNative(enabled); });
+        return enabled && IsRawMouseMotionSupportedNative();
+    }
+
+    bool Window::IsRawMouseMotionSupported() const { return IsRawMouseMotionSupportedNative(); }
+
+    uint32_t Window::GetRawMouseMotion(RawMouseMotion* samples, uint32_t maxCount) const {
+        const uint32_t count = std::min(GetRawMouseMotionCount(), maxCount);
+        const uint32_t mask = (uint32_t)m_rawMotionSamples.size() - 1;
+
+        for (uint32_t i = 0; i < count; i++)
+            samples[i] = m_rawMotionSamples[(m_rawMotionCount - count + i) & mask];
+
+        return count;
+    }
+
+    uint32_t Window::GetRawMouseMotionCount() const { return std::min(m_rawMotionCount, (uint32_t)m_rawMotionSamples.size()); }
+
+    Vector2<float> Window::GetRawMouseDelta() const { return m_rawMouseDelta; }
+    Vector2<int32_t> Window::GetWindowPosition() const { return m_inputThread ? m_inputState.position : m_position; }
+    Vector2<int32_t> Window::GetFramebufferSize() const { return m_inputThread ? m_inputState.framebufferSize : m_framebufferSize; }
+
+    void Window::BeginInputFrame() {
+        m_frame++;
+        m_frameTime = GetTime();
+        m_scrollDelta = { 0.0f, 0.0f };
+        m_rawMotionCount = 0;
+        m_rawMouseDelta = { 0.0f, 0.0f };
+
+        m_currentKeys = m_inputThread ? &m_inputState.keys : &m_keys;
+        m_currentMouseButtons = m_inputThread ? &m_inputState.mouseButtons : &m_mouseButtons;
+        m_currentMods = m_inputThread ? &m_inputState.mods : &m_mods;
+
+        m_previousKeys = *m_currentKeys;
+        m_previousMouseButtons = *m_currentMouseButtons;
+    }
+
+    void Window::BeginInputFrames() {
+        for (Window* window : m_sWindows)
+            window->BeginInputFrame();
+    }
+
+    void Window::SetUserPointer(void* ptr) { m_userPtr = ptr; }
+    void* Window::GetUserPointer() const { return m_userPtr; }
+
+    void Window::Center(Monitor monitor) {
+        // If the monitor is not a primary monitor we have to offset the position.
+        Vector2<int32_t> offset = monitor.position != Monitor::GetPrimaryMonitor().position ? monitor.position : Vector2<int32_t>{ 0, 0 };
+        SetWindowPosition({ ((monitor.size.x - m_size.width) / 2) + offset.x , ((monitor.size.y - m_size.height) / 2) + offset.y });
+    }
+
+    bool Window::Fullscreen(bool fullscreen, Monitor monitor, VideoMode mode) {
+        if (!fullscreen || mode.IsEmpty()) {
+            Fullscreen(fullscreen, monitor);
+            return true;
+        }
+
+        // Only one monitor is switched at a time.
+        if (m_videoModeMonitor.id != 0 && m_videoModeMonitor.id != monitor.id) RestoreVideoMode();
+
+        const bool switched = monitor.SetVideoModeNative(mode);
+        if (switched) {
+            m_videoModeMonitor = monitor;
+
+            // The monitor has its new size right away. The OS reports the change to the windows later.
+            Monitor::InvalidateCache();
+            Monitor::FindMonitor(monitor.id, monitor);
+        }
+
+        if (!m_fullscreen) {
+            Fullscreen(true, monitor);
+        }
+        else {
+            SetWindowPosition(monitor.position);
+            SetWindowSize(monitor.size);
+        }
+
+        return switched;
+    }
+
+    void Window::RestoreVideoMode() {
+        if (m_videoModeMonitor.id == 0) return;
+
+        m_videoModeMonitor.RestoreVideoModeNative();
+        m_videoModeMonitor = {};
+        Monitor::InvalidateCache();
+    }
+
+    bool Window::IsFullscreen() const { return m_inputThread ? m_inputState.fullscreen : m_fullscreen; }
+
+    double Window::GetTime() const { 
+        return (double)GetTimeNs() / 1'000'000.0;
+    }
+
+    uint64_t Window::GetTimeNs() const {
+        const uint64_t now = IWindow::GetTimeNs();
+        return now > m_createTimeNs ? now - m_createTimeNs : 0;
+    }
+
+    uint64_t Window::TimestampFromAge(uint64_t ageNs) const {
+        if (ageNs == UINT64_MAX) return 0;
+
+        // Events from before the window was created are clamped to its creation. 1 keeps them apart from "now".
+        const uint64_t now = GetTimeNs();
+        return ageNs < now ? now - ageNs : 1;
+    }
+
+    uint64_t Window::GetEventTimestamp() const { return m_dispatchTimestamp; }
+
+    void Window::MarkPresent() {
+        if (!m_oldestInputTimestamp) return;
+
+        const uint64_t now = GetTimeNs();
+        const double latency = now > m_oldestInputTimestamp ? (double)(now - m_oldestInputTimestamp) / 1'000'000.0 : 0.0;
+        m_oldestInputTimestamp = 0;
+
+        LatencyStats& stats = m_latencyStats;
+        stats.minMs = stats.count ? std::fmin(stats.minMs, latency) : latency;
+        stats.maxMs = std::fmax(stats.maxMs, latency);
+        stats.totalMs += latency;
+        stats.count++;
+        stats.buckets[LatencyStats::BucketOf(latency)]++;
+    }
+
+    LatencyStats Window::GetLatencyStats() const { return m_latencyStats; }
+    void Window::ResetLatencyStats() { m_latencyStats = {}; }
+
+    bool Window::IsFocused() const { return m_inputThread ? m_inputState.focused : m_focused; }
+    bool Window::IsIconified() const { return m_inputThread ? m_inputState.iconified : m_iconified; }
+    bool Window::IsMaximized() const { return m_inputThread ? m_inputState.maximized : m_maximized; }
+
+    std::wstring Window::GetTitle() const { return m_title; }
+
+    Window::WindowPosCallback Window::SetPositionCallback(WindowPosCallback callback) {
+        WindowPosCallback oldCallback = std::move(m_posCallback);
+        m_posCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::WindowPos, (bool)m_posCallback);
+        return oldCallback;
+    }
+
+    Window::WindowSizeCallback Window::SetSizeCallback(WindowSizeCallback callback) {
+        WindowPosCallback oldCallback = std::move(m_sizeCallback);
+        m_sizeCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::WindowSize, (bool)m_sizeCallback);
+        return oldCallback;
+    }
+
+    Window::KeyCallback Window::SetKeyCallback(KeyCallback callback) {
+        KeyCallback oldCallback = std::move(m_keyCallback);
+        m_keyCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::Key, (bool)m_keyCallback);
+        return oldCallback;
+    }
+
+    Window::MouseMoveCallback Window::SetMouseMoveCallback(MouseMoveCallback callback) {
+        MouseMoveCallback oldCallback = std::move(m_mouseMovecallback);
+        m_mouseMovecallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::MouseMove, (bool)m_mouseMovecallback);
+        return oldCallback;
+    }
+
+    Window::MouseButtonCallback Window::SetMouseButtonCallback(MouseButtonCallback callback) {
+        MouseButtonCallback oldCallback = std::move(m_mouseButtonCallback);
+        m_mouseButtonCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::MouseButton, (bool)m_mouseButtonCallback);
+        return oldCallback;
+    }
+
+    Window::MouseScrollCallback Window::SetMouseScrollCallback(MouseScrollCallback callback) {
+        MouseScrollCallback oldCallback = std::move(m_mouseScrollCallback);
+        m_mouseScrollCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::MouseScroll, (bool)m_mouseScrollCallback);
+        return oldCallback;
+    }
+
+    Window::WindowFocusCallback Window::SetWindowFocusCallback(WindowFocusCallback callback)
+    {
+        WindowFocusCallback oldCallback = std::move(m_windowFocusCallback);
+        m_windowFocusCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::WindowFocus, (bool)m_windowFocusCallback);
+        return oldCallback;
+    }
+
+    Window::MouseEnteredCallback Window::SetMouseEnteredCallback(MouseEnteredCallback callback)
+    {
+        MouseEnteredCallback oldCallback = std::move(m_mouseEnteredCallback);
+        m_mouseEnteredCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::MouseEntered, (bool)m_mouseEnteredCallback);
+        return oldCallback;
+    }
+
+    Window::CharCallback Window::SetCharCallback(CharCallback callback)
+    {
+        CharCallback oldcallback = std::move(m_charCallback);
+        m_charCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::Char, (bool)m_charCallback);
+        return oldcallback;
+    }
+
+    Window::FramebufferSizeCallback Window::SetFramebufferSizeCallback(FramebufferSizeCallback callback)
+    {
+        FramebufferSizeCallback oldcallback = std::move(m_framebufferSizeCallback);
+        m_framebufferSizeCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::FramebufferSize, (bool)m_framebufferSizeCallback);
+        return oldcallback;
+    }
+
+    Window::WindowIconifiedCallback Window::SetWindowIconifiedCallback(WindowIconifiedCallback callback) {
+        WindowIconifiedCallback oldcallback = std::move(m_inconifiedCallback);
+        m_inconifiedCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::WindowIconified, (bool)m_inconifiedCallback);
+        return oldcallback;
+    }
+
+    Window::WindowMaximizedCallback Window::SetWindowMaximizedCallback(WindowMaximizedCallback callback) {
+        WindowMaximizedCallback oldcallback = std::move(m_maximizedCallback);
+        m_maximizedCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::WindowMaximized, (bool)m_maximizedCallback);
+        return oldcallback;
+    }
+
+    Window::PathDropCallback Window::SetPathDropCallback(PathDropCallback callback)
+    {
+        PathDropCallback oldCallback = std::move(m_pathDropCallback);
+        m_pathDropCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::PathDrop, (bool)m_pathDropCallback);
+        return oldCallback;
+    }
+
+    Window::MonitorCallback Window::SetMonitorCallback(MonitorCallback callback)
+    {
+        MonitorCallback oldCallback = std::move(m_monitorCallback);
+        m_monitorCallback = std::move(callback);
+        return oldCallback;
+    }
+
+    Window::DPIChangedCallback Window::SetDPIChangedCallback(DPIChangedCallback callback)
+    {
+        DPIChangedCallback oldCallback = std::move(m_dpiChangedCallback);
+        m_dpiChangedCallback = std::move(callback);
+        SetCallbackBit(m_setCallbacks, EventType::DPIChanged, (bool)m_dpiChangedCallback);
+        return oldCallback;
+    }
+
+    void Window::SetEventCoalescing(EventType type, bool coalesce) {
+        const bool canCoalesce = type == EventType::MouseMove || type == EventType::WindowPos || type == EventType::WindowSize || type == EventType::FramebufferSize;
+        IWINDOW_CHECK_ERROR(!canCoalesce, ErrorType::WindowApi, ErrorSeverity::Warning, "IWindow::Window::SetEventCoalescing only merges MouseMove, WindowPos, WindowSize and FramebufferSize events.", true, );
+
+        // Events of the type that are already waiting are still delivered at the end of the update.
+        if (coalesce) m_coalescedEvents |= 1u << (uint32_t)type;
+        else m_coalescedEvents &= ~(1u << (uint32_t)type);
+    }
+
+    bool Window::IsEventCoalesced(EventType type) const { return m_coalescedEvents & (1u << (uint32_t)type); }
+
+    void Window::SetEventQueueCapacity(uint32_t capacity) {
+        uint32_t size = 0;
+        if (capacity > 0) {
+            size = 1;
+            while (size < capacity) size <<= 1;
+        }
+
+        m_events.assign(size, Event{});
+        m_eventsRead = 0;
+        m_eventsWritten = 0;
+    }
+
+    bool Window::PollEvent(Event& event) {
+        if (m_eventsRead == m_eventsWritten) return false;
+
+        event = m_events[m_eventsRead & (uint32_t)(m_events.size() - 1)];
+        m_eventsRead++;
+
+        return true;
+    }
+
+    const std::vector<std::wstring>& Window::GetDroppedPaths() const { return m_droppedPaths; }
+
+    Event& Window::NextEvent(EventType type) {
+        // Full. Drop the oldest event.
+        if (m_eventsWritten - m_eventsRead == (uint32_t)m_events.size())
+            m_eventsRead++;
+
+        Event& event = m_events[m_eventsWritten & (uint32_t)(m_events.size() - 1)];
+        m_eventsWritten++;
+
+        event.type = type;
+        return event;
+    }
+
+    void Window::EmitKeyEvent(Key key, KeyModifier mods, InputState state, bool repeat) {
+        Event event{};
+        event.type = EventType::Key;
+        event.key = KeyEvent{ key, mods, state, repeat };
+        EmitEvent(event);
+    }
+
+    void Window::EmitCharEvent(char32_t c, KeyModifier mods) {
+        Event event{};
+        event.type = EventType::Char;
+        event.character = CharEvent{ c, mods };
+        EmitEvent(event);
+    }
+
+    void Window::EmitMouseMoveEvent(Vector2<int32_t> position) {
+        Event event{};
+        event.type = EventType::MouseMove;
+        event.mousePosition = position;
+        EmitEvent(event);
+    }
+
+    void Window::EmitMouseButtonEvent(MouseButton button, KeyModifier mods, InputState state) {
+        Event event{};
+        event.type = EventType::MouseButton;
+        event.mouseButton = MouseButtonEvent{ button, mods, state };
+        EmitEvent(event);
+    }
+
+    void Window::EmitMouseScrollEvent(Vector2<float> offset) {
+        Event event{};
+        event.type = EventType::MouseScroll;
+        event.scrollOffset = offset;
+        EmitEvent(event);
+    }
+
+    void Window::EmitMouseEnteredEvent(bool entered) {
+        Event event{};
+        event.type = EventType::MouseEntered;
+        event.value = entered;
+        EmitEvent(event);
+    }
+
+    void Window::EmitWindowFocusEvent(bool focused) {
+        Event event{};
+        event.type = EventType::WindowFocus;
+        event.value = focused;
+        EmitEvent(event);
+    }
+
+    void Window::EmitWindowPosEvent(Vector2<int32_t> position) {
+        Event event{};
+        event.type = EventType::WindowPos;
+        event.position = position;
+        EmitEvent(event);
+    }
+
+    void Window::EmitWindowSizeEvent(Vector2<int32_t> size) {
+        Event event{};
+        event.type = EventType::WindowSize;
+        event.size = size;
+        EmitEvent(event);
+    }
+
+    void Window::EmitFramebufferSizeEvent(Vector2<int32_t> size) {
+        Event event{};
+        event.type = EventType::FramebufferSize;
+        event.size = size;
+        EmitEvent(event);
+    }
+
+    void Window::EmitWindowIconifiedEvent(bool iconified) {
+        Event event{};
+        event.type = EventType::WindowIconified;
+        event.value = iconified;
+        EmitEvent(event);
+    }
+
+    void Window::EmitWindowMaximizedEvent(bool maximized) {
+        Event event{};
+        event.type = EventType::WindowMaximized;
+        event.value = maximized;
+        EmitEvent(event);
+    }
+
+    void Window::EmitDPIChangedEvent(Vector2<uint32_t> dpi) {
+        Event event{};
+        event.type = EventType::DPIChanged;
+        event.dpi = dpi;
+        EmitEvent(event);
+    }
+
+    void Window::EmitPathDropEvent(std::vector<std::wstring>& paths, Vector2<int32_t> position) {
+        Event event{};
+        event.type = EventType::PathDrop;
+        event.pathDrop = PathDropEvent{ position, (uint32_t)paths.size() };
+        event.timestamp = m_eventTimestamp ? m_eventTimestamp : GetTimeNs();
+
+        if (!m_inputThread || !IsInputThread()) {
+            DispatchEvent(event, &paths);
+            return;
+        }
+
+        // The paths go through their own queue. The render thread takes them when it reaches the event, so both are pushed or neither is.
+        // Pushing the paths first makes them visible before the event.
+        if (m_inputThread->paths.IsFull() || m_inputThread->events.IsFull()) return;
+
+        m_inputThread->paths.Push(paths);
+        m_inputThread->events.Push(event);
+    }
+
+    void Window::EmitRawMouseMotionEvent(Vector2<float> delta) {
+        Event event{};
+        event.type = EventType::RawMouseMotion;
+        event.rawMouseMotion.delta = delta;
+        EmitEvent(event);
+    }
+
+    static bool ContainsMonitor(const std::vector<Monitor>& monitors, uint64_t id) {
+        for (const Monitor& monitor : monitors)
+            if (monitor.id == id) return true;
+        return false;
+    }
+
+    void Window::UpdateMonitors() {
+        std::vector<Monitor> monitors = Monitor::GetAllMonitors();
+
+        for (const Monitor& monitor : m_prevMonitors)
+            if (!ContainsMonitor(monitors, monitor.id)) EmitMonitorEvent(monitor, false);
+        for (const Monitor& monitor : monitors)
+            if (!ContainsMonitor(m_prevMonitors, monitor.id)) EmitMonitorEvent(monitor, true);
+
+        m_prevMonitors = std::move(monitors);
+    }
+
+    void Window::EmitMonitorEvent(const Monitor& monitor, bool connected) {
+        if (!m_inputThread || !IsInputThread()) {
+            m_monitorCallback(*this, monitor, connected);
+            return;
+        }
+
+        m_inputThread->monitors.Push(std::make_pair(monitor, connected));
+    }
+
+    void Window::EmitEvent(Event& event) {
+        event.timestamp = m_eventTimestamp ? m_eventTimestamp : GetTimeNs();
+
+        // Raw mouse motion samples are read without their event.
+        if (event.type == EventType::RawMouseMotion) event.rawMouseMotion.time = (double)event.timestamp / 1'000'000.0;
+
+        if (!m_inputThread || !IsInputThread()) {
+            DispatchEvent(event, nullptr);
+            return;
+        }
+
+        // The input thread never waits on the render thread. If the queue is full the event is lost but the snapshot still has the state it changed.
+        m_inputThread->events.Push(event);
+    }
+
+    void Window::DispatchEvent(const Event& event, std::vector<std::wstring>* paths) {
+        if (event.type == EventType::MouseScroll) {
+            m_scrollDelta.x += event.scrollOffset.x;
+            m_scrollDelta.y += event.scrollOffset.y;
+        }
+
+        if (event.type == EventType::RawMouseMotion) {
+            m_rawMouseDelta.x += event.rawMouseMotion.delta.x;
+            m_rawMouseDelta.y += event.rawMouseMotion.delta.y;
+
+            if (!m_rawMotionSamples.empty()) 
+                m_rawMotionSamples[m_rawMotionCount++ & (uint32_t)(m_rawMotionSamples.size() - 1)] = event.rawMouseMotion;
+        }
+
+        switch (event.type) {
+        case EventType::Key: case EventType::Char: case EventType::MouseMove: case EventType::MouseButton: case EventType::MouseScroll: case EventType::RawMouseMotion:
+            if (!m_oldestInputTimestamp || event.timestamp < m_oldestInputTimestamp) m_oldestInputTimestamp = event.timestamp;
+            break;
+        default: break;
+        }
+
+        if (m_coalescedEvents & (1u << (uint32_t)event.type)) {
+            for (uint32_t i = 0; i < m_pendingEventCount; i++) {
+                if (m_pendingEvents[i].type == event.type) {
+                    m_pendingEvents[i] = event;
+                    return;
+                }
+            }
+
+            // Only the four types SetEventCoalescing accepts get here, so it never fills up. Delivering the merged events keeps the array in bounds if it does.
+            if (m_pendingEventCount == m_pendingEvents.size()) FlushCoalescedEvents();
+            m_pendingEvents[m_pendingEventCount++] = event;
+            return;
+        }
+
+        FlushCoalescedEvents();
+        DeliverEvent(event, paths);
+    }
+
+    void Window::FlushCoalescedEvents() {
+        if (!m_pendingEventCount) return;
+
+        // A callback may update the window again and merge new events.
+        const std::array<Event, 4> pending = m_pendingEvents;
+        const uint32_t count = m_pendingEventCount;
+        m_pendingEventCount = 0;
+
+        for (uint32_t i = 0; i < count; i++) DeliverEvent(pending[i], nullptr);
+    }
+
+    void Window::FlushCoalescedEventsOfAll() {
+        for (Window* window : m_sWindows)
+            window->FlushCoalescedEvents();
+    }
+
+    void Window::DeliverEvent(const Event& event, std::vector<std::wstring>* paths) {
+        if (!m_events.empty()) {
+            if (event.type == EventType::PathDrop) m_droppedPaths = *paths;
+
+            NextEvent(event.type) = event;
+        }
+
+        if (!IsCallbackSet(m_setCallbacks, event.type)) return;
+
+        // A callback may update the window again, which dispatches more events.
+        const uint64_t outerTimestamp = m_dispatchTimestamp;
+        m_dispatchTimestamp = event.timestamp;
+
+        switch (event.type)
+        {
+        case EventType::Key: m_keyCallback(*this, event.key.key, event.key.mods, event.key.state, event.key.repeat); break;
+        case EventType::Char: m_charCallback(*this, event.character.c, event.character.mods); break;
+        case EventType::MouseMove: m_mouseMovecallback(*this, event.mousePosition); break;
+        case EventType::MouseButton: m_mouseButtonCallback(*this, event.mouseButton.button, event.mouseButton.mods, event.mouseButton.state); break;
+        case EventType::MouseScroll: m_mouseScrollCallback(*this, event.scrollOffset); break;
+        case EventType::MouseEntered: m_mouseEnteredCallback(*this, event.value); break;
+        case EventType::WindowFocus: m_windowFocusCallback(*this, event.value); break;
+        case EventType::WindowPos: m_posCallback(*this, event.position); break;
+        case EventType::WindowSize: m_sizeCallback(*this, event.size); break;
+        case EventType::FramebufferSize: m_framebufferSizeCallback(*this, event.size); break;
+        case EventType::WindowIconified: m_inconifiedCallback(*this, event.value); break;
+        case EventType::WindowMaximized: m_maximizedCallback(*this, event.value); break;
+        case EventType::PathDrop: m_pathDropCallback(*this, *paths, event.pathDrop.position); break;
+        case EventType::DPIChanged: m_dpiChangedCallback(*this, event.dpi); break;
+        default: break;
+        }
+
+        m_dispatchTimestamp = outerTimestamp;
+    }
+
+    const NativeWindowHandle& Window::GetNativeWindowHandle() const { return m_window; };
+    const NativeDeviceContext& Window::GetNativeDeviceContext() const { return m_deviceContext; }
+}
@@ -29,16 +29,20 @@
 
 #include <vector>
 #include <array>
+#include <atomic>
 #include <string>
 
 #include "IWindow.h"
 #include "IWindowPlatform.h"
 #include "IWindowCodes.h"
+#include "IWindowDelegate.h"
 #include "IWindowCore.h"
 #include "IWindowUtils.h"
+#include "IWindowEvent.h"
 
 #include <chrono>
 #include <functional>
+#include <memory>
 
 
 #ifdef _WIN32
@@ -52,7 +56,12 @@ namespace IWindow {
     /// </summary>
     class IWINDOW_API Window {
     public:
-        Window() = default;
+        Window();
+        /// <summary>
+        /// Removes the window from the list IWindow::PollEvents uses. Call IWindow::Window::Destroy to destroy the window.
+        /// If the window has an input thread it is stopped and the window is destroyed.
+        /// </summary>
+        ~Window();
         /// <summary>
         /// Creates the window. Prefer to use IWindow::Window::Create. Call IWindow::Initialize before creating the window.
         /// </summary>
@@ -90,18 +99,84 @@ namespace IWindow {
         /// </param>
         bool Create(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor = Monitor::GetPrimaryMonitor(), const Vector2<int32_t>& position = {}, const Style& style = Style::Default);
         /// <summary>
-        /// Destroys the window.
+        /// Destroys the window. Stops the input thread if the window has one.
         /// </summary>
         void Destroy();
         /// <summary>
         /// Updates the window and gets any event such as mouse movement, resizing the window, keyboard input, etc. 
+        /// With an input thread this calls the callbacks for the events the input thread handed over since the last call and never touches the OS.
         /// </summary>
         void Update();
         /// <summary>
-        /// The current thread will be paused until a event occurs.
+        /// The current thread will be paused until a event occurs or IWindow::PostEmptyEvent is called.
         /// </summary>
         void WaitForEvent();
         /// <summary>
+        /// Same as Window::WaitForEvent but returns after timeoutSeconds at the latest. A negative timeout waits forever.
+        /// </summary>
+        void WaitForEvent(double timeoutSeconds);
+
+        /// <summary>
+        /// Run the OS event loop of this window on its own thread so input is read while the render thread is blocked (e.g. in SwapBuffers or vkQueuePresentKHR).
+        /// Call before IWindow::Window::Create. The input thread creates the window, which Win32 needs to deliver its messages there, and destroys it in Window::Destroy.
+        /// Events are handed to the render thread through a lock-free queue. Callbacks and the event queue still run on the thread that calls Window::Update.
+        /// The getters (GetMousePosition, IsKeyDown, GetWindowSize, ...) return the state from the last Window::Update.
+        /// Functions that change the window (SetWindowSize, SetTitle, SetCursor, ...) have to be called through Window::RunOnInputThread.
+        /// The window is not updated by IWindow::PollEvents.
+        /// </summary>
+        /// <param name="info">Priority, CPU affinity and queue size of the thread.</param>
+        void SetInputThread(const InputThreadInfo& info = {});
+        /// <returns>true if the window's events are read on an input thread. See IWindow::Window::SetInputThread.</returns>
+        bool HasInputThread() const;
+        /// <summary>
+        /// Gets the newest state the input thread published. Unlike the getters it is not held back until the next Window::Update, 
+        /// so reading it right before rendering gives the freshest mouse position.
+        /// Without an input thread it is the current state of the window.
+        /// Only call from the thread that calls Window::Update.
+        /// </summary>
+        InputSnapshot GetLatestInput();
+        /// <summary>
+        /// Copies the state the getters return after the last update, with the scroll offsets of the whole update summed up in scrollDelta.
+        /// The copy doesn't change when the window updates again, so worker threads can read it without racing Window::Update.
+        /// Only call from the thread that calls Window::Update.
+        /// </summary>
+        InputSnapshot CaptureInputSnapshot() const;
+        /// <summary>
+        /// Run task on the input thread and wake it. Returns right away. Tasks run in the order they were added.
+        /// Without an input thread task runs right away on the calling thread.
+        /// </summary>
+        void RunOnInputThread(std::function<void(Window&)> task);
+        /// <summary>
+        /// Checks if the compositor wants a new frame. Use it to skip rendering frames that would never be shown (e.g. while the window is hidden).
+        /// Only Wayland tells the client when to draw, on every other backend this always returns true.
+        /// </summary>
+        /// <returns>
+        /// true if a frame should be rendered.
+        /// false if the compositor has not asked for the next frame yet.
+        /// </returns>
+        bool IsReadyForNextFrame() const;
+        /// <summary>
+        /// Asks the compositor to say when it wants the next frame. Call right before presenting (vkQueuePresentKHR, SwapBuffers, ...).
+        /// IsReadyForNextFrame returns false until the compositor answers. Window::WaitForEvent returns when it does.
+        /// Does nothing on backends other than Wayland.
+        /// </summary>
+        void RequestFrame();
+        /// <summary>
+        /// Records that a frame is being presented, for IWindow::Window::GetLatencyStats. IWindow::GL::Context::SwapFramebuffers, IWindow::Vk::QueuePresent
+        /// and IWindow::Null::PresentFramebuffer call it. Call it yourself right before presenting any other way. Only call from the thread that calls Window::Update.
+        /// </summary>
+        void MarkPresent();
+        /// <summary>
+        /// Gets the input-to-present latency of every frame marked with Window::MarkPresent since the window was created or Window::ResetLatencyStats.
+        /// A frame's latency is from its oldest input event (key, char, mouse and raw mouse motion) to the present. Frames without input are not counted.
+        /// It ends at the present call, so it doesn't include the time the GPU and the compositor take to show the frame.
+        /// </summary>
+        LatencyStats GetLatencyStats() const;
+        /// <summary>
+        /// Clears the latency histogram, e.g. after loading so only gameplay is measured.
+        /// </summary>
+        void ResetLatencyStats();
+        /// <summary>
         /// Checks if the window is still open. 
         /// </summary>
         /// <returns>
@@ -158,7 +233,7 @@ namespace IWindow {
         /// true if modifier is down.
         /// false if modifier is not down.
         /// </returns>
-        bool IsKeyModifiersDown(KeyModifier mods);
+        bool IsKeyModifiersDown(KeyModifier mods) { return ((uint64_t)*m_currentMods & (uint64_t)mods & MODIFIER_MASK) == ((uint64_t)mods & MODIFIER_MASK); }
         /// <summary>
         /// Check if a key modifier is up.
         /// </summary>
@@ -167,7 +242,7 @@ namespace IWindow {
         /// true if modifier is not down.
         /// false if modifier is down.
         /// </returns>
-        bool IsKeyModifiersUp(KeyModifier mods);
+        bool IsKeyModifiersUp(KeyModifier mods) { return !((uint64_t)*m_currentMods & (uint64_t)mods & MODIFIER_MASK); }
         /// <summary>
         /// Check if key and modifiers are down.
         /// </summary>
@@ -177,7 +252,7 @@ namespace IWindow {
         /// true if key and modifiers are down.
         /// false if key and modifiers are not down.
         /// </returns>
-        bool IsKeyDown(Key key, KeyModifier mods = KeyModifier::None);
+        bool IsKeyDown(Key key, KeyModifier mods = KeyModifier::None) { return m_currentKeys->Test((size_t)key) && IsKeyModifiersDown(mods); }
         /// <summary>
         /// Check if key and modifiers are up.
         /// </summary>
@@ -187,17 +262,41 @@ namespace IWindow {
         /// true if key and modifiers are not down.
         /// false if key and modifiers are down.
         /// </returns>
-        bool IsKeyUp(Key key, KeyModifier mods = KeyModifier::None);
+        bool IsKeyUp(Key key, KeyModifier mods = KeyModifier::None) { return !m_currentKeys->Test((size_t)key) && IsKeyModifiersUp(mods); }
         /// <summary>
-        /// Check if key and modifiers were just pressed in the last update.
+        /// Check if key was pressed in the last update and modifiers are down.
+        /// A key that was pressed and released within one update is not reported. Use the key callback or the event queue to see those.
         /// </summary>
         /// <param name="key">Key to check.</param>
         /// <param name="mods">Modifiers to check.</param>
         /// <returns>
-        /// true if key and modifiers are down and were not pressed for more than 1 update call.
-        /// false if key and modifiers are down and were pressed for more than 1 update call or if they are up.
+        /// true if key is down, was up before the last update and modifiers are down.
+        /// false otherwise.
         /// </returns>
-        bool IsKeyJustPressed(Key key, KeyModifier mods = KeyModifier::None);
+        bool IsKeyJustPressed(Key key, KeyModifier mods = KeyModifier::None) {
+            return m_currentKeys->Test((size_t)key) && !m_previousKeys.Test((size_t)key) && IsKeyModifiersDown(mods);
+        }
+        /// <summary>
+        /// Check if key was released in the last update and modifiers are down.
+        /// </summary>
+        /// <param name="key">Key to check.</param>
+        /// <param name="mods">Modifiers to check.</param>
+        /// <returns>
+        /// true if key is up, was down before the last update and modifiers are down.
+        /// false otherwise.
+        /// </returns>
+        bool IsKeyJustReleased(Key key, KeyModifier mods = KeyModifier::None) {
+            return !m_currentKeys->Test((size_t)key) && m_previousKeys.Test((size_t)key) && IsKeyModifiersDown(mods);
+        }
+        /// <summary>
+        /// Calls function(Key key, bool down) for every key that was pressed or released in the last update.
+        /// Cheaper than calling IsKeyJustPressed for every key because keys are compared 64 at a time.
+        /// </summary>
+        /// <param name="function">Called with the key and whether it is down now.</param>
+        template<typename F>
+        void ForEachChangedKey(F&& function) const {
+            GetCurrentKeys().ForEachChanged(m_previousKeys, [&](size_t key, bool down) { function((Key)key, down); });
+        }
         /// <summary>
         /// Check if mouse button and modifiers are down.
         /// </summary>
@@ -207,7 +306,7 @@ namespace IWindow {
         /// true if mouse button and modifiers are down.
         /// false if mouse button and modifiers are not down.
         /// </returns>
-        bool IsMouseButtonDown(MouseButton button, KeyModifier mods = KeyModifier::None);
+        bool IsMouseButtonDown(MouseButton button, KeyModifier mods = KeyModifier::None) { return m_currentMouseButtons->Test((size_t)button) && IsKeyModifiersDown(mods); }
         /// <summary>
         /// Check if mouse button and modifiers are not down.
         /// </summary>
@@ -217,10 +316,66 @@ namespace IWindow {
         /// true if mouse button and modifiers are not down.
         /// false if mouse button and modifiers are down.
         /// </returns>
-        bool IsMouseButtonUp(MouseButton button, KeyModifier mods = KeyModifier::None);
+        bool IsMouseButtonUp(MouseButton button, KeyModifier mods = KeyModifier::None) { return !m_currentMouseButtons->Test((size_t)button) && IsKeyModifiersUp(mods); }
+        /// <summary>
+        /// Check if mouse button was pressed in the last update and modifiers are down.
+        /// </summary>
+        /// <param name="button">Button to check.</param>
+        /// <param name="mods">Modifiers to check.</param>
+        /// <returns>
+        /// true if mouse button is down, was up before the last update and modifiers are down.
+        /// false otherwise.
+        /// </returns>
+        bool IsMouseButtonJustPressed(MouseButton button, KeyModifier mods = KeyModifier::None) {
+            return m_currentMouseButtons->Test((size_t)button) && !m_previousMouseButtons.Test((size_t)button) && IsKeyModifiersDown(mods);
+        }
+        /// <summary>
+        /// Check if mouse button was released in the last update and modifiers are down.
+        /// </summary>
+        /// <param name="button">Button to check.</param>
+        /// <param name="mods">Modifiers to check.</param>
+        /// <returns>
+        /// true if mouse button is up, was down before the last update and modifiers are down.
+        /// false otherwise.
+        /// </returns>
+        bool IsMouseButtonJustReleased(MouseButton button, KeyModifier mods = KeyModifier::None) {
+            return !m_currentMouseButtons->Test((size_t)button) && m_previousMouseButtons.Test((size_t)button) && IsKeyModifiersDown(mods);
+        }
 
         /// <returns>Scroll offset from the last update call.</returns>
         Vector2<float> GetMouseScrollOffset() const;
+        /// <returns>Sum of the offsets of every scroll event in the last update call.</returns>
+        Vector2<float> GetMouseScrollDelta() const;
+
+        /// <summary>
+        /// Turns raw mouse motion on or off. Every relative motion the mouse reports, without pointer acceleration and without being merged
+        /// with other motion, is recorded with its time while the window is focused. Read them with Window::GetRawMouseMotion after an update.
+        /// Uses WM_INPUT on Win32 and XI_RawMotion (XInput2) on X11. Wayland has no raw mouse motion yet.
+        /// With an input thread call it from the render thread. The window system is changed on the input thread, so motion before that is not recorded.
+        /// </summary>
+        /// <param name="enabled">true to record raw mouse motion.</param>
+        /// <param name="sampleCapacity">
+        /// Number of samples kept per update. Rounded up to a power of two. A 1000 Hz mouse needs about 17 for a 60 Hz update.
+        /// When an update has more samples the oldest are dropped. They are still added to Window::GetRawMouseDelta.
+        /// </param>
+        /// <returns>
+        /// true if raw mouse motion is on.
+        /// false if enabled is false or the backend has no raw mouse motion.
+        /// </returns>
+        bool SetRawMouseMotion(bool enabled, uint32_t sampleCapacity = 1024);
+        /// <returns>true if the backend and the machine support raw mouse motion.</returns>
+        bool IsRawMouseMotionSupported() const;
+        /// <summary>
+        /// Copies the raw mouse motion samples of the last update, oldest first.
+        /// </summary>
+        /// <param name="samples">Array of at least maxCount samples.</param>
+        /// <param name="maxCount">Maximum number of samples to copy. The newest samples are copied if there are more.</param>
+        /// <returns>Number of samples copied.</returns>
+        uint32_t GetRawMouseMotion(RawMouseMotion* samples, uint32_t maxCount) const;
+        /// <returns>Number of raw mouse motion samples kept from the last update.</returns>
+        uint32_t GetRawMouseMotionCount() const;
+        /// <returns>Sum of every raw mouse motion of the last update, including samples that did not fit.</returns>
+        Vector2<float> GetRawMouseDelta() const;
 
         /// <summary>
         /// Set a pointer that the user can access if they have the corresponding window.
@@ -253,6 +408,23 @@ namespace IWindow {
         /// </param>
         void Fullscreen(bool fullscreen, Monitor monitor);
         /// <summary>
+        /// Makes the window exclusive fullscreen: switches the monitor to a video mode, e.g. 1920x1080 at 144 hertz on a 4K monitor, and covers it.
+        /// The monitor gets its old mode back when the window leaves fullscreen or is destroyed.
+        /// If the mode can't be set the window still becomes fullscreen at the monitor's current mode.
+        /// Wayland compositors don't let clients change modes.
+        /// </summary>
+        /// <param name="fullscreen">
+        /// Set to true if you want to make the window to fullscreen.
+        /// Set to false if you want to make the window not fullscreen, which is the same as IWindow::Window::Fullscreen(false, monitor).
+        /// </param>
+        /// <param name="monitor">The monitor to switch.</param>
+        /// <param name="mode">One of Monitor::GetVideoModes, e.g. from Monitor::GetClosestVideoMode. An empty mode keeps the current mode.</param>
+        /// <returns>
+        /// true if the monitor is in the mode.
+        /// false if the mode couldn't be set.
+        /// </returns>
+        bool Fullscreen(bool fullscreen, Monitor monitor, VideoMode mode);
+        /// <summary>
         /// Checks if the window is fullscreen.
         /// </summary>
         /// <returns>
@@ -297,8 +469,15 @@ namespace IWindow {
         /// <param name="text">String to set the clipboard to.</param>
         void SetClipboardText(const std::string& text);
         
-        /// <returns>Time since this window was created.</returns>
+        /// <returns>Milliseconds since this window was created, on the clock of IWindow::GetTimeNs.</returns>
         double GetTime() const;
+        /// <summary>
+        /// Gets when the event whose callback is running happened, in nanoseconds since the window was created (the clock of Window::GetTime).
+        /// Taken from the OS where the event has a timestamp: milliseconds on X11, Wayland and Win32 (GetMessageTime). Otherwise it is when the event was read.
+        /// Events from the event queue carry the same value in IWindow::Event::timestamp.
+        /// </summary>
+        /// <returns>Timestamp of the current event. 0 outside of a callback.</returns>
+        uint64_t GetEventTimestamp() const;
 
         /// <summary>
         /// Checks if the user is focused on the window.
@@ -337,16 +516,17 @@ namespace IWindow {
         /// <param name="style">Styles to set.</param>
         void SetStyle(Style style);
 
-        // Input callbacks
-        typedef std::function<void(Window&, Key, KeyModifier, InputState, bool)> KeyCallback;
-        typedef std::function<void(Window&, Vector2<int32_t>)> MouseMoveCallback;
-        typedef std::function<void(Window&, Vector2<float>)> MouseScrollCallback;
-        typedef std::function<void(Window&, MouseButton, KeyModifier, InputState)> MouseButtonCallback;
-        typedef std::function<void(Window&, bool)> WindowFocusCallback;
-        typedef std::function<void(Window&, char32_t, KeyModifier)> CharCallback;
-        typedef std::function<void(Window&, std::vector<std::wstring>&, Vector2<int32_t>)> PathDropCallback;
-        typedef std::function<void(Window&, const Monitor&, bool)> MonitorCallback;
-        typedef std::function<void(Window&, Vector2<uint32_t>)> DPIChangedCallback;
+        // Input callbacks. Delegates store the callable inline so setting and calling a callback never allocates. 
+        // Lambdas, function pointers and std::function still convert to them. See IWindowDelegate.h.
+        typedef Delegate<void(Window&, Key, KeyModifier, InputState, bool)> KeyCallback;
+        typedef Delegate<void(Window&, Vector2<int32_t>)> MouseMoveCallback;
+        typedef Delegate<void(Window&, Vector2<float>)> MouseScrollCallback;
+        typedef Delegate<void(Window&, MouseButton, KeyModifier, InputState)> MouseButtonCallback;
+        typedef Delegate<void(Window&, bool)> WindowFocusCallback;
+        typedef Delegate<void(Window&, char32_t, KeyModifier)> CharCallback;
+        typedef Delegate<void(Window&, std::vector<std::wstring>&, Vector2<int32_t>)> PathDropCallback;
+        typedef Delegate<void(Window&, const Monitor&, bool)> MonitorCallback;
+        typedef Delegate<void(Window&, Vector2<uint32_t>)> DPIChangedCallback;
         typedef WindowFocusCallback MouseEnteredCallback;
         typedef WindowFocusCallback WindowIconifiedCallback;
         typedef WindowFocusCallback WindowMaximizedCallback;
@@ -371,16 +551,200 @@ namespace IWindow {
         MonitorCallback SetMonitorCallback(MonitorCallback callback);
         DPIChangedCallback SetDPIChangedCallback(DPIChangedCallback callback);
 
+        /// <summary>
+        /// Turns on the event queue. Every event is also written to a ring buffer that is read with IWindow::Window::PollEvent.
+        /// Callbacks that are set are still called. Monitor events only have a callback.
+        /// </summary>
+        /// <param name="capacity">
+        /// Number of events the queue can hold. Rounded up to a power of two. 
+        /// When the queue is full the oldest event is dropped. 0 turns the queue off, which is the default.
+        /// </param>
+        void SetEventQueueCapacity(uint32_t capacity);
+        /// <summary>
+        /// Takes the oldest event out of the event queue. Events are added by Window::Update, Window::WaitForEvent and IWindow::PollEvents.
+        /// </summary>
+        /// <param name="event">Set to the event if there was one.</param>
+        /// <returns>
+        /// true if an event was taken out of the queue.
+        /// false if the queue is empty or off.
+        /// </returns>
+        bool PollEvent(Event& event);
+        /// <returns>Paths of the last PathDrop event written to the event queue.</returns>
+        const std::vector<std::wstring>& GetDroppedPaths() const;
+        /// <summary>
+        /// Merges the events of a type that arrive within one update into one callback (and one event in the event queue) with the final value,
+        /// e.g. so a window drag rebuilds the swapchain once per update instead of once per message.
+        /// A merged event is delivered before the next event of a type that isn't merged, so the order with keys and buttons is kept, or at the end of the update.
+        /// The getters (GetSize, GetMousePosition, ...) always have the latest value. Off for every type by default.
+        /// </summary>
+        /// <param name="type">EventType::MouseMove, EventType::WindowPos, EventType::WindowSize or EventType::FramebufferSize.</param>
+        /// <param name="coalesce">true to merge the events, false to deliver every one.</param>
+        void SetEventCoalescing(EventType type, bool coalesce);
+        /// <returns>true if events of type are merged. See IWindow::Window::SetEventCoalescing.</returns>
+        bool IsEventCoalesced(EventType type) const;
+
 
         bool operator==(IWindow::Window& window);
         bool operator!=(IWindow::Window& window);
     private:
+        friend void PollEvents();
+        friend void WaitEvents();
+        friend void WaitEvents(double timeoutSeconds);
+        friend void PostEmptyEvent();
+#if defined(__linux__)
+        friend int GetEventFd();
+        friend void DispatchPending();
+#endif
+
+        // Every created window. Events read by IWindow::PollEvents are handed to the window they belong to.
+        static std::vector<Window*> m_sWindows;
+
+        void AddToRegistry();
+        void RemoveFromRegistry();
+        static Window* FromNativeWindowHandle(const NativeWindowHandle& handle);
+
+        // The backends report every event through these. They write the event to the event queue and call the callback if one was set.
+        void EmitKeyEvent(Key key, KeyModifier mods, InputState state, bool repeat);
+        void EmitCharEvent(char32_t c, KeyModifier mods);
+        void EmitMouseMoveEvent(Vector2<int32_t> position);
+        void EmitMouseButtonEvent(MouseButton button, KeyModifier mods, InputState state);
+        void EmitMouseScrollEvent(Vector2<float> offset);
+        void EmitMouseEnteredEvent(bool entered);
+        void EmitWindowFocusEvent(bool focused);
+        void EmitWindowPosEvent(Vector2<int32_t> position);
+        void EmitWindowSizeEvent(Vector2<int32_t> size);
+        void EmitFramebufferSizeEvent(Vector2<int32_t> size);
+        void EmitWindowIconifiedEvent(bool iconified);
+        void EmitWindowMaximizedEvent(bool maximized);
+        void EmitPathDropEvent(std::vector<std::wstring>& paths, Vector2<int32_t> position);
+        void EmitDPIChangedEvent(Vector2<uint32_t> dpi);
+        void EmitRawMouseMotionEvent(Vector2<float> delta);
+
+        void EmitMonitorEvent(const Monitor& monitor, bool connected);
+        // Reads the monitors again and reports the ones that were connected or disconnected since the last call, by Monitor::id. 
+        // Backends drop the monitor cache with Monitor::InvalidateCache first when the OS reports a change.
+        void UpdateMonitors();
+        // Hands the event to the render thread when called on the input thread. Otherwise dispatches it right away.
+        // Stamps the event with m_eventTimestamp, or the current time if the backend didn't set one.
+        void EmitEvent(Event& event);
+        // Writes the event to the event queue and calls its callback. paths is only used by PathDrop events.
+        void DispatchEvent(const Event& event, std::vector<std::wstring>* paths);
+
+        // The slot for the next event in the event queue. Only call when the queue is on.
+        Event& NextEvent(EventType type);
+
+        // Implemented by every backend. Create, Destroy, Update and WaitForEvent call these directly or from the input thread.
+        bool CreateNative(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style);
+        void DestroyNative();
+        void UpdateNative();
+        // A negative timeout waits forever. Also returns for IWindow::PostEmptyEvent unless called on the input thread.
+        void WaitForEventNative(double timeoutSeconds);
+        // Selects raw mouse motion of the window system. Called on the input thread if there is one. Returns false if it is not supported.
+        bool SetRawMouseMotionNative(bool enabled);
+        bool IsRawMouseMotionSupportedNative() const;
+        // Makes WaitForEventNative return. Safe to call from any thread once the window was created.
+        void WakeEventLoop();
+        // Wakes IWindow::WaitEvents and every WaitForEventNative that isn't on an input thread. Safe to call from any thread.
+        static void PostEmptyEventNative();
+        // Implemented by every backend. IWindow::PollEvents, IWindow::WaitEvents and IWindow::DispatchPending begin an input frame on every window and call these.
+        static void PollEventsNative();
+        static void WaitEventsNative(double timeoutSeconds);
+#if defined(__linux__)
+        static void DispatchPendingNative();
+#endif
+
+        // Makes the keys and mouse buttons that are down the state the Just* queries compare against. Called before an update handles its events.
+        void BeginInputFrame();
+        static void BeginInputFrames();
+        const KeyBitSet& GetCurrentKeys() const { return *m_currentKeys; }
+        const MouseButtonBitSet& GetCurrentMouseButtons() const { return *m_currentMouseButtons; }
+
+        // See IWindowWindow.cpp. nullptr if the window has no input thread.
+        struct InputThread;
+        std::unique_ptr<InputThread> m_inputThread;
+        // The render thread's copy of the input thread's state. The getters read it when there is an input thread.
+        InputSnapshot m_inputState{};
+
+        void RunInputThread(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style);
+        bool IsInputThread() const;
+        void PublishInput();
+        InputSnapshot CaptureState() const;
+        // Calls the callbacks of every event the input thread handed over and takes its latest snapshot.
+        void DispatchInputThreadEvents();
+
 #if defined (_WIN32)
         LRESULT CALLBACK WindowCallback(HWND window, UINT msg, WPARAM wparam, LPARAM lparam);
         static LRESULT CALLBACK s_WindowCallback(HWND window, UINT msg, WPARAM wparam, LPARAM lparam);
+#elif defined(IWINDOW_XCB)
+        void WindowCallback(xcb_generic_event_t* event);
+        void UpdateWindowState();
+        void UpdateSizeHints();
+
+        // Reads every event on the shared connection. Events for target are handled right away and the rest are queued for their window.
+        // If target is nullptr every event is handled right away.
+        static void ReadEvents(Window* target);
+        // Adds an event to the pending events of the window it is for.
+        static void QueueEvent(xcb_generic_event_t* event);
+        void DispatchPendingEvents();
+        // Keeps an event read outside of Update for the next Update. Goes through QueueEvent unless the window has its own connection.
+        void KeepEvent(xcb_generic_event_t* event) const;
+
+        // mutable because GetClipboardText has to queue events while it waits for the selection owner.
+        mutable XcbWindowData m_xcb;
+#elif defined(IWINDOW_XLIB)
+        void WindowCallback(XEvent* event);
+        void UpdateWindowState();
+        void UpdateSizeHints();
+
+        XlibWindowData m_xlib;
+#elif defined(IWINDOW_WAYLAND)
+        // Wayland listeners are C callbacks. See IWindowWayland.cpp.
+        friend struct WaylandListeners;
+
+        void DispatchEvents(int32_t timeoutMS);
+        // Dispatches the events of every window. Used by IWindow::PollEvents and IWindow::WaitEvents.
+        static void DispatchAllEvents(int32_t timeoutMS);
+        // DispatchEvents is split in two so the connections of several windows can be polled at once. 
+        // PrepareRead returns true if it had to dispatch events that were already read.
+        bool PrepareRead();
+        void FinishRead(bool readable);
+        // Milliseconds until the next key repeat or -1 if no key is repeating.
+        int32_t GetRepeatTimeout() const;
+
+        WaylandWindowData m_wl;
+#elif defined(IWINDOW_NULL)
+        void WindowCallback(const Null::Event& event);
+        // Resizes the in-memory framebuffer to m_framebufferSize.
+        void ResizeFramebuffer();
+        // Monitor::GetCacheGeneration when the window last read the monitors. Null::SetMonitors changes it.
+        uint64_t m_monitorGeneration = 0;
 #endif
         Vector2<int32_t> m_size, m_oldSize, m_position, m_framebufferSize, m_mousePosition;
         Vector2<float> m_scrollOffset;
+        // Summed up by DispatchEvent and reset by BeginInputFrame. Only used by the thread that calls Window::Update.
+        Vector2<float> m_scrollDelta{};
+        uint64_t m_frame = 0;
+        double m_frameTime = 0.0;
+
+        // Set by the backends to the time of the OS event they are handling. 0 uses the current time. Only used by the thread that reads the window's events.
+        uint64_t m_eventTimestamp = 0;
+        // Timestamp of the event DispatchEvent is handling. 0 outside of a callback.
+        uint64_t m_dispatchTimestamp = 0;
+        // Nanoseconds on the clock of GetTime.
+        uint64_t GetTimeNs() const;
+        // Converts how long ago an OS event happened to the clock of GetTime. UINT64_MAX means unknown and gives 0 (the current time).
+        uint64_t TimestampFromAge(uint64_t ageNs) const;
+
+        // Timestamp of the oldest input event since the last MarkPresent, 0 if there was none. Only used by the thread that calls Window::Update.
+        uint64_t m_oldestInputTimestamp = 0;
+        LatencyStats m_latencyStats{};
+
+        // Set by SetRawMouseMotionNative. Only used by the thread that reads the window's events.
+        bool m_rawMouseMotion = false;
+        // Ring buffer of the raw mouse motion of the current update. Size is a power of two. Written by DispatchEvent and reset by BeginInputFrame.
+        std::vector<RawMouseMotion> m_rawMotionSamples{};
+        uint32_t m_rawMotionCount = 0;
+        Vector2<float> m_rawMouseDelta{};
         // wstring guarantees that the chars are 16 bit not 32 bit which std::wstring does not guarantee.
         std::wstring m_title;
 
@@ -393,47 +757,60 @@ namespace IWindow {
 
         NativeStyle m_windowStyle;
 
-        std::chrono::high_resolution_clock::time_point m_timeMS;
+        // IWindow::GetTimeNs when the window was created.
+        uint64_t m_createTimeNs = 0;
 
-        std::vector<bool> m_keys{ false };
-        std::vector<bool> m_keysPressedOnce{ false };
+        // Written by the backends. With an input thread m_previousKeys and m_previousMouseButtons hold the previous m_inputState instead.
+        KeyBitSet m_keys{}, m_previousKeys{};
         KeyModifier m_mods;
-        std::vector<bool> m_mouseButtons{ false };
+        MouseButtonBitSet m_mouseButtons{}, m_previousMouseButtons{};
+        // What the Is* queries read. BeginInputFrame points them at m_inputState when there is an input thread, so a query doesn't have to check.
+        const KeyBitSet* m_currentKeys = &m_keys;
+        const MouseButtonBitSet* m_currentMouseButtons = &m_mouseButtons;
+        const KeyModifier* m_currentMods = &m_mods;
+        static constexpr uint64_t MODIFIER_MASK = (uint64_t)KeyModifier::Max - 1;
 
         std::vector<Monitor> m_prevMonitors{};
-
-        static void DefaultWindowPosCallback(Window&, Vector2<int32_t>) {}
-        static void DefaultWindowSizeCallback(Window&, Vector2<int32_t>) {}
-        static void DefaultKeyCallback(Window&, Key, KeyModifier, InputState, bool) {}
-        static void DefaultMouseMoveCallback(Window&, Vector2<int32_t>) {}
-        static void DefaultMouseButtonCallback(Window&, MouseButton, KeyModifier, InputState) {}
-        static void DefaultMouseScrollCallback(Window&, Vector2<float>) {}
-        static void DefaultWindowFocusCallback(Window&, bool) {}
-        static void DefaultMouseEnteredCallback(Window&, bool) {}
-        static void DefaultCharCallback(Window&, char32_t, KeyModifier) {}
-        static void DefaultFramebufferSizeCallback(Window&, Vector2<int32_t>) {}
-        static void DefaultWindowIconifiedCallback(Window&, bool) {}
-        static void DefaultWindowMaximizedCallback(Window&, bool) {}
-        static void DefualtPathDropCallback(Window&, std::vector<std::wstring>&, Vector2<int32_t>) {}
-        static void DefualtMonitorCallback(Window&, const Monitor& monitor, bool) {}
-        static void DefualtDPIChangedCallback(Window&, Vector2<uint32_t>) {}
-
-
-        WindowPosCallback m_posCallback = DefaultWindowPosCallback;
-        WindowSizeCallback m_sizeCallback = DefaultWindowSizeCallback;
-        KeyCallback m_keyCallback = DefaultKeyCallback;
-        MouseMoveCallback m_mouseMovecallback = DefaultMouseMoveCallback;
-        MouseButtonCallback m_mouseButtonCallback = DefaultMouseButtonCallback;
-        MouseScrollCallback m_mouseScrollCallback = DefaultMouseScrollCallback;
-        WindowFocusCallback m_windowFocusCallback = DefaultWindowFocusCallback;
-        MouseEnteredCallback m_mouseEnteredCallback = DefaultMouseEnteredCallback;
-        CharCallback m_charCallback = DefaultCharCallback;
-        FramebufferSizeCallback m_framebufferSizeCallback = DefaultFramebufferSizeCallback;
-        WindowIconifiedCallback m_inconifiedCallback = DefaultWindowIconifiedCallback;
-        WindowMaximizedCallback m_maximizedCallback = DefaultWindowMaximizedCallback;
-        PathDropCallback m_pathDropCallback = DefualtPathDropCallback;
-        MonitorCallback m_monitorCallback = DefualtMonitorCallback;
-        DPIChangedCallback m_dpiChangedCallback = DefualtDPIChangedCallback;
+        // Monitor Fullscreen switched to a video mode. Its id is 0 when no mode was switched.
+        Monitor m_videoModeMonitor{};
+        // Gives m_videoModeMonitor its old video mode back.
+        void RestoreVideoMode();
+
+        WindowPosCallback m_posCallback{};
+        WindowSizeCallback m_sizeCallback{};
+        KeyCallback m_keyCallback{};
+        MouseMoveCallback m_mouseMovecallback{};
+        MouseButtonCallback m_mouseButtonCallback{};
+        MouseScrollCallback m_mouseScrollCallback{};
+        WindowFocusCallback m_windowFocusCallback{};
+        MouseEnteredCallback m_mouseEnteredCallback{};
+        CharCallback m_charCallback{};
+        FramebufferSizeCallback m_framebufferSizeCallback{};
+        WindowIconifiedCallback m_inconifiedCallback{};
+        WindowMaximizedCallback m_maximizedCallback{};
+        PathDropCallback m_pathDropCallback{};
+        MonitorCallback m_monitorCallback{};
+        DPIChangedCallback m_dpiChangedCallback{};
+
+        // Bit 1 << IWindow::EventType is set for every callback the user set. Events without a callback skip the call.
+        uint32_t m_setCallbacks = 0;
+
+        // Bit 1 << IWindow::EventType is set for every type SetEventCoalescing merges.
+        uint32_t m_coalescedEvents = 0;
+        // The merged events waiting to be delivered, in the order their types first arrived. At most one per type.
+        std::array<Event, 4> m_pendingEvents{};
+        uint32_t m_pendingEventCount = 0;
+        // Delivers the merged events. Called before an event that isn't merged and at the end of an update.
+        void FlushCoalescedEvents();
+        static void FlushCoalescedEventsOfAll();
+        // Writes the event to the event queue and calls its callback.
+        void DeliverEvent(const Event& event, std::vector<std::wstring>* paths);
+
+        // Ring buffer of events. Empty when the event queue is off. The size is a power of two.
+        std::vector<Event> m_events{};
+        // Only ever increase. Wrapped with the size of m_events.
+        uint32_t m_eventsRead = 0, m_eventsWritten = 0;
+        std::vector<std::wstring> m_droppedPaths{};
 
         NativeDeviceContext m_deviceContext;
         NativeWindowHandle m_window;
@@ -443,7 +820,7 @@ namespace IWindow {
 
         void* m_userPtr;
 
-        static uint32_t m_sWindowCount;
+        static std::atomic<uint32_t> m_sWindowCount;
         uint32_t m_windowIndex;
 
         static Version m_version;
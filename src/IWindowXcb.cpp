@@ -0,0 +1,1251 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_XCB)
+
+#include "IWindowWindow.h"
+#include "IWindowUtilsLinux.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <xcb/xinput.h>
+#include <xcb/randr.h>
+
+namespace IWindow {
+    // Every window shares one connection to the X server. The first window opens it and the last one closes it.
+    static xcb_connection_t* s_connection = nullptr;
+    static uint32_t s_connectionUsers = 0;
+
+    static void ReleaseConnection() {
+        if (--s_connectionUsers > 0) {
+            xcb_flush(s_connection);
+            return;
+        }
+
+        xcb_disconnect(s_connection);
+        s_connection = nullptr;
+    }
+
+    static void InternAtoms(xcb_connection_t* connection, std::array<xcb_atom_t, (size_t)X11Atom::Max>& atoms) {
+        std::array<xcb_intern_atom_cookie_t, (size_t)X11Atom::Max> cookies{};
+
+        // Send every request before waiting on any reply so this is a single round trip.
+        for (size_t i = 0; i < cookies.size(); i++)
+            cookies[i] = xcb_intern_atom(connection, 0, (uint16_t)strlen(X11_ATOM_NAMES[i]), X11_ATOM_NAMES[i]);
+
+        for (size_t i = 0; i < cookies.size(); i++) {
+            xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(connection, cookies[i], nullptr);
+            atoms[i] = reply ? reply->atom : (xcb_atom_t)XCB_ATOM_NONE;
+            free(reply);
+        }
+    }
+
+    static void LoadKeyboardMapping(xcb_connection_t* connection, XcbWindowData& data) {
+        const xcb_setup_t* setup = xcb_get_setup(connection);
+
+        data.minKeyCode = setup->min_keycode;
+
+        xcb_get_keyboard_mapping_reply_t* reply = xcb_get_keyboard_mapping_reply(connection,
+            xcb_get_keyboard_mapping(connection, setup->min_keycode, (uint8_t)(setup->max_keycode - setup->min_keycode + 1)), nullptr);
+
+        IWINDOW_CHECK_ERROR(!reply, ErrorType::WindowApi, ErrorSeverity::Error, "xcb_get_keyboard_mapping() failed. Failed to get the keyboard mapping!", true, ;);
+
+        xcb_keysym_t* keysyms = xcb_get_keyboard_mapping_keysyms(reply);
+        data.keysyms.assign(keysyms, keysyms + xcb_get_keyboard_mapping_keysyms_length(reply));
+        data.keysymsPerKeyCode = reply->keysyms_per_keycode;
+
+        free(reply);
+    }
+
+    static bool IsKeypadKeysym(xcb_keysym_t keysym) { return keysym >= 0xff80 && keysym <= 0xffbd; }
+
+    static xcb_keysym_t KeyCodeToKeysym(const XcbWindowData& data, xcb_keycode_t keyCode, uint16_t state) {
+        size_t index = (size_t)(keyCode - data.minKeyCode) * data.keysymsPerKeyCode;
+        if (keyCode < data.minKeyCode || index >= data.keysyms.size()) return 0;
+
+        xcb_keysym_t lower = data.keysyms[index];
+        xcb_keysym_t upper = data.keysymsPerKeyCode > 1 ? data.keysyms[index + 1] : 0;
+        if (upper == 0) upper = lower;
+
+        bool shift = state & XCB_MOD_MASK_SHIFT;
+
+        // Mod2 is num lock on every X server that matters.
+        if ((state & XCB_MOD_MASK_2) && IsKeypadKeysym(upper))
+            return shift ? lower : upper;
+
+        if ((state & XCB_MOD_MASK_LOCK) && lower >= 'a' && lower <= 'z')
+            shift = !shift;
+
+        return shift ? upper : lower;
+    }
+
+    // X reports key repeats as a release followed by a press of the same key with the same timestamp.
+    static bool IsKeyRepeat(xcb_generic_event_t* event, xcb_generic_event_t* next) {
+        if ((event->response_type & ~0x80) != XCB_KEY_RELEASE || (next->response_type & ~0x80) != XCB_KEY_PRESS)
+            return false;
+
+        xcb_key_release_event_t* release = (xcb_key_release_event_t*)event;
+        xcb_key_press_event_t* press = (xcb_key_press_event_t*)next;
+
+        return release->detail == press->detail && release->time == press->time;
+    }
+
+    // The window an event was sent to. XCB_WINDOW_NONE if the event is for every window (e.g. keyboard mapping changes).
+    static xcb_window_t EventWindow(xcb_generic_event_t* event) {
+        switch (event->response_type & ~0x80)
+        {
+        case XCB_KEY_PRESS:
+        case XCB_KEY_RELEASE:
+            return ((xcb_key_press_event_t*)event)->event;
+        case XCB_BUTTON_PRESS:
+        case XCB_BUTTON_RELEASE:
+            return ((xcb_button_press_event_t*)event)->event;
+        case XCB_MOTION_NOTIFY:
+            return ((xcb_motion_notify_event_t*)event)->event;
+        case XCB_ENTER_NOTIFY:
+        case XCB_LEAVE_NOTIFY:
+            return ((xcb_enter_notify_event_t*)event)->event;
+        case XCB_FOCUS_IN:
+        case XCB_FOCUS_OUT:
+            return ((xcb_focus_in_event_t*)event)->event;
+        case XCB_EXPOSE:
+            return ((xcb_expose_event_t*)event)->window;
+        case XCB_CONFIGURE_NOTIFY:
+            return ((xcb_configure_notify_event_t*)event)->window;
+        case XCB_MAP_NOTIFY:
+            return ((xcb_map_notify_event_t*)event)->window;
+        case XCB_UNMAP_NOTIFY:
+            return ((xcb_unmap_notify_event_t*)event)->window;
+        case XCB_REPARENT_NOTIFY:
+            return ((xcb_reparent_notify_event_t*)event)->window;
+        case XCB_DESTROY_NOTIFY:
+            return ((xcb_destroy_notify_event_t*)event)->window;
+        case XCB_PROPERTY_NOTIFY:
+            return ((xcb_property_notify_event_t*)event)->window;
+        case XCB_CLIENT_MESSAGE:
+            return ((xcb_client_message_event_t*)event)->window;
+        case XCB_SELECTION_REQUEST:
+            return ((xcb_selection_request_event_t*)event)->owner;
+        case XCB_SELECTION_NOTIFY:
+            return ((xcb_selection_notify_event_t*)event)->requestor;
+        case XCB_SELECTION_CLEAR:
+            return ((xcb_selection_clear_event_t*)event)->owner;
+        default:
+            return XCB_WINDOW_NONE;
+        }
+    }
+
+    // Core events are always sizeof(xcb_generic_event_t). Generic events (XInput 2) are followed by length more 4 byte units.
+    static size_t EventSize(const xcb_generic_event_t* event) {
+        if ((event->response_type & ~0x80) != XCB_GE_GENERIC) return sizeof(xcb_generic_event_t);
+        return sizeof(xcb_generic_event_t) + (size_t)((const xcb_ge_generic_event_t*)event)->length * 4;
+    }
+
+    static uint8_t QueryXInput2(xcb_connection_t* connection) {
+        const xcb_query_extension_reply_t* extension = xcb_get_extension_data(connection, &xcb_input_id);
+        if (!extension || !extension->present) return 0;
+
+        xcb_input_xi_query_version_reply_t* reply = xcb_input_xi_query_version_reply(connection, xcb_input_xi_query_version(connection, 2, 0), nullptr);
+        const bool supported = reply && reply->major_version >= 2;
+        free(reply);
+
+        return supported ? extension->major_opcode : 0;
+    }
+
+    // Asks for RandR screen and output changes on the root window, so every window on the connection hears about monitor hot-plugs.
+    // Returns the first event of RandR, 0 if the X server doesn't have RandR 1.2.
+    static uint8_t SelectMonitorChanges(xcb_connection_t* connection, xcb_window_t root) {
+        const xcb_query_extension_reply_t* extension = xcb_get_extension_data(connection, &xcb_randr_id);
+        if (!extension || !extension->present) return 0;
+
+        // The X server only sends the events of the version the client asked for.
+        xcb_randr_query_version_reply_t* reply = xcb_randr_query_version_reply(connection, xcb_randr_query_version(connection, 1, 5), nullptr);
+        const bool supported = reply && (reply->major_version > 1 || reply->minor_version >= 2);
+        free(reply);
+        if (!supported) return 0;
+
+        xcb_randr_select_input(connection, root, XCB_RANDR_NOTIFY_MASK_SCREEN_CHANGE | XCB_RANDR_NOTIFY_MASK_OUTPUT_CHANGE);
+
+        return extension->first_event;
+    }
+
+    // Raw events are only reported to clients that select them on the root window.
+    static void SelectRawMotion(xcb_connection_t* connection, xcb_window_t root, bool selected) {
+        struct {
+            xcb_input_event_mask_t header;
+            uint32_t mask;
+        } mask{};
+        mask.header.deviceid = XCB_INPUT_DEVICE_ALL_MASTER;
+        mask.header.mask_len = 1;
+        mask.mask = selected ? XCB_INPUT_XI_EVENT_MASK_RAW_MOTION : 0;
+
+        xcb_input_xi_select_events(connection, root, 1, &mask.header);
+    }
+
+    static float Fp3232ToFloat(xcb_input_fp3232_t value) { return (float)((double)value.integral + (double)value.frac / 4294967296.0); }
+
+    // Unaccelerated motion of valuators 0 (x) and 1 (y). Only valuators that changed are sent, in the order of the mask.
+    static Vector2<float> ReadRawMotion(const xcb_input_raw_motion_event_t* raw) {
+        Vector2<float> delta{};
+        if (!raw->valuators_len) return delta;
+
+        const uint32_t mask = xcb_input_raw_button_press_valuator_mask(raw)[0];
+        const xcb_input_fp3232_t* values = xcb_input_raw_button_press_axisvalues_raw(raw);
+
+        if (mask & 1) delta.x = Fp3232ToFloat(*values++);
+        if (mask & 2) delta.y = Fp3232ToFloat(*values);
+
+        return delta;
+    }
+
+    // Server time of input events in milliseconds. 0 for events without one.
+    static uint32_t EventServerTime(xcb_generic_event_t* event) {
+        switch (event->response_type & ~0x80)
+        {
+        case XCB_KEY_PRESS:
+        case XCB_KEY_RELEASE:
+            return ((xcb_key_press_event_t*)event)->time;
+        case XCB_BUTTON_PRESS:
+        case XCB_BUTTON_RELEASE:
+            return ((xcb_button_press_event_t*)event)->time;
+        case XCB_MOTION_NOTIFY:
+            return ((xcb_motion_notify_event_t*)event)->time;
+        case XCB_ENTER_NOTIFY:
+        case XCB_LEAVE_NOTIFY:
+            return ((xcb_enter_notify_event_t*)event)->time;
+        default:
+            return 0;
+        }
+    }
+
+    static void SendClientMessage(xcb_connection_t* connection, xcb_window_t destination, xcb_window_t window, xcb_atom_t type, std::array<uint32_t, 5> data, uint32_t eventMask) {
+        xcb_client_message_event_t event{};
+        event.response_type = XCB_CLIENT_MESSAGE;
+        event.format = 32;
+        event.window = window;
+        event.type = type;
+        for (size_t i = 0; i < data.size(); i++)
+            event.data.data32[i] = data[i];
+
+        xcb_send_event(connection, 0, destination, eventMask, (const char*)&event);
+    }
+
+    static void SendNetWmState(xcb_connection_t* connection, const XcbWindowData& data, xcb_window_t window, bool add, X11Atom first, X11Atom second) {
+        SendClientMessage(connection, data.screen->root, window, data.atoms[(size_t)X11Atom::NetWmState],
+            { add ? 1u : 0u, data.atoms[(size_t)first], second != X11Atom::Max ? data.atoms[(size_t)second] : (xcb_atom_t)XCB_ATOM_NONE, 1, 0 },
+            XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY | XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT);
+    }
+
+    static std::string GetPropertyString(xcb_connection_t* connection, xcb_window_t window, xcb_atom_t property) {
+        xcb_get_property_reply_t* reply = xcb_get_property_reply(connection, 
+            xcb_get_property(connection, 1, window, property, XCB_GET_PROPERTY_TYPE_ANY, 0, UINT32_MAX / 4), nullptr);
+
+        if (!reply) return std::string{};
+
+        std::string value{ (const char*)xcb_get_property_value(reply), (size_t)xcb_get_property_value_length(reply) };
+        free(reply);
+
+        return value;
+    }
+
+    static xcb_cursor_t CreateGlyphCursor(xcb_connection_t* connection, uint16_t glyph) {
+        xcb_font_t font = xcb_generate_id(connection);
+        xcb_cursor_t cursor = xcb_generate_id(connection);
+
+        xcb_open_font(connection, font, (uint16_t)strlen("cursor"), "cursor");
+        xcb_create_glyph_cursor(connection, cursor, font, font, glyph, glyph + 1, 0, 0, 0, 0xffff, 0xffff, 0xffff);
+        xcb_close_font(connection, font);
+
+        return cursor;
+    }
+
+    // The core protocol only has 1 bit cursors. Dark pixels are drawn black, light pixels white and transparent pixels are masked.
+    static xcb_cursor_t CreateImageCursor(xcb_connection_t* connection, xcb_window_t window, Image image, Vector2<int32_t> hot) {
+        const xcb_setup_t* setup = xcb_get_setup(connection);
+        const uint16_t width = image.size.width ? (uint16_t)image.size.width : 1;
+        const uint16_t height = image.size.height ? (uint16_t)image.size.height : 1;
+        const uint32_t pad = setup->bitmap_format_scanline_pad;
+        const uint32_t stride = ((width + pad - 1) / pad) * pad / 8;
+        const bool lsbFirst = setup->bitmap_format_bit_order == XCB_IMAGE_ORDER_LSB_FIRST;
+
+        std::vector<uint8_t> sourceBits(stride * height, 0), maskBits(stride * height, 0);
+
+        for (uint32_t y = 0; y < image.size.height; y++) {
+            for (uint32_t x = 0; x < image.size.width; x++) {
+                const uint8_t* pixel = image.data + (y * image.size.width + x) * 4;
+                const uint8_t bit = lsbFirst ? (uint8_t)(1 << (x % 8)) : (uint8_t)(0x80 >> (x % 8));
+                const size_t byte = y * stride + x / 8;
+
+                if ((pixel[0] + pixel[1] + pixel[2]) / 3 < 128)
+                    sourceBits[byte] |= bit;
+                if (pixel[3] >= 128)
+                    maskBits[byte] |= bit;
+            }
+        }
+
+        xcb_pixmap_t source = xcb_generate_id(connection);
+        xcb_pixmap_t mask = xcb_generate_id(connection);
+        xcb_gcontext_t gc = xcb_generate_id(connection);
+        xcb_cursor_t cursor = xcb_generate_id(connection);
+
+        xcb_create_pixmap(connection, 1, source, window, width, height);
+        xcb_create_pixmap(connection, 1, mask, window, width, height);
+        xcb_create_gc(connection, gc, source, 0, nullptr);
+
+        xcb_put_image(connection, XCB_IMAGE_FORMAT_XY_PIXMAP, source, gc, width, height, 0, 0, 0, 1, (uint32_t)sourceBits.size(), sourceBits.data());
+        xcb_put_image(connection, XCB_IMAGE_FORMAT_XY_PIXMAP, mask, gc, width, height, 0, 0, 0, 1, (uint32_t)maskBits.size(), maskBits.data());
+
+        // Foreground black, background white.
+        xcb_create_cursor(connection, cursor, source, mask, 0, 0, 0, 0xffff, 0xffff, 0xffff, (uint16_t)hot.x, (uint16_t)hot.y);
+
+        xcb_free_gc(connection, gc);
+        xcb_free_pixmap(connection, source);
+        xcb_free_pixmap(connection, mask);
+
+        return cursor;
+    }
+
+    bool Window::CreateNative(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) {
+        // User did not call IWindow::Initialize
+        std::string setVersion = GetVersion();
+
+        IWINDOW_CHECK_ERROR(setVersion == "", ErrorType::WindowApi, ErrorSeverity::Warning, "You have to call IWindow::Initialize before creating a window! The version is set the current version.", false, false);
+
+        if (setVersion == "") IWindow::Initialize(IWindow::CurrentVersion);
+
+        m_size = size;
+        m_oldSize = size;
+        m_framebufferSize = size;
+        m_position = position;
+        m_title = title;
+        m_userPtr = nullptr;
+        m_running = true;
+        m_fullscreen = false;
+        m_focused = false;
+        m_mouseEntered = false;
+        m_iconified = false;
+        m_maximized = false;
+        m_mods = KeyModifier::None;
+        m_windowStyle = 0;
+        m_icon = 0;
+        m_xcb.dndSource = XCB_WINDOW_NONE;
+        m_xcb.dndVersion = 0;
+
+        // A window with an input thread gets its own connection so the input thread is the only one reading its events.
+        m_xcb.ownsConnection = (bool)m_inputThread;
+
+        if (m_xcb.ownsConnection) {
+            m_deviceContext = xcb_connect(nullptr, nullptr);
+
+            if (xcb_connection_has_error(m_deviceContext)) {
+                xcb_disconnect(m_deviceContext);
+                m_deviceContext = nullptr;
+                IWINDOW_CHECK_ERROR(true, ErrorType::WindowApi, ErrorSeverity::FatalError, "xcb_connect() failed. Failed to connect to the X server!", true, false);
+            }
+        }
+        else {
+            if (!s_connection) {
+                s_connection = xcb_connect(nullptr, nullptr);
+
+                if (xcb_connection_has_error(s_connection)) {
+                    xcb_disconnect(s_connection);
+                    s_connection = nullptr;
+                    IWINDOW_CHECK_ERROR(true, ErrorType::WindowApi, ErrorSeverity::FatalError, "xcb_connect() failed. Failed to connect to the X server!", true, false);
+                }
+            }
+
+            s_connectionUsers++;
+            m_deviceContext = s_connection;
+        }
+
+        m_xcb.screen = xcb_setup_roots_iterator(xcb_get_setup(m_deviceContext)).data;
+
+        InternAtoms(m_deviceContext, m_xcb.atoms);
+        LoadKeyboardMapping(m_deviceContext, m_xcb);
+        m_xcb.xinputOpcode = QueryXInput2(m_deviceContext);
+        m_xcb.randrEventBase = SelectMonitorChanges(m_deviceContext, m_xcb.screen->root);
+
+        // for multi-window support. Windows with an input thread are created on it, so the count is atomic.
+        m_windowIndex = ++m_sWindowCount;
+
+        const uint32_t eventMask = 
+            XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_PROPERTY_CHANGE | XCB_EVENT_MASK_FOCUS_CHANGE |
+            XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE | XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE |
+            XCB_EVENT_MASK_POINTER_MOTION | XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW;
+
+        const uint32_t values[] = { m_xcb.screen->white_pixel, eventMask };
+
+        m_window = xcb_generate_id(m_deviceContext);
+
+        xcb_generic_error_t* error = xcb_request_check(m_deviceContext,
+            xcb_create_window_checked
+            (
+                m_deviceContext,                                        // Connection
+                XCB_COPY_FROM_PARENT,                                   // Depth
+                m_window,                                               // Window id
+                m_xcb.screen->root,                                     // Parent Window
+                (int16_t)position.x,                                    // PosX
+                (int16_t)position.y,                                    // PosY
+                (uint16_t)size.width,                                   // SizeX
+                (uint16_t)size.height,                                  // SizeY
+                0,                                                      // Border width
+                XCB_WINDOW_CLASS_INPUT_OUTPUT,                          // Class
+                m_xcb.screen->root_visual,                              // Visual
+                XCB_CW_BACK_PIXEL | XCB_CW_EVENT_MASK,                  // Value mask
+                values                                                  // Values
+            )
+        );
+
+        bool failed = error != nullptr;
+        free(error);
+
+        if (failed && m_xcb.ownsConnection) xcb_disconnect(m_deviceContext);
+        else if (failed) ReleaseConnection();
+
+        IWINDOW_CHECK_ERROR(failed, ErrorType::WindowApi, ErrorSeverity::FatalError, "xcb_create_window() failed. Failed to create a window!", true, false);
+
+        // Get a ClientMessage instead of the window being destroyed when the user closes it.
+        xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, m_window, m_xcb.atoms[(size_t)X11Atom::WmProtocols], XCB_ATOM_ATOM, 32, 1, &m_xcb.atoms[(size_t)X11Atom::WmDeleteWindow]);
+
+        // Accept files dropped on the window.
+        const uint32_t xdndVersion = 5;
+        xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, m_window, m_xcb.atoms[(size_t)X11Atom::XdndAware], XCB_ATOM_ATOM, 32, 1, &xdndVersion);
+
+        SetTitle(title);
+
+        m_cursor = CreateGlyphCursor(m_deviceContext, CursorIDToX11Glyph(CursorID::Arrow));
+        xcb_change_window_attributes(m_deviceContext, m_window, XCB_CW_CURSOR, &m_cursor);
+
+        SetStyle(style);
+
+        if (!(NativeStyle)(style & Style::NotVisible))
+            xcb_map_window(m_deviceContext, m_window);
+
+        // Put window to middle of the screen if the user didn't provide a position.
+        if (position.IsEmpty()) { 
+            Center(monitor); 
+        }
+        else {
+            SetWindowPosition(position);
+        }
+
+        xcb_flush(m_deviceContext);
+
+        AddToRegistry();
+
+        m_createTimeNs = IWindow::GetTimeNs();
+
+        m_prevMonitors = Monitor::GetAllMonitors();
+
+        return true;
+    }
+
+    void Window::DestroyNative() {
+        if (m_rawMouseMotion) SetRawMouseMotionNative(false);
+
+        RemoveFromRegistry();
+
+        for (xcb_generic_event_t* event : m_xcb.pendingEvents)
+            free(event);
+        m_xcb.pendingEvents.clear();
+
+        if (m_cursor) xcb_free_cursor(m_deviceContext, m_cursor);
+        xcb_destroy_window(m_deviceContext, m_window);
+
+        if (m_xcb.ownsConnection) xcb_disconnect(m_deviceContext);
+        else ReleaseConnection();
+    }
+
+    void Window::KeepEvent(xcb_generic_event_t* event) const {
+        // Every event on our own connection is ours.
+        if (m_xcb.ownsConnection) m_xcb.pendingEvents.push_back(event);
+        else QueueEvent(event);
+    }
+
+    void Window::QueueEvent(xcb_generic_event_t* event) {
+        const xcb_window_t eventWindow = EventWindow(event);
+
+        if (eventWindow != XCB_WINDOW_NONE) {
+            Window* window = FromNativeWindowHandle(eventWindow);
+
+            // The window was already destroyed.
+            if (!window) {
+                free(event);
+                return;
+            }
+
+            window->m_xcb.pendingEvents.push_back(event);
+            return;
+        }
+
+        // Every window gets its own copy.
+        const size_t size = EventSize(event);
+        for (Window* window : m_sWindows) {
+            xcb_generic_event_t* copy = (xcb_generic_event_t*)malloc(size);
+            memcpy(copy, event, size);
+            window->m_xcb.pendingEvents.push_back(copy);
+        }
+
+        free(event);
+    }
+
+    void Window::DispatchPendingEvents() {
+        // Swap first because a callback may queue more.
+        std::vector<xcb_generic_event_t*> pendingEvents{};
+        pendingEvents.swap(m_xcb.pendingEvents);
+        for (xcb_generic_event_t* event : pendingEvents) {
+            WindowCallback(event);
+            free(event);
+        }
+    }
+
+    void Window::ReadEvents(Window* target) {
+        const bool ownsConnection = target && target->m_xcb.ownsConnection;
+        xcb_connection_t* connection = ownsConnection ? target->m_deviceContext : s_connection;
+
+        if (!connection) return;
+
+        xcb_flush(connection);
+
+        // xcb_poll_for_event reads everything the socket has in one read.
+        // Every other event is already in xcb's queue so draining it does not touch the socket again.
+        xcb_generic_event_t* event = xcb_poll_for_event(connection);
+        while (event) {
+            xcb_generic_event_t* next = xcb_poll_for_queued_event(connection);
+
+            // Drop the release of a repeated key. The press is reported as a repeat because the key is still down.
+            if (next && IsKeyRepeat(event, next)) {
+                free(event);
+                event = next;
+                continue;
+            }
+
+            const xcb_window_t eventWindow = EventWindow(event);
+
+            if (!target) {
+                if (eventWindow == XCB_WINDOW_NONE) {
+                    // Indexed because a callback may create or destroy a window.
+                    for (size_t i = 0; i < m_sWindows.size(); i++)
+                        m_sWindows[i]->WindowCallback(event);
+                }
+                else if (Window* window = FromNativeWindowHandle(eventWindow)) {
+                    window->WindowCallback(event);
+                }
+
+                free(event);
+            }
+            else if (eventWindow == target->m_window || ownsConnection) {
+                target->WindowCallback(event);
+                free(event);
+            }
+            else {
+                QueueEvent(event);
+            }
+
+            event = next;
+        }
+
+        // The X server went away.
+        if (xcb_connection_has_error(connection)) {
+            if (ownsConnection) {
+                target->m_running = false;
+                return;
+            }
+
+            for (Window* window : m_sWindows)
+                window->m_running = false;
+        }
+    }
+
+    void Window::UpdateNative() {
+        // Events read while another window was updating or while we were not in Update.
+        DispatchPendingEvents();
+
+        // Events for other windows are kept for their Update or IWindow::PollEvents.
+        ReadEvents(this);
+    }
+
+    // Sleeps until the socket has data, IWindow::PostEmptyEvent was called or the timeout passed. Returns true if the socket has data.
+    static bool PollConnection(xcb_connection_t* connection, double timeoutSeconds) {
+        pollfd fds[2] = {
+            { xcb_get_file_descriptor(connection), POLLIN, 0 },
+            { GetEmptyEventFd(), POLLIN, 0 },
+        };
+
+        if (::poll(fds, 2, TimeoutToMS(timeoutSeconds)) <= 0) return false;
+
+        if (fds[1].revents & POLLIN) {
+            DrainEventFd(fds[1].fd);
+            return false;
+        }
+
+        return true;
+    }
+
+    void Window::WaitForEventNative(double timeoutSeconds) {
+        xcb_flush(m_deviceContext);
+
+        if (m_inputThread) {
+            // The input thread never waits with a timeout. Unlike poll() on the socket, xcb_wait_for_event also 
+            // returns for events that a request on the render thread read into xcb's queue.
+            while (m_xcb.pendingEvents.empty()) {
+                xcb_generic_event_t* event = xcb_wait_for_event(m_deviceContext);
+
+                // The connection is broken. Update stops the window.
+                if (!event) break;
+
+                KeepEvent(event);
+            }
+
+            UpdateNative();
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        // Events for other windows are queued for them while we wait for one of ours.
+        while (m_xcb.pendingEvents.empty()) {
+            if (xcb_generic_event_t* event = xcb_poll_for_event(m_deviceContext)) {
+                KeepEvent(event);
+                continue;
+            }
+
+            // The connection is broken. Update stops the window.
+            if (xcb_connection_has_error(m_deviceContext)) break;
+
+            if (!PollConnection(m_deviceContext, RemainingTimeout(timeoutSeconds, start))) break;
+        }
+
+        UpdateNative();
+    }
+
+    void Window::WakeEventLoop() {
+        // Client messages sent with an empty event mask go to the client that created the window. WindowCallback ignores the type.
+        xcb_client_message_event_t message{};
+        message.response_type = XCB_CLIENT_MESSAGE;
+        message.format = 32;
+        message.window = m_window;
+        message.type = XCB_ATOM_NONE;
+
+        xcb_send_event(m_deviceContext, 0, m_window, XCB_EVENT_MASK_NO_EVENT, (const char*)&message);
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::PostEmptyEventNative() { SignalEventFd(GetEmptyEventFd()); }
+
+    void Window::PollEventsNative() {
+        for (size_t i = 0; i < m_sWindows.size(); i++)
+            m_sWindows[i]->DispatchPendingEvents();
+
+        ReadEvents(nullptr);
+    }
+
+    void Window::WaitEventsNative(double timeoutSeconds) {
+        if (!s_connection) return;
+
+        bool pending = false;
+        for (Window* window : m_sWindows)
+            pending = pending || !window->m_xcb.pendingEvents.empty();
+
+        if (!pending) {
+            xcb_flush(s_connection);
+
+            xcb_generic_event_t* event = xcb_poll_for_event(s_connection);
+            if (!event && PollConnection(s_connection, timeoutSeconds)) 
+                event = xcb_poll_for_event(s_connection);
+
+            if (event) QueueEvent(event);
+        }
+
+        PollEventsNative();
+    }
+
+    int GetEventFd() { return s_connection ? xcb_get_file_descriptor(s_connection) : -1; }
+
+    void Window::DispatchPendingNative() {
+        if (!s_connection) return;
+
+        while (true) {
+            PollEventsNative();
+
+            // Requests of the callbacks are only sent by a flush.
+            xcb_flush(s_connection);
+
+            // A request waiting for its reply reads the events that came before it into xcb's queue, and a callback that updates 
+            // another window leaves events in that window's queue. The fd is not readable for either so they are handled here.
+            bool pending = false;
+            for (Window* window : m_sWindows)
+                pending = pending || !window->m_xcb.pendingEvents.empty();
+
+            xcb_generic_event_t* event = xcb_poll_for_queued_event(s_connection);
+            if (!event && !pending) break;
+
+            if (event) QueueEvent(event);
+        }
+    }
+
+    void Window::UpdateWindowState() {
+        xcb_get_property_reply_t* reply = xcb_get_property_reply(m_deviceContext,
+            xcb_get_property(m_deviceContext, 0, m_window, m_xcb.atoms[(size_t)X11Atom::NetWmState], XCB_ATOM_ATOM, 0, 32), nullptr);
+
+        if (!reply) return;
+
+        const xcb_atom_t* states = (const xcb_atom_t*)xcb_get_property_value(reply);
+        const int32_t count = xcb_get_property_value_length(reply) / (int32_t)sizeof(xcb_atom_t);
+
+        bool iconified = false, maximizedVert = false, maximizedHorz = false;
+        for (int32_t i = 0; i < count; i++) {
+            if (states[i] == m_xcb.atoms[(size_t)X11Atom::NetWmStateHidden]) iconified = true;
+            if (states[i] == m_xcb.atoms[(size_t)X11Atom::NetWmStateMaximizedVert]) maximizedVert = true;
+            if (states[i] == m_xcb.atoms[(size_t)X11Atom::NetWmStateMaximizedHorz]) maximizedHorz = true;
+        }
+
+        free(reply);
+
+        if (iconified != m_iconified) {
+            m_iconified = iconified;
+            EmitWindowIconifiedEvent(m_iconified);
+        }
+
+        if ((maximizedVert && maximizedHorz) != m_maximized) {
+            m_maximized = maximizedVert && maximizedHorz;
+            EmitWindowMaximizedEvent(m_maximized);
+        }
+    }
+
+    void Window::WindowCallback(xcb_generic_event_t* event) {
+        const uint32_t serverTime = EventServerTime(event);
+        m_eventTimestamp = serverTime ? TimestampFromAge(MonotonicEventAge(serverTime)) : 0;
+
+        // The top bit is set for events sent with SendEvent.
+        switch (event->response_type & ~0x80)
+        {
+        case XCB_CLIENT_MESSAGE: {
+            xcb_client_message_event_t* message = (xcb_client_message_event_t*)event;
+            const uint32_t* data = message->data.data32;
+
+            if (message->type == m_xcb.atoms[(size_t)X11Atom::WmProtocols] && data[0] == m_xcb.atoms[(size_t)X11Atom::WmDeleteWindow]) {
+                m_running = false;
+            }
+            else if (message->type == m_xcb.atoms[(size_t)X11Atom::XdndEnter]) {
+                m_xcb.dndSource = data[0];
+                m_xcb.dndVersion = data[1] >> 24;
+            }
+            else if (message->type == m_xcb.atoms[(size_t)X11Atom::XdndPosition]) {
+                // Root window coordinates packed as x << 16 | y.
+                m_xcb.dndX = (int16_t)(data[2] >> 16);
+                m_xcb.dndY = (int16_t)(data[2] & 0xffff);
+
+                SendClientMessage(m_deviceContext, m_xcb.dndSource, m_xcb.dndSource, m_xcb.atoms[(size_t)X11Atom::XdndStatus],
+                    { m_window, 1, 0, 0, m_xcb.dndVersion >= 2 ? m_xcb.atoms[(size_t)X11Atom::XdndActionCopy] : (xcb_atom_t)XCB_ATOM_NONE }, XCB_EVENT_MASK_NO_EVENT);
+                xcb_flush(m_deviceContext);
+            }
+            else if (message->type == m_xcb.atoms[(size_t)X11Atom::XdndDrop]) {
+                xcb_convert_selection(m_deviceContext, m_window, m_xcb.atoms[(size_t)X11Atom::XdndSelection], m_xcb.atoms[(size_t)X11Atom::TextUriList],
+                    m_xcb.atoms[(size_t)X11Atom::XdndSelection], m_xcb.dndVersion >= 1 ? data[2] : XCB_CURRENT_TIME);
+                xcb_flush(m_deviceContext);
+            }
+
+            break;
+        }
+        case XCB_CONFIGURE_NOTIFY: {
+            xcb_configure_notify_event_t* configure = (xcb_configure_notify_event_t*)event;
+
+            Vector2<int32_t> position{ configure->x, configure->y };
+
+            // A real ConfigureNotify is relative to the window manager's frame. Only synthetic ones from the window manager are in root coordinates.
+            if (!(event->response_type & 0x80)) {
+                xcb_translate_coordinates_reply_t* reply = xcb_translate_coordinates_reply(m_deviceContext, 
+                    xcb_translate_coordinates(m_deviceContext, m_window, m_xcb.screen->root, 0, 0), nullptr);
+
+                if (reply) position = { reply->dst_x, reply->dst_y };
+                free(reply);
+            }
+
+            if (position.x != m_position.x || position.y != m_position.y) {
+                m_position = position;
+                EmitWindowPosEvent(m_position);
+            }
+
+            if (configure->width != m_size.width || configure->height != m_size.height) {
+                // On X framebuffer size and window size are the same.
+                m_size = { configure->width, configure->height };
+                m_framebufferSize = m_size;
+
+                EmitWindowSizeEvent(m_size);
+                EmitFramebufferSizeEvent(m_framebufferSize);
+            }
+
+            break;
+        }
+        case XCB_PROPERTY_NOTIFY: {
+            xcb_property_notify_event_t* property = (xcb_property_notify_event_t*)event;
+
+            if (property->atom == m_xcb.atoms[(size_t)X11Atom::NetWmState])
+                UpdateWindowState();
+
+            break;
+        }
+        case XCB_MOTION_NOTIFY: {
+            xcb_motion_notify_event_t* motion = (xcb_motion_notify_event_t*)event;
+
+            m_mousePosition = { motion->event_x, motion->event_y };
+            EmitMouseMoveEvent(m_mousePosition);
+
+            break;
+        }
+        case XCB_GE_GENERIC: {
+            xcb_ge_generic_event_t* generic = (xcb_ge_generic_event_t*)event;
+
+            // Raw motion is sent to every window of the connection. The focused one takes it, like WM_INPUT on Win32.
+            if (!m_rawMouseMotion || !m_focused || !m_xcb.xinputOpcode || generic->extension != m_xcb.xinputOpcode || generic->event_type != XCB_INPUT_RAW_MOTION) 
+                break;
+
+            xcb_input_raw_motion_event_t* raw = (xcb_input_raw_motion_event_t*)event;
+            m_eventTimestamp = TimestampFromAge(MonotonicEventAge(raw->time));
+            EmitRawMouseMotionEvent(ReadRawMotion(raw));
+
+            break;
+        }
+        case XCB_ENTER_NOTIFY: 
+        case XCB_LEAVE_NOTIFY: {
+            m_mouseEntered = (event->response_type & ~0x80) == XCB_ENTER_NOTIFY;
+            EmitMouseEnteredEvent(m_mouseEntered);
+
+            break;
+        }
+        case XCB_FOCUS_IN: 
+        case XCB_FOCUS_OUT: {
+            xcb_focus_in_event_t* focus = (xcb_focus_in_event_t*)event;
+
+            // Sent when the window manager grabs the keyboard while the user drags the window.
+            if (focus->mode == XCB_NOTIFY_MODE_GRAB || focus->mode == XCB_NOTIFY_MODE_UNGRAB) break;
+
+            m_focused = (event->response_type & ~0x80) == XCB_FOCUS_IN;
+            EmitWindowFocusEvent(m_focused);
+
+            break;
+        }
+        case XCB_KEY_PRESS: 
+        case XCB_KEY_RELEASE: {
+            xcb_key_press_event_t* keyEvent = (xcb_key_press_event_t*)event;
+            const InputState inputState = (event->response_type & ~0x80) == XCB_KEY_PRESS ? InputState::Down : InputState::Up;
+
+            Key key = EvdevKeyCodeToIWindowKey(keyEvent->detail - 8);
+
+            m_mods = X11StateToKeyModifiers(keyEvent->state);
+            if (inputState == InputState::Down)
+                m_mods |= KeyToKeyModifier(key);
+            else
+                m_mods &= (KeyModifier)~(int64_t)KeyToKeyModifier(key);
+
+            if (key != Key::Max) {
+                // A press while the key is still down is a repeat. See IsKeyRepeat.
+                bool repeat = inputState == InputState::Down && m_keys.Test((size_t)key);
+
+                m_keys.Set((size_t)key, inputState == InputState::Down);
+
+                EmitKeyEvent(key, m_mods, inputState, repeat);
+            }
+
+            if (inputState == InputState::Up) break;
+
+            // Control and alt combinations are shortcuts not text.
+            if ((uint64_t)(m_mods & (KeyModifier::Control | KeyModifier::Alt))) break;
+
+            char32_t c = X11KeysymToUnicode(KeyCodeToKeysym(m_xcb, keyEvent->detail, keyEvent->state));
+
+            // Dont input char if its backspace, ...
+            if (c < 32 || (c > 126 && c < 160))
+                break;
+
+            EmitCharEvent(c, m_mods);
+
+            break;
+        }
+        case XCB_BUTTON_PRESS:
+        case XCB_BUTTON_RELEASE: {
+            xcb_button_press_event_t* buttonEvent = (xcb_button_press_event_t*)event;
+            const InputState inputState = (event->response_type & ~0x80) == XCB_BUTTON_PRESS ? InputState::Down : InputState::Up;
+
+            m_mods = X11StateToKeyModifiers(buttonEvent->state);
+
+            // Buttons 4 - 7 are the scroll wheel.
+            if (buttonEvent->detail >= 4 && buttonEvent->detail <= 7) {
+                if (inputState == InputState::Up) break;
+
+                m_scrollOffset = { 0.0f, 0.0f };
+                if (buttonEvent->detail == 4) m_scrollOffset.y = 1.0f;
+                if (buttonEvent->detail == 5) m_scrollOffset.y = -1.0f;
+                if (buttonEvent->detail == 6) m_scrollOffset.x = 1.0f;
+                if (buttonEvent->detail == 7) m_scrollOffset.x = -1.0f;
+
+                EmitMouseScrollEvent(m_scrollOffset);
+                break;
+            }
+
+            MouseButton button = X11ButtonToMouseButton(buttonEvent->detail);
+            if (button == MouseButton::Max) break;
+
+            m_mouseButtons.Set((size_t)button, inputState == InputState::Down);
+            EmitMouseButtonEvent(button, m_mods, inputState);
+
+            break;
+        }
+        case XCB_SELECTION_REQUEST: {
+            xcb_selection_request_event_t* request = (xcb_selection_request_event_t*)event;
+
+            // xcb_send_event always sends 32 bytes.
+            uint32_t buffer[8]{};
+            xcb_selection_notify_event_t* notify = (xcb_selection_notify_event_t*)buffer;
+            notify->response_type = XCB_SELECTION_NOTIFY;
+            notify->time = request->time;
+            notify->requestor = request->requestor;
+            notify->selection = request->selection;
+            notify->target = request->target;
+            notify->property = XCB_ATOM_NONE;
+
+            if (request->target == m_xcb.atoms[(size_t)X11Atom::Targets]) {
+                const xcb_atom_t targets[] = { m_xcb.atoms[(size_t)X11Atom::Targets], m_xcb.atoms[(size_t)X11Atom::Utf8String], XCB_ATOM_STRING };
+                xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, request->requestor, request->property, XCB_ATOM_ATOM, 32, 3, targets);
+                notify->property = request->property;
+            }
+            else if (request->target == m_xcb.atoms[(size_t)X11Atom::Utf8String] || request->target == XCB_ATOM_STRING) {
+                xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, request->requestor, request->property, request->target, 8, 
+                    (uint32_t)m_xcb.clipboardText.size(), m_xcb.clipboardText.c_str());
+                notify->property = request->property;
+            }
+
+            xcb_send_event(m_deviceContext, 0, request->requestor, XCB_EVENT_MASK_NO_EVENT, (const char*)buffer);
+            xcb_flush(m_deviceContext);
+
+            break;
+        }
+        case XCB_SELECTION_CLEAR: {
+            m_xcb.clipboardText.clear();
+            break;
+        }
+        case XCB_SELECTION_NOTIFY: {
+            xcb_selection_notify_event_t* notify = (xcb_selection_notify_event_t*)event;
+
+            // Only drops are handled here. Clipboard replies are handled in GetClipboardText.
+            if (notify->property != m_xcb.atoms[(size_t)X11Atom::XdndSelection]) break;
+
+            std::vector<std::wstring> paths = ParseUriList(GetPropertyString(m_deviceContext, m_window, notify->property));
+
+            Vector2<int32_t> dropPosition = m_mousePosition;
+            xcb_translate_coordinates_reply_t* reply = xcb_translate_coordinates_reply(m_deviceContext,
+                xcb_translate_coordinates(m_deviceContext, m_xcb.screen->root, m_window, m_xcb.dndX, m_xcb.dndY), nullptr);
+
+            if (reply) dropPosition = { reply->dst_x, reply->dst_y };
+            free(reply);
+
+            EmitMouseMoveEvent(dropPosition);
+            EmitPathDropEvent(paths, dropPosition);
+
+            SendClientMessage(m_deviceContext, m_xcb.dndSource, m_xcb.dndSource, m_xcb.atoms[(size_t)X11Atom::XdndFinished],
+                { m_window, 1, m_xcb.atoms[(size_t)X11Atom::XdndActionCopy], 0, 0 }, XCB_EVENT_MASK_NO_EVENT);
+            xcb_flush(m_deviceContext);
+
+            break;
+        }
+        case XCB_MAPPING_NOTIFY: {
+            LoadKeyboardMapping(m_deviceContext, m_xcb);
+            break;
+        }
+        default: {
+            // A monitor was connected, disconnected or changed.
+            const int32_t randrEvent = (int32_t)(event->response_type & ~0x80) - (int32_t)m_xcb.randrEventBase;
+            if (m_xcb.randrEventBase && (randrEvent == XCB_RANDR_SCREEN_CHANGE_NOTIFY || randrEvent == XCB_RANDR_NOTIFY)) {
+                Monitor::InvalidateCache();
+                UpdateMonitors();
+            }
+            break;
+        }
+        }
+
+        m_eventTimestamp = 0;
+    }
+
+    void Window::UpdateSizeHints() {
+        // See the WM_NORMAL_HINTS section of the ICCCM. 18 CARDINALs, the first one is flags.
+        std::array<uint32_t, 18> hints{};
+
+        if (!(m_windowStyle & (NativeStyle)Style::Resizable)) {
+            const uint32_t pMinSize = 1 << 4, pMaxSize = 1 << 5;
+            hints[0] = pMinSize | pMaxSize;
+            hints[5] = hints[7] = (uint32_t)m_size.width;
+            hints[6] = hints[8] = (uint32_t)m_size.height;
+        }
+
+        xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, m_window, XCB_ATOM_WM_NORMAL_HINTS, XCB_ATOM_WM_SIZE_HINTS, 32, (uint32_t)hints.size(), hints.data());
+    }
+
+    void Window::SetWindowSize(const Vector2<int32_t>& size) {
+        m_size = size;
+
+        const uint32_t values[] = { (uint32_t)m_size.width, (uint32_t)m_size.height };
+        xcb_configure_window(m_deviceContext, m_window, XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT, values);
+
+        if (!(m_windowStyle & (NativeStyle)Style::Resizable))
+            UpdateSizeHints();
+
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::SetWindowPosition(const Vector2<int32_t>& position) {
+        m_position = position;
+
+        const uint32_t values[] = { (uint32_t)m_position.x, (uint32_t)m_position.y };
+        xcb_configure_window(m_deviceContext, m_window, XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y, values);
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::SetMousePosition(const Vector2<int32_t>& position) { 
+        m_mousePosition = position;
+
+        xcb_warp_pointer(m_deviceContext, XCB_WINDOW_NONE, m_window, 0, 0, 0, 0, (int16_t)position.x, (int16_t)position.y);
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::Fullscreen(bool fullscreen, Monitor monitor) {
+        if (m_fullscreen == fullscreen)
+            return;
+
+        m_fullscreen = fullscreen;
+
+        // No fullscreen
+        if (!m_fullscreen) {
+            RestoreVideoMode();
+            SendNetWmState(m_deviceContext, m_xcb, m_window, false, X11Atom::NetWmStateFullscreen, X11Atom::Max);
+            SetWindowSize(m_oldSize);
+            Center(monitor);
+            return;
+        }
+
+        // Fullscreen
+        m_oldSize = m_size;
+
+        // The window manager puts the window on the monitor it is on.
+        SetWindowPosition(monitor.position);
+        SetWindowSize(monitor.size);
+        SendNetWmState(m_deviceContext, m_xcb, m_window, true, X11Atom::NetWmStateFullscreen, X11Atom::Max);
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::SetIcon(Image image) {
+        // _NET_WM_ICON is width, height then ARGB pixels.
+        std::vector<uint32_t> icon(2 + image.size.width * image.size.height);
+        icon[0] = (uint32_t)image.size.width;
+        icon[1] = (uint32_t)image.size.height;
+
+        const uint8_t* source = image.data;
+        for (size_t i = 2; i < icon.size(); i++) {
+            icon[i] = ((uint32_t)source[3] << 24) | ((uint32_t)source[0] << 16) | ((uint32_t)source[1] << 8) | (uint32_t)source[2];
+            source += 4;
+        }
+
+        xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, m_window, m_xcb.atoms[(size_t)X11Atom::NetWmIcon], XCB_ATOM_CARDINAL, 32, (uint32_t)icon.size(), icon.data());
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::SetCursor(Image image, Vector2<int32_t> hot) {
+        xcb_cursor_t oldCursor = m_cursor;
+
+        m_cursor = CreateImageCursor(m_deviceContext, m_window, image, hot);
+        xcb_change_window_attributes(m_deviceContext, m_window, XCB_CW_CURSOR, &m_cursor);
+
+        if (oldCursor) xcb_free_cursor(m_deviceContext, oldCursor);
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::SetIcon(IconID iconID) {
+        // Removing _NET_WM_ICON makes the window manager use its default icon.
+        xcb_delete_property(m_deviceContext, m_window, m_xcb.atoms[(size_t)X11Atom::NetWmIcon]);
+        xcb_flush(m_deviceContext);
+    }
+
+    bool Window::SetRawMouseMotionNative(bool enabled) {
+        IWINDOW_CHECK_ERROR(enabled && !m_xcb.xinputOpcode, ErrorType::WindowApi, ErrorSeverity::Warning, "The X server has no XInput 2. Raw mouse motion stays off!", true, false);
+
+        m_rawMouseMotion = enabled;
+        if (!m_xcb.xinputOpcode) return false;
+
+        // The selection belongs to the connection so it stays while another window on the same connection records raw motion.
+        // A window with an input thread has a connection of its own and isn't in the registry.
+        bool selected = m_rawMouseMotion;
+        if (!m_xcb.ownsConnection) {
+            for (Window* window : m_sWindows)
+                selected = selected || (window->m_deviceContext == m_deviceContext && window->m_rawMouseMotion);
+        }
+
+        SelectRawMotion(m_deviceContext, m_xcb.screen->root, selected);
+        xcb_flush(m_deviceContext);
+
+        return enabled;
+    }
+
+    bool Window::IsRawMouseMotionSupportedNative() const { return m_xcb.xinputOpcode != 0; }
+
+    void Window::SetCursor(CursorID cursorID) {
+        xcb_cursor_t oldCursor = m_cursor;
+
+        if (cursorID != CursorID::Hidden) {
+            m_cursor = CreateGlyphCursor(m_deviceContext, CursorIDToX11Glyph(cursorID));
+        }
+        else {
+            // A fully transparent 1x1 cursor
+            uint8_t pixel[4] = { 0, 0, 0, 0 };
+            Image image{};
+            image.size = { 1, 1 };
+            image.data = pixel;
+            m_cursor = CreateImageCursor(m_deviceContext, m_window, image, { 0, 0 });
+        }
+
+        xcb_change_window_attributes(m_deviceContext, m_window, XCB_CW_CURSOR, &m_cursor);
+
+        if (oldCursor) xcb_free_cursor(m_deviceContext, oldCursor);
+        xcb_flush(m_deviceContext);
+    }
+
+    std::string Window::GetClipboardText() const {
+        const xcb_atom_t clipboard = m_xcb.atoms[(size_t)X11Atom::Clipboard];
+        const xcb_atom_t property = m_xcb.atoms[(size_t)X11Atom::IWindowSelection];
+
+        xcb_get_selection_owner_reply_t* owner = xcb_get_selection_owner_reply(m_deviceContext, xcb_get_selection_owner(m_deviceContext, clipboard), nullptr);
+        if (!owner) return std::string{};
+
+        xcb_window_t ownerWindow = owner->owner;
+        free(owner);
+
+        if (ownerWindow == XCB_WINDOW_NONE) return std::string{};
+        if (ownerWindow == m_window) return m_xcb.clipboardText;
+
+        xcb_convert_selection(m_deviceContext, m_window, clipboard, m_xcb.atoms[(size_t)X11Atom::Utf8String], property, XCB_CURRENT_TIME);
+        xcb_flush(m_deviceContext);
+
+        // Wait for the owner to answer. Every other event is kept for the next Window::Update.
+        xcb_selection_notify_event_t* notify = nullptr;
+        std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+        while (!notify && std::chrono::steady_clock::now() < timeout) {
+            xcb_generic_event_t* event = xcb_poll_for_event(m_deviceContext);
+
+            if (!event) {
+                pollfd fd{ xcb_get_file_descriptor(m_deviceContext), POLLIN, 0 };
+                ::poll(&fd, 1, 100);
+                continue;
+            }
+
+            if ((event->response_type & ~0x80) == XCB_SELECTION_NOTIFY && ((xcb_selection_notify_event_t*)event)->selection == clipboard) {
+                notify = (xcb_selection_notify_event_t*)event;
+                break;
+            }
+
+            KeepEvent(event);
+        }
+
+        IWINDOW_CHECK_ERROR(!notify, ErrorType::WindowApi, ErrorSeverity::Error, "The clipboard owner did not respond. Could not get clipboard text.", true, std::string{});
+
+        // Conversion failed.
+        if (notify->property == XCB_ATOM_NONE) {
+            free(notify);
+            return std::string{};
+        }
+
+        free(notify);
+
+        // Large INCR transfers are not supported.
+        return GetPropertyString(m_deviceContext, m_window, property);
+    }
+
+    void Window::SetClipboardText(const std::string& text) {
+        m_xcb.clipboardText = text;
+
+        // The text is sent when another client asks for it. See XCB_SELECTION_REQUEST in WindowCallback.
+        xcb_set_selection_owner(m_deviceContext, m_window, m_xcb.atoms[(size_t)X11Atom::Clipboard], XCB_CURRENT_TIME);
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::SetTitle(const std::wstring& title) {  
+        m_title = title;
+
+        std::string utf8Title = WStringToUTF8(title);
+
+        xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, m_window, m_xcb.atoms[(size_t)X11Atom::NetWmName], m_xcb.atoms[(size_t)X11Atom::Utf8String], 8, (uint32_t)utf8Title.size(), utf8Title.c_str());
+        xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, m_window, XCB_ATOM_WM_NAME, XCB_ATOM_STRING, 8, (uint32_t)utf8Title.size(), utf8Title.c_str());
+        xcb_flush(m_deviceContext);
+    }
+
+    void Window::SetStyle(Style style) {
+        // All styles ignored when in fullscreen.
+        if (m_fullscreen) return;
+
+        // On X m_windowStyle stores IWindow::Style::Resizable and IWindow::Style::Decorated.
+        if ((NativeStyle)(style & Style::Default)) {
+            m_windowStyle = (NativeStyle)(Style::Resizable | Style::Decorated);
+        }
+
+        if ((NativeStyle)(style & Style::Resizable)) {
+            m_windowStyle |= (NativeStyle)Style::Resizable;
+        }
+        if ((NativeStyle)(style & Style::NotResizable)) {
+            m_windowStyle &= ~(NativeStyle)Style::Resizable;
+        }
+
+        if ((NativeStyle)(style & Style::Visible)) {
+            xcb_map_window(m_deviceContext, m_window);
+        }
+        if ((NativeStyle)(style & Style::NotVisible)) {
+            xcb_unmap_window(m_deviceContext, m_window);
+        }
+
+        if ((NativeStyle)(style & Style::Decorated)) {
+            m_windowStyle |= (NativeStyle)Style::Decorated;
+        }
+        if ((NativeStyle)(style & Style::NotDecorated)) {
+            m_windowStyle &= ~(NativeStyle)Style::Decorated;
+        }
+
+        if ((NativeStyle)(style & Style::Maximize)) {
+            SendNetWmState(m_deviceContext, m_xcb, m_window, true, X11Atom::NetWmStateMaximizedVert, X11Atom::NetWmStateMaximizedHorz);
+        }
+        if ((NativeStyle)(style & Style::Restore)) {
+            SendNetWmState(m_deviceContext, m_xcb, m_window, false, X11Atom::NetWmStateMaximizedVert, X11Atom::NetWmStateMaximizedHorz);
+        }
+
+        UpdateSizeHints();
+
+        // _MOTIF_WM_HINTS is flags, functions, decorations, input mode and status. Flag 2 means decorations is set.
+        const uint32_t motifHints[5] = { 2, 0, (m_windowStyle & (NativeStyle)Style::Decorated) ? 1u : 0u, 0, 0 };
+        xcb_change_property(m_deviceContext, XCB_PROP_MODE_REPLACE, m_window, m_xcb.atoms[(size_t)X11Atom::MotifWmHints], m_xcb.atoms[(size_t)X11Atom::MotifWmHints], 32, 5, motifHints);
+
+        xcb_flush(m_deviceContext);
+    }
+}
+#endif
@@ -0,0 +1,1075 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_XLIB)
+
+#include "IWindowWindow.h"
+#include "IWindowUtilsLinux.h"
+
+// Xlib has to come after IWindow's headers. Its macros (None, Bool, ...) would break IWindow's enums otherwise.
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+#include <X11/XKBlib.h>
+#include <X11/Xcursor/Xcursor.h>
+#include <X11/extensions/XInput2.h>
+#include <X11/extensions/Xrandr.h>
+
+#include <climits>
+#include <poll.h>
+
+namespace IWindow {
+    // Every window shares one connection to the X server. The first window opens it and the last one closes it.
+    static Display* s_display = nullptr;
+    static uint32_t s_displayUsers = 0;
+
+    static void ReleaseDisplay() {
+        if (--s_displayUsers > 0) {
+            XFlush(s_display);
+            return;
+        }
+
+        XCloseDisplay(s_display);
+        s_display = nullptr;
+    }
+
+    static void InternAtoms(Display* display, std::array<Atom, (size_t)X11Atom::Max>& atoms) {
+        // XInternAtoms sends every request before waiting on any reply so this is a single round trip.
+        XInternAtoms(display, const_cast<char**>(X11_ATOM_NAMES.data()), (int)X11_ATOM_NAMES.size(), False, atoms.data());
+    }
+
+    // Only used when the server does not support detectable auto repeat. 
+    // X then reports key repeats as a release followed by a press of the same key with the same timestamp.
+    static bool IsKeyRepeat(Display* display, const XEvent& event) {
+        if (event.type != KeyRelease || XEventsQueued(display, QueuedAlready) == 0)
+            return false;
+
+        XEvent next;
+        XPeekEvent(display, &next);
+
+        return next.type == KeyPress && next.xkey.window == event.xkey.window && next.xkey.keycode == event.xkey.keycode && next.xkey.time == event.xkey.time;
+    }
+
+    // Generic events (XInput 2) have no window. Their xany.window overlaps other fields.
+    // Events selected on the root window (XInput 2 raw motion, RandR) are not for one window.
+    static ::Window EventWindow(const XEvent& event) { 
+        if (event.type == GenericEvent || event.xany.window == DefaultRootWindow(event.xany.display)) return None;
+        return event.xany.window; 
+    }
+
+    // Events that are not sent to a window (e.g. MappingNotify) are handled by whichever window sees them first.
+    static Bool IsWindowEvent(Display*, XEvent* event, XPointer window) {
+        const ::Window eventWindow = EventWindow(*event);
+        return eventWindow == *(::Window*)window || eventWindow == None;
+    }
+
+    // Server time of input events in milliseconds. 0 for events without one.
+    static Time EventServerTime(const XEvent& event) {
+        switch (event.type)
+        {
+        case KeyPress:
+        case KeyRelease:
+            return event.xkey.time;
+        case ButtonPress:
+        case ButtonRelease:
+            return event.xbutton.time;
+        case MotionNotify:
+            return event.xmotion.time;
+        case EnterNotify:
+        case LeaveNotify:
+            return event.xcrossing.time;
+        default:
+            return 0;
+        }
+    }
+
+    static int32_t QueryXInput2(Display* display) {
+        int opcode, event, error;
+        if (!XQueryExtension(display, "XInputExtension", &opcode, &event, &error)) return 0;
+
+        int major = 2, minor = 0;
+        return XIQueryVersion(display, &major, &minor) == Success ? opcode : 0;
+    }
+
+    // Asks for RandR screen and output changes on the root window, so the display hears about monitor hot-plugs.
+    // Returns the first event of RandR, 0 if the X server doesn't have RandR 1.2.
+    static int32_t SelectMonitorChanges(Display* display, ::Window root) {
+        int event, error;
+        if (!XRRQueryExtension(display, &event, &error)) return 0;
+
+        int major = 1, minor = 0;
+        if (!XRRQueryVersion(display, &major, &minor) || (major == 1 && minor < 2)) return 0;
+
+        XRRSelectInput(display, root, RRScreenChangeNotifyMask | RROutputChangeNotifyMask);
+
+        return event;
+    }
+
+    // Raw events are only reported to clients that select them on the root window.
+    static void SelectRawMotion(Display* display, ::Window root, bool selected) {
+        unsigned char mask[XIMaskLen(XI_RawMotion)] = {};
+        if (selected) XISetMask(mask, XI_RawMotion);
+
+        XIEventMask eventMask{};
+        eventMask.deviceid = XIAllMasterDevices;
+        eventMask.mask_len = sizeof(mask);
+        eventMask.mask = mask;
+
+        XISelectEvents(display, root, &eventMask, 1);
+    }
+
+    // Unaccelerated motion of valuators 0 (x) and 1 (y). Only valuators that changed are sent, in the order of the mask.
+    static Vector2<float> ReadRawMotion(const XIRawEvent& raw) {
+        Vector2<float> delta{};
+        const double* values = raw.raw_values;
+
+        if (raw.valuators.mask_len > 0 && XIMaskIsSet(raw.valuators.mask, 0)) delta.x = (float)*values++;
+        if (raw.valuators.mask_len > 0 && XIMaskIsSet(raw.valuators.mask, 1)) delta.y = (float)*values;
+
+        return delta;
+    }
+
+    struct WindowEventSearch {
+        ::Window window;
+        bool found;
+    };
+
+    // Never takes an event out of the queue. Only remembers whether one for the window is in it.
+    static Bool FindWindowEvent(Display* display, XEvent* event, XPointer search) {
+        WindowEventSearch& windowSearch = *(WindowEventSearch*)search;
+        if (IsWindowEvent(display, event, (XPointer)&windowSearch.window)) windowSearch.found = true;
+        return False;
+    }
+
+    // Sleeps until the socket has data, IWindow::PostEmptyEvent was called or the timeout passed. Returns true if the socket has data.
+    static bool PollDisplay(Display* display, double timeoutSeconds) {
+        pollfd fds[2] = {
+            { ConnectionNumber(display), POLLIN, 0 },
+            { GetEmptyEventFd(), POLLIN, 0 },
+        };
+
+        if (::poll(fds, 2, TimeoutToMS(timeoutSeconds)) <= 0) return false;
+
+        if (fds[1].revents & POLLIN) {
+            DrainEventFd(fds[1].fd);
+            return false;
+        }
+
+        return true;
+    }
+
+    static void SendClientMessage(Display* display, ::Window destination, ::Window window, Atom type, std::array<long, 5> data, long eventMask) {
+        XEvent event{};
+        event.xclient.type = ClientMessage;
+        event.xclient.format = 32;
+        event.xclient.window = window;
+        event.xclient.message_type = type;
+        for (size_t i = 0; i < data.size(); i++)
+            event.xclient.data.l[i] = data[i];
+
+        XSendEvent(display, destination, False, eventMask, &event);
+    }
+
+    static void SendNetWmState(Display* display, const XlibWindowData& data, ::Window window, bool add, X11Atom first, X11Atom second) {
+        SendClientMessage(display, data.root, window, data.atoms[(size_t)X11Atom::NetWmState],
+            { add ? 1 : 0, (long)data.atoms[(size_t)first], second != X11Atom::Max ? (long)data.atoms[(size_t)second] : (long)None, 1, 0 },
+            SubstructureNotifyMask | SubstructureRedirectMask);
+    }
+
+    static std::string GetPropertyString(Display* display, ::Window window, Atom property) {
+        Atom type;
+        int format;
+        unsigned long count, bytesAfter;
+        unsigned char* data = nullptr;
+
+        if (XGetWindowProperty(display, window, property, 0, LONG_MAX / 4, True, AnyPropertyType, &type, &format, &count, &bytesAfter, &data) != Success || !data)
+            return std::string{};
+
+        std::string value{};
+        if (format == 8) value.assign((const char*)data, count);
+
+        XFree(data);
+
+        return value;
+    }
+
+    static Bool IsClipboardNotify(Display* display, XEvent* event, XPointer clipboard) {
+        return event->type == SelectionNotify && event->xselection.selection == *(Atom*)clipboard;
+    }
+
+    static Cursor CreateImageCursor(Display* display, Image image, Vector2<int32_t> hot) {
+        XcursorImage* cursorImage = XcursorImageCreate((int)image.size.width, (int)image.size.height);
+        if (!cursorImage) return 0;
+
+        cursorImage->xhot = (XcursorDim)hot.x;
+        cursorImage->yhot = (XcursorDim)hot.y;
+
+        // Xcursor wants premultiplied ARGB.
+        const uint8_t* source = image.data;
+        for (uint32_t i = 0; i < (uint32_t)(image.size.width * image.size.height); i++) {
+            const uint32_t alpha = source[3];
+            cursorImage->pixels[i] = (alpha << 24) | ((source[0] * alpha / 255) << 16) | ((source[1] * alpha / 255) << 8) | (source[2] * alpha / 255);
+            source += 4;
+        }
+
+        Cursor cursor = XcursorImageLoadCursor(display, cursorImage);
+        XcursorImageDestroy(cursorImage);
+
+        return cursor;
+    }
+
+    bool Window::CreateNative(const Vector2<int32_t>& size, const std::wstring& title, const Monitor& monitor, const Vector2<int32_t>& position, const Style& style) {
+        // User did not call IWindow::Initialize
+        std::string setVersion = GetVersion();
+
+        IWINDOW_CHECK_ERROR(setVersion == "", ErrorType::WindowApi, ErrorSeverity::Warning, "You have to call IWindow::Initialize before creating a window! The version is set the current version.", false, false);
+
+        if (setVersion == "") IWindow::Initialize(IWindow::CurrentVersion);
+
+        m_size = size;
+        m_oldSize = size;
+        m_framebufferSize = size;
+        m_position = position;
+        m_title = title;
+        m_userPtr = nullptr;
+        m_running = true;
+        m_fullscreen = false;
+        m_focused = false;
+        m_mouseEntered = false;
+        m_iconified = false;
+        m_maximized = false;
+        m_mods = KeyModifier{};
+        m_windowStyle = 0;
+        m_icon = 0;
+        m_xlib.inputMethod = nullptr;
+        m_xlib.inputContext = nullptr;
+        m_xlib.dndSource = None;
+        m_xlib.dndVersion = 0;
+
+        // A window with an input thread gets its own display so the input thread is the only one reading its events.
+        m_xlib.ownsDisplay = (bool)m_inputThread;
+
+        if (m_xlib.ownsDisplay) {
+            // The render thread still uses the display (WakeEventLoop, Vulkan, GLX). libX11 1.8 does this itself, older versions need it before XOpenDisplay.
+            XInitThreads();
+
+            m_deviceContext = XOpenDisplay(nullptr);
+
+            IWINDOW_CHECK_ERROR(!m_deviceContext, ErrorType::WindowApi, ErrorSeverity::FatalError, "XOpenDisplay() failed. Failed to connect to the X server!", true, false);
+
+            XkbSetDetectableAutoRepeat(m_deviceContext, True, nullptr);
+        }
+        else {
+            if (!s_display) {
+                s_display = XOpenDisplay(nullptr);
+
+                IWINDOW_CHECK_ERROR(!s_display, ErrorType::WindowApi, ErrorSeverity::FatalError, "XOpenDisplay() failed. Failed to connect to the X server!", true, false);
+
+                // Stop the server from sending a release before every repeated press. IsKeyRepeat handles servers that don't support it.
+                XkbSetDetectableAutoRepeat(s_display, True, nullptr);
+            }
+
+            s_displayUsers++;
+            m_deviceContext = s_display;
+        }
+
+        m_xlib.screen = DefaultScreen(m_deviceContext);
+        m_xlib.root = RootWindow(m_deviceContext, m_xlib.screen);
+
+        InternAtoms(m_deviceContext, m_xlib.atoms);
+        m_xlib.xinputOpcode = QueryXInput2(m_deviceContext);
+        m_xlib.randrEventBase = SelectMonitorChanges(m_deviceContext, m_xlib.root);
+
+        // for multi-window support. Windows with an input thread are created on it, so the count is atomic.
+        m_windowIndex = ++m_sWindowCount;
+
+        XSetWindowAttributes attributes{};
+        attributes.background_pixel = WhitePixel(m_deviceContext, m_xlib.screen);
+        attributes.event_mask = 
+            ExposureMask | StructureNotifyMask | PropertyChangeMask | FocusChangeMask |
+            KeyPressMask | KeyReleaseMask | ButtonPressMask | ButtonReleaseMask |
+            PointerMotionMask | EnterWindowMask | LeaveWindowMask;
+
+        m_window = XCreateWindow
+        (
+            m_deviceContext,                                        // Display
+            m_xlib.root,                                            // Parent Window
+            position.x,                                             // PosX
+            position.y,                                             // PosY
+            (unsigned int)size.width,                               // SizeX
+            (unsigned int)size.height,                              // SizeY
+            0,                                                      // Border width
+            CopyFromParent,                                         // Depth
+            InputOutput,                                            // Class
+            CopyFromParent,                                         // Visual
+            CWBackPixel | CWEventMask,                              // Value mask
+            &attributes                                             // Values
+        );
+
+        if (!m_window && m_xlib.ownsDisplay) XCloseDisplay(m_deviceContext);
+        else if (!m_window) ReleaseDisplay();
+
+        IWINDOW_CHECK_ERROR(!m_window, ErrorType::WindowApi, ErrorSeverity::FatalError, "XCreateWindow() failed. Failed to create a window!", true, false);
+
+        // Get a ClientMessage instead of the window being destroyed when the user closes it.
+        XSetWMProtocols(m_deviceContext, m_window, &m_xlib.atoms[(size_t)X11Atom::WmDeleteWindow], 1);
+
+        // Accept files dropped on the window. Format 32 properties are arrays of long in Xlib.
+        const long xdndVersion = 5;
+        XChangeProperty(m_deviceContext, m_window, m_xlib.atoms[(size_t)X11Atom::XdndAware], XA_ATOM, 32, PropModeReplace, (const unsigned char*)&xdndVersion, 1);
+
+        // The input method turns key presses into UTF-8 text. Without one chars fall back to the keysym.
+        if (XSupportsLocale()) {
+            XSetLocaleModifiers("");
+            m_xlib.inputMethod = XOpenIM(m_deviceContext, nullptr, nullptr, nullptr);
+        }
+
+        if (m_xlib.inputMethod) {
+            m_xlib.inputContext = XCreateIC(m_xlib.inputMethod, 
+                XNInputStyle, XIMPreeditNothing | XIMStatusNothing, 
+                XNClientWindow, m_window, 
+                XNFocusWindow, m_window, 
+                nullptr);
+        }
+
+        SetTitle(title);
+
+        m_cursor = XCreateFontCursor(m_deviceContext, CursorIDToX11Glyph(CursorID::Arrow));
+        XDefineCursor(m_deviceContext, m_window, m_cursor);
+
+        SetStyle(style);
+
+        if (!(NativeStyle)(style & Style::NotVisible))
+            XMapWindow(m_deviceContext, m_window);
+
+        // Put window to middle of the screen if the user didn't provide a position.
+        if (position.IsEmpty()) { 
+            Center(monitor); 
+        }
+        else {
+            SetWindowPosition(position);
+        }
+
+        XFlush(m_deviceContext);
+
+        AddToRegistry();
+
+        m_createTimeNs = IWindow::GetTimeNs();
+
+        m_prevMonitors = Monitor::GetAllMonitors();
+
+        return true;
+    }
+
+    void Window::DestroyNative() {
+        if (m_rawMouseMotion) SetRawMouseMotionNative(false);
+
+        RemoveFromRegistry();
+
+        if (m_xlib.inputContext) XDestroyIC(m_xlib.inputContext);
+        if (m_xlib.inputMethod) XCloseIM(m_xlib.inputMethod);
+
+        if (m_cursor) XFreeCursor(m_deviceContext, m_cursor);
+        XDestroyWindow(m_deviceContext, m_window);
+
+        if (m_xlib.ownsDisplay) XCloseDisplay(m_deviceContext);
+        else ReleaseDisplay();
+    }
+
+    void Window::UpdateNative() {
+        XFlush(m_deviceContext);
+
+        // QueuedAfterReading reads everything the socket has without blocking. 
+        // After that only Xlib's queue is searched so Update never waits on the server.
+        XEventsQueued(m_deviceContext, QueuedAfterReading);
+
+        // Events for other windows stay in the queue for their Update or IWindow::PollEvents.
+        XEvent event;
+        while (XCheckIfEvent(m_deviceContext, &event, IsWindowEvent, (XPointer)&m_window)) {
+            // The input method may consume key events (e.g. dead keys).
+            if (XFilterEvent(&event, None)) continue;
+
+            // Drop the release of a repeated key. The press is reported as a repeat because the key is still down.
+            if (IsKeyRepeat(m_deviceContext, event)) continue;
+
+            WindowCallback(&event);
+        }
+    }
+
+    void Window::WaitForEventNative(double timeoutSeconds) {
+        if (m_inputThread) {
+            // The input thread never waits with a timeout. Unlike poll() on the socket, XPeekIfEvent also 
+            // returns for events that a request on the render thread read into Xlib's queue.
+            // Blocks until this window has an event but leaves it in the queue for Update.
+            XEvent event;
+            XPeekIfEvent(m_deviceContext, &event, IsWindowEvent, (XPointer)&m_window);
+
+            UpdateNative();
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        // Events for other windows stay in the queue while we wait for one of ours.
+        while (true) {
+            XFlush(m_deviceContext);
+            XEventsQueued(m_deviceContext, QueuedAfterReading);
+
+            XEvent event;
+            WindowEventSearch search{ m_window, false };
+            XCheckIfEvent(m_deviceContext, &event, FindWindowEvent, (XPointer)&search);
+
+            if (search.found || !PollDisplay(m_deviceContext, RemainingTimeout(timeoutSeconds, start))) break;
+        }
+
+        UpdateNative();
+    }
+
+    void Window::WakeEventLoop() {
+        // Client messages sent with an empty event mask go to the client that created the window. WindowCallback ignores the type.
+        SendClientMessage(m_deviceContext, m_window, m_window, None, {}, NoEventMask);
+        XFlush(m_deviceContext);
+    }
+
+    void Window::PostEmptyEventNative() { SignalEventFd(GetEmptyEventFd()); }
+
+    void Window::PollEventsNative() {
+        if (!s_display) return;
+
+        XFlush(s_display);
+
+        // Same as Window::Update but every event is taken in order and handed to its window.
+        XEventsQueued(s_display, QueuedAfterReading);
+
+        while (XEventsQueued(s_display, QueuedAlready) > 0) {
+            XEvent event;
+            XNextEvent(s_display, &event);
+
+            if (XFilterEvent(&event, None)) continue;
+
+            if (IsKeyRepeat(s_display, event)) continue;
+
+            // Events that are not sent to a window are about the whole display so one window is enough.
+            Window* window = nullptr;
+            if (EventWindow(event) != None) 
+                window = FromNativeWindowHandle(EventWindow(event));
+            else if (!m_sWindows.empty()) 
+                window = m_sWindows[0];
+
+            if (window) window->WindowCallback(&event);
+        }
+    }
+
+    void Window::WaitEventsNative(double timeoutSeconds) {
+        if (!s_display) return;
+
+        XFlush(s_display);
+
+        if (XEventsQueued(s_display, QueuedAfterReading) == 0) 
+            PollDisplay(s_display, timeoutSeconds);
+
+        PollEventsNative();
+    }
+
+    int GetEventFd() { return s_display ? ConnectionNumber(s_display) : -1; }
+
+    void Window::DispatchPendingNative() {
+        if (!s_display) return;
+
+        // Requests of the callbacks are only sent by a flush, which may read more events into Xlib's queue. The fd is not readable for those.
+        do {
+            PollEventsNative();
+            XFlush(s_display);
+        } while (XEventsQueued(s_display, QueuedAlready) > 0);
+    }
+
+    void Window::UpdateWindowState() {
+        Atom type;
+        int format;
+        unsigned long count, bytesAfter;
+        unsigned char* data = nullptr;
+
+        if (XGetWindowProperty(m_deviceContext, m_window, m_xlib.atoms[(size_t)X11Atom::NetWmState], 0, 32, False, XA_ATOM, 
+            &type, &format, &count, &bytesAfter, &data) != Success || !data) 
+            return;
+
+        const Atom* states = (const Atom*)data;
+
+        bool iconified = false, maximizedVert = false, maximizedHorz = false;
+        for (unsigned long i = 0; i < count; i++) {
+            if (states[i] == m_xlib.atoms[(size_t)X11Atom::NetWmStateHidden]) iconified = true;
+            if (states[i] == m_xlib.atoms[(size_t)X11Atom::NetWmStateMaximizedVert]) maximizedVert = true;
+            if (states[i] == m_xlib.atoms[(size_t)X11Atom::NetWmStateMaximizedHorz]) maximizedHorz = true;
+        }
+
+        XFree(data);
+
+        if (iconified != m_iconified) {
+            m_iconified = iconified;
+            EmitWindowIconifiedEvent(m_iconified);
+        }
+
+        if ((maximizedVert && maximizedHorz) != m_maximized) {
+            m_maximized = maximizedVert && maximizedHorz;
+            EmitWindowMaximizedEvent(m_maximized);
+        }
+    }
+
+    void Window::WindowCallback(XEvent* event) {
+        const Time serverTime = EventServerTime(*event);
+        m_eventTimestamp = serverTime ? TimestampFromAge(MonotonicEventAge((uint32_t)serverTime)) : 0;
+
+        switch (event->type)
+        {
+        case ClientMessage: {
+            const XClientMessageEvent& message = event->xclient;
+            const long* data = message.data.l;
+
+            if (message.message_type == m_xlib.atoms[(size_t)X11Atom::WmProtocols] && (Atom)data[0] == m_xlib.atoms[(size_t)X11Atom::WmDeleteWindow]) {
+                m_running = false;
+            }
+            else if (message.message_type == m_xlib.atoms[(size_t)X11Atom::XdndEnter]) {
+                m_xlib.dndSource = (::Window)data[0];
+                m_xlib.dndVersion = (uint32_t)(data[1] >> 24);
+            }
+            else if (message.message_type == m_xlib.atoms[(size_t)X11Atom::XdndPosition]) {
+                // Root window coordinates packed as x << 16 | y.
+                m_xlib.dndX = (int16_t)((data[2] >> 16) & 0xffff);
+                m_xlib.dndY = (int16_t)(data[2] & 0xffff);
+
+                SendClientMessage(m_deviceContext, m_xlib.dndSource, m_xlib.dndSource, m_xlib.atoms[(size_t)X11Atom::XdndStatus],
+                    { (long)m_window, 1, 0, 0, m_xlib.dndVersion >= 2 ? (long)m_xlib.atoms[(size_t)X11Atom::XdndActionCopy] : (long)None }, NoEventMask);
+                XFlush(m_deviceContext);
+            }
+            else if (message.message_type == m_xlib.atoms[(size_t)X11Atom::XdndDrop]) {
+                XConvertSelection(m_deviceContext, m_xlib.atoms[(size_t)X11Atom::XdndSelection], m_xlib.atoms[(size_t)X11Atom::TextUriList],
+                    m_xlib.atoms[(size_t)X11Atom::XdndSelection], m_window, m_xlib.dndVersion >= 1 ? (Time)data[2] : CurrentTime);
+                XFlush(m_deviceContext);
+            }
+
+            break;
+        }
+        case ConfigureNotify: {
+            const XConfigureEvent& configure = event->xconfigure;
+
+            Vector2<int32_t> position{ configure.x, configure.y };
+
+            // A real ConfigureNotify is relative to the window manager's frame. Only synthetic ones from the window manager are in root coordinates.
+            if (!configure.send_event) {
+                ::Window child;
+                XTranslateCoordinates(m_deviceContext, m_window, m_xlib.root, 0, 0, &position.x, &position.y, &child);
+            }
+
+            if (position.x != m_position.x || position.y != m_position.y) {
+                m_position = position;
+                EmitWindowPosEvent(m_position);
+            }
+
+            if (configure.width != m_size.width || configure.height != m_size.height) {
+                // On X framebuffer size and window size are the same.
+                m_size = { configure.width, configure.height };
+                m_framebufferSize = m_size;
+
+                EmitWindowSizeEvent(m_size);
+                EmitFramebufferSizeEvent(m_framebufferSize);
+            }
+
+            break;
+        }
+        case PropertyNotify: {
+            if (event->xproperty.atom == m_xlib.atoms[(size_t)X11Atom::NetWmState])
+                UpdateWindowState();
+
+            break;
+        }
+        case MotionNotify: {
+            m_mousePosition = { event->xmotion.x, event->xmotion.y };
+            EmitMouseMoveEvent(m_mousePosition);
+
+            break;
+        }
+        case GenericEvent: {
+            XGenericEventCookie& cookie = event->xcookie;
+            if (cookie.extension != m_xlib.xinputOpcode || cookie.evtype != XI_RawMotion || !XGetEventData(m_deviceContext, &cookie)) break;
+
+            // The event has no window and only one window of the display sees it. The focused window takes it, like WM_INPUT on Win32.
+            // A window with an input thread has a display of its own and isn't in the registry.
+            Window* target = nullptr;
+            if (m_xlib.ownsDisplay) {
+                if (m_rawMouseMotion && m_focused) target = this;
+            }
+            else {
+                for (Window* window : m_sWindows) {
+                    if (window->m_deviceContext == m_deviceContext && window->m_rawMouseMotion && window->m_focused) {
+                        target = window;
+                        break;
+                    }
+                }
+            }
+
+            if (target) {
+                const XIRawEvent& raw = *(const XIRawEvent*)cookie.data;
+                target->m_eventTimestamp = target->TimestampFromAge(MonotonicEventAge((uint32_t)raw.time));
+                target->EmitRawMouseMotionEvent(ReadRawMotion(raw));
+                target->m_eventTimestamp = 0;
+            }
+
+            XFreeEventData(m_deviceContext, &cookie);
+
+            break;
+        }
+        case EnterNotify: 
+        case LeaveNotify: {
+            m_mouseEntered = event->type == EnterNotify;
+            EmitMouseEnteredEvent(m_mouseEntered);
+
+            break;
+        }
+        case FocusIn: 
+        case FocusOut: {
+            // Sent when the window manager grabs the keyboard while the user drags the window.
+            if (event->xfocus.mode == NotifyGrab || event->xfocus.mode == NotifyUngrab) break;
+
+            m_focused = event->type == FocusIn;
+
+            if (m_xlib.inputContext) {
+                if (m_focused) XSetICFocus(m_xlib.inputContext);
+                else XUnsetICFocus(m_xlib.inputContext);
+            }
+
+            EmitWindowFocusEvent(m_focused);
+
+            break;
+        }
+        case KeyPress: 
+        case KeyRelease: {
+            XKeyEvent& keyEvent = event->xkey;
+            const InputState inputState = event->type == KeyPress ? InputState::Down : InputState::Up;
+
+            Key key = EvdevKeyCodeToIWindowKey(keyEvent.keycode - 8);
+
+            m_mods = X11StateToKeyModifiers(keyEvent.state);
+            if (inputState == InputState::Down)
+                m_mods |= KeyToKeyModifier(key);
+            else
+                m_mods &= (KeyModifier)~(int64_t)KeyToKeyModifier(key);
+
+            if (key != Key::Max) {
+                // A press while the key is still down is a repeat.
+                bool repeat = inputState == InputState::Down && m_keys.Test((size_t)key);
+
+                m_keys.Set((size_t)key, inputState == InputState::Down);
+
+                EmitKeyEvent(key, m_mods, inputState, repeat);
+            }
+
+            if (inputState == InputState::Up) break;
+
+            // Control and alt combinations are shortcuts not text.
+            if ((uint64_t)(m_mods & (KeyModifier::Control | KeyModifier::Alt))) break;
+
+            std::u32string text{};
+
+            if (m_xlib.inputContext) {
+                char buffer[64];
+                KeySym keysym;
+                Status status;
+
+                int length = Xutf8LookupString(m_xlib.inputContext, &keyEvent, buffer, (int)sizeof(buffer), &keysym, &status);
+
+                std::string utf8{};
+                if (status == XBufferOverflow) {
+                    utf8.resize((size_t)length);
+                    length = Xutf8LookupString(m_xlib.inputContext, &keyEvent, utf8.data(), length, &keysym, &status);
+                }
+                else {
+                    utf8.assign(buffer, (size_t)length);
+                }
+
+                if (status == XLookupChars || status == XLookupBoth) {
+                    for (wchar_t c : UTF8ToWString(utf8))
+                        text += (char32_t)c;
+                }
+            }
+            else {
+                KeySym keysym = 0;
+                XLookupString(&keyEvent, nullptr, 0, &keysym, nullptr);
+                text += X11KeysymToUnicode((uint32_t)keysym);
+            }
+
+            for (char32_t c : text) {
+                // Dont input char if its backspace, ...
+                if (c < 32 || (c > 126 && c < 160))
+                    continue;
+
+                EmitCharEvent(c, m_mods);
+            }
+
+            break;
+        }
+        case ButtonPress:
+        case ButtonRelease: {
+            const XButtonEvent& buttonEvent = event->xbutton;
+            const InputState inputState = event->type == ButtonPress ? InputState::Down : InputState::Up;
+
+            m_mods = X11StateToKeyModifiers(buttonEvent.state);
+
+            // Buttons 4 - 7 are the scroll wheel.
+            if (buttonEvent.button >= 4 && buttonEvent.button <= 7) {
+                if (inputState == InputState::Up) break;
+
+                m_scrollOffset = { 0.0f, 0.0f };
+                if (buttonEvent.button == 4) m_scrollOffset.y = 1.0f;
+                if (buttonEvent.button == 5) m_scrollOffset.y = -1.0f;
+                if (buttonEvent.button == 6) m_scrollOffset.x = 1.0f;
+                if (buttonEvent.button == 7) m_scrollOffset.x = -1.0f;
+
+                EmitMouseScrollEvent(m_scrollOffset);
+                break;
+            }
+
+            MouseButton button = X11ButtonToMouseButton(buttonEvent.button);
+            if (button == MouseButton::Max) break;
+
+            m_mouseButtons.Set((size_t)button, inputState == InputState::Down);
+            EmitMouseButtonEvent(button, m_mods, inputState);
+
+            break;
+        }
+        case SelectionRequest: {
+            const XSelectionRequestEvent& request = event->xselectionrequest;
+
+            XEvent reply{};
+            reply.xselection.type = SelectionNotify;
+            reply.xselection.time = request.time;
+            reply.xselection.requestor = request.requestor;
+            reply.xselection.selection = request.selection;
+            reply.xselection.target = request.target;
+            reply.xselection.property = None;
+
+            if (request.target == m_xlib.atoms[(size_t)X11Atom::Targets]) {
+                const Atom targets[] = { m_xlib.atoms[(size_t)X11Atom::Targets], m_xlib.atoms[(size_t)X11Atom::Utf8String], XA_STRING };
+                XChangeProperty(m_deviceContext, request.requestor, request.property, XA_ATOM, 32, PropModeReplace, (const unsigned char*)targets, 3);
+                reply.xselection.property = request.property;
+            }
+            else if (request.target == m_xlib.atoms[(size_t)X11Atom::Utf8String] || request.target == XA_STRING) {
+                XChangeProperty(m_deviceContext, request.requestor, request.property, request.target, 8, PropModeReplace, 
+                    (const unsigned char*)m_xlib.clipboardText.c_str(), (int)m_xlib.clipboardText.size());
+                reply.xselection.property = request.property;
+            }
+
+            XSendEvent(m_deviceContext, request.requestor, False, NoEventMask, &reply);
+            XFlush(m_deviceContext);
+
+            break;
+        }
+        case SelectionClear: {
+            m_xlib.clipboardText.clear();
+            break;
+        }
+        case SelectionNotify: {
+            // Only drops are handled here. Clipboard replies are handled in GetClipboardText.
+            if (event->xselection.property != m_xlib.atoms[(size_t)X11Atom::XdndSelection]) break;
+
+            std::vector<std::wstring> paths = ParseUriList(GetPropertyString(m_deviceContext, m_window, event->xselection.property));
+
+            Vector2<int32_t> dropPosition = m_mousePosition;
+            ::Window child;
+            XTranslateCoordinates(m_deviceContext, m_xlib.root, m_window, m_xlib.dndX, m_xlib.dndY, &dropPosition.x, &dropPosition.y, &child);
+
+            EmitMouseMoveEvent(dropPosition);
+            EmitPathDropEvent(paths, dropPosition);
+
+            SendClientMessage(m_deviceContext, m_xlib.dndSource, m_xlib.dndSource, m_xlib.atoms[(size_t)X11Atom::XdndFinished],
+                { (long)m_window, 1, (long)m_xlib.atoms[(size_t)X11Atom::XdndActionCopy], 0, 0 }, NoEventMask);
+            XFlush(m_deviceContext);
+
+            break;
+        }
+        case MappingNotify: {
+            XRefreshKeyboardMapping(&event->xmapping);
+            break;
+        }
+        default: {
+            // A monitor was connected, disconnected or changed. Only one window of the display sees it, so it tells the others.
+            const int32_t randrEvent = event->type - m_xlib.randrEventBase;
+            if (!m_xlib.randrEventBase || (randrEvent != RRScreenChangeNotify && randrEvent != RRNotify)) break;
+
+            XRRUpdateConfiguration(event);
+            Monitor::InvalidateCache();
+
+            for (size_t i = 0; i < m_sWindows.size(); i++)
+                if (m_sWindows[i]->m_deviceContext == m_deviceContext) m_sWindows[i]->UpdateMonitors();
+
+            break;
+        }
+        }
+
+        m_eventTimestamp = 0;
+    }
+
+    void Window::UpdateSizeHints() {
+        XSizeHints* hints = XAllocSizeHints();
+
+        if (!(m_windowStyle & (NativeStyle)Style::Resizable)) {
+            hints->flags = PMinSize | PMaxSize;
+            hints->min_width = hints->max_width = m_size.width;
+            hints->min_height = hints->max_height = m_size.height;
+        }
+
+        XSetWMNormalHints(m_deviceContext, m_window, hints);
+        XFree(hints);
+    }
+
+    void Window::SetWindowSize(const Vector2<int32_t>& size) {
+        m_size = size;
+
+        XResizeWindow(m_deviceContext, m_window, (unsigned int)m_size.width, (unsigned int)m_size.height);
+
+        if (!(m_windowStyle & (NativeStyle)Style::Resizable))
+            UpdateSizeHints();
+
+        XFlush(m_deviceContext);
+    }
+
+    void Window::SetWindowPosition(const Vector2<int32_t>& position) {
+        m_position = position;
+
+        XMoveWindow(m_deviceContext, m_window, m_position.x, m_position.y);
+        XFlush(m_deviceContext);
+    }
+
+    void Window::SetMousePosition(const Vector2<int32_t>& position) { 
+        m_mousePosition = position;
+
+        XWarpPointer(m_deviceContext, None, m_window, 0, 0, 0, 0, position.x, position.y);
+        XFlush(m_deviceContext);
+    }
+
+    void Window::Fullscreen(bool fullscreen, Monitor monitor) {
+        if (m_fullscreen == fullscreen)
+            return;
+
+        m_fullscreen = fullscreen;
+
+        // No fullscreen
+        if (!m_fullscreen) {
+            RestoreVideoMode();
+            SendNetWmState(m_deviceContext, m_xlib, m_window, false, X11Atom::NetWmStateFullscreen, X11Atom::Max);
+            SetWindowSize(m_oldSize);
+            Center(monitor);
+            return;
+        }
+
+        // Fullscreen
+        m_oldSize = m_size;
+
+        // The window manager puts the window on the monitor it is on.
+        SetWindowPosition(monitor.position);
+        SetWindowSize(monitor.size);
+        SendNetWmState(m_deviceContext, m_xlib, m_window, true, X11Atom::NetWmStateFullscreen, X11Atom::Max);
+        XFlush(m_deviceContext);
+    }
+
+    void Window::SetIcon(Image image) {
+        // _NET_WM_ICON is width, height then ARGB pixels. Format 32 properties are arrays of long in Xlib.
+        std::vector<unsigned long> icon(2 + image.size.width * image.size.height);
+        icon[0] = (unsigned long)image.size.width;
+        icon[1] = (unsigned long)image.size.height;
+
+        const uint8_t* source = image.data;
+        for (size_t i = 2; i < icon.size(); i++) {
+            icon[i] = ((unsigned long)source[3] << 24) | ((unsigned long)source[0] << 16) | ((unsigned long)source[1] << 8) | (unsigned long)source[2];
+            source += 4;
+        }
+
+        XChangeProperty(m_deviceContext, m_window, m_xlib.atoms[(size_t)X11Atom::NetWmIcon], XA_CARDINAL, 32, PropModeReplace, (const unsigned char*)icon.data(), (int)icon.size());
+        XFlush(m_deviceContext);
+    }
+
+    void Window::SetCursor(Image image, Vector2<int32_t> hot) {
+        Cursor oldCursor = m_cursor;
+
+        m_cursor = CreateImageCursor(m_deviceContext, image, hot);
+        XDefineCursor(m_deviceContext, m_window, m_cursor);
+
+        if (oldCursor) XFreeCursor(m_deviceContext, oldCursor);
+        XFlush(m_deviceContext);
+    }
+
+    void Window::SetIcon(IconID iconID) {
+        // Removing _NET_WM_ICON makes the window manager use its default icon.
+        XDeleteProperty(m_deviceContext, m_window, m_xlib.atoms[(size_t)X11Atom::NetWmIcon]);
+        XFlush(m_deviceContext);
+    }
+
+    bool Window::SetRawMouseMotionNative(bool enabled) {
+        IWINDOW_CHECK_ERROR(enabled && !m_xlib.xinputOpcode, ErrorType::WindowApi, ErrorSeverity::Warning, "The X server has no XInput 2. Raw mouse motion stays off!", true, false);
+
+        m_rawMouseMotion = enabled;
+        if (!m_xlib.xinputOpcode) return false;
+
+        // The selection belongs to the display so it stays while another window on the same display records raw motion.
+        bool selected = m_rawMouseMotion;
+        if (!m_xlib.ownsDisplay) {
+            for (Window* window : m_sWindows)
+                selected = selected || (window->m_deviceContext == m_deviceContext && window->m_rawMouseMotion);
+        }
+
+        SelectRawMotion(m_deviceContext, m_xlib.root, selected);
+        XFlush(m_deviceContext);
+
+        return enabled;
+    }
+
+    bool Window::IsRawMouseMotionSupportedNative() const { return m_xlib.xinputOpcode != 0; }
+
+    void Window::SetCursor(CursorID cursorID) {
+        Cursor oldCursor = m_cursor;
+
+        if (cursorID != CursorID::Hidden) {
+            m_cursor = XCreateFontCursor(m_deviceContext, CursorIDToX11Glyph(cursorID));
+        }
+        else {
+            // A fully transparent 1x1 cursor
+            uint8_t pixel[4] = { 0, 0, 0, 0 };
+            Image image{};
+            image.size = { 1, 1 };
+            image.data = pixel;
+            m_cursor = CreateImageCursor(m_deviceContext, image, { 0, 0 });
+        }
+
+        XDefineCursor(m_deviceContext, m_window, m_cursor);
+
+        if (oldCursor) XFreeCursor(m_deviceContext, oldCursor);
+        XFlush(m_deviceContext);
+    }
+
+    std::string Window::GetClipboardText() const {
+        Atom clipboard = m_xlib.atoms[(size_t)X11Atom::Clipboard];
+        const Atom property = m_xlib.atoms[(size_t)X11Atom::IWindowSelection];
+
+        ::Window owner = XGetSelectionOwner(m_deviceContext, clipboard);
+
+        if (owner == None) return std::string{};
+        if (owner == m_window) return m_xlib.clipboardText;
+
+        XConvertSelection(m_deviceContext, clipboard, m_xlib.atoms[(size_t)X11Atom::Utf8String], property, m_window, CurrentTime);
+        XFlush(m_deviceContext);
+
+        // Wait for the owner to answer. Every other event stays in Xlib's queue for the next Window::Update.
+        XEvent notify{};
+        bool received = false;
+        std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+        while (std::chrono::steady_clock::now() < timeout) {
+            if (XCheckIfEvent(m_deviceContext, &notify, IsClipboardNotify, (XPointer)&clipboard)) {
+                received = true;
+                break;
+            }
+
+            pollfd fd{ ConnectionNumber(m_deviceContext), POLLIN, 0 };
+            ::poll(&fd, 1, 100);
+        }
+
+        IWINDOW_CHECK_ERROR(!received, ErrorType::WindowApi, ErrorSeverity::Error, "The clipboard owner did not respond. Could not get clipboard text.", true, std::string{});
+
+        // Conversion failed.
+        if (notify.xselection.property == None) 
+            return std::string{};
+
+        // Large INCR transfers are not supported.
+        return GetPropertyString(m_deviceContext, m_window, property);
+    }
+
+    void Window::SetClipboardText(const std::string& text) {
+        m_xlib.clipboardText = text;
+
+        // The text is sent when another client asks for it. See SelectionRequest in WindowCallback.
+        XSetSelectionOwner(m_deviceContext, m_xlib.atoms[(size_t)X11Atom::Clipboard], m_window, CurrentTime);
+        XFlush(m_deviceContext);
+    }
+
+    void Window::SetTitle(const std::wstring& title) {  
+        m_title = title;
+
+        std::string utf8Title = WStringToUTF8(title);
+
+        XChangeProperty(m_deviceContext, m_window, m_xlib.atoms[(size_t)X11Atom::NetWmName], m_xlib.atoms[(size_t)X11Atom::Utf8String], 8, PropModeReplace, 
+            (const unsigned char*)utf8Title.c_str(), (int)utf8Title.size());
+        XChangeProperty(m_deviceContext, m_window, XA_WM_NAME, XA_STRING, 8, PropModeReplace, (const unsigned char*)utf8Title.c_str(), (int)utf8Title.size());
+        XFlush(m_deviceContext);
+    }
+
+    void Window::SetStyle(Style style) {
+        // All styles ignored when in fullscreen.
+        if (m_fullscreen) return;
+
+        // On X m_windowStyle stores IWindow::Style::Resizable and IWindow::Style::Decorated.
+        if ((NativeStyle)(style & Style::Default)) {
+            m_windowStyle = (NativeStyle)(Style::Resizable | Style::Decorated);
+        }
+
+        if ((NativeStyle)(style & Style::Resizable)) {
+            m_windowStyle |= (NativeStyle)Style::Resizable;
+        }
+        if ((NativeStyle)(style & Style::NotResizable)) {
+            m_windowStyle &= ~(NativeStyle)Style::Resizable;
+        }
+
+        if ((NativeStyle)(style & Style::Visible)) {
+            XMapWindow(m_deviceContext, m_window);
+        }
+        if ((NativeStyle)(style & Style::NotVisible)) {
+            XUnmapWindow(m_deviceContext, m_window);
+        }
+
+        if ((NativeStyle)(style & Style::Decorated)) {
+            m_windowStyle |= (NativeStyle)Style::Decorated;
+        }
+        if ((NativeStyle)(style & Style::NotDecorated)) {
+            m_windowStyle &= ~(NativeStyle)Style::Decorated;
+        }
+
+        if ((NativeStyle)(style & Style::Maximize)) {
+            SendNetWmState(m_deviceContext, m_xlib, m_window, true, X11Atom::NetWmStateMaximizedVert, X11Atom::NetWmStateMaximizedHorz);
+        }
+        if ((NativeStyle)(style & Style::Restore)) {
+            SendNetWmState(m_deviceContext, m_xlib, m_window, false, X11Atom::NetWmStateMaximizedVert, X11Atom::NetWmStateMaximizedHorz);
+        }
+
+        UpdateSizeHints();
+
+        // _MOTIF_WM_HINTS is flags, functions, decorations, input mode and status. Flag 2 means decorations is set.
+        const long motifHints[5] = { 2, 0, (m_windowStyle & (NativeStyle)Style::Decorated) ? 1 : 0, 0, 0 };
+        XChangeProperty(m_deviceContext, m_window, m_xlib.atoms[(size_t)X11Atom::MotifWmHints], m_xlib.atoms[(size_t)X11Atom::MotifWmHints], 32, PropModeReplace, 
+            (const unsigned char*)motifHints, 5);
+
+        XFlush(m_deviceContext);
+    }
+}
+#endif
@@ -0,0 +1,56 @@
+/*
+    BSD 2-Clause License
+
+    Copyright (c) 2022, Immanuel Charles
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined(IWINDOW_XLIB)
+
+#include "IWindowVK.h"
+
+#include <X11/Xlib.h>
+#include <vulkan/vulkan_xlib.h>
+
+namespace IWindow {
+    namespace Vk {
+        void GetRequiredInstanceExtensions(std::vector<const char*>& extensionNames) {
+            extensionNames.push_back(VK_KHR_XLIB_SURFACE_EXTENSION_NAME);
+            extensionNames.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+        }
+
+        VkResult CreateSurface(Window& window, VkInstance& instance, VkSurfaceKHR& surface) {
+            VkXlibSurfaceCreateInfoKHR surfaceInfo{};
+            surfaceInfo.sType = VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR;
+            surfaceInfo.dpy = window.GetNativeDeviceContext();
+            surfaceInfo.window = window.GetNativeWindowHandle();
+
+            VkResult result = vkCreateXlibSurfaceKHR(instance, &surfaceInfo, nullptr, (VkSurfaceKHR*)&surface);
+
+            IWINDOW_CHECK_ERROR(result != VK_SUCCESS, ErrorType::Vulkan, ErrorSeverity::FatalError, "vkCreateXlibSurfaceKHR() failed. Failed to create a VkSurfaceKHR!", false, result);
+
+            return result;
+        }
+    }
+}
+#endif
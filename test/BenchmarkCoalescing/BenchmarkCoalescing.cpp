@@ -0,0 +1,161 @@
+#include "IWindow.h"
+#include "IWindowNull.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Replays a recorded 1000-event window drag, first moving the window and then resizing it from a corner, with and without
+// IWindow::Window::SetEventCoalescing. Counts the callbacks and the time the updates take when every size callback rebuilds a swapchain.
+// Uses the null backend so it runs anywhere.
+
+constexpr uint32_t DRAG_EVENT_COUNT = 1000;
+// A 1000 Hz mouse read at 60 frames per second.
+constexpr uint32_t EVENTS_PER_UPDATE = 16;
+// What rebuilding a swapchain and the layout costs, roughly.
+constexpr std::chrono::microseconds REBUILD_TIME{ 50 };
+
+static std::vector<IWindow::Null::Event> RecordDrag() {
+    std::vector<IWindow::Null::Event> drag{};
+
+    IWindow::Vector2<int32_t> position{ 100, 100 }, size{ 640, 480 }, mouse{ 320, 10 };
+    for (uint32_t i = 0; i < DRAG_EVENT_COUNT / 2; i++) {
+        IWindow::Null::Event event{};
+        const bool moving = i < DRAG_EVENT_COUNT / 4;
+
+        // The window follows the title bar, then the bottom right corner follows the mouse.
+        if (moving) {
+            mouse.x = 320 + (int32_t)(i % 2);
+            position.x += 1 + (int32_t)(i % 3);
+            position.y += (int32_t)(i % 2);
+            event.type = IWindow::Null::EventType::Position;
+            event.position = position;
+        }
+        else {
+            size.width += 1 + (int32_t)(i % 2);
+            size.height += (int32_t)(i % 3 == 0);
+            mouse = { size.width - 1, size.height - 1 };
+            event.type = IWindow::Null::EventType::Size;
+            event.size = size;
+        }
+        drag.push_back(event);
+
+        IWindow::Null::Event motion{};
+        motion.type = IWindow::Null::EventType::MouseMove;
+        motion.position = mouse;
+        drag.push_back(motion);
+    }
+
+    return drag;
+}
+
+struct Result {
+    uint64_t callbacks, rebuilds;
+    double ms;
+    IWindow::Vector2<int32_t> size, position;
+};
+
+static Result Replay(const std::vector<IWindow::Null::Event>& drag, bool coalesce) {
+    IWindow::Window window{};
+    window.Create({ 640, 480 }, L"IWindow coalescing benchmark", IWindow::Monitor::GetPrimaryMonitor(), { 100, 100 });
+
+    for (IWindow::EventType type : { IWindow::EventType::MouseMove, IWindow::EventType::WindowPos, IWindow::EventType::WindowSize, IWindow::EventType::FramebufferSize })
+        window.SetEventCoalescing(type, coalesce);
+
+    Result result{};
+    window.SetPositionCallback([&](IWindow::Window&, IWindow::Vector2<int32_t> position) { result.callbacks++; result.position = position; });
+    window.SetMouseMoveCallback([&](IWindow::Window&, IWindow::Vector2<int32_t>) { result.callbacks++; });
+    window.SetSizeCallback([&](IWindow::Window&, IWindow::Vector2<int32_t> size) { result.callbacks++; result.size = size; });
+    window.SetFramebufferSizeCallback([&](IWindow::Window&, IWindow::Vector2<int32_t>) {
+        result.callbacks++;
+        result.rebuilds++;
+
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + REBUILD_TIME;
+        while (std::chrono::steady_clock::now() < end);
+    });
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < drag.size(); i += EVENTS_PER_UPDATE) {
+        for (size_t j = i; j < i + EVENTS_PER_UPDATE && j < drag.size(); j++) IWindow::Null::PushEvent(window, drag[j]);
+        window.Update();
+    }
+
+    result.ms = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / 1'000'000.0;
+
+    window.Destroy();
+    return result;
+}
+
+// Motion before a key press is delivered before it, so a click lands where the mouse was.
+static bool CheckOrder() {
+    IWindow::Window window{};
+    window.Create({ 640, 480 }, L"IWindow coalescing order");
+    window.SetEventCoalescing(IWindow::EventType::MouseMove, true);
+
+    std::vector<int32_t> order{};
+    window.SetMouseMoveCallback([&](IWindow::Window&, IWindow::Vector2<int32_t> position) { order.push_back(position.x); });
+    window.SetMouseButtonCallback([&](IWindow::Window&, IWindow::MouseButton, IWindow::KeyModifier, IWindow::InputState) { order.push_back(-1); });
+
+    for (int32_t x : { 1, 2, 3 }) IWindow::Null::PushMouseMoveEvent(window, { x, 0 });
+    IWindow::Null::PushMouseButtonEvent(window, IWindow::MouseButton::Left, IWindow::InputState::Down);
+    for (int32_t x : { 4, 5 }) IWindow::Null::PushMouseMoveEvent(window, { x, 0 });
+    window.Update();
+
+    window.Destroy();
+    return order == std::vector<int32_t>{ 3, -1, 5 };
+}
+
+// Keys, buttons, characters and dropped paths are never merged, asking for it leaves them alone.
+static bool CheckRefused() {
+    IWindow::Window window{};
+    window.Create({ 640, 480 }, L"IWindow coalescing refused");
+    for (IWindow::EventType type : { IWindow::EventType::Key, IWindow::EventType::MouseButton, IWindow::EventType::Char, IWindow::EventType::PathDrop, IWindow::EventType::MouseMove })
+        window.SetEventCoalescing(type, true);
+
+    uint32_t presses = 0;
+    window.SetMouseButtonCallback([&](IWindow::Window&, IWindow::MouseButton, IWindow::KeyModifier, IWindow::InputState) { presses++; });
+
+    for (uint32_t i = 0; i < 8; i++) IWindow::Null::PushMouseButtonEvent(window, IWindow::MouseButton::Left, i % 2 ? IWindow::InputState::Up : IWindow::InputState::Down);
+    window.Update();
+
+    const bool refused = !window.IsEventCoalesced(IWindow::EventType::Key) && !window.IsEventCoalesced(IWindow::EventType::MouseButton) &&
+        !window.IsEventCoalesced(IWindow::EventType::Char) && !window.IsEventCoalesced(IWindow::EventType::PathDrop) && window.IsEventCoalesced(IWindow::EventType::MouseMove);
+
+    window.Destroy();
+    return refused && presses == 8;
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    if (!CheckOrder()) {
+        std::cout << "FAILED: coalesced motion was delivered out of order\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!CheckRefused()) {
+        std::cout << "FAILED: events that can't be merged were coalesced\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<IWindow::Null::Event> drag = RecordDrag();
+
+    const Result every = Replay(drag, false);
+    const Result merged = Replay(drag, true);
+
+    std::cout << "Replay of a " << drag.size() << " event drag, " << EVENTS_PER_UPDATE << " events per update\n"
+        << "    Every event: " << every.callbacks << " callbacks, " << every.rebuilds << " rebuilds, " << every.ms << " ms\n"
+        << "    Coalesced:   " << merged.callbacks << " callbacks, " << merged.rebuilds << " rebuilds, " << merged.ms << " ms\n";
+
+    IWindow::Shutdown();
+
+    // Merging may only drop the values in between.
+    const bool ok = merged.size.width == every.size.width && merged.size.height == every.size.height && 
+        merged.position.x == every.position.x && merged.position.y == every.position.y && merged.callbacks < every.callbacks;
+    if (!ok) std::cout << "FAILED: coalesced replay ended with a different size or position\n";
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,118 @@
+#include "IWindow.h"
+#include "IWindowNull.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+
+// Micro-benchmark of the mouse move callback: what it costs to set, copy (as the ImGui backend does to chain callbacks) and call it,
+// with IWindow::Delegate and with the std::function the callbacks used to be. Also counts heap allocations.
+// Build with optimizations. Uses the null backend so it runs anywhere.
+
+static uint64_t s_allocations = 0;
+
+void* operator new(size_t size) {
+    s_allocations++;
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+typedef std::function<void(IWindow::Window&, IWindow::Vector2<int32_t>)> StdMouseMoveCallback;
+
+struct Result {
+    double nsPerOp;
+    uint64_t allocations;
+};
+
+template<typename F>
+static Result Measure(uint64_t iterations, F&& body) {
+    const uint64_t allocations = s_allocations;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < iterations; i++) body(i);
+
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return { ns / (double)iterations, s_allocations - allocations };
+}
+
+static void Print(const char* name, Result stdFunction, Result delegate) {
+    std::cout << name << "\n"
+        << "    std::function:     " << stdFunction.nsPerOp << " ns, " << stdFunction.allocations << " allocations\n"
+        << "    IWindow::Delegate: " << delegate.nsPerOp << " ns, " << delegate.allocations << " allocations\n";
+}
+
+// Three pointers of state, more than the small buffer of most std::function implementations.
+struct MouseState {
+    int64_t* sumX;
+    int64_t* sumY;
+    uint64_t* count;
+};
+
+int main() {
+    constexpr uint64_t SET_ITERATIONS = 1'000'000;
+    constexpr uint64_t CALL_ITERATIONS = 100'000'000;
+    constexpr uint64_t EVENT_ITERATIONS = 10'000'000;
+    constexpr uint64_t EVENTS_PER_UPDATE = 1000;
+
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow delegate benchmark")) return EXIT_FAILURE;
+    window.Update();
+
+    int64_t sumX = 0, sumY = 0;
+    uint64_t count = 0;
+    const MouseState state{ &sumX, &sumY, &count };
+
+    auto callback = [state](IWindow::Window&, IWindow::Vector2<int32_t> position) {
+        *state.sumX += position.x;
+        *state.sumY += position.y;
+        (*state.count)++;
+    };
+
+    StdMouseMoveCallback stdCallback{};
+    IWindow::Window::MouseMoveCallback delegate{};
+
+    Print("Set a capturing lambda",
+        Measure(SET_ITERATIONS, [&](uint64_t) { stdCallback = callback; }),
+        Measure(SET_ITERATIONS, [&](uint64_t) { delegate = callback; }));
+
+    StdMouseMoveCallback stdChained{};
+    IWindow::Window::MouseMoveCallback delegateChained{};
+
+    Print("Copy to chain",
+        Measure(SET_ITERATIONS, [&](uint64_t) { stdChained = stdCallback; }),
+        Measure(SET_ITERATIONS, [&](uint64_t) { delegateChained = delegate; }));
+
+    // Called through volatile pointers so the compiler can't see the target and inline it.
+    StdMouseMoveCallback* volatile stdTarget = &stdCallback;
+    IWindow::Window::MouseMoveCallback* volatile delegateTarget = &delegate;
+
+    Print("Call",
+        Measure(CALL_ITERATIONS, [&](uint64_t i) { (*stdTarget)(window, { (int32_t)i, 1 }); }),
+        Measure(CALL_ITERATIONS, [&](uint64_t i) { (*delegateTarget)(window, { (int32_t)i, 1 }); }));
+
+    // The whole path of an event: queued by the backend, read by Window::Update and dispatched to the callback.
+    window.SetMouseMoveCallback(callback);
+    const Result windowResult = Measure(EVENT_ITERATIONS / EVENTS_PER_UPDATE, [&](uint64_t i) {
+        for (uint64_t event = 0; event < EVENTS_PER_UPDATE; event++)
+            IWindow::Null::PushMouseMoveEvent(window, { (int32_t)event, (int32_t)i });
+        window.Update();
+    });
+
+    std::cout << "Window::Update mouse move event\n    " << windowResult.nsPerOp / EVENTS_PER_UPDATE << " ns per event\n";
+
+    // Keeps the sums alive.
+    std::cout << "Checksum: " << (sumX ^ sumY) + (int64_t)count << '\n';
+
+    window.Destroy();
+    IWindow::Shutdown();
+
+    return EXIT_SUCCESS;
+}
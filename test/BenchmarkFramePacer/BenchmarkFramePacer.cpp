@@ -0,0 +1,107 @@
+#include "IWindow.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+// Paces a loop at 60, 144 and 240 frames per second with IWindow::FramePacer and with the std::this_thread::sleep_for limiter
+// most loops have, and prints how late each one lets the frames start and how much CPU it takes. Every frame does a third of a frame of work.
+// Run the Release build on an idle machine. Doesn't need a window.
+
+constexpr double RATES[] = { 60.0, 144.0, 240.0 };
+constexpr double SECONDS_PER_RATE = 2.0;
+constexpr double WORK_FRACTION = 1.0 / 3.0;
+
+static uint64_t Now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Busy work, like building a command buffer. Varies between frames so the limiters can't settle on one sleep.
+static void Work(uint64_t periodNs, uint64_t frame) {
+    const uint64_t end = Now() + (uint64_t)(periodNs * WORK_FRACTION * (0.5 + (double)(frame % 7) / 6.0));
+    while (Now() < end);
+}
+
+static void Record(IWindow::FramePacingStats& stats, uint64_t deadline, uint64_t now) {
+    const double errorUs = now > deadline ? (double)(now - deadline) / 1'000.0 : 0.0;
+    stats.minErrorUs = stats.count ? std::fmin(stats.minErrorUs, errorUs) : errorUs;
+    stats.maxErrorUs = std::fmax(stats.maxErrorUs, errorUs);
+    stats.totalErrorUs += errorUs;
+    stats.buckets[IWindow::FramePacingStats::BucketOf(errorUs)]++;
+    stats.count++;
+}
+
+struct Result {
+    IWindow::FramePacingStats stats;
+    double cpu;
+};
+
+static Result PaceWithFramePacer(double rate) {
+    IWindow::FramePacer pacer{ rate };
+    const uint64_t periodNs = (uint64_t)(1'000'000'000.0 / rate);
+    const uint64_t frames = (uint64_t)(rate * SECONDS_PER_RATE);
+
+    const std::clock_t cpuStart = std::clock();
+    const uint64_t start = Now();
+    for (uint64_t frame = 0; frame <= frames; frame++) {
+        Work(periodNs, frame);
+        pacer.Wait();
+    }
+
+    const double wall = (double)(Now() - start) / 1'000'000'000.0;
+    return { pacer.GetStats(), (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC / wall };
+}
+
+// The usual limiter: sleep for whatever is left of the frame.
+static Result PaceWithSleepFor(double rate) {
+    const uint64_t periodNs = (uint64_t)(1'000'000'000.0 / rate);
+    const uint64_t frames = (uint64_t)(rate * SECONDS_PER_RATE);
+
+    IWindow::FramePacingStats stats{};
+    const std::clock_t cpuStart = std::clock();
+    const uint64_t start = Now();
+    uint64_t frameStart = Now();
+    for (uint64_t frame = 0; frame <= frames; frame++) {
+        Work(periodNs, frame);
+
+        const uint64_t elapsed = Now() - frameStart;
+        if (elapsed < periodNs) std::this_thread::sleep_for(std::chrono::nanoseconds(periodNs - elapsed));
+
+        const uint64_t now = Now();
+        if (frame) Record(stats, frameStart + periodNs, now);
+        frameStart = now;
+    }
+
+    const double wall = (double)(Now() - start) / 1'000'000'000.0;
+    return { stats, (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC / wall };
+}
+
+static void Print(const char* name, const Result& result) {
+    const IWindow::FramePacingStats& stats = result.stats;
+    std::cout << "    " << name << stats.count << " frames, late by mean " << stats.GetMeanErrorUs() << " us, p99 " << stats.GetPercentileUs(0.99)
+        << " us, max " << stats.maxErrorUs << " us, " << stats.missed << " missed, " << result.cpu * 100.0 << "% CPU\n";
+}
+
+int main() {
+    bool ok = true;
+
+    for (double rate : RATES) {
+        const Result pacer = PaceWithFramePacer(rate);
+        const Result sleepFor = PaceWithSleepFor(rate);
+
+        std::cout << rate << " Hz\n";
+        Print("FramePacer: ", pacer);
+        Print("sleep_for:  ", sleepFor);
+
+        // Every frame but the first, which starts the schedule, is recorded.
+        ok &= pacer.stats.count == (uint64_t)(rate * SECONDS_PER_RATE);
+    }
+
+    if (!ok) std::cout << "FAILED: FramePacer lost frames\n";
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,254 @@
+#include "IWindow.h"
+#include "IWindowGamepad.h"
+#include "IWindowNull.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Checks IWindow::NormalizeGamepadAxes and IWindow::ApplyGamepadDeadzone against the scalar formulas below for random and extreme stick positions, 
+// with every deadzone shape and a few deadzones and response curves, and that IWindow::Gamepad reads the result.
+// Then compares reading the axes of four gamepads a few times per frame the way Gamepad did before, converting and checking the deadzone in every call,
+// with converting them once per update. Uses the null backend so it runs anywhere.
+
+constexpr uint32_t PADS = (uint32_t)IWindow::GamepadID::Max;
+constexpr uint32_t CASES = 100'000;
+constexpr uint32_t FRAMES = 100'000;
+// How often a game reads every axis in a frame: the input mapping, the camera, the UI...
+constexpr uint32_t READS_PER_FRAME = 4;
+constexpr float TOLERANCE = 1e-6f;
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+static float ReferenceStick(int16_t value) { return std::fmax((float)value / (float)SHRT_MAX, -1.0f); }
+
+static IWindow::GamepadAxes ReferenceNormalize(const IWindow::NativeGamepadState& state) {
+    return {
+        ReferenceStick(state.Gamepad.sThumbLX), ReferenceStick(state.Gamepad.sThumbLY), ReferenceStick(state.Gamepad.sThumbRX), ReferenceStick(state.Gamepad.sThumbRY),
+        (float)state.Gamepad.bLeftTrigger / 255.0f, (float)state.Gamepad.bRightTrigger / 255.0f,
+    };
+}
+
+static void ReferenceStickDeadzone(float& x, float& y, const IWindow::GamepadAxisSettings& settings) {
+    const float deadzone = settings.stickDeadzone, curve = settings.stickResponseCurve;
+
+    switch (settings.stickDeadzoneType) {
+        case IWindow::StickDeadzone::Axial:
+            x = std::fabs(x) > deadzone ? std::copysign(std::pow(std::fabs(x), curve), x) : 0.0f;
+            y = std::fabs(y) > deadzone ? std::copysign(std::pow(std::fabs(y), curve), y) : 0.0f;
+            break;
+        case IWindow::StickDeadzone::Radial: {
+            const float magnitude = std::sqrt(x * x + y * y);
+            if (magnitude <= deadzone) x = y = 0.0f;
+            else {
+                x = x / magnitude * std::pow(magnitude, curve);
+                y = y / magnitude * std::pow(magnitude, curve);
+            }
+            break;
+        }
+        case IWindow::StickDeadzone::ScaledRadial: {
+            const float magnitude = std::sqrt(x * x + y * y);
+            if (magnitude <= deadzone) x = y = 0.0f;
+            else {
+                const float scaled = std::pow(std::fmin((magnitude - deadzone) / (1.0f - deadzone), 1.0f), curve);
+                x = x / magnitude * scaled;
+                y = y / magnitude * scaled;
+            }
+            break;
+        }
+    }
+}
+
+static IWindow::GamepadAxes ReferenceDeadzone(IWindow::GamepadAxes axes, const IWindow::GamepadAxisSettings& settings) {
+    ReferenceStickDeadzone(axes[0], axes[1], settings);
+    ReferenceStickDeadzone(axes[2], axes[3], settings);
+    for (size_t trigger : { 4, 5 }) if (axes[trigger] <= settings.triggerDeadzone) axes[trigger] = 0.0f;
+    return axes;
+}
+
+static bool Same(const IWindow::GamepadAxes& left, const IWindow::GamepadAxes& right, float tolerance) {
+    for (size_t i = 0; i < left.size(); i++)
+        if (!(std::fabs(left[i] - right[i]) <= tolerance)) return false;
+    return true;
+}
+
+// Random positions, with the ends of the range, the middle and the edges of the deadzones mixed in.
+static std::vector<IWindow::NativeGamepadState> MakeStates(uint32_t count) {
+    static const int16_t SPECIAL[] = { SHRT_MIN, SHRT_MIN + 1, -4915, -1, 0, 1, 4915, 4916, 9830, SHRT_MAX };
+
+    std::vector<IWindow::NativeGamepadState> states(count);
+    uint32_t random = 2024;
+    const auto next = [&random] { random = random * 1664525u + 1013904223u; return random; };
+    const auto axis = [&] { return (next() >> 28) < 3 ? SPECIAL[(next() >> 8) % 10] : (int16_t)(next() >> 16); };
+
+    for (IWindow::NativeGamepadState& state : states) {
+        state.Gamepad.sThumbLX = axis();
+        state.Gamepad.sThumbLY = axis();
+        state.Gamepad.sThumbRX = axis();
+        state.Gamepad.sThumbRY = axis();
+        state.Gamepad.bLeftTrigger = (uint8_t)(next() >> 24);
+        state.Gamepad.bRightTrigger = (uint8_t)(next() >> 24);
+    }
+    return states;
+}
+
+static bool CheckAgainstReference(const std::vector<IWindow::NativeGamepadState>& states) {
+    std::vector<IWindow::GamepadAxes> axes(states.size());
+    IWindow::NormalizeGamepadAxes(states.data(), axes.data(), states.size());
+
+    bool normalized = true;
+    for (size_t i = 0; i < states.size(); i++) normalized &= Same(axes[i], ReferenceNormalize(states[i]), 0.0f);
+    bool ok = Check(normalized, "Normalized axes match the scalar conversion");
+
+    for (IWindow::StickDeadzone type : { IWindow::StickDeadzone::Axial, IWindow::StickDeadzone::Radial, IWindow::StickDeadzone::ScaledRadial }) {
+        for (float deadzone : { 0.0f, 0.15f, 0.3f }) {
+            for (float curve : { 1.0f, 2.0f, 0.5f }) {
+                const IWindow::GamepadAxisSettings settings{ type, deadzone, deadzone, curve };
+
+                bool same = true;
+                for (const IWindow::GamepadAxes& raw : axes) same &= Same(IWindow::ApplyGamepadDeadzone(raw, settings), ReferenceDeadzone(raw, settings), TOLERANCE);
+
+                if (!same) std::cout << "FAILED: deadzone type " << (int)type << ", deadzone " << deadzone << ", curve " << curve << " doesn't match the scalar reference\n";
+                ok &= same;
+            }
+        }
+    }
+
+    return ok;
+}
+
+static IWindow::GamepadAxes Sticks(float lx, float ly) { return { lx, ly, 0.0f, 0.0f, 0.0f, 0.0f }; }
+
+static bool CheckShapes() {
+    bool ok = true;
+
+    // Pushed a little along the diagonal: outside a round deadzone of 0.15, inside the cross.
+    const IWindow::GamepadAxes diagonal = Sticks(0.12f, 0.12f);
+    const IWindow::GamepadAxes axial = IWindow::ApplyGamepadDeadzone(diagonal, { IWindow::StickDeadzone::Axial });
+    const IWindow::GamepadAxes radial = IWindow::ApplyGamepadDeadzone(diagonal, { IWindow::StickDeadzone::Radial });
+    ok &= Check(axial[0] == 0.0f && axial[1] == 0.0f, "The axial deadzone is a cross");
+    ok &= Check(radial[0] == 0.12f && radial[1] == 0.12f, "The radial deadzone is round");
+
+    // Along the x axis only x is kept, and the scaled deadzone starts at 0 and ends at 1.
+    const IWindow::GamepadAxisSettings scaled{ IWindow::StickDeadzone::ScaledRadial };
+    ok &= Check(IWindow::ApplyGamepadDeadzone(Sticks(0.16f, 0.0f), scaled)[0] < 0.02f, "Scaled deadzone starts near 0");
+    ok &= Check(IWindow::ApplyGamepadDeadzone(Sticks(1.0f, 0.0f), scaled)[0] == 1.0f, "Scaled deadzone reaches 1");
+
+    // The corner of the square the pad reports is pulled onto the circle.
+    const IWindow::GamepadAxes corner = IWindow::ApplyGamepadDeadzone(Sticks(1.0f, 1.0f), scaled);
+    ok &= Check(std::fabs(std::sqrt(corner[0] * corner[0] + corner[1] * corner[1]) - 1.0f) < TOLERANCE, "Scaled deadzone ends at the circle");
+
+    // A curve of 2 halves the stick halfway out.
+    const IWindow::GamepadAxes curved = IWindow::ApplyGamepadDeadzone(Sticks(0.0f, -0.5f), { IWindow::StickDeadzone::Radial, 0.15f, 0.15f, 2.0f });
+    ok &= Check(curved[0] == 0.0f && std::fabs(curved[1] + 0.25f) < TOLERANCE, "Response curve");
+
+    return ok;
+}
+
+static bool CheckGamepad() {
+    IWindow::NativeGamepadState state{};
+    state.Gamepad.sThumbLX = 4000;
+    state.Gamepad.sThumbLY = 4000;
+    state.Gamepad.sThumbRY = -16384;
+    state.Gamepad.bLeftTrigger = 20;
+    IWindow::Null::SetGamepadState(IWindow::GamepadID::GP1, state);
+
+    // Empty slots are probed one per update.
+    IWindow::Gamepad gamepad{ IWindow::GamepadID::GP1 };
+    for (uint32_t i = 0; i < PADS && !gamepad.IsConnected(); i++) gamepad.Update();
+
+    bool ok = true;
+    ok &= Check(IWindow::GamepadManager::Get().GetAxes(IWindow::GamepadID::GP1) == ReferenceNormalize(state), "GamepadManager::GetAxes");
+
+    const IWindow::GamepadAxes expected = ReferenceDeadzone(ReferenceNormalize(state), {});
+    ok &= Check(gamepad.LeftStickX() == 0.0f && gamepad.LeftStickY() == 0.0f && gamepad.RightStickY() == expected[3] && gamepad.LeftTrigger() == 0.0f, "Gamepad reads the axial deadzone by default");
+
+    // A setting applies right away, without another update.
+    gamepad.SetStickDeadzoneType(IWindow::StickDeadzone::Radial);
+    gamepad.SetTriggerDeadzone(0.05f);
+    ok &= Check(gamepad.LeftStickX() == ReferenceStick(4000) && gamepad.GetAxis(IWindow::GamepadAxis::LeftTrigger) == 20.0f / 255.0f, "Settings apply without an update");
+
+    IWindow::Null::SetGamepadConnected(IWindow::GamepadID::GP1, false);
+    gamepad.Update();
+    ok &= Check(gamepad.RightStickY() == 0.0f, "A disconnected gamepad reads 0");
+
+    return ok;
+}
+
+// What Gamepad::LeftStickX and the others did before: convert and check an axial deadzone in every call.
+static float PerCallAxis(const IWindow::NativeGamepadState& state, uint32_t axis, float stickDeadzone, float triggerDeadzone) {
+    if (axis >= 4) {
+        const float trigger = (float)(axis == 4 ? state.Gamepad.bLeftTrigger : state.Gamepad.bRightTrigger) / 255.0f;
+        return trigger > triggerDeadzone ? trigger : 0.0f;
+    }
+
+    const int16_t raw[] = { state.Gamepad.sThumbLX, state.Gamepad.sThumbLY, state.Gamepad.sThumbRX, state.Gamepad.sThumbRY };
+    const float value = (float)raw[axis] / SHRT_MAX;
+    return value > stickDeadzone || value < -stickDeadzone ? value : 0.0f;
+}
+
+template<typename F>
+static double Measure(F&& frame) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < FRAMES; i++) frame(i);
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    const std::vector<IWindow::NativeGamepadState> states = MakeStates(CASES);
+
+    bool ok = CheckAgainstReference(states);
+    ok &= CheckShapes();
+    ok &= CheckGamepad();
+
+    const IWindow::GamepadAxisSettings axial{};
+    float sum = 0.0f;
+
+    const double perCall = Measure([&](uint32_t frame) {
+        const IWindow::NativeGamepadState* pads = &states[(frame * PADS) % (CASES - PADS)];
+        for (uint32_t read = 0; read < READS_PER_FRAME; read++)
+            for (uint32_t pad = 0; pad < PADS; pad++)
+                for (uint32_t axis = 0; axis < (uint32_t)IWindow::GamepadAxis::Max; axis++) sum += PerCallAxis(pads[pad], axis, axial.stickDeadzone, axial.triggerDeadzone);
+    });
+
+    const auto batched = [&](const IWindow::GamepadAxisSettings& settings) {
+        return Measure([&](uint32_t frame) {
+            const IWindow::NativeGamepadState* pads = &states[(frame * PADS) % (CASES - PADS)];
+
+            std::array<IWindow::GamepadAxes, PADS> axes;
+            IWindow::NormalizeGamepadAxes(pads, axes.data(), PADS);
+            for (IWindow::GamepadAxes& pad : axes) pad = IWindow::ApplyGamepadDeadzone(pad, settings);
+
+            for (uint32_t read = 0; read < READS_PER_FRAME; read++)
+                for (const IWindow::GamepadAxes& pad : axes)
+                    for (float value : pad) sum += value;
+        });
+    };
+
+    const double batchedAxial = batched(axial);
+    const double batchedScaled = batched({ IWindow::StickDeadzone::ScaledRadial });
+    const double batchedCurve = batched({ IWindow::StickDeadzone::ScaledRadial, 0.15f, 0.15f, 2.0f });
+
+    std::cout << PADS << " gamepads, every axis read " << READS_PER_FRAME << " times per frame\n"
+        << "    Converted in every call:         " << perCall << " ns per frame\n"
+        << "    Once per update, axial:          " << batchedAxial << " ns per frame\n"
+        << "    Once per update, scaled radial:  " << batchedScaled << " ns per frame\n"
+        << "    Scaled radial with a curve of 2: " << batchedCurve << " ns per frame\n"
+        << "Checksum: " << sum << '\n';
+
+    IWindow::Shutdown();
+
+    if (!ok) std::cout << "FAILED\n";
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
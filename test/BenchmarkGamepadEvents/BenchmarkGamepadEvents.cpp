@@ -0,0 +1,180 @@
+#include "IWindow.h"
+#include "IWindowGamepad.h"
+#include "IWindowNull.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Plays the same 10000 frames of four gamepads twice: once scanning all 14 buttons and 6 axes of every pad every frame, 
+// the way an input remapping layer does, and once with the button and axis callbacks of IWindow::GamepadManager.
+// Checks that both see the same button presses and releases and prints how long a frame of input handling takes.
+// Uses the null backend so it runs anywhere.
+
+constexpr uint32_t PADS = (uint32_t)IWindow::GamepadID::Max;
+constexpr uint32_t FRAMES = 10'000;
+constexpr float AXIS_THRESHOLD = 0.01f;
+
+static const IWindow::GamepadButton BUTTONS[] = {
+    IWindow::GamepadButton::A, IWindow::GamepadButton::B, IWindow::GamepadButton::X, IWindow::GamepadButton::Y,
+    IWindow::GamepadButton::DpadUp, IWindow::GamepadButton::DpadDown, IWindow::GamepadButton::DpadLeft, IWindow::GamepadButton::DpadRight,
+    IWindow::GamepadButton::LeftShoulder, IWindow::GamepadButton::RightShoulder, IWindow::GamepadButton::LeftStick, IWindow::GamepadButton::RightStick,
+    IWindow::GamepadButton::Start, IWindow::GamepadButton::Back,
+};
+
+// Every frame of every pad. A button changes now and then, the left stick circles and the triggers are mostly still.
+static std::vector<std::array<IWindow::NativeGamepadState, PADS>> Record() {
+    std::vector<std::array<IWindow::NativeGamepadState, PADS>> frames(FRAMES);
+
+    uint32_t random = 12345;
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        for (uint32_t pad = 0; pad < PADS; pad++) {
+            IWindow::NativeGamepadState state = frame ? frames[frame - 1][pad] : IWindow::NativeGamepadState{};
+
+            random = random * 1664525u + 1013904223u;
+            if ((random >> 24) < 12) state.Gamepad.wButtons ^= (uint16_t)BUTTONS[(random >> 8) % 14];
+
+            const double angle = (double)(frame + pad * 100) * 0.02;
+            state.Gamepad.sThumbLX = (int16_t)(std::cos(angle) * 20000.0);
+            state.Gamepad.sThumbLY = (int16_t)(std::sin(angle) * 20000.0);
+            if (frame % 600 == 0) state.Gamepad.bRightTrigger = (uint8_t)(state.Gamepad.bRightTrigger ? 0 : 255);
+
+            frames[frame][pad] = state;
+        }
+    }
+
+    return frames;
+}
+
+struct Result {
+    uint64_t presses, releases, axisChanges;
+    double usPerFrame;
+};
+
+static float AxisOf(const IWindow::NativeGamepadState& state, uint32_t axis) {
+    switch (axis) {
+        case 0: return std::fmax((float)state.Gamepad.sThumbLX / 32767.0f, -1.0f);
+        case 1: return std::fmax((float)state.Gamepad.sThumbLY / 32767.0f, -1.0f);
+        case 2: return std::fmax((float)state.Gamepad.sThumbRX / 32767.0f, -1.0f);
+        case 3: return std::fmax((float)state.Gamepad.sThumbRY / 32767.0f, -1.0f);
+        case 4: return (float)state.Gamepad.bLeftTrigger / 255.0f;
+        default: return (float)state.Gamepad.bRightTrigger / 255.0f;
+    }
+}
+
+static Result Scan(const std::vector<std::array<IWindow::NativeGamepadState, PADS>>& frames) {
+    std::array<IWindow::Gamepad, PADS> gamepads{};
+    for (uint32_t pad = 0; pad < PADS; pad++) gamepads[pad] = IWindow::Gamepad{ (IWindow::GamepadID)pad };
+
+    std::array<std::array<float, 6>, PADS> lastAxes{};
+    Result result{};
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (const std::array<IWindow::NativeGamepadState, PADS>& frame : frames) {
+        for (uint32_t pad = 0; pad < PADS; pad++) IWindow::Null::SetGamepadState((IWindow::GamepadID)pad, frame[pad]);
+
+        for (IWindow::Gamepad& gamepad : gamepads) {
+            gamepad.Update();
+
+            for (IWindow::GamepadButton button : BUTTONS) {
+                result.presses += gamepad.IsButtonJustPressed(button);
+                result.releases += gamepad.IsButtonJustReleased(button);
+            }
+
+            const IWindow::NativeGamepadState state = gamepad.GetState();
+            for (uint32_t axis = 0; axis < 6; axis++) {
+                const float value = AxisOf(state, axis);
+                if (std::fabs(value - lastAxes[(size_t)gamepad.GetID()][axis]) < AXIS_THRESHOLD) continue;
+                lastAxes[(size_t)gamepad.GetID()][axis] = value;
+                result.axisChanges++;
+            }
+        }
+    }
+    result.usPerFrame = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0 / FRAMES;
+
+    return result;
+}
+
+static Result Callbacks(const std::vector<std::array<IWindow::NativeGamepadState, PADS>>& frames) {
+    IWindow::GamepadManager& manager = IWindow::GamepadManager::Get();
+    Result result{};
+
+    manager.SetAxisThreshold(AXIS_THRESHOLD);
+    manager.SetButtonCallback([&](IWindow::GamepadID, IWindow::GamepadButton, IWindow::InputState state) {
+        if (state == IWindow::InputState::Down) result.presses++;
+        else result.releases++;
+    });
+    manager.SetAxisCallback([&](IWindow::GamepadID, IWindow::GamepadAxis, float) { result.axisChanges++; });
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (const std::array<IWindow::NativeGamepadState, PADS>& frame : frames) {
+        for (uint32_t pad = 0; pad < PADS; pad++) IWindow::Null::SetGamepadState((IWindow::GamepadID)pad, frame[pad]);
+        manager.Update();
+    }
+    result.usPerFrame = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0 / FRAMES;
+
+    manager.SetButtonCallback(nullptr);
+    manager.SetAxisCallback(nullptr);
+    return result;
+}
+
+// A pad that is pulled out releases what was held.
+static bool CheckDisconnect() {
+    IWindow::GamepadManager& manager = IWindow::GamepadManager::Get();
+
+    IWindow::NativeGamepadState held{};
+    held.Gamepad.wButtons = (uint16_t)IWindow::GamepadButton::A | (uint16_t)IWindow::GamepadButton::Start;
+    held.Gamepad.sThumbRX = 32767;
+    IWindow::Null::SetGamepadState(IWindow::GamepadID::GP2, held);
+    manager.Update();
+
+    uint32_t releases = 0;
+    float rightStickX = 1.0f;
+    manager.SetButtonCallback([&](IWindow::GamepadID gid, IWindow::GamepadButton, IWindow::InputState state) { releases += gid == IWindow::GamepadID::GP2 && state == IWindow::InputState::Up; });
+    manager.SetAxisCallback([&](IWindow::GamepadID gid, IWindow::GamepadAxis axis, float value) { if (gid == IWindow::GamepadID::GP2 && axis == IWindow::GamepadAxis::RightStickX) rightStickX = value; });
+
+    IWindow::Null::SetGamepadConnected(IWindow::GamepadID::GP2, false);
+    manager.Update();
+
+    manager.SetButtonCallback(nullptr);
+    manager.SetAxisCallback(nullptr);
+    return releases == 2 && rightStickX == 0.0f;
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    // Every pad connected before the frames start.
+    for (uint32_t pad = 0; pad < PADS; pad++) IWindow::Null::SetGamepadState((IWindow::GamepadID)pad, {});
+    for (uint32_t pad = 0; pad < PADS; pad++) IWindow::GamepadManager::Get().Update();
+
+    const std::vector<std::array<IWindow::NativeGamepadState, PADS>> frames = Record();
+    const Result scan = Scan(frames);
+
+    for (uint32_t pad = 0; pad < PADS; pad++) IWindow::Null::SetGamepadState((IWindow::GamepadID)pad, {});
+    IWindow::GamepadManager::Get().Update();
+    const Result callbacks = Callbacks(frames);
+
+    std::cout << FRAMES << " frames of " << PADS << " gamepads\n"
+        << "    Scanning every button and axis: " << scan.presses << " presses, " << scan.releases << " releases, " << scan.axisChanges << " axis changes, " 
+        << scan.usPerFrame << " us per frame\n"
+        << "    Button and axis callbacks:      " << callbacks.presses << " presses, " << callbacks.releases << " releases, " << callbacks.axisChanges << " axis changes, " 
+        << callbacks.usPerFrame << " us per frame\n";
+
+    bool ok = true;
+    if (scan.presses != callbacks.presses || scan.releases != callbacks.releases || !callbacks.axisChanges) {
+        std::cout << "FAILED: the callbacks saw other changes than the scan\n";
+        ok = false;
+    }
+    if (!CheckDisconnect()) {
+        std::cout << "FAILED: a disconnected gamepad kept its buttons held\n";
+        ok = false;
+    }
+
+    IWindow::Shutdown();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,154 @@
+#include "IWindow.h"
+#include "IWindowGamepad.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Counts the driver calls four IWindow::Gamepad objects make per frame with IWindow::GamepadManager, against the old scheme where every 
+// Gamepad::Update polled all four slots and then its own one again. A mock backend stands in for XInput and adds up what the calls would cost.
+// Also checks the probe schedule: connected pads are polled once per frame, empty slots back off and new pads are still found.
+// Uses the null backend so it runs anywhere.
+
+constexpr uint32_t SLOTS = (uint32_t)IWindow::GamepadID::Max;
+constexpr uint64_t FRAME_NS = 16'666'667;
+constexpr uint32_t FRAMES = 60 * 60;
+// Roughly what XInputGetState takes for a connected pad and for an empty slot.
+constexpr uint64_t CONNECTED_POLL_NS = 10'000;
+constexpr uint64_t EMPTY_POLL_NS = 800'000;
+
+class MockBackend final : public IWindow::GamepadBackend {
+public:
+    std::array<bool, SLOTS> connected{};
+    std::array<IWindow::NativeGamepadState, SLOTS> states{};
+    std::array<uint64_t, SLOTS> polls{};
+    uint64_t emptyPolls = 0, connectedPolls = 0, costNs = 0;
+
+    bool Poll(IWindow::GamepadID gid, IWindow::NativeGamepadState& state) override {
+        const uint32_t i = (uint32_t)gid;
+        polls[i]++;
+
+        if (!connected[i]) {
+            emptyPolls++;
+            costNs += EMPTY_POLL_NS;
+            return false;
+        }
+
+        connectedPolls++;
+        costNs += CONNECTED_POLL_NS;
+        state = states[i];
+        return true;
+    }
+
+    void Rumble(IWindow::GamepadID, float) override {}
+
+    void ResetCounts() {
+        polls = {};
+        emptyPolls = connectedPolls = costNs = 0;
+    }
+};
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+// What Gamepad::Update used to do for every gamepad object.
+static void LegacyUpdate(MockBackend& backend, IWindow::GamepadID own) {
+    IWindow::NativeGamepadState state{};
+    for (uint32_t i = 0; i < SLOTS; i++) backend.Poll((IWindow::GamepadID)i, state);
+    backend.Poll(own, state);
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::GamepadManager& manager = IWindow::GamepadManager::Get();
+    MockBackend backend{};
+    backend.connected = { true, true, false, false };
+    backend.states[0].Gamepad.wButtons = (uint16_t)IWindow::GamepadButton::A;
+    manager.SetBackend(&backend);
+
+    std::vector<std::pair<IWindow::GamepadID, bool>> changes{};
+    manager.SetConnectedCallback([&](IWindow::GamepadID gid, bool connected) { changes.push_back({ gid, connected }); });
+
+    bool ok = true;
+
+    // Two pads need at most one update per slot to be found. Gamepad::Update updates on IWindow::GetTimeNs, so the tests start from it.
+    uint64_t time = IWindow::GetTimeNs();
+    for (uint32_t i = 0; i < SLOTS; i++) manager.Update(time += FRAME_NS);
+    ok &= Check(manager.IsConnected(IWindow::GamepadID::GP0) && manager.IsConnected(IWindow::GamepadID::GP1) && changes.size() == 2, "Pads found in the first updates");
+
+    // Four gamepad objects poll each pad once per frame.
+    std::array<IWindow::Gamepad, SLOTS> gamepads{};
+    for (uint32_t i = 0; i < SLOTS; i++) gamepads[i] = IWindow::Gamepad{ (IWindow::GamepadID)i };
+
+    // The first frame only copies what the updates above read.
+    backend.ResetCounts();
+    const uint64_t updates = manager.GetUpdateCount();
+    for (uint32_t frame = 0; frame < 100; frame++)
+        for (IWindow::Gamepad& gamepad : gamepads) gamepad.Update();
+    ok &= Check(manager.GetUpdateCount() - updates == 99 && backend.connectedPolls == 2 * 99, "Connected pads polled once per frame");
+    time = std::max(time, IWindow::GetTimeNs());
+    ok &= Check(gamepads[0].IsButtonDown(IWindow::GamepadButton::A) && gamepads[1].IsButtonUp(IWindow::GamepadButton::A), "Gamepads read their own slot");
+
+    // A minute at 60 frames per second, on the manager's clock.
+    backend.ResetCounts();
+    for (uint32_t frame = 0; frame < FRAMES; frame++) manager.Update(time += FRAME_NS);
+    const MockBackend managed = backend;
+
+    backend.ResetCounts();
+    for (uint32_t frame = 0; frame < FRAMES; frame++)
+        for (uint32_t i = 0; i < SLOTS; i++) LegacyUpdate(backend, (IWindow::GamepadID)i);
+    const MockBackend legacy = backend;
+
+    // 250 ms, 500 ms, 1 s and then every 2 s.
+    ok &= Check(managed.polls[2] <= 35 && managed.polls[3] <= 35, "Empty slots back off");
+
+    // Without a notification a new pad is found within the longest backoff.
+    changes.clear();
+    backend.connected[2] = true;
+    uint32_t frames = 0;
+    while (!manager.IsConnected(IWindow::GamepadID::GP2) && frames < 1000) {
+        manager.Update(time += FRAME_NS);
+        frames++;
+    }
+    ok &= Check(frames <= 2'000'000'000 / FRAME_NS + 1, "New pad found within the longest backoff");
+
+    // With one it is found right away.
+    backend.connected[3] = true;
+    manager.ResetProbeBackoff();
+    manager.Update(time += FRAME_NS);
+    ok &= Check(manager.IsConnected(IWindow::GamepadID::GP3), "New pad found after ResetProbeBackoff");
+
+    // Pulling a pad out is noticed on the next update.
+    backend.connected[1] = false;
+    manager.Update(time += FRAME_NS);
+    ok &= Check(!manager.IsConnected(IWindow::GamepadID::GP1) && changes.size() == 3 && !changes[2].second, "Disconnect reported");
+
+    // The cost of an update without the driver.
+    backend.connected = { true, true, true, true };
+    manager.ResetProbeBackoff();
+    for (uint32_t i = 0; i < SLOTS; i++) manager.Update(time += FRAME_NS);
+    constexpr uint32_t CALLS = 1'000'000;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < CALLS; i++) manager.Update(time += FRAME_NS);
+    const double updateNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / CALLS;
+
+    std::cout << "Four gamepads, two connected, " << FRAMES << " frames\n"
+        << "    Every slot every update: " << (double)(legacy.connectedPolls + legacy.emptyPolls) / FRAMES << " driver calls, " 
+        << (double)legacy.costNs / FRAMES / 1'000'000.0 << " ms per frame\n"
+        << "    GamepadManager:          " << (double)(managed.connectedPolls + managed.emptyPolls) / FRAMES << " driver calls, " 
+        << (double)managed.costNs / FRAMES / 1'000'000.0 << " ms per frame, " << managed.emptyPolls << " probes of empty slots\n"
+        << "GamepadManager::Update with four pads: " << updateNs << " ns without the driver\n";
+    std::cout << (ok ? "OK" : "FAILED") << '\n';
+
+    manager.SetBackend(nullptr);
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
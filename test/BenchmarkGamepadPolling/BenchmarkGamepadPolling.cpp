@@ -0,0 +1,171 @@
+#include "IWindow.h"
+#include "IWindowGamepad.h"
+#include "IWindowEvdevGamepad.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <linux/input.h>
+#include <unistd.h>
+
+// Taps A for 5 milliseconds in every 16 millisecond frame of a pad replayed through a pipe, and counts the taps the button callback hears
+// when the gamepads are read once per frame and when IWindow::GamepadManager reads them on its polling thread at 1000 Hz.
+// Prints how long a press takes to be read, from the timestamps of the samples, and checks that
+// GamepadManager::GetLatestSample never returns half of one reading while the polling thread writes it.
+// Linux only.
+
+constexpr uint32_t FRAMES = 60;
+constexpr std::chrono::milliseconds FRAME_TIME{ 16 };
+constexpr std::chrono::milliseconds TAP_TIME{ 5 };
+
+struct Result {
+    uint32_t taps;
+    std::vector<uint64_t> latenciesNs;
+};
+
+static void Write(int fd, std::initializer_list<input_event> events) { (void)!write(fd, events.begin(), events.size() * sizeof(input_event)); }
+
+static input_event Event(uint16_t type, uint16_t code, int32_t value) {
+    input_event event{};
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    return event;
+}
+
+static std::array<IWindow::EvdevAxisRange, IWindow::EvdevGamepad::AXIS_COUNT> Axes() {
+    std::array<IWindow::EvdevAxisRange, IWindow::EvdevGamepad::AXIS_COUNT> axes{};
+    for (uint16_t axis : { ABS_X, ABS_Y, ABS_RX, ABS_RY }) axes[axis] = { -32768, 32767 };
+    return axes;
+}
+
+static Result Tap(int fd, bool pollingThread) {
+    IWindow::GamepadManager& manager = IWindow::GamepadManager::Get();
+    if (pollingThread) manager.StartPollingThread({ 1000.0 });
+
+    Result result{};
+    manager.SetButtonCallback([&](IWindow::GamepadID, IWindow::GamepadButton button, IWindow::InputState state) {
+        result.taps += button == IWindow::GamepadButton::A && state == IWindow::InputState::Down;
+    });
+
+    IWindow::Gamepad gamepad{ IWindow::GamepadID::GP0 };
+    gamepad.Update();
+
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const uint64_t frameNs = IWindow::GetTimeNs();
+
+        // The game reads the pad at the start of the frame, the player taps in the middle of it.
+        std::this_thread::sleep_for(TAP_TIME / 2);
+        const uint64_t pressNs = IWindow::GetTimeNs();
+        Write(fd, { Event(EV_KEY, BTN_A, 1), Event(EV_SYN, SYN_REPORT, 0) });
+        std::this_thread::sleep_for(TAP_TIME);
+        Write(fd, { Event(EV_KEY, BTN_A, 0), Event(EV_SYN, SYN_REPORT, 0) });
+
+        std::this_thread::sleep_until(start + FRAME_TIME);
+        gamepad.Update();
+
+        IWindow::GamepadSample samples[16];
+        const size_t count = manager.GetHistory(IWindow::GamepadID::GP0, frameNs, samples, 16);
+        for (size_t i = 0; i < count; i++) {
+            if (!(samples[i].state.Gamepad.wButtons & (uint16_t)IWindow::GamepadButton::A)) continue;
+            result.latenciesNs.push_back(samples[i].timestamp - pressNs);
+            break;
+        }
+    }
+
+    manager.SetButtonCallback({});
+    if (pollingThread) manager.StopPollingThread();
+
+    std::sort(result.latenciesNs.begin(), result.latenciesNs.end());
+    return result;
+}
+
+// Moves both sticks to the same place as fast as the pipe takes it while another thread reads the newest sample.
+static bool CheckTornReads(int fd, uint64_t& reads) {
+    IWindow::GamepadManager& manager = IWindow::GamepadManager::Get();
+    manager.StartPollingThread({ 4000.0 });
+
+    std::atomic<bool> done{ false };
+    bool torn = false;
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            const IWindow::GamepadSample sample = manager.GetLatestSample(IWindow::GamepadID::GP0);
+            torn |= sample.state.Gamepad.sThumbLX != sample.state.Gamepad.sThumbRX;
+            reads++;
+        }
+    });
+
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    for (int32_t value = 0; std::chrono::steady_clock::now() < end; value = (value + 97) % 32767) {
+        Write(fd, { Event(EV_ABS, ABS_X, value), Event(EV_ABS, ABS_RX, value), Event(EV_SYN, SYN_REPORT, 0) });
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        manager.Update();
+    }
+
+    done = true;
+    reader.join();
+    manager.StopPollingThread();
+
+    return !torn;
+}
+
+static void Print(const char* name, const Result& result) {
+    std::cout << "    " << name << result.taps << " of " << FRAMES << " taps";
+    if (!result.latenciesNs.empty()) {
+        std::cout << ", press read after median " << (double)result.latenciesNs[result.latenciesNs.size() / 2] / 1'000.0
+            << " us, max " << (double)result.latenciesNs.back() / 1'000.0 << " us";
+    }
+    std::cout << '\n';
+}
+
+int main() {
+    IWindow::GamepadManager& manager = IWindow::GamepadManager::Get();
+
+    // An empty directory, so only the replayed pad is there.
+    char directory[] = "/tmp/iwindow-polling-XXXXXX";
+    if (!mkdtemp(directory)) return EXIT_FAILURE;
+
+    IWindow::EvdevGamepadBackend backend{ directory };
+    manager.SetBackend(&backend);
+
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) return EXIT_FAILURE;
+
+    IWindow::EvdevGamepad replayed{};
+    replayed.Attach(pipeFds[0], Axes(), "Replayed taps");
+    backend.AddGamepad(std::move(replayed));
+
+    const Result perFrame = Tap(pipeFds[1], false);
+    const Result polled = Tap(pipeFds[1], true);
+
+    uint64_t reads = 0;
+    const bool whole = CheckTornReads(pipeFds[1], reads);
+
+    std::cout << FRAMES << " frames of " << FRAME_TIME.count() << " ms, one " << TAP_TIME.count() << " ms tap each\n";
+    Print("Read per frame:         ", perFrame);
+    Print("Polling thread 1000 Hz: ", polled);
+    std::cout << "    " << reads << " reads of the newest sample while it was written\n";
+
+    close(pipeFds[1]);
+    manager.SetBackend(nullptr);
+    rmdir(directory);
+
+    bool ok = true;
+    if (polled.taps < FRAMES * 8 / 10) {
+        std::cout << "FAILED: the polling thread missed taps\n";
+        ok = false;
+    }
+    if (!whole) {
+        std::cout << "FAILED: GetLatestSample returned a torn sample\n";
+        ok = false;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
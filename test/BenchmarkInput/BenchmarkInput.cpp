@@ -0,0 +1,111 @@
+#include "IWindow.h"
+#include "IWindowNull.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Micro-benchmark of reading the keyboard every frame: IsKeyDown and IsKeyJustPressed for every key, ForEachChangedKey,
+// and the std::vector<bool> keys the window used to have. Also checks the edges the queries report.
+// Build with optimizations. Uses the null backend so it runs anywhere.
+
+template<typename F>
+static double Measure(uint64_t iterations, F&& body) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < iterations; i++) body(i);
+
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return ns / (double)iterations;
+}
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+int main() {
+    constexpr uint64_t FRAMES = 1'000'000;
+    constexpr uint64_t KEY_COUNT = (uint64_t)IWindow::Key::Max;
+
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow input benchmark")) return EXIT_FAILURE;
+    window.Update();
+
+    bool ok = true;
+
+    // Edges are relative to the previous update, not to key repeat.
+    IWindow::Null::PushKeyEvent(window, IWindow::Key::A, IWindow::InputState::Down);
+    IWindow::Null::PushMouseButtonEvent(window, IWindow::MouseButton::Left, IWindow::InputState::Down);
+    window.Update();
+    ok &= Check(window.IsKeyJustPressed(IWindow::Key::A), "A just pressed");
+    ok &= Check(window.IsMouseButtonJustPressed(IWindow::MouseButton::Left), "Left just pressed");
+
+    IWindow::Null::PushKeyEvent(window, IWindow::Key::A, IWindow::InputState::Down);
+    window.Update();
+    ok &= Check(window.IsKeyDown(IWindow::Key::A) && !window.IsKeyJustPressed(IWindow::Key::A), "A repeat is not a press");
+
+    IWindow::Null::PushKeyEvent(window, IWindow::Key::A, IWindow::InputState::Up);
+    IWindow::Null::PushMouseButtonEvent(window, IWindow::MouseButton::Left, IWindow::InputState::Up);
+    window.Update();
+    ok &= Check(window.IsKeyJustReleased(IWindow::Key::A), "A just released");
+    ok &= Check(!window.IsMouseButtonDown(IWindow::MouseButton::Left), "Left up after release");
+    ok &= Check(window.IsMouseButtonJustReleased(IWindow::MouseButton::Left), "Left just released");
+
+    uint64_t changed = 0;
+    window.ForEachChangedKey([&](IWindow::Key key, bool down) { changed += key == IWindow::Key::A && !down; });
+    ok &= Check(changed == 1, "ForEachChangedKey reports A");
+
+    window.Update();
+    ok &= Check(!window.IsKeyJustReleased(IWindow::Key::A), "Release lasts one update");
+
+    // A few keys held so the loops have something to find.
+    for (IWindow::Key key : { IWindow::Key::W, IWindow::Key::LShift, IWindow::Key::Space })
+        IWindow::Null::PushKeyEvent(window, key, IWindow::InputState::Down);
+    window.Update();
+
+    uint64_t sum = 0;
+
+    const double downAll = Measure(FRAMES, [&](uint64_t) {
+        for (uint64_t key = 0; key < KEY_COUNT; key++) sum += window.IsKeyDown((IWindow::Key)key);
+    });
+
+    const double justPressedAll = Measure(FRAMES, [&](uint64_t) {
+        for (uint64_t key = 0; key < KEY_COUNT; key++) sum += window.IsKeyJustPressed((IWindow::Key)key);
+    });
+
+    const double changedKeys = Measure(FRAMES, [&](uint64_t) {
+        window.ForEachChangedKey([&](IWindow::Key key, bool down) { sum += (uint64_t)key + down; });
+    });
+
+    // What IsKeyDown and IsKeyJustPressed read before the bitsets.
+    std::vector<bool> keys((size_t)KEY_COUNT), keysPressedOnce((size_t)KEY_COUNT);
+    keys[(size_t)IWindow::Key::W] = true;
+    keysPressedOnce[(size_t)IWindow::Key::W] = true;
+    std::vector<bool>* volatile keysTarget = &keys;
+    std::vector<bool>* volatile keysPressedOnceTarget = &keysPressedOnce;
+
+    const double vectorAll = Measure(FRAMES, [&](uint64_t) {
+        const std::vector<bool>& down = *keysTarget;
+        const std::vector<bool>& pressed = *keysPressedOnceTarget;
+        for (uint64_t key = 0; key < KEY_COUNT; key++) sum += down[key] && pressed[key];
+    });
+
+    std::cout << "Query all " << KEY_COUNT << " keys per frame\n"
+        << "    IsKeyDown:               " << downAll << " ns\n"
+        << "    IsKeyJustPressed:        " << justPressedAll << " ns\n"
+        << "    ForEachChangedKey:       " << changedKeys << " ns\n"
+        << "    std::vector<bool> down && pressed: " << vectorAll << " ns\n";
+
+    // Keeps the sums alive.
+    std::cout << "Checksum: " << sum << '\n';
+
+    window.Destroy();
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
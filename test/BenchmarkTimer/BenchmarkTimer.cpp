@@ -0,0 +1,89 @@
+#include "IWindow.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+// Micro-benchmark of reading the time: IWindow::GetTimeNs and IWindow::GetTimerValue from the OS clock and from the time stamp counter,
+// Window::GetTime and the std::chrono clocks. Also checks that every clock only goes forward.
+// Build with optimizations. Uses the null backend so it runs anywhere.
+
+constexpr uint64_t CALLS = 10'000'000;
+
+// Reads a clock CALLS times. The reads depend on each other through sum, so the compiler can't drop or merge them.
+template<typename F>
+static double Measure(F&& read, bool& monotonic, uint64_t& sum) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    uint64_t previous = read();
+    for (uint64_t i = 0; i < CALLS; i++) {
+        const uint64_t now = read();
+        monotonic &= now >= previous;
+        sum += now - previous;
+        previous = now;
+    }
+
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / (double)CALLS;
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow timer benchmark")) return EXIT_FAILURE;
+
+    bool monotonic = true;
+    uint64_t sum = 0;
+
+    const uint64_t osFrequency = IWindow::GetTimerFrequency();
+    const double osTimeNs = Measure([] { return IWindow::GetTimeNs(); }, monotonic, sum);
+    const double osValue = Measure([] { return IWindow::GetTimerValue(); }, monotonic, sum);
+
+    const double windowTime = Measure([&] { return (uint64_t)(window.GetTime() * 1'000'000.0); }, monotonic, sum);
+    const double steadyClock = Measure([] { return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count(); }, monotonic, sum);
+    const double highResolutionClock = Measure([] { return (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count(); }, monotonic, sum);
+
+    std::cout << "Per call, OS clock at " << osFrequency << " Hz\n"
+        << "    IWindow::GetTimeNs:                " << osTimeNs << " ns\n"
+        << "    IWindow::GetTimerValue:            " << osValue << " ns\n"
+        << "    Window::GetTime:                   " << windowTime << " ns\n"
+        << "    std::chrono::steady_clock:         " << steadyClock << " ns\n"
+        << "    std::chrono::high_resolution_clock: " << highResolutionClock << " ns\n";
+
+    if (IWindow::UseTscTimer(true)) {
+        // The calibration is checked against the OS clock over at least 100 milliseconds.
+        const uint64_t tscStart = IWindow::GetTimeNs();
+        const std::chrono::steady_clock::time_point steadyStart = std::chrono::steady_clock::now();
+
+        const double tscTimeNs = Measure([] { return IWindow::GetTimeNs(); }, monotonic, sum);
+        const double tscValue = Measure([] { return IWindow::GetTimerValue(); }, monotonic, sum);
+
+        while (std::chrono::steady_clock::now() - steadyStart < std::chrono::milliseconds(100));
+        const double tscElapsed = (double)(IWindow::GetTimeNs() - tscStart);
+        const double steadyElapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - steadyStart).count();
+
+        std::cout << "Time stamp counter at " << IWindow::GetTimerFrequency() << " Hz\n"
+            << "    IWindow::GetTimeNs:                " << tscTimeNs << " ns\n"
+            << "    IWindow::GetTimerValue:            " << tscValue << " ns\n"
+            << "    Drift from the OS clock:           " << (tscElapsed - steadyElapsed) / steadyElapsed * 1'000'000.0 << " ppm\n";
+
+        // The switch is one way. Neither call may move the clock back.
+        const uint64_t before = IWindow::GetTimeNs();
+        const bool stays = IWindow::UseTscTimer(true) && IWindow::UseTscTimer(false);
+        monotonic &= stays && IWindow::GetTimeNs() >= before;
+        if (!stays) std::cout << "FAILED: IWindow::UseTscTimer left the time stamp counter\n";
+    }
+    else {
+        std::cout << "No invariant time stamp counter.\n";
+    }
+
+    // Keeps the sums alive.
+    std::cout << "Checksum: " << sum << '\n';
+    if (!monotonic) std::cout << "FAILED: a clock went backwards\n";
+
+    window.Destroy();
+    IWindow::Shutdown();
+
+    return monotonic ? EXIT_SUCCESS : EXIT_FAILURE;
+}
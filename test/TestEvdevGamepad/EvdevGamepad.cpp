@@ -0,0 +1,278 @@
+#include "IWindow.h"
+#include "IWindowGamepad.h"
+#include "IWindowEvdevGamepad.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Reads gamepads through IWindow::EvdevGamepadBackend and checks the buttons, sticks, triggers and hot-plug.
+// With /dev/uinput (run as root) it makes a virtual Xbox 360 pad and finds it in /dev/input through inotify.
+// Without it, it replays a capture through a pipe: the recording built in below, or a file of raw input_events 
+// given as the first argument, e.g. from cat /dev/input/eventN > capture.bin, read with the axis ranges of an Xbox One pad.
+// Linux only.
+
+struct CaptureEvent {
+    uint16_t type, code;
+    int32_t value;
+};
+
+// Pressing A, pushing the left stick to the top right, pulling the left trigger with the d-pad held left, then letting go.
+static const std::vector<CaptureEvent> RECORDING = {
+    { EV_KEY, BTN_A, 1 }, { EV_SYN, SYN_REPORT, 0 },
+    { EV_ABS, ABS_X, 32767 }, { EV_ABS, ABS_Y, -32768 }, { EV_SYN, SYN_REPORT, 0 },
+    { EV_ABS, ABS_Z, 1023 }, { EV_ABS, ABS_HAT0X, -1 }, { EV_SYN, SYN_REPORT, 0 },
+};
+
+static const std::vector<CaptureEvent> RELEASE = {
+    { EV_KEY, BTN_A, 0 }, { EV_ABS, ABS_X, 0 }, { EV_ABS, ABS_Y, 0 }, { EV_ABS, ABS_Z, 0 }, { EV_ABS, ABS_HAT0X, 0 }, { EV_SYN, SYN_REPORT, 0 },
+};
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+static bool Near(float value, float expected) { return std::fabs(value - expected) < 0.01f; }
+
+static std::array<IWindow::EvdevAxisRange, IWindow::EvdevGamepad::AXIS_COUNT> XboxOneAxes() {
+    std::array<IWindow::EvdevAxisRange, IWindow::EvdevGamepad::AXIS_COUNT> axes{};
+    for (uint16_t axis : { ABS_X, ABS_Y, ABS_RX, ABS_RY }) axes[axis] = { -32768, 32767 };
+    for (uint16_t axis : { ABS_Z, ABS_RZ }) axes[axis] = { 0, 1023 };
+    for (uint16_t axis : { ABS_HAT0X, ABS_HAT0Y }) axes[axis] = { -1, 1 };
+    return axes;
+}
+
+static void Write(int fd, const std::vector<CaptureEvent>& capture) {
+    std::vector<input_event> events{};
+    for (const CaptureEvent& event : capture) {
+        input_event raw{};
+        raw.type = event.type;
+        raw.code = event.code;
+        raw.value = event.value;
+        events.push_back(raw);
+    }
+
+    (void)!write(fd, events.data(), events.size() * sizeof(input_event));
+}
+
+// Updates until done returns true or a few seconds passed. udev makes the node and gives it its permissions asynchronously.
+template<typename F>
+static bool UpdateUntil(IWindow::Gamepad& gamepad, F&& done) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+        gamepad.Update();
+        if (done()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+// What the built-in recording leaves the pad at.
+static bool CheckRecording(IWindow::Gamepad& gamepad) {
+    bool ok = true;
+    ok &= Check(gamepad.IsButtonDown(IWindow::GamepadButton::A, IWindow::GamepadButton::DpadLeft), "A and left held");
+    ok &= Check(Near(gamepad.LeftStickX(), 1.0f) && Near(gamepad.LeftStickY(), 1.0f), "Left stick at the top right");
+    ok &= Check(Near(gamepad.LeftTrigger(), 1.0f) && gamepad.RightTrigger() == 0.0f, "Left trigger pulled");
+    return ok;
+}
+
+static bool TestReplay(const char* capturePath) {
+    IWindow::GamepadManager& manager = IWindow::GamepadManager::Get();
+
+    // An empty directory, so only the replayed pad is there.
+    char directory[] = "/tmp/iwindow-evdev-XXXXXX";
+    if (!mkdtemp(directory)) return Check(false, "Temporary directory");
+
+    IWindow::EvdevGamepadBackend backend{ directory };
+    manager.SetBackend(&backend);
+
+    std::vector<std::pair<IWindow::GamepadID, bool>> changes{};
+    manager.SetConnectedCallback([&](IWindow::GamepadID gid, bool connected) { changes.push_back({ gid, connected }); });
+
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) return Check(false, "Pipe");
+
+    IWindow::EvdevGamepad replayed{};
+    replayed.Attach(pipeFds[0], XboxOneAxes(), "Replayed capture");
+    backend.AddGamepad(std::move(replayed));
+
+    bool ok = Check(backend.HasDeviceNotifications(), "inotify watches the directory");
+
+    IWindow::Gamepad gamepad{ IWindow::GamepadID::GP0 };
+    gamepad.Update();
+    ok &= Check(gamepad.IsConnected() && changes.size() == 1 && changes[0].second, "Replayed pad connected");
+
+    if (capturePath) {
+        // A recorded capture, printed as it was left.
+        FILE* file = std::fopen(capturePath, "rb");
+        input_event events[64];
+        size_t count = 0, total = 0;
+        while (file && (count = std::fread(events, sizeof(input_event), 64, file))) {
+            (void)!write(pipeFds[1], events, count * sizeof(input_event));
+            total += count;
+            gamepad.Update();
+        }
+        if (file) std::fclose(file);
+
+        std::cout << "Replayed " << total << " events: buttons " << std::hex << gamepad.GetState().Gamepad.wButtons << std::dec
+            << ", left stick " << gamepad.LeftStickX() << " " << gamepad.LeftStickY() << ", right stick " << gamepad.RightStickX() << " " << gamepad.RightStickY()
+            << ", triggers " << gamepad.LeftTrigger() << " " << gamepad.RightTrigger() << '\n';
+    }
+    else {
+        Write(pipeFds[1], RECORDING);
+        gamepad.Update();
+        ok &= CheckRecording(gamepad);
+        ok &= Check(gamepad.GetState().dwPacketNumber == 3, "One packet per SYN_REPORT");
+
+        // Nothing shows before its SYN_REPORT.
+        Write(pipeFds[1], { { EV_ABS, ABS_RX, 16384 } });
+        gamepad.Update();
+        ok &= Check(gamepad.RightStickX() == 0.0f, "Incomplete report not applied");
+        Write(pipeFds[1], { { EV_SYN, SYN_REPORT, 0 } });
+        gamepad.Update();
+        ok &= Check(Near(gamepad.RightStickX(), 0.5f), "Report applied");
+
+        // Events dropped by the kernel are skipped up to the next report.
+        Write(pipeFds[1], { { EV_SYN, SYN_DROPPED, 0 }, { EV_KEY, BTN_B, 1 }, { EV_SYN, SYN_REPORT, 0 } });
+        gamepad.Update();
+        ok &= Check(gamepad.IsButtonUp(IWindow::GamepadButton::B), "Dropped events skipped");
+
+        Write(pipeFds[1], RELEASE);
+        gamepad.Update();
+        ok &= Check(gamepad.IsButtonUp(IWindow::GamepadButton::A) && gamepad.LeftStickX() == 0.0f && gamepad.LeftTrigger() == 0.0f, "Released");
+
+        // A thousand reports arrive between two frames and are read in batches.
+        std::vector<CaptureEvent> burst{};
+        for (int32_t i = 0; i < 1000; i++) {
+            burst.push_back({ EV_ABS, ABS_RY, -i * 32 });
+            burst.push_back({ EV_SYN, SYN_REPORT, 0 });
+        }
+        Write(pipeFds[1], burst);
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        gamepad.Update();
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / (double)burst.size();
+        ok &= Check(Near(gamepad.RightStickY(), 999.0f * 32.0f / 32767.0f), "Burst read to the last report");
+        std::cout << "Read " << burst.size() << " events in one update, " << ns << " ns per event\n";
+
+        // Nodes that aren't gamepads are ignored.
+        const std::string notAGamepad = std::string(directory) + "/event7";
+        close(open(notAGamepad.c_str(), O_CREAT | O_WRONLY, 0600));
+        gamepad.Update();
+        ok &= Check(changes.size() == 1, "Other event nodes ignored");
+        unlink(notAGamepad.c_str());
+    }
+
+    // The end of the capture unplugs the pad.
+    close(pipeFds[1]);
+    gamepad.Update();
+    gamepad.Update();
+    ok &= Check(!gamepad.IsConnected() && changes.size() == 2 && !changes[1].second, "Replayed pad disconnected");
+
+    manager.SetBackend(nullptr);
+    rmdir(directory);
+
+    return ok;
+}
+
+static int CreateVirtualPad() {
+    const int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+    if (fd < 0) return -1;
+
+    ioctl(fd, UI_SET_EVBIT, EV_KEY);
+    ioctl(fd, UI_SET_EVBIT, EV_ABS);
+    for (int key : { BTN_A, BTN_B, BTN_X, BTN_Y, BTN_TL, BTN_TR, BTN_SELECT, BTN_START, BTN_MODE, BTN_THUMBL, BTN_THUMBR }) ioctl(fd, UI_SET_KEYBIT, key);
+
+    const std::array<IWindow::EvdevAxisRange, IWindow::EvdevGamepad::AXIS_COUNT> axes = XboxOneAxes();
+    for (uint16_t code = 0; code < IWindow::EvdevGamepad::AXIS_COUNT; code++) {
+        if (axes[code].minimum == axes[code].maximum) continue;
+
+        ioctl(fd, UI_SET_ABSBIT, code);
+        uinput_abs_setup abs{};
+        abs.code = code;
+        abs.absinfo.minimum = axes[code].minimum;
+        abs.absinfo.maximum = axes[code].maximum;
+        ioctl(fd, UI_ABS_SETUP, &abs);
+    }
+
+    uinput_setup setup{};
+    setup.id.bustype = BUS_USB;
+    setup.id.vendor = 0x045e;
+    setup.id.product = 0x028e;
+    std::snprintf(setup.name, sizeof(setup.name), "IWindow virtual gamepad");
+
+    if (ioctl(fd, UI_DEV_SETUP, &setup) < 0 || ioctl(fd, UI_DEV_CREATE) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static bool TestUinput(int uinput) {
+    IWindow::GamepadManager& manager = IWindow::GamepadManager::Get();
+
+    // Pads that were already plugged in take the first slots.
+    std::vector<IWindow::Gamepad> gamepads{};
+    for (uint32_t i = 0; i < (uint32_t)IWindow::GamepadID::Max; i++) gamepads.emplace_back((IWindow::GamepadID)i);
+
+    IWindow::EvdevGamepadBackend& backend = static_cast<IWindow::EvdevGamepadBackend&>(manager.GetBackend());
+    IWindow::Gamepad* virtualPad = nullptr;
+    const auto find = [&] {
+        for (IWindow::Gamepad& gamepad : gamepads) {
+            gamepad.Update();
+            if (gamepad.IsConnected() && backend.GetGamepad(gamepad.GetID()).GetName() == "IWindow virtual gamepad") virtualPad = &gamepad;
+        }
+        return virtualPad != nullptr;
+    };
+
+    bool ok = Check(UpdateUntil(gamepads[0], find), "Virtual pad found through inotify");
+    if (!virtualPad) return false;
+
+    Write(uinput, RECORDING);
+    ok &= Check(UpdateUntil(*virtualPad, [&] { return virtualPad->IsButtonDown(IWindow::GamepadButton::DpadLeft); }), "Virtual pad input arrived");
+    ok &= CheckRecording(*virtualPad);
+
+    ioctl(uinput, UI_DEV_DESTROY);
+    close(uinput);
+    ok &= Check(UpdateUntil(*virtualPad, [&] { return !virtualPad->IsConnected(); }), "Virtual pad unplugged");
+
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    bool ok = true;
+
+    const int uinput = CreateVirtualPad();
+    if (uinput >= 0) {
+        IWindow::EvdevGamepadBackend backend{};
+        IWindow::GamepadManager::Get().SetBackend(&backend);
+        ok &= TestUinput(uinput);
+        IWindow::GamepadManager::Get().SetBackend(nullptr);
+    }
+    else {
+        std::cout << "No /dev/uinput, only replaying\n";
+    }
+
+    ok &= TestReplay(argc > 1 ? argv[1] : nullptr);
+
+    std::cout << (ok ? "OK" : "FAILED") << '\n';
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,55 @@
+#include "IWindow.h"
+#include "IWindowNull.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// Checks that Window::CaptureInputSnapshot holds the input of one update and that a copy can be read on another thread
+// while the window updates. Uses the null backend so it runs anywhere.
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow input snapshot test")) return EXIT_FAILURE;
+    window.Update();
+
+    bool ok = true;
+
+    // A snapshot sums up every scroll event of the update and doesn't change with later updates.
+    IWindow::Null::PushMouseScrollEvent(window, { 0.0f, 1.0f });
+    IWindow::Null::PushMouseScrollEvent(window, { 0.0f, 2.0f });
+    IWindow::Null::PushKeyEvent(window, IWindow::Key::W, IWindow::InputState::Down);
+    IWindow::Null::PushMouseButtonEvent(window, IWindow::MouseButton::Left, IWindow::InputState::Down);
+    window.Update();
+    const IWindow::InputSnapshot snapshot = window.CaptureInputSnapshot();
+
+    // The worker reads its copy while the window releases the key.
+    bool workerSawInput = false;
+    std::thread worker([&workerSawInput, copy = snapshot] {
+        workerSawInput = copy.keys.Test((size_t)IWindow::Key::W) && copy.mouseButtons.Test((size_t)IWindow::MouseButton::Left) && copy.scrollDelta.y == 3.0f;
+    });
+
+    IWindow::Null::PushKeyEvent(window, IWindow::Key::W, IWindow::InputState::Up);
+    window.Update();
+    worker.join();
+
+    ok &= Check(snapshot.scrollDelta.y == 3.0f && snapshot.scrollOffset.y == 2.0f, "Snapshot scroll delta is the sum of the update");
+    ok &= Check(workerSawInput, "Worker reads the input of the captured update");
+    ok &= Check(!window.IsKeyDown(IWindow::Key::W) && snapshot.keys.Test((size_t)IWindow::Key::W), "Snapshot keeps the keys of its update");
+    ok &= Check(window.GetMouseScrollDelta().y == 0.0f && window.CaptureInputSnapshot().frame == snapshot.frame + 1, "Next update starts a new frame");
+
+    std::cout << (ok ? "OK" : "FAILED") << '\n';
+
+    window.Destroy();
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
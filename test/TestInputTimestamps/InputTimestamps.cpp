@@ -0,0 +1,70 @@
+#include "IWindow.h"
+#include "IWindowNull.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// Checks that events carry the time they happened, not the time the update read them, both in the event queue and
+// through Window::GetEventTimestamp inside a callback. Uses the null backend so it runs anywhere.
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+// Skips the other events the window queued, e.g. focus and size.
+static bool PollKeyEvent(IWindow::Window& window, IWindow::Event& event) {
+    while (window.PollEvent(event))
+        if (event.type == IWindow::EventType::Key) return true;
+
+    return false;
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow input timestamp test")) return EXIT_FAILURE;
+    window.SetEventQueueCapacity(16);
+    window.Update();
+
+    bool ok = true;
+
+    // A timestamp set by the backend is passed on unchanged.
+    IWindow::Null::Event timedKey{};
+    timedKey.type = IWindow::Null::EventType::Key;
+    timedKey.key = IWindow::Key::B;
+    timedKey.state = IWindow::InputState::Down;
+    timedKey.timestamp = 1234;
+    IWindow::Null::PushEvent(window, timedKey);
+
+    uint64_t callbackTimestamp = 0;
+    window.SetKeyCallback([&](IWindow::Window& w, IWindow::Key, IWindow::KeyModifier, IWindow::InputState, bool) { callbackTimestamp = w.GetEventTimestamp(); });
+    window.Update();
+
+    IWindow::Event event{};
+    ok &= Check(PollKeyEvent(window, event) && event.timestamp == 1234, "Queued event keeps its timestamp");
+    ok &= Check(callbackTimestamp == 1234, "GetEventTimestamp inside the callback");
+    ok &= Check(window.GetEventTimestamp() == 0, "GetEventTimestamp outside a callback");
+
+    // An event read 20 ms after it happened still has the time it happened.
+    const uint64_t beforePush = (uint64_t)(window.GetTime() * 1'000'000.0);
+    IWindow::Null::PushKeyEvent(window, IWindow::Key::B, IWindow::InputState::Up);
+    const uint64_t afterPush = (uint64_t)(window.GetTime() * 1'000'000.0) + 1;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    window.Update();
+
+    ok &= Check(PollKeyEvent(window, event) && event.timestamp >= beforePush && event.timestamp <= afterPush, "Event has the time of the push, not of the update");
+    ok &= Check(callbackTimestamp == event.timestamp, "Callback and queue see the same timestamp");
+
+    std::cout << (ok ? "OK" : "FAILED") << '\n';
+
+    window.SetKeyCallback(nullptr);
+    window.Destroy();
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+#include "IWindow.h"
+#include "IWindowNull.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// Checks the input-to-present latency histogram headless: frames are presented with IWindow::Null::PresentFramebuffer
+// and their input is pushed with IWindow::Null::PushEvent. Uses the null backend so it runs anywhere, e.g. in CI.
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+// Pushes a key press that happened ageMs before now, i.e. ageMs before the frame reads it.
+static void PushOldKey(IWindow::Window& window, IWindow::Key key, double ageMs) {
+    IWindow::Null::Event event{};
+    event.type = IWindow::Null::EventType::Key;
+    event.key = key;
+    event.state = IWindow::InputState::Down;
+    event.timestamp = (uint64_t)((window.GetTime() - ageMs) * 1'000'000.0);
+    IWindow::Null::PushEvent(window, event);
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow latency test")) return EXIT_FAILURE;
+
+    bool ok = true;
+
+    ok &= Check(IWindow::LatencyStats::BucketOf(0.0) == 0 && IWindow::LatencyStats::BucketOf(0.125) == 4 && IWindow::LatencyStats::BucketOf(1e9) == IWindow::LatencyStats::BUCKET_COUNT - 1, "Bucket bounds");
+
+    // Let the clock run past the ages pushed below.
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    window.Update();
+    IWindow::Null::PresentFramebuffer(window);
+    window.ResetLatencyStats();
+
+    // Frames without input don't count.
+    window.Update();
+    IWindow::Null::PresentFramebuffer(window);
+    ok &= Check(window.GetLatencyStats().count == 0, "Frame without input is not counted");
+
+    // A frame's latency runs from its oldest input to its present.
+    PushOldKey(window, IWindow::Key::A, 40.0);
+    PushOldKey(window, IWindow::Key::B, 10.0);
+    window.Update();
+    IWindow::Null::PresentFramebuffer(window);
+    IWindow::LatencyStats latency = window.GetLatencyStats();
+    ok &= Check(latency.count == 1 && latency.minMs >= 40.0 && latency.maxMs < 1000.0, "Latency from the oldest input of the frame");
+
+    // Input is only counted for the first present after it.
+    IWindow::Null::PresentFramebuffer(window);
+    ok &= Check(window.GetLatencyStats().count == 1, "Second present without input is not counted");
+
+    for (double ageMs : { 2.0, 4.0, 8.0, 16.0 }) {
+        PushOldKey(window, IWindow::Key::C, ageMs);
+        window.Update();
+        IWindow::Null::PresentFramebuffer(window);
+    }
+
+    latency = window.GetLatencyStats();
+    ok &= Check(latency.count == 5 && latency.minMs >= 2.0 && latency.minMs < 40.0, "Every presented frame with input is counted");
+    ok &= Check(latency.GetMeanMs() >= latency.minMs && latency.GetMeanMs() <= latency.maxMs, "Mean between min and max");
+    ok &= Check(latency.GetPercentileMs(0.5) >= 8.0 && latency.GetPercentileMs(0.5) < 40.0 && latency.GetPercentileMs(1.0) == latency.maxMs, "Percentiles");
+
+    uint64_t bucketTotal = 0;
+    for (uint64_t bucket : latency.buckets) bucketTotal += bucket;
+    ok &= Check(bucketTotal == latency.count, "Every frame is in one bucket");
+
+    window.ResetLatencyStats();
+    ok &= Check(window.GetLatencyStats().count == 0 && window.GetLatencyStats().GetPercentileMs(0.99) == 0.0, "Reset clears the histogram");
+
+    std::cout << (ok ? "OK" : "FAILED") << '\n';
+
+    window.Destroy();
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
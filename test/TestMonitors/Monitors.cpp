@@ -0,0 +1,156 @@
+#include "IWindow.h"
+
+#if defined(IWINDOW_NULL)
+#include "IWindowNull.h"
+#else
+#include <xcb/xcb.h>
+#include <xcb/randr.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Connects and disconnects monitors and checks that the monitor callback reports exactly the monitors that changed, by identity.
+// With the null backend the monitors are swapped with IWindow::Null::SetMonitors.
+// With XCB virtual RandR 1.5 monitors are added and removed on the X server, so run it on an X server without a user, e.g. xvfb-run.
+
+struct MonitorChange {
+    std::string name;
+    bool connected;
+};
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+// Updates until count changes were reported or a few seconds passed. The X server sends its notifications asynchronously.
+static void WaitForChanges(IWindow::Window& window, std::vector<MonitorChange>& changes, size_t count) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (changes.size() < count && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        window.WaitForEvent(0.05);
+
+    // Anything that arrives late would be a wrong report.
+    window.WaitForEvent(0.1);
+}
+
+#if defined(IWINDOW_NULL)
+static IWindow::Monitor MakeMonitor(const std::string& name, int32_t x) {
+    IWindow::Monitor monitor{};
+    monitor.size = { 1920, 1080 };
+    monitor.position = { x, 0 };
+    monitor.name = name;
+    monitor.dpi = { 96, 96 };
+    return monitor;
+}
+
+static void Connect(IWindow::Window&, const std::vector<std::string>& names) {
+    std::vector<IWindow::Monitor> monitors{};
+    for (const std::string& name : names) monitors.push_back(MakeMonitor(name, (int32_t)monitors.size() * 1920));
+    IWindow::Null::SetMonitors(monitors);
+}
+#else
+// Replaces the virtual monitors this test made with names. Monitors the X server had before are kept.
+static void Connect(IWindow::Window& window, const std::vector<std::string>& names) {
+    static std::vector<xcb_atom_t> s_added{};
+
+    xcb_connection_t* connection = window.GetNativeDeviceContext();
+    const xcb_window_t root = xcb_setup_roots_iterator(xcb_get_setup(connection)).data->root;
+
+    std::vector<xcb_atom_t> atoms{};
+    for (const std::string& name : names) {
+        xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(connection, xcb_intern_atom(connection, 0, (uint16_t)name.size(), name.c_str()), nullptr);
+        atoms.push_back(reply ? reply->atom : XCB_ATOM_NONE);
+        free(reply);
+    }
+
+    for (xcb_atom_t atom : s_added) {
+        bool kept = false;
+        for (xcb_atom_t keep : atoms) kept |= keep == atom;
+        if (!kept) xcb_randr_delete_monitor_checked(connection, root, atom);
+    }
+
+    for (size_t i = 0; i < atoms.size(); i++) {
+        bool added = false;
+        for (xcb_atom_t atom : s_added) added |= atom == atoms[i];
+        if (added) continue;
+
+        // A monitor without outputs. The X server only reports it while it lies inside the screen.
+        xcb_randr_monitor_info_t info{};
+        info.name = atoms[i];
+        info.x = (int16_t)(i * 64);
+        info.width = 64;
+        info.height = 64;
+        info.width_in_millimeters = 17;
+        info.height_in_millimeters = 17;
+        xcb_randr_set_monitor_checked(connection, root, &info);
+    }
+
+    s_added = atoms;
+    xcb_flush(connection);
+}
+#endif
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+#if defined(IWINDOW_NULL)
+    Connect(window, { "IWINDOW-A", "IWINDOW-B", "IWINDOW-C" });
+#endif
+
+    if (!window.Create({ 640, 480 }, L"IWindow monitor test")) return EXIT_FAILURE;
+
+    std::vector<MonitorChange> changes{};
+    window.SetMonitorCallback([&](IWindow::Window&, const IWindow::Monitor& monitor, bool connected) { changes.push_back({ monitor.name, connected }); });
+
+#if !defined(IWINDOW_NULL)
+    // The window is needed to talk to the X server, so the monitors are added once it listens for changes.
+    Connect(window, { "IWINDOW-A", "IWINDOW-B", "IWINDOW-C" });
+    WaitForChanges(window, changes, 3);
+    changes.clear();
+#endif
+
+    bool ok = true;
+
+    IWindow::Monitor b{};
+    for (const IWindow::Monitor& monitor : IWindow::Monitor::GetAllMonitors())
+        if (monitor.name == "IWINDOW-B") b = monitor;
+    ok &= Check(b.id != 0, "B is connected");
+
+    // Removing the middle monitor reports it, not the last one.
+    Connect(window, { "IWINDOW-A", "IWINDOW-C" });
+    WaitForChanges(window, changes, 1);
+    ok &= Check(changes.size() == 1 && changes[0].name == "IWINDOW-B" && !changes[0].connected, "Only B disconnected");
+
+    IWindow::Monitor found{};
+    ok &= Check(!IWindow::Monitor::FindMonitor(b.id, found), "B can't be found");
+
+    changes.clear();
+    Connect(window, { "IWINDOW-A", "IWINDOW-C", "IWINDOW-D" });
+    WaitForChanges(window, changes, 1);
+    ok &= Check(changes.size() == 1 && changes[0].name == "IWINDOW-D" && changes[0].connected, "Only D connected");
+
+    // The cache makes the default argument of every Window::Create cheap.
+    constexpr uint32_t CALLS = 100'000;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t names = 0;
+    for (uint32_t i = 0; i < CALLS; i++) names += IWindow::Monitor::GetPrimaryMonitor().name.size();
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / CALLS;
+
+    std::cout << "Monitor::GetPrimaryMonitor: " << ns << " ns per call (" << names << ")\n";
+    std::cout << (ok ? "OK" : "FAILED") << '\n';
+
+#if !defined(IWINDOW_NULL)
+    Connect(window, {});
+#endif
+
+    window.Destroy();
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,107 @@
+#include "IWindow.h"
+
+#if defined(IWINDOW_NULL)
+#include "IWindowNull.h"
+#else
+#include <xcb/xcb.h>
+#include <xcb/xtest.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Replays a recorded mouse movement through raw mouse motion and checks that every delta arrives, in order and unaccelerated.
+// With the null backend the deltas are pushed with IWindow::Null::PushRawMouseMotionEvent.
+// With XCB they are injected as relative XTest motion, so run it on an X server without a user, e.g. xvfb-run.
+
+// Small, large and diagonal motion, like a quick flick of an aim trainer.
+static const IWindow::Vector2<float> RECORDED_MOTION[] = {
+    { 1, 0 }, { 2, 0 }, { 3, -1 }, { 8, -2 }, { 20, -5 }, { 40, -9 }, { 25, -4 }, { 9, 0 }, { 2, 1 }, { 0, 1 },
+    { -1, 0 }, { -3, 2 }, { -12, 6 }, { -30, 11 }, { -18, 5 }, { -4, 1 }, { 0, -1 }, { 1, -1 }, { 0, 3 }, { 5, 5 },
+};
+
+constexpr size_t MOTION_COUNT = sizeof(RECORDED_MOTION) / sizeof(RECORDED_MOTION[0]);
+
+static void Inject(IWindow::Window& window, IWindow::Vector2<float> delta) {
+#if defined(IWINDOW_NULL)
+    IWindow::Null::PushRawMouseMotionEvent(window, delta);
+#else
+    // detail 1 makes the motion relative.
+    xcb_connection_t* connection = window.GetNativeDeviceContext();
+    xcb_test_fake_input(connection, XCB_MOTION_NOTIFY, 1, XCB_CURRENT_TIME, XCB_WINDOW_NONE, (int16_t)delta.x, (int16_t)delta.y, 0);
+    xcb_flush(connection);
+#endif
+}
+
+// Raw motion is only recorded for the focused window. There is no window manager on Xvfb to give it focus.
+static bool Focus(IWindow::Window& window) {
+#if !defined(IWINDOW_NULL)
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    while (!window.IsFocused() && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+        xcb_connection_t* connection = window.GetNativeDeviceContext();
+        xcb_set_input_focus(connection, XCB_INPUT_FOCUS_POINTER_ROOT, window.GetNativeWindowHandle(), XCB_CURRENT_TIME);
+        xcb_flush(connection);
+
+        window.WaitForEvent(0.1);
+    }
+
+    return window.IsFocused();
+#else
+    IWindow::Null::PushFocusEvent(window, true);
+    window.Update();
+    return true;
+#endif
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow raw mouse test")) return EXIT_FAILURE;
+
+    if (!window.IsRawMouseMotionSupported() || !window.SetRawMouseMotion(true, MOTION_COUNT * 2)) {
+        std::cout << "Raw mouse motion is not supported!\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!Focus(window)) {
+        std::cout << "The window never got focus!\n";
+        return EXIT_FAILURE;
+    }
+
+    // Motion from before the replay.
+    window.Update();
+
+    for (IWindow::Vector2<float> delta : RECORDED_MOTION) Inject(window, delta);
+
+    // Everything is read in one update, the way a frame sees a burst from a high-rate mouse.
+    std::vector<IWindow::RawMouseMotion> samples{};
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (samples.size() < MOTION_COUNT && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        window.Update();
+
+        std::vector<IWindow::RawMouseMotion> update(window.GetRawMouseMotionCount());
+        window.GetRawMouseMotion(update.data(), (uint32_t)update.size());
+        samples.insert(samples.end(), update.begin(), update.end());
+    }
+
+    bool ok = samples.size() == MOTION_COUNT;
+    for (size_t i = 0; ok && i < MOTION_COUNT; i++) {
+        ok = std::abs(samples[i].delta.x - RECORDED_MOTION[i].x) < 0.01f && std::abs(samples[i].delta.y - RECORDED_MOTION[i].y) < 0.01f;
+        ok = ok && (i == 0 || samples[i].time >= samples[i - 1].time);
+    }
+
+    std::cout << "Replayed " << MOTION_COUNT << " motions, got " << samples.size() << " samples: " << (ok ? "OK" : "FAILED") << '\n';
+
+    window.Destroy();
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+#include "IWindow.h"
+
+#if defined(IWINDOW_NULL)
+#include "IWindowNull.h"
+#else
+#include <xcb/xcb.h>
+#include <xcb/randr.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Switches the primary monitor to 800x600 at 144 hertz with exclusive fullscreen and checks that it gets its mode back
+// when the window leaves fullscreen and when it is destroyed.
+// With the null backend the modes are given with IWindow::Null::SetVideoModes.
+// With XCB the modes are added to the RandR output of the primary monitor, so run it on an X server without a user, e.g. xvfb-run.
+// Xvfb only shows modes that fit its screen, which is 1280x1024 by default.
+
+struct TestMode {
+    int32_t width, height;
+    double refreshRate;
+};
+
+static const TestMode TEST_MODES[] = { { 800, 600, 60.0 }, { 800, 600, 144.0 }, { 640, 480, 144.0 } };
+
+static bool Check(bool condition, const char* what) {
+    if (!condition) std::cout << "FAILED: " << what << '\n';
+    return condition;
+}
+
+static bool SameMode(const IWindow::VideoMode& left, const IWindow::VideoMode& right) {
+    return left.size.width == right.size.width && left.size.height == right.size.height && std::abs(left.refreshRate - right.refreshRate) < 0.5;
+}
+
+// The X server reports the switch asynchronously, so the window's monitor callback only sees it after a few updates.
+static void Settle(IWindow::Window& window) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200)) window.WaitForEvent(0.05);
+}
+
+#if defined(IWINDOW_NULL)
+static void AddModes(const IWindow::Monitor& monitor) {
+    std::vector<IWindow::VideoMode> modes{ { monitor.size, 60.0, 32 } };
+    for (const TestMode& mode : TEST_MODES) modes.push_back({ { mode.width, mode.height }, mode.refreshRate, 32 });
+    IWindow::Null::SetVideoModes(monitor.name, modes);
+}
+
+static void RemoveModes() {}
+#else
+static std::vector<xcb_randr_mode_t> s_modes{};
+static xcb_randr_output_t s_output = XCB_NONE;
+
+// Adds the test modes to the first output of the monitor.
+static void AddModes(const IWindow::Monitor& monitor) {
+    xcb_connection_t* connection = xcb_connect(nullptr, nullptr);
+    const xcb_window_t root = xcb_setup_roots_iterator(xcb_get_setup(connection)).data->root;
+
+    xcb_randr_get_monitors_reply_t* monitors = xcb_randr_get_monitors_reply(connection, xcb_randr_get_monitors(connection, root, 1), nullptr);
+    if (!monitors) {
+        xcb_disconnect(connection);
+        return;
+    }
+
+    for (xcb_randr_monitor_info_iterator_t it = xcb_randr_get_monitors_monitors_iterator(monitors); it.rem; xcb_randr_monitor_info_next(&it))
+        if ((uint64_t)it.data->name == monitor.id && xcb_randr_monitor_info_outputs_length(it.data)) s_output = xcb_randr_monitor_info_outputs(it.data)[0];
+    free(monitors);
+
+    for (const TestMode& mode : TEST_MODES) {
+        const std::string name = std::to_string(mode.width) + "x" + std::to_string(mode.height) + "_" + std::to_string((int32_t)mode.refreshRate);
+
+        // The blanking of a CVT reduced blanking mode, roughly.
+        xcb_randr_mode_info_t info{};
+        info.width = (uint16_t)mode.width;
+        info.height = (uint16_t)mode.height;
+        info.htotal = (uint16_t)(mode.width + 160);
+        info.vtotal = (uint16_t)(mode.height + 30);
+        info.hsync_start = (uint16_t)(mode.width + 48);
+        info.hsync_end = (uint16_t)(mode.width + 80);
+        info.vsync_start = (uint16_t)(mode.height + 3);
+        info.vsync_end = (uint16_t)(mode.height + 7);
+        info.dot_clock = (uint32_t)(mode.refreshRate * info.htotal * info.vtotal);
+        info.name_len = (uint16_t)name.size();
+
+        xcb_randr_create_mode_reply_t* reply = xcb_randr_create_mode_reply(connection, xcb_randr_create_mode(connection, root, info, (uint32_t)name.size(), name.c_str()), nullptr);
+        if (!reply) continue;
+
+        s_modes.push_back(reply->mode);
+        free(xcb_request_check(connection, xcb_randr_add_output_mode_checked(connection, s_output, reply->mode)));
+        free(reply);
+    }
+
+    xcb_disconnect(connection);
+}
+
+static void RemoveModes() {
+    xcb_connection_t* connection = xcb_connect(nullptr, nullptr);
+
+    for (xcb_randr_mode_t mode : s_modes) {
+        free(xcb_request_check(connection, xcb_randr_delete_output_mode_checked(connection, s_output, mode)));
+        free(xcb_request_check(connection, xcb_randr_destroy_mode_checked(connection, mode)));
+    }
+
+    xcb_disconnect(connection);
+}
+#endif
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Monitor primary = IWindow::Monitor::GetPrimaryMonitor();
+    AddModes(primary);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow video mode test")) return EXIT_FAILURE;
+
+    uint32_t disconnects = 0;
+    window.SetMonitorCallback([&](IWindow::Window&, const IWindow::Monitor&, bool connected) { disconnects += !connected; });
+
+    bool ok = true;
+
+    const IWindow::VideoMode original = primary.GetCurrentVideoMode();
+    const std::vector<IWindow::VideoMode> modes = primary.GetVideoModes();
+    ok &= Check(!original.IsEmpty() && modes.size() >= 3, "Video modes listed");
+    for (size_t i = 1; i < modes.size(); i++)
+        ok &= Check(modes[i - 1].size.width <= modes[i].size.width, "Video modes sorted");
+
+    const IWindow::VideoMode wanted = primary.GetClosestVideoMode({ 800, 600 }, 150.0);
+    ok &= Check(SameMode(wanted, { { 800, 600 }, 144.0, 0 }), "Closest mode is 800x600 at 144 hertz");
+
+    // Trade resolution for frame rate.
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ok &= Check(window.Fullscreen(true, primary, wanted), "Fullscreen with a video mode");
+    const double ms = (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    Settle(window);
+
+    IWindow::Monitor switched{};
+    ok &= Check(window.IsFullscreen() && SameMode(primary.GetCurrentVideoMode(), wanted), "Monitor is in the mode");
+    ok &= Check(IWindow::Monitor::FindMonitor(primary.id, switched) && switched.size.width == 800 && switched.size.height == 600, "Monitor has the size of the mode");
+
+    window.Fullscreen(false, primary);
+    Settle(window);
+    ok &= Check(!window.IsFullscreen() && SameMode(primary.GetCurrentVideoMode(), original), "Leaving fullscreen restores the mode");
+
+    window.Fullscreen(true, primary, primary.GetClosestVideoMode({ 640, 480 }, 144.0));
+    window.Destroy();
+    ok &= Check(SameMode(primary.GetCurrentVideoMode(), original), "Destroy restores the mode");
+
+    ok &= Check(disconnects == 0, "A mode switch is not a hot-plug");
+
+    std::cout << "Switched to " << wanted.size.width << "x" << wanted.size.height << " at " << wanted.refreshRate << " hertz in " << ms << " ms\n";
+    std::cout << (ok ? "OK" : "FAILED") << '\n';
+
+    RemoveModes();
+    IWindow::Shutdown();
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -224,8 +224,11 @@ int main() {
         }
 
         gp.Update();
-        window2.Update();
-        window.Update();
+        // Handles the events of both windows in one pass.
+        // or
+        // window2.Update();
+        // window.Update();
+        IWindow::PollEvents();
     }
 
     window.Destroy();
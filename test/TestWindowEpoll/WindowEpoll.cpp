@@ -0,0 +1,113 @@
+#include "IWindow.h"
+
+#if defined(IWINDOW_NULL)
+#include "IWindowNull.h"
+#endif
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+// Runs IWindow inside an epoll loop next to a timerfd, the way a service with its own reactor would.
+// The loop only wakes up for window events and timer ticks. Window::Update is never called.
+// With the null backend the timer plays the user: it presses a key and then closes the window, so the example ends by itself.
+
+constexpr int64_t TICK_NS = 16'666'667;
+constexpr uint64_t MAX_TICKS = 600;
+
+static int CreateTimer() {
+    const int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (timerFd < 0) return -1;
+
+    itimerspec interval{};
+    interval.it_value.tv_nsec = TICK_NS;
+    interval.it_interval.tv_nsec = TICK_NS;
+    timerfd_settime(timerFd, 0, &interval, nullptr);
+
+    return timerFd;
+}
+
+static void Watch(int epollFd, int fd) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+}
+
+int main() {
+    IWindow::Initialize(IWindow::CurrentVersion);
+
+    IWindow::Window window{};
+    if (!window.Create({ 640, 480 }, L"IWindow epoll example")) return EXIT_FAILURE;
+
+    uint32_t keyEvents = 0;
+    window.SetKeyCallback([&](IWindow::Window&, IWindow::Key key, IWindow::KeyModifier, IWindow::InputState state, bool) {
+        keyEvents++;
+        std::cout << "Key: " << (int)key << (state == IWindow::InputState::Down ? " pressed\n" : " released\n");
+    });
+
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    const int timerFd = CreateTimer();
+    const int windowFd = IWindow::GetEventFd();
+
+    if (epollFd < 0 || timerFd < 0 || windowFd < 0) {
+        std::cout << "Failed to set up the epoll loop!\n";
+        return EXIT_FAILURE;
+    }
+
+    Watch(epollFd, timerFd);
+    Watch(epollFd, windowFd);
+
+    // Events that came in while the window was created.
+    IWindow::DispatchPending();
+
+    uint64_t ticks = 0;
+    uint64_t windowWakeUps = 0;
+
+    while (window.IsRunning() && ticks < MAX_TICKS) {
+        epoll_event events[2];
+        const int count = epoll_wait(epollFd, events, 2, -1);
+
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.fd == windowFd) {
+                windowWakeUps++;
+                IWindow::DispatchPending();
+                continue;
+            }
+
+            uint64_t expirations = 0;
+            if (read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) continue;
+
+            ticks += expirations;
+
+#if defined(IWINDOW_NULL)
+            if (ticks == 1) {
+                IWindow::Null::PushKeyEvent(window, IWindow::Key::A, IWindow::InputState::Down);
+                IWindow::Null::PushKeyEvent(window, IWindow::Key::A, IWindow::InputState::Up);
+            }
+            else if (keyEvents == 2) {
+                IWindow::Null::PushCloseEvent(window);
+            }
+#endif
+        }
+    }
+
+    std::cout << "Ticks: " << ticks << ", window wake-ups: " << windowWakeUps << ", key events: " << keyEvents << '\n';
+
+    close(timerFd);
+    close(epollFd);
+
+    window.Destroy();
+    IWindow::Shutdown();
+
+#if defined(IWINDOW_NULL)
+    // Both key events and the close request have to arrive through the fd.
+    return (keyEvents == 2 && !window.IsRunning()) ? EXIT_SUCCESS : EXIT_FAILURE;
+#else
+    return EXIT_SUCCESS;
+#endif
+}